@@ -26,6 +26,7 @@
 #include <QApplication>
 
 #include "qucsactivefilter.h"
+#include "../qucs-batch/synthbatch.h"
 
 struct tQucsSettings QucsSettings;
 
@@ -62,8 +63,84 @@ bool saveApplSettings(QucsActiveFilter *qucs)
 }
 
 
+// #########################################################################
+// Synthesizes one row of the batch mode.
+static bool batchFilter(const SynthSpec &row, SynthResult &result)
+{
+    static const QStringList functions = {"butterworth", "chebyshev", "inverse-chebyshev",
+                                          "cauer", "bessel", "legendre"};
+    static const Filter::FilterFunc funcs[] = {Filter::Butterworth, Filter::Chebyshev,
+                                               Filter::InvChebyshev, Filter::Cauer,
+                                               Filter::Bessel, Filter::Legendre};
+    static const QStringList types = {"lowpass", "highpass", "bandpass", "bandstop"};
+    static const Filter::FType ftypes[] = {Filter::LowPass, Filter::HighPass,
+                                           Filter::BandPass, Filter::BandStop};
+    static const QStringList topologies = {"mfb", "sallen-key", "cauer"};
+
+    Filter::FilterFunc ffunc = funcs[row.choice("function", functions, 0)];
+    Filter::FType ftyp = ftypes[row.choice("type", types, 0)];
+    int topology = row.choice("topology", topologies, 0);
+
+    FilterParam par = {};
+    par.As = row.number("as", 20);
+    par.Rp = row.number("rp", 3);
+    par.Kv = pow(10, row.number("kv", 0)/20.0);
+    par.order = int(row.number("order", 5));
+    if ((ftyp == Filter::LowPass) || (ftyp == Filter::HighPass)) {
+        par.Ap = row.number("ap", 3);
+        par.Fc = row.number("fc", 1000);
+        par.Fs = row.number("fs", 1200);
+    } else {
+        for (const char *key : {"fl", "fu", "tw"})
+            if (!row.contains(key))
+                row.fail(QStringLiteral("%1 is needed by band filters").arg(key));
+        par.Fl = row.number("fl", 0);
+        par.Fu = row.number("fu", 0);
+        par.TW = row.number("tw", 0);
+        if (par.Fl > par.Fu)
+            row.fail(QObject::tr("Upper cutoff frequency of band-pass/band-stop filter is\n"
+                                 "less than lower. Unable to implement such filter.\n"
+                                 "Change parameters and try again."));
+    }
+    if (!row.error().isEmpty())
+        return false;
+
+    QStringList lst;
+    QString err;
+    bool ok = QucsActiveFilter::calcFilter(ffunc, ftyp, topology, par, {}, {},
+                                           lst, result.schematic, err);
+    if (!ok) {
+        row.fail(err.simplified());
+        return false;
+    }
+    result.parts = lst;
+    return true;
+}
+
+static const char *batchKeys =
+    "  name        file name of the design\n"
+    "  function    butterworth, chebyshev, inverse-chebyshev, cauer, bessel,\n"
+    "              legendre (butterworth)\n"
+    "  type        lowpass, highpass, bandpass, bandstop (lowpass)\n"
+    "  topology    mfb, sallen-key, cauer (mfb)\n"
+    "  ap, fc, fs  low and high pass: pass band attenuation, cutoff and stop band\n"
+    "              frequency (3 dB, 1000 Hz, 1200 Hz)\n"
+    "  fl, fu, tw  band pass and band stop: lower and upper cutoff frequency,\n"
+    "              transient bandwidth (no defaults)\n"
+    "  as          stop band attenuation (20 dB)\n"
+    "  rp          pass band ripple (3 dB)\n"
+    "  kv          pass band gain (0 dB)\n"
+    "  order       order of Bessel and Legendre filters (5)";
+
+
 int main(int argc, char *argv[])
 {
+    // headless synthesis of a table of filters
+    if (synthbatch::requested(argc, argv)) {
+        QCoreApplication a(argc, argv);
+        return synthbatch::run(argc, argv, "activefilter", batchKeys, batchFilter);
+    }
+
     QApplication a(argc, argv);
 
     QString LangDir;
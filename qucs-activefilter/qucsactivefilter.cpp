@@ -21,6 +21,8 @@
 #include "schcauer.h"
 #include "transferfuncdialog.h"
 #include "helpdialog.h"
+#include "tolerance.h"
+#include "../qucs-filter/responseplot.h"
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -134,6 +136,9 @@ QucsActiveFilter::QucsActiveFilter(QWidget *parent)
     btnCalcSchematic = new QPushButton(tr("Calculate and copy to clipboard"));
     connect(btnCalcSchematic,SIGNAL(clicked()),SLOT(slotCalcSchematic()));
 
+    btnCompare = new QPushButton(tr("Compare designs..."));
+    connect(btnCompare,SIGNAL(clicked()),SLOT(slotCompare()));
+
     txtResult = new QPlainTextEdit;
     txtResult->setReadOnly(true);
     txtResult->setWordWrapMode(QTextOption::NoWrap);
@@ -207,6 +212,7 @@ QucsActiveFilter::QucsActiveFilter(QWidget *parent)
     l2->addWidget(cbxFilterType);
     vl4->addLayout(l2);
     vl4->addWidget(btnCalcSchematic);
+    vl4->addWidget(btnCompare);
 
     gpbFunc->setLayout(vl4);
     // do not actually show on screen (yet)
@@ -242,6 +248,48 @@ QucsActiveFilter::QucsActiveFilter(QWidget *parent)
 
     this->slotUpdateSchematic();
 
+    // component tolerances, below the topology
+    QGroupBox *gpbTol = new QGroupBox(tr("Tolerance analysis"));
+    QGridLayout *vl6 = new QGridLayout;
+    vl6->setSpacing(3);
+    QStringList series;
+    series<<"E6"<<"E12"<<"E24"<<"E48"<<"E96"<<"E192";
+    cbxRSeries = new QComboBox;
+    cbxRSeries->addItems(series);
+    cbxRSeries->setCurrentIndex(4);
+    cbxCSeries = new QComboBox;
+    cbxCSeries->addItems(series);
+    cbxCSeries->setCurrentIndex(1);
+    edtRTol = new QLineEdit("1");
+    edtRTol->setValidator(val1);
+    edtCTol = new QLineEdit("5");
+    edtCTol->setValidator(val1);
+    edtSamples = new QLineEdit("1000");
+    edtSamples->setValidator(new QIntValidator(1,1000000));
+    btnTolerance = new QPushButton(tr("Analyse E-series values and tolerances"));
+    btnTolerance->setEnabled(false);
+    connect(btnTolerance,SIGNAL(clicked()),SLOT(slotTolerance()));
+    vl6->addWidget(new QLabel(tr("Resistors")),0,0);
+    vl6->addWidget(cbxRSeries,0,1);
+    vl6->addWidget(edtRTol,0,2);
+    vl6->addWidget(new QLabel("%"),0,3);
+    vl6->addWidget(new QLabel(tr("Capacitors")),1,0);
+    vl6->addWidget(cbxCSeries,1,1);
+    vl6->addWidget(edtCTol,1,2);
+    vl6->addWidget(new QLabel("%"),1,3);
+    vl6->addWidget(new QLabel(tr("Samples")),2,0);
+    vl6->addWidget(edtSamples,2,1);
+    vl6->addWidget(btnTolerance,3,0,1,4);
+    gpbTol->setLayout(vl6);
+
+    // response of the designed circuit, right of the tolerance box
+    QGroupBox *gpbPlot = new QGroupBox(tr("Transfer function preview"));
+    QVBoxLayout *vl7 = new QVBoxLayout;
+    plotResponse = new ResponsePlot;
+    plotResponse->setLabels(tr("dB(V(out)/V(in))"), QString());
+    vl7->addWidget(plotResponse);
+    gpbPlot->setLayout(vl7);
+
     // place the boxes in a grid, so they will align nicely
     QGridLayout *layout = new QGridLayout();
     layout->setColumnStretch(1, 5); // stretch only the right part
@@ -250,6 +298,8 @@ QucsActiveFilter::QucsActiveFilter(QWidget *parent)
     layout->addWidget(gpbAFR, 0, 2);
     layout->addWidget(gpbFunc, 1, 0);
     layout->addWidget(gpbSCH, 1, 2);
+    layout->addWidget(gpbTol, 2, 0);
+    layout->addWidget(gpbPlot, 2, 2);
 
     top1 = new QVBoxLayout;
     top1->addLayout(layout);
@@ -277,11 +327,9 @@ QucsActiveFilter::~QucsActiveFilter()
     
 }
 
-void QucsActiveFilter::slotCalcSchematic()
+// Reads the filter parameters and the filter type (ftyp) from the widgets.
+bool QucsActiveFilter::readParameters(FilterParam &par)
 {
-    txtResult->clear();
-
-    FilterParam par;
     if ((cbxResponse->currentIndex()==tLowPass)||
         (cbxResponse->currentIndex()==tHiPass)) {
        par.Ap = edtA1->text().toFloat();       
@@ -296,13 +344,37 @@ void QucsActiveFilter::slotCalcSchematic()
            errorMessage(tr("Upper cutoff frequency of band-pass/band-stop filter is\n"
                            "less than lower. Unable to implement such filter.\n"
                            "Change parameters and try again."));
-           return;
+           return false;
        }
     }
     par.As = edtA2->text().toFloat();
     par.Rp = edtPassbRpl->text().toFloat();
     double  G = edtKv->text().toFloat();
     par.Kv = pow(10,G/20.0);
+    par.order = edtOrder->text().toInt();
+
+    switch (cbxResponse->currentIndex()) {
+    case tLowPass : ftyp = Filter::LowPass;
+        break;
+    case tHiPass : ftyp = Filter::HighPass;
+        break;
+    case tBandPass : ftyp = Filter::BandPass;
+        break;
+    case tBandStop : ftyp = Filter::BandStop;
+        break;
+    default: ftyp = Filter::NoFilter;
+        break;
+    }
+    return true;
+}
+
+void QucsActiveFilter::slotCalcSchematic()
+{
+    txtResult->clear();
+
+    FilterParam par;
+    if (!readParameters(par))
+        return;
 
     QStringList lst;
     Filter::FilterFunc ffunc;
@@ -317,10 +389,8 @@ void QucsActiveFilter::slotCalcSchematic()
             case funcCauer : ffunc = Filter::Cauer;
                      break;
             case funcBessel : ffunc = Filter::Bessel;
-                     par.order = edtOrder->text().toInt();
                      break;
             case funcLegendre : ffunc = Filter::Legendre;
-                     par.order = edtOrder->text().toInt();
                      break;
             case funcUser : ffunc = Filter::User;
                      break;
@@ -328,25 +398,267 @@ void QucsActiveFilter::slotCalcSchematic()
                      break;
         }
 
+    QString s, err;
+    bool ok = calcFilter(ffunc, ftyp, cbxFilterType->currentIndex(), par,
+                         coeffA, coeffB, lst, s, err);
+    if (!lst.isEmpty())
+        txtResult->appendHtml("<pre>" + lst.join("\n") + "</pre>");
+    if (!err.isEmpty())
+        errorMessage(err);
 
+    if (ok) {
+      statusBar()->showMessage(tr("Filter calculation was successful"), 2000);
+        txtResult->appendHtml("<pre>\r\n" + 
+			      tr("Filter calculation was successful") +
+			      "</pre>");
+    } else {
+      statusBar()->showMessage(tr("Filter calculation terminated with error!"), 2000);
+        txtResult->appendHtml("<pre>\r\n" +
+			      tr("Filter calculation terminated with error") +
+			      "</pre>");
+    }
 
-    switch (cbxResponse->currentIndex()) {
-    case tLowPass : ftyp = Filter::LowPass;
-        break;
-    case tHiPass : ftyp = Filter::HighPass;
-        break;
-    case tBandPass : ftyp = Filter::BandPass;
+    QClipboard *cb = QApplication::clipboard();
+    cb->setText(s);
+
+    lastSchematic = ok ? s : QString();
+    btnTolerance->setEnabled(ok);
+
+    // the preview is the AC response of the schematic as it was built,
+    // the same nodal analysis the tolerance analysis uses
+    plotResponse->clear();
+    ToleranceAnalysis tol;
+    if (ok && tol.setSchematic(s.toStdString()) && tol.runIdeal(201))
+        plotResponse->setResponse(tol.frequencies(), tol.idealGain(),
+                                  std::vector<double>(), true);
+}
+
+void QucsActiveFilter::slotTolerance()
+{
+    static const int series[] = {6, 12, 24, 48, 96, 192};
+
+    ToleranceAnalysis tol;
+    if (!tol.setSchematic(lastSchematic.toStdString())) {
+        errorMessage(tr("Unable to analyse the filter: %1")
+                     .arg(QString::fromStdString(tol.error())));
+        return;
+    }
+    ToleranceAnalysis::Options opt;
+    opt.resistorSeries = series[cbxRSeries->currentIndex()];
+    opt.capacitorSeries = series[cbxCSeries->currentIndex()];
+    opt.resistorTolerance = edtRTol->text().toDouble();
+    opt.capacitorTolerance = edtCTol->text().toDouble();
+    opt.samples = edtSamples->text().toInt();
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool ok = tol.run(opt);
+    QApplication::restoreOverrideCursor();
+    if (!ok) {
+        errorMessage(QString::fromStdString(tol.error()));
+        return;
+    }
+
+    QStringList lst;
+    lst<<tr("Part   Ideal value    E%1/E%2 value")
+         .arg(opt.resistorSeries).arg(opt.capacitorSeries);
+    // as in the part list: resistors in kOhm, capacitors scaled like
+    // Filter::autoscaleCapacitor() does
+    auto format = [](const ToleranceAnalysis::Part &p, double v) {
+        if (p.name.front() == 'R')
+            return QStringLiteral("%1k").arg(v*1e-3,0,'f',3);
+        if (v >= 1e-7)
+            return QStringLiteral("%1uF").arg(v*1e6,0,'f',3);
+        if (v >= 1e-8)
+            return QStringLiteral("%1nF").arg(v*1e9,0,'f',3);
+        return QStringLiteral("%1pF").arg(v*1e12,0,'f',3);
+    };
+    for (const ToleranceAnalysis::Part &p : tol.parts()) {
+        lst<<QStringLiteral("%1%2%3")
+             .arg(QString::fromStdString(p.name),-6)
+             .arg(format(p,p.ideal),12)
+             .arg(format(p,p.series),16);
+    }
+    lst<<""
+       <<tr("Largest gain deviation of the E-series design: %1 dB")
+         .arg(tol.seriesDeviation(),0,'f',3)
+       <<tr("Yield (gain within %1 dB, phase within %2 deg): %3 % of %4 samples")
+         .arg(opt.maxGainDeviation).arg(opt.maxPhaseDeviation)
+         .arg(100.0*tol.yield(),0,'f',1).arg(opt.samples)
+       <<""
+       <<tr("Frequency(Hz)  Ideal(dB)  E-series(dB)  Min(dB)   Max(dB)  Phase(deg)");
+    const std::vector<double> &f = tol.frequencies();
+    for (size_t i = 0; i < f.size(); i += 10) {
+        lst<<QStringLiteral("%1 %2 %3 %4 %5 %6...%7")
+             .arg(f[i],13,'g',4)
+             .arg(tol.idealGain()[i],10,'f',2)
+             .arg(tol.seriesGain()[i],13,'f',2)
+             .arg(tol.minGain()[i],9,'f',2)
+             .arg(tol.maxGain()[i],9,'f',2)
+             .arg(tol.minPhase()[i],8,'f',1)
+             .arg(tol.maxPhase()[i],0,'f',1);
+    }
+    txtResult->appendHtml("<pre>" + lst.join("\n") + "</pre>");
+}
+
+// Designs the filter with every approximation and topology that fits the
+// filter type and ranks the designs by their response and part count.
+void QucsActiveFilter::slotCompare()
+{
+    FilterParam par;
+    if (!readParameters(par))
+        return;
+
+    // the pass band loss and the stop band attenuation are measured
+    // relative to the pass band gain Kv at these frequencies
+    std::vector<double> passFreq, stopFreq;
+    switch (ftyp) {
+    case Filter::LowPass :
+    case Filter::HighPass :
+        passFreq = {par.Fc};
+        stopFreq = {par.Fs};
         break;
-    case tBandStop : ftyp = Filter::BandStop;
+    case Filter::BandPass :
+        passFreq = {par.Fl, par.Fu};
+        if (par.Fl > par.TW)
+            stopFreq.push_back(par.Fl - par.TW);
+        stopFreq.push_back(par.Fu + par.TW);
         break;
-    default: ftyp = Filter::NoFilter;
+    default :
+        passFreq = {par.Fl, par.Fu};
+        if (par.Fl + par.TW < par.Fu - par.TW)
+            stopFreq = {par.Fl + par.TW, par.Fu - par.TW};
+        else
+            stopFreq = {sqrt(par.Fl*par.Fu)};
         break;
     }
+    std::vector<double> freq = passFreq;
+    freq.insert(freq.end(), stopFreq.begin(), stopFreq.end());
+    const double Kv = 20.0*log10(par.Kv);
+
+    // the same combinations slotSwitchParameters() offers
+    struct Candidate {
+        int func, topology, opamps, parts;
+        double passLoss, stopAtten;
+        bool meets;
+    };
+    static const Filter::FilterFunc funcs[] = {
+        Filter::Butterworth, Filter::Chebyshev, Filter::InvChebyshev,
+        Filter::Cauer, Filter::Bessel, Filter::Legendre};
+    QList<Candidate> candidates;
+    QStringList errors;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    for (int func = funcButterworth; func <= funcLegendre; func++) {
+        QList<int> topologies;
+        if ((func==funcInvChebyshev)||(func==funcCauer)||(ftyp==Filter::BandStop))
+            topologies<<topoCauer;
+        else
+            topologies<<topoMFB<<topoSallenKey;
+        for (int topology : topologies) {
+            QStringList lst;
+            QString s, err;
+            QString name = cbxFilterFunc->itemText(func) + ", " +
+                           (topology==topoCauer ? tr("Cauer section")
+                                                : cbxFilterType->itemText(topology));
+            if (!calcFilter(funcs[func], ftyp, topology, par, coeffA, coeffB,
+                            lst, s, err)) {
+                errors<<name + ": " + err.section('\n', 0, 0);
+                continue;
+            }
+            ToleranceAnalysis tol;
+            if (!tol.setSchematic(s.toStdString()) || !tol.runIdeal(freq)) {
+                errors<<name + ": " + QString::fromStdString(tol.error());
+                continue;
+            }
+            Candidate c;
+            c.func = func;
+            c.topology = topology;
+            c.opamps = s.count("<OpAmp");
+            c.parts = int(tol.parts().size());
+            c.passLoss = 0;
+            c.stopAtten = 1e300;
+            for (size_t i = 0; i < freq.size(); i++) {
+                double atten = Kv - tol.idealGain()[i];
+                if (i < passFreq.size())
+                    c.passLoss = std::max(c.passLoss, atten);
+                else
+                    c.stopAtten = std::min(c.stopAtten, atten);
+            }
+            c.meets = c.stopAtten >= par.As;
+            candidates.append(c);
+        }
+    }
+    QApplication::restoreOverrideCursor();
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate &a, const Candidate &b) {
+        if (a.meets != b.meets) return a.meets;
+        if (a.opamps != b.opamps) return a.opamps < b.opamps;
+        if (a.parts != b.parts) return a.parts < b.parts;
+        return a.passLoss < b.passLoss;
+    });
+
+    QDialog *dlg = new QDialog(this);
+    dlg->setAttribute(Qt::WA_DeleteOnClose);
+    dlg->setWindowTitle(tr("Compare designs"));
+    QVBoxLayout *vbox = new QVBoxLayout(dlg);
+    vbox->addWidget(new QLabel(
+        tr("Requirement: %1 dB stop band attenuation. Double-click a design to load it.")
+        .arg(par.As), dlg));
+
+    QTableWidget *table = new QTableWidget(candidates.size(), 6, dlg);
+    table->setHorizontalHeaderLabels(QStringList()<<tr("Approximation")<<tr("Topology")
+        <<tr("Op amps")<<tr("R and C")<<tr("Pass band loss")<<tr("Stop band attenuation"));
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->hide();
+    for (int row = 0; row < candidates.size(); row++) {
+        const Candidate &c = candidates.at(row);
+        QStringList cells;
+        cells<<cbxFilterFunc->itemText(c.func)
+             <<(c.topology==topoCauer ? tr("Cauer section")
+                                      : cbxFilterType->itemText(c.topology))
+             <<QString::number(c.opamps)<<QString::number(c.parts)
+             <<QStringLiteral("%1 dB").arg(c.passLoss,0,'f',2)
+             <<QStringLiteral("%1 dB").arg(c.stopAtten,0,'f',1);
+        for (int col = 0; col < cells.size(); col++) {
+            QTableWidgetItem *item = new QTableWidgetItem(cells.at(col));
+            if (!c.meets)
+                item->setForeground(palette().brush(QPalette::Disabled, QPalette::Text));
+            table->setItem(row, col, item);
+        }
+    }
+    table->resizeColumnsToContents();
+    vbox->addWidget(table);
+
+    errors.removeDuplicates();
+    if (!errors.isEmpty()) {
+        QLabel *lblErrors = new QLabel(tr("Left out:") + "\n" + errors.join("\n"), dlg);
+        lblErrors->setWordWrap(true);
+        vbox->addWidget(lblErrors);
+    }
+
+    connect(table, &QTableWidget::cellDoubleClicked, this,
+            [this, candidates](int row, int) {
+        const Candidate &c = candidates.at(row);
+        cbxFilterFunc->setCurrentIndex(c.func); // also sets up the topologies
+        cbxFilterType->setCurrentIndex(c.topology);
+        slotCalcSchematic();
+    });
 
-    QString s;
+    dlg->resize(table->horizontalHeader()->length() + 40, 400);
+    dlg->show();
+}
+
+// Designs the filter and creates its schematic "s", the pole/zero and part
+// lists go to "lst". Does not use the widgets, the batch mode calls it too.
+bool QucsActiveFilter::calcFilter(Filter::FilterFunc ffunc, Filter::FType ftyp, int topology,
+                                  FilterParam par, const QVector<long double> &coeffA,
+                                  const QVector<long double> &coeffB,
+                                  QStringList &lst, QString &s, QString &err)
+{
     bool ok = false;
 
-    switch (cbxFilterType->currentIndex()) {
+    switch (topology) {
     case topoCauer : {
             if (((ffunc==Filter::InvChebyshev)||
                  (ffunc==Filter::Cauer)||
@@ -355,16 +667,15 @@ void QucsActiveFilter::slotCalcSchematic()
                    ok = cauer.calcFilter();
                    cauer.createPolesZerosList(lst);
                    cauer.createPartList(lst);
-		   txtResult->appendHtml("<pre>" + lst.join("\n") + "</pre>");
                    if (ok) {
                        cauer.createSchematic(s);
                    } else {
-                       errorMessage(tr("Unable to implement filter with such parameters and topology \n"
-                                       "Change parameters and/or topology and try again!"));
+                       err = tr("Unable to implement filter with such parameters and topology \n"
+                                "Change parameters and/or topology and try again!");
                    }
                 } else {
-                    errorMessage(tr("Unable to use Cauer section for Chebyshev or Butterworth \n"
-                                 "frequency response. Try to use another topology."));
+                    err = tr("Unable to use Cauer section for Chebyshev or Butterworth \n"
+                             "frequency response. Try to use another topology.");
                 }
              }
 
@@ -378,16 +689,15 @@ void QucsActiveFilter::slotCalcSchematic()
                     ok = mfb.calcFilter();
                     mfb.createPolesZerosList(lst);
                     mfb.createPartList(lst);
-                    txtResult->appendHtml("<pre>" + lst.join("\n") + "</pre>");
                     if (ok) {
                         mfb.createSchematic(s);
                     } else {
-                        errorMessage(tr("Unable to implement filter with such parameters and topology \n"
-                                        "Change parameters and/or topology and try again!"));
+                        err = tr("Unable to implement filter with such parameters and topology \n"
+                                 "Change parameters and/or topology and try again!");
                     }
                 } else {
-                    errorMessage(tr("Unable to use MFB filter for Cauer or Inverse Chebyshev \n"
-                                 "frequency response. Try to use another topology."));
+                    err = tr("Unable to use MFB filter for Cauer or Inverse Chebyshev \n"
+                             "frequency response. Try to use another topology.");
                 }
              }
              break;
@@ -399,34 +709,19 @@ void QucsActiveFilter::slotCalcSchematic()
                ok = sk.calcFilter();
                sk.createPolesZerosList(lst);
                sk.createPartList(lst);
-	       txtResult->appendHtml("<pre>" + lst.join("\n") + "</pre>");
                if (ok) {
                    sk.createSchematic(s);
                } else {
-                   errorMessage(tr("Unable to implement filter with such parameters and topology \n"
-                                   "Change parameters and/or topology and try again!"));
+                   err = tr("Unable to implement filter with such parameters and topology \n"
+                            "Change parameters and/or topology and try again!");
                }
              }
              break;
-    default : errorMessage(tr("Function will be implemented in future version"));
+    default : err = tr("Function will be implemented in future version");
              break;
     }
 
-    if (ok) {
-      statusBar()->showMessage(tr("Filter calculation was successful"), 2000);
-        txtResult->appendHtml("<pre>\r\n" + 
-			      tr("Filter calculation was successful") +
-			      "</pre>");
-    } else {
-      statusBar()->showMessage(tr("Filter calculation terminated with error!"), 2000);
-        txtResult->appendHtml("<pre>\r\n" +
-			      tr("Filter calculation terminated with error") +
-			      "</pre>");
-    }
-
-    QClipboard *cb = QApplication::clipboard();
-    cb->setText(s);
-
+    return ok;
 }
 
 void QucsActiveFilter::slotUpdateResponse()
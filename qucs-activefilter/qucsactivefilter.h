@@ -29,6 +29,8 @@
 #include <complex>
 #include "filter.h"
 
+class ResponsePlot;
+
 struct tQucsSettings {
   int x, y;      // position of main window
   QFont font;
@@ -76,6 +78,7 @@ private:
 
     QComboBox *cbxFilterFunc;
     QPushButton *btnCalcSchematic;
+    QPushButton *btnCompare;
     QPushButton *btnDefineTransferFunc;
 
     QGroupBox *gpbCons;
@@ -94,6 +97,15 @@ private:
     QComboBox *cbxResponse;
 
     QPushButton *btnElements;
+
+    QComboBox *cbxRSeries;     // E-series of resistors
+    QComboBox *cbxCSeries;     // E-series of capacitors
+    QLineEdit *edtRTol;        // resistor tolerance, %
+    QLineEdit *edtCTol;        // capacitor tolerance, %
+    QLineEdit *edtSamples;     // Monte Carlo samples
+    QPushButton *btnTolerance;
+    QString lastSchematic;     // schematic of the last successful calculation
+    ResponsePlot *plotResponse; // transfer function of the last calculation
     //QPushButton *btnPassive;
 
     QVBoxLayout *top1;
@@ -103,6 +115,7 @@ private:
     QWidget *zenter;
 
     void errorMessage(QString s);
+    bool readParameters(FilterParam &par);
 
     QVector< std::complex<float> > Poles;
 
@@ -119,6 +132,8 @@ private slots:
     void slotUpdateSchematic();
     void slotUpdateResponse();
     void slotCalcSchematic();
+    void slotTolerance();
+    void slotCompare();
     void slotSwitchParameters();
     void slotSetLabels();
     void slotDefineTransferFunc();
@@ -131,6 +146,11 @@ private slots:
 public:
     QucsActiveFilter(QWidget *parent = 0);
     ~QucsActiveFilter();
+
+    static bool calcFilter(Filter::FilterFunc ffunc, Filter::FType ftyp, int topology,
+                           FilterParam par, const QVector<long double> &coeffA,
+                           const QVector<long double> &coeffB,
+                           QStringList &lst, QString &s, QString &err);
 };
 
 #endif // FILTERSINTEZ_H
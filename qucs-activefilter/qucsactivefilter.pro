@@ -21,7 +21,10 @@ SOURCES += main.cpp\
     schcauer.cpp \
     transferfuncdialog.cpp \
     qucsactivefilter.cpp \
-    helpdialog.cpp
+    helpdialog.cpp \
+    tolerance.cpp \
+    ../qucs-batch/synthbatch.cpp \
+    ../qucs-filter/responseplot.cpp
 
 HEADERS  += \
     filter.h \
@@ -33,7 +36,10 @@ HEADERS  += \
     transferfuncdialog.h \
     bessel.h \
     qucsactivefilter.h \
-    helpdialog.h
+    helpdialog.h \
+    tolerance.h \
+    ../qucs-batch/synthbatch.h \
+    ../qucs-filter/responseplot.h
 
 RESOURCES += \
     qucsactivefilter.qrc
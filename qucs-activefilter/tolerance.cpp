@@ -0,0 +1,570 @@
+/***************************************************************************
+                              tolerance.cpp
+                             ---------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "tolerance.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+const double pi = 3.14159265358979323846;
+
+const double E6[] = {1.0, 1.5, 2.2, 3.3, 4.7, 6.8};
+const double E12[] = {1.0, 1.2, 1.5, 1.8, 2.2, 2.7, 3.3, 3.9, 4.7, 5.6, 6.8, 8.2};
+const double E24[] = {1.0, 1.1, 1.2, 1.3, 1.5, 1.6, 1.8, 2.0, 2.2, 2.4, 2.7, 3.0,
+                      3.3, 3.6, 3.9, 4.3, 4.7, 5.1, 5.6, 6.2, 6.8, 7.5, 8.2, 9.1};
+
+// E-series mantissas in [1, 10); E48 and above follow the rounded
+// geometric series, E3...E24 have their historic values
+std::vector<double> mantissas(int series)
+{
+    switch (series) {
+    case 6:  return std::vector<double>(std::begin(E6), std::end(E6));
+    case 12: return std::vector<double>(std::begin(E12), std::end(E12));
+    case 24: return std::vector<double>(std::begin(E24), std::end(E24));
+    default: break;
+    }
+    std::vector<double> m;
+    for (int i = 0; i < series; i++) {
+        double v = std::round(100.0 * std::pow(10.0, double(i) / series)) / 100.0;
+        if (series == 192 && i == 185)
+            v = 9.20;   // the one exception of E192
+        m.push_back(v);
+    }
+    return m;
+}
+
+// Splits a schematic line "<a b "c d" e>" into its fields.
+std::vector<std::string> fields(const std::string &line)
+{
+    std::vector<std::string> f;
+    size_t begin = line.find('<'), end = line.rfind('>');
+    if (begin == std::string::npos || end == std::string::npos || end <= begin)
+        return f;
+    std::string field;
+    bool quoted = false, any = false;
+    for (size_t i = begin + 1; i < end; i++) {
+        char c = line[i];
+        if (c == '"') {
+            quoted = !quoted;
+            any = true;
+        } else if (c == ' ' && !quoted) {
+            if (any)
+                f.push_back(field);
+            field.clear();
+            any = false;
+        } else {
+            field += c;
+            any = true;
+        }
+    }
+    if (any)
+        f.push_back(field);
+    return f;
+}
+
+// "12.5k", "4.7 nF", "10 kHz"
+double value(const std::string &s)
+{
+    const char *p = s.c_str();
+    char *end;
+    double v = std::strtod(p, &end);
+    while (*end == ' ')
+        end++;
+    switch (*end) {
+    case 'f': v *= 1e-15; break;
+    case 'p': v *= 1e-12; break;
+    case 'n': v *= 1e-9; break;
+    case 'u': v *= 1e-6; break;
+    case 'm': v *= 1e-3; break;
+    case 'k': v *= 1e3; break;
+    case 'M': v *= 1e6; break;
+    case 'G': v *= 1e9; break;
+    default: break;
+    }
+    return v;
+}
+
+struct Disjoint {
+    std::vector<int> parent;
+    int add() {
+        parent.push_back(int(parent.size()));
+        return parent.back();
+    }
+    int find(int i) {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    }
+    void unite(int a, int b) { parent[find(a)] = find(b); }
+};
+
+double dB(std::complex<double> h)
+{
+    return 20.0 * std::log10(std::max(std::abs(h), 1e-30));
+}
+
+double degrees(std::complex<double> h)
+{
+    return std::arg(h) * 180.0 / pi;
+}
+
+} // namespace
+
+ToleranceAnalysis::ToleranceAnalysis()
+    : a_nodes(0), a_in(-1), a_out(-1), a_stop(0), a_seriesDeviation(0), a_yield(0)
+{
+}
+
+double ToleranceAnalysis::seriesValue(double value, int series, int dir)
+{
+    if (value <= 0)
+        return value;
+    const std::vector<double> m = mantissas(series);
+    double decade = std::pow(10.0, std::floor(std::log10(value)));
+    double x = value / decade;
+    // series values around x, the next decade included
+    double below = m.front(), above = 10.0;
+    for (double v : m) {
+        if (v <= x * (1 + 1e-9))
+            below = v;
+        if (v >= x * (1 - 1e-9)) {
+            above = v;
+            break;
+        }
+    }
+    if (dir < 0)
+        return below * decade;
+    if (dir > 0)
+        return above * decade;
+    // nearest on the logarithmic scale, as the series are spaced
+    return (x / below < above / x ? below : above) * decade;
+}
+
+bool ToleranceAnalysis::setSchematic(const std::string &schematic)
+{
+    a_elements.clear();
+    a_parts.clear();
+    a_error.clear();
+
+    Disjoint nets;
+    std::map<std::pair<int, int>, int> points;
+    auto point = [&](int x, int y) {
+        auto it = points.find({x, y});
+        if (it != points.end())
+            return it->second;
+        int n = nets.add();
+        points[{x, y}] = n;
+        return n;
+    };
+    std::vector<int> grounds;
+    int in = -1, out = -1;
+    std::vector<std::vector<int>> elementPoints;
+
+    std::istringstream stream(schematic);
+    std::string line, section;
+    while (std::getline(stream, line)) {
+        if (line.find("<Components>") != std::string::npos) { section = "c"; continue; }
+        if (line.find("<Wires>") != std::string::npos)      { section = "w"; continue; }
+        if (line.find("</") != std::string::npos)           { section.clear(); continue; }
+
+        std::vector<std::string> f = fields(line);
+        if (section == "w" && f.size() >= 5) {
+            int a = point(std::atoi(f[0].c_str()), std::atoi(f[1].c_str()));
+            int b = point(std::atoi(f[2].c_str()), std::atoi(f[3].c_str()));
+            nets.unite(a, b);
+            if (f[4] == "in")
+                in = a;
+            else if (f[4] == "out")
+                out = a;
+        }
+        if (section != "c" || f.size() < 9)
+            continue;
+
+        const std::string &model = f[0];
+        std::vector<std::pair<int, int>> ports;
+        Element e;
+        e.part = -1;
+        e.gain = 0;
+        if (model == "R" || model == "C") {
+            if (f.size() < 10)
+                continue;
+            ports = {{-30, 0}, {30, 0}};
+            e.kind = model == "R" ? Resistor : Capacitor;
+            e.part = int(a_parts.size());
+            a_parts.push_back({f[1], value(f[9]), 0});
+        } else if (model == "OpAmp") {
+            ports = {{-30, 20}, {-30, -20}, {40, 0}};
+            e.kind = OpAmp;
+            e.gain = f.size() > 9 ? value(f[9]) : 1e6;
+        } else if (model == "Vac") {
+            ports = {{30, 0}, {-30, 0}};
+            e.kind = Source;
+        } else if (model == "GND") {
+            ports = {{0, 0}};
+        } else {
+            if (model == ".AC" && f.size() > 13)
+                a_stop = value(f[13]);
+            continue;
+        }
+
+        // placed as Component::load() does: mirrored first, then rotated
+        int cx = std::atoi(f[3].c_str()), cy = std::atoi(f[4].c_str());
+        bool mirror = std::atoi(f[7].c_str()) == 1;
+        int rotate = std::atoi(f[8].c_str()) & 3;
+        std::vector<int> at;
+        for (auto &p : ports) {
+            int x = p.first, y = mirror ? -p.second : p.second;
+            for (int r = 0; r < rotate; r++) {
+                int tmp = -x;
+                x = y;
+                y = tmp;
+            }
+            at.push_back(point(cx + x, cy + y));
+        }
+        if (model == "GND") {
+            grounds.push_back(at[0]);
+            continue;
+        }
+        elementPoints.push_back(at);
+        a_elements.push_back(e);
+    }
+
+    if (in < 0 || out < 0 || a_parts.empty()) {
+        a_error = "The schematic has no filter with \"in\" and \"out\" labels";
+        return false;
+    }
+    if (a_stop <= 0) {
+        a_error = "The schematic has no AC simulation";
+        return false;
+    }
+
+    // number the nets, ground is 0
+    for (size_t i = 1; i < grounds.size(); i++)
+        nets.unite(grounds[i], grounds[0]);
+    std::map<int, int> number;
+    if (!grounds.empty())
+        number[nets.find(grounds[0])] = 0;
+    auto node = [&](int p) {
+        int root = nets.find(p);
+        auto it = number.find(root);
+        if (it != number.end())
+            return it->second;
+        int n = int(number.size()) + (grounds.empty() ? 1 : 0);
+        number[root] = n;
+        return n;
+    };
+    for (size_t i = 0; i < a_elements.size(); i++)
+        for (size_t k = 0; k < elementPoints[i].size(); k++)
+            a_elements[i].node[k] = node(elementPoints[i][k]);
+    a_in = node(in);
+    a_out = node(out);
+    a_nodes = 0;
+    for (auto &entry : number)
+        a_nodes = std::max(a_nodes, entry.second);
+    return true;
+}
+
+// Nodal analysis with the op amps as voltage controlled voltage sources
+// and the source as a voltage source: h[i] = V(out)/V(in) at a_freq[i].
+void ToleranceAnalysis::response(const std::vector<double> &values,
+                                 std::vector<std::complex<double>> &h) const
+{
+    using cplx = std::complex<double>;
+    int sources = 0;
+    for (const Element &e : a_elements)
+        if (e.kind == OpAmp || e.kind == Source)
+            sources++;
+    const int n = a_nodes + sources;
+    std::vector<cplx> A(size_t(n) * n), b(n);
+
+    h.resize(a_freq.size());
+    for (size_t f = 0; f < a_freq.size(); f++) {
+        const double w = 2 * pi * a_freq[f];
+        std::fill(A.begin(), A.end(), cplx(0));
+        std::fill(b.begin(), b.end(), cplx(0));
+        auto at = [&](int row, int col) -> cplx & { return A[size_t(row) * n + col]; };
+
+        int extra = a_nodes;
+        for (const Element &e : a_elements) {
+            const int *k = e.node;
+            switch (e.kind) {
+            case Resistor:
+            case Capacitor: {
+                cplx y = e.kind == Resistor ? cplx(1.0 / values[e.part])
+                                            : cplx(0, w * values[e.part]);
+                if (k[0]) at(k[0] - 1, k[0] - 1) += y;
+                if (k[1]) at(k[1] - 1, k[1] - 1) += y;
+                if (k[0] && k[1]) {
+                    at(k[0] - 1, k[1] - 1) -= y;
+                    at(k[1] - 1, k[0] - 1) -= y;
+                }
+                break;
+            }
+            case OpAmp:
+                // V(out) = G (V(+) - V(-)), the output current is unknown
+                if (k[2]) {
+                    at(k[2] - 1, extra) += 1.0;
+                    at(extra, k[2] - 1) += 1.0;
+                }
+                if (k[1]) at(extra, k[1] - 1) -= e.gain;
+                if (k[0]) at(extra, k[0] - 1) += e.gain;
+                extra++;
+                break;
+            case Source:
+                if (k[0]) {
+                    at(k[0] - 1, extra) += 1.0;
+                    at(extra, k[0] - 1) += 1.0;
+                }
+                if (k[1]) {
+                    at(k[1] - 1, extra) -= 1.0;
+                    at(extra, k[1] - 1) -= 1.0;
+                }
+                b[extra] = 1.0;
+                extra++;
+                break;
+            }
+        }
+
+        // Gaussian elimination with partial pivoting
+        for (int c = 0; c < n; c++) {
+            int pivot = c;
+            for (int r = c + 1; r < n; r++)
+                if (std::abs(at(r, c)) > std::abs(at(pivot, c)))
+                    pivot = r;
+            if (pivot != c) {
+                for (int j = c; j < n; j++)
+                    std::swap(at(c, j), at(pivot, j));
+                std::swap(b[c], b[pivot]);
+            }
+            cplx d = at(c, c);
+            if (d == cplx(0))
+                continue;
+            for (int r = c + 1; r < n; r++) {
+                cplx m = at(r, c) / d;
+                if (m == cplx(0))
+                    continue;
+                for (int j = c; j < n; j++)
+                    at(r, j) -= m * at(c, j);
+                b[r] -= m * b[c];
+            }
+        }
+        for (int r = n - 1; r >= 0; r--) {
+            cplx s = b[r];
+            for (int j = r + 1; j < n; j++)
+                s -= at(r, j) * b[j];
+            b[r] = at(r, r) == cplx(0) ? cplx(0) : s / at(r, r);
+        }
+
+        cplx vin = a_in ? b[a_in - 1] : cplx(0);
+        cplx vout = a_out ? b[a_out - 1] : cplx(0);
+        h[f] = vin == cplx(0) ? cplx(0) : vout / vin;
+    }
+}
+
+// Largest gain deviation from the ideal response in dB, in the range that
+// is checked; the largest phase deviation in degrees goes to "phase".
+double ToleranceAnalysis::deviation(const std::vector<std::complex<double>> &h,
+                                    double *phase) const
+{
+    double gain = 0, ph = 0;
+    for (size_t f = 0; f < h.size(); f++) {
+        if (!a_inRange[f])
+            continue;
+        gain = std::max(gain, std::abs(dB(h[f]) - a_idealGain[f]));
+        if (a_ideal[f] != std::complex<double>(0))
+            ph = std::max(ph, std::abs(degrees(h[f] / a_ideal[f])));
+    }
+    if (phase)
+        *phase = ph;
+    return gain;
+}
+
+bool ToleranceAnalysis::runIdeal(int points)
+{
+    points = std::max(2, points);
+    std::vector<double> freq(points);
+    for (int i = 0; i < points; i++)
+        freq[i] = a_stop * std::pow(10.0, 3.0 * (double(i) / (points - 1) - 1));
+    return runIdeal(freq);
+}
+
+bool ToleranceAnalysis::runIdeal(const std::vector<double> &freq)
+{
+    if (a_parts.empty()) {
+        a_error = "No circuit";
+        return false;
+    }
+
+    a_freq = freq;
+    const int points = int(a_freq.size());
+    std::vector<double> ideal;
+    for (const Part &p : a_parts)
+        ideal.push_back(p.ideal);
+    response(ideal, a_ideal);
+
+    a_idealGain.resize(points);
+    a_idealPhase.resize(points);
+    for (int f = 0; f < points; f++) {
+        a_idealGain[f] = dB(a_ideal[f]);
+        a_idealPhase[f] = degrees(a_ideal[f]);
+    }
+    return true;
+}
+
+bool ToleranceAnalysis::run(const Options &options)
+{
+    if (!runIdeal(options.points))
+        return false;
+
+    const int points = int(a_freq.size());
+    std::vector<double> ideal;
+    for (const Part &p : a_parts)
+        ideal.push_back(p.ideal);
+
+    a_inRange.resize(points);
+    double peak = -1e300;
+    for (int f = 0; f < points; f++)
+        peak = std::max(peak, a_idealGain[f]);
+    for (int f = 0; f < points; f++)
+        a_inRange[f] = a_idealGain[f] >= peak - options.range;
+
+    // E-series assignment: start from the nearest values, then give every
+    // part the other neighbour of its ideal value as long as this brings
+    // the response closer to the ideal one
+    std::vector<bool> resistor(a_parts.size(), false);
+    for (const Element &e : a_elements)
+        if (e.kind == Resistor)
+            resistor[e.part] = true;
+    std::vector<int> series(a_parts.size());
+    std::vector<double> values(a_parts.size());
+    for (size_t i = 0; i < a_parts.size(); i++) {
+        series[i] = resistor[i] ? options.resistorSeries : options.capacitorSeries;
+        values[i] = seriesValue(ideal[i], series[i]);
+    }
+    std::vector<std::complex<double>> h;
+    response(values, h);
+    double best = deviation(h);
+    for (int pass = 0; pass < 8; pass++) {
+        bool changed = false;
+        for (size_t i = 0; i < a_parts.size(); i++) {
+            double current = values[i];
+            double lower = seriesValue(ideal[i], series[i], -1);
+            values[i] = current == lower ? seriesValue(ideal[i], series[i], 1) : lower;
+            if (values[i] == current)
+                continue;
+            response(values, h);
+            double d = deviation(h);
+            if (d < best - 1e-12) {
+                best = d;
+                changed = true;
+            } else {
+                values[i] = current;
+            }
+        }
+        if (!changed)
+            break;
+    }
+    for (size_t i = 0; i < a_parts.size(); i++)
+        a_parts[i].series = values[i];
+    response(values, h);
+    a_seriesDeviation = deviation(h);
+    a_seriesGain.resize(points);
+    a_seriesPhase.resize(points);
+    for (int f = 0; f < points; f++) {
+        a_seriesGain[f] = dB(h[f]);
+        a_seriesPhase[f] = degrees(h[f]);
+    }
+
+    // Monte Carlo around the E-series values: normal distribution with the
+    // tolerance as three sigma, cut at the tolerance
+    std::vector<double> tolerance(a_parts.size());
+    for (size_t i = 0; i < a_parts.size(); i++)
+        tolerance[i] = (resistor[i] ? options.resistorTolerance
+                                    : options.capacitorTolerance) / 100.0;
+
+    a_minGain.assign(points, 1e300);
+    a_maxGain.assign(points, -1e300);
+    std::vector<double> minDev(points, 1e300), maxDev(points, -1e300);
+    std::atomic<int> next{0};
+    std::atomic<int> passed{0};
+    std::mutex lock;
+    auto work = [&]() {
+        std::vector<double> v(values.size()), lo(points, 1e300), hi(points, -1e300);
+        std::vector<double> plo(points, 1e300), phi(points, -1e300);
+        std::vector<std::complex<double>> hs;
+        int ok = 0;
+        for (;;) {
+            int sample = next++;
+            if (sample >= options.samples)
+                break;
+            // every sample has its own generator: the result does not
+            // depend on the number of threads
+            std::seed_seq seed{options.seed, unsigned(sample)};
+            std::mt19937 random(seed);
+            std::normal_distribution<double> normal(0.0, 1.0 / 3.0);
+            for (size_t i = 0; i < values.size(); i++)
+                v[i] = values[i] * (1 + tolerance[i] * std::clamp(normal(random), -1.0, 1.0));
+            response(v, hs);
+            for (int f = 0; f < points; f++) {
+                double g = dB(hs[f]);
+                double p = a_ideal[f] == std::complex<double>(0) ? 0 : degrees(hs[f] / a_ideal[f]);
+                lo[f] = std::min(lo[f], g);
+                hi[f] = std::max(hi[f], g);
+                plo[f] = std::min(plo[f], p);
+                phi[f] = std::max(phi[f], p);
+            }
+            double phase;
+            double gain = deviation(hs, &phase);
+            if (gain <= options.maxGainDeviation &&
+                (options.maxPhaseDeviation <= 0 || phase <= options.maxPhaseDeviation))
+                ok++;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        for (int f = 0; f < points; f++) {
+            a_minGain[f] = std::min(a_minGain[f], lo[f]);
+            a_maxGain[f] = std::max(a_maxGain[f], hi[f]);
+            minDev[f] = std::min(minDev[f], plo[f]);
+            maxDev[f] = std::max(maxDev[f], phi[f]);
+        }
+        passed += ok;
+    };
+    int threads = options.threads > 0 ? options.threads
+                                      : int(std::max(1u, std::thread::hardware_concurrency()));
+    threads = std::max(1, std::min(threads, options.samples));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++)
+        workers.emplace_back(work);
+    work();
+    for (std::thread &t : workers)
+        t.join();
+
+    a_minPhase.resize(points);
+    a_maxPhase.resize(points);
+    for (int f = 0; f < points; f++) {
+        a_minPhase[f] = a_idealPhase[f] + minDev[f];
+        a_maxPhase[f] = a_idealPhase[f] + maxDev[f];
+    }
+    a_yield = options.samples > 0 ? double(passed) / options.samples : 0;
+    return true;
+}
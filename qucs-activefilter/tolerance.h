@@ -0,0 +1,125 @@
+/***************************************************************************
+                               tolerance.h
+                              -------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TOLERANCE_H
+#define TOLERANCE_H
+
+#include <complex>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Component tolerance and E-series analysis of a designed filter.
+ *
+ * The circuit is read from the schematic the filter classes create
+ * (resistors, capacitors, op amps, the source and the "in" and "out"
+ * labels) and its response V(out)/V(in) is computed by nodal analysis,
+ * so every topology is analysed as it is actually built.
+ *
+ * The ideal values are first snapped to the chosen E-series, picking for
+ * each part the lower or upper series value that brings the response
+ * closest to the ideal one. Then many sets of parts, each value spread
+ * within its tolerance, are evaluated on all cores, giving the envelope
+ * of gain and phase and the yield: the share of sets whose response stays
+ * within the allowed deviation.
+ */
+class ToleranceAnalysis
+{
+public:
+    struct Options {
+        int resistorSeries = 96;     // E-series of resistors (6...192)
+        int capacitorSeries = 12;    // E-series of capacitors
+        double resistorTolerance = 1;    // %
+        double capacitorTolerance = 5;   // %
+        int samples = 1000;
+        int points = 101;            // frequencies, logarithmic
+        double maxGainDeviation = 1;     // dB, for the yield
+        double maxPhaseDeviation = 10;   // degrees, for the yield
+        // only frequencies where the ideal gain is at most this far below
+        // its peak count, the stopband is not checked
+        double range = 40;           // dB
+        unsigned seed = 1;
+        int threads = 0;             // 0: all cores
+    };
+
+    struct Part {
+        std::string name;
+        double ideal;        // Ohm or F
+        double series;       // E-series value
+    };
+
+    ToleranceAnalysis();
+
+    // Reads the circuit from a Qucs schematic, false (see error()) if it is
+    // not a filter schematic.
+    bool setSchematic(const std::string &schematic);
+    // Only the response of the ideal circuit, fills frequencies(),
+    // idealGain() and idealPhase(): at "points" logarithmic frequencies up
+    // to the end of the AC simulation or at the frequencies "freq".
+    bool runIdeal(int points = 101);
+    bool runIdeal(const std::vector<double> &freq);
+    bool run(const Options &options);
+
+    const std::string &error() const { return a_error; }
+
+    const std::vector<Part> &parts() const { return a_parts; }
+    const std::vector<double> &frequencies() const { return a_freq; }
+    // responses in dB and degrees at frequencies()
+    const std::vector<double> &idealGain() const { return a_idealGain; }
+    const std::vector<double> &idealPhase() const { return a_idealPhase; }
+    const std::vector<double> &seriesGain() const { return a_seriesGain; }
+    const std::vector<double> &seriesPhase() const { return a_seriesPhase; }
+    const std::vector<double> &minGain() const { return a_minGain; }
+    const std::vector<double> &maxGain() const { return a_maxGain; }
+    const std::vector<double> &minPhase() const { return a_minPhase; }
+    const std::vector<double> &maxPhase() const { return a_maxPhase; }
+    // largest gain deviation of the E-series design from the ideal one, dB
+    double seriesDeviation() const { return a_seriesDeviation; }
+    // share of the samples within the allowed deviation, 0...1
+    double yield() const { return a_yield; }
+
+    // Nearest value of the E-series below (dir < 0), above (dir > 0) or
+    // next to (dir == 0) "value".
+    static double seriesValue(double value, int series, int dir = 0);
+
+private:
+    enum Kind { Resistor, Capacitor, OpAmp, Source };
+    struct Element {
+        Kind kind;
+        int part;            // index in a_parts, -1 for op amps and sources
+        int node[3];         // 0 is ground; op amp: -, +, out; source: +, -
+        double gain;
+    };
+
+    void response(const std::vector<double> &values,
+                  std::vector<std::complex<double>> &h) const;
+    double deviation(const std::vector<std::complex<double>> &h,
+                     double *phase = nullptr) const;
+
+    std::vector<Element> a_elements;
+    std::vector<Part> a_parts;
+    int a_nodes, a_in, a_out;
+    double a_stop;           // upper frequency of the AC simulation
+
+    std::vector<double> a_freq;
+    std::vector<std::complex<double>> a_ideal;
+    std::vector<bool> a_inRange;
+    std::vector<double> a_idealGain, a_idealPhase, a_seriesGain, a_seriesPhase;
+    std::vector<double> a_minGain, a_maxGain, a_minPhase, a_maxPhase;
+    double a_seriesDeviation, a_yield;
+    std::string a_error;
+};
+
+#endif // TOLERANCE_H
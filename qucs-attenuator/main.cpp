@@ -27,6 +27,8 @@
 #include <QSettings>
 
 #include "qucsattenuator.h"
+#include "attenuatorfunc.h"
+#include "../qucs-batch/synthbatch.h"
 
 struct tQucsSettings QucsSettings;
 
@@ -61,8 +63,81 @@ bool saveApplSettings(QucsAttenuator *qucs)
 
 
 
+// #########################################################################
+// Synthesizes one row of the batch mode.
+static bool batchAttenuator(const SynthSpec &Row, SynthResult &Result)
+{
+  static const QStringList Topologies = {"pi", "tee", "bridged-tee", "reflection",
+      "qw-series", "qw-shunt", "lpad-series", "lpad-shunt", "r-series", "r-shunt"};
+
+  struct tagATT Values = {};
+  Values.Topology = Row.choice("topology", Topologies, PI_TYPE);
+  Values.Attenuation = Row.number("attenuation", 1.0);
+  Values.Zin = Row.number("zin", 50.0);
+  Values.Zout = Row.number("zout", Values.Zin);
+  Values.minR = Row.flag("highr", false);
+  Values.freq = Row.number("freq", 1.5e9);
+  Values.useLumped = Row.flag("lumped", false);
+
+  // input power in W or in dBm (dBW)
+  QString Power = Row.text("power", "0 dBm").trimmed();
+  double P;
+  bool dB = Power.endsWith("dBm") || Power.endsWith("dBW");
+  if(!SynthSpec::toNumber(dB ? Power.chopped(3) : Power, P))
+    Row.fail(QStringLiteral("\"%1\" is not a power (power)").arg(Power));
+  if(Power.endsWith("dBm"))
+    P = pow(10, 0.1*(P-30));
+  else if(Power.endsWith("dBW"))
+    P = pow(10, 0.1*P);
+  Values.Pin = P;
+  bool SP_box = Row.flag("spar", false);
+  if(!Row.error().isEmpty())
+    return false;
+
+  QUCS_Att qatt;
+  if(qatt.Calc(&Values) == -1) {
+    Row.fail(QStringLiteral("Set Attenuation less than %1 dB")
+             .arg(QString::number(Values.MinimumATT, 'f', 3)));
+    return false;
+  }
+  QString * s = qatt.createSchematic(&Values, SP_box);
+  if(!s)
+    return false;
+  Result.schematic = *s;
+  delete s;
+
+  // the resistors and their dissipated power, as shown by the dialog
+  const double R[] = {Values.R1, Values.R2, Values.R3, Values.R4};
+  const double PR[] = {Values.PR1, Values.PR2, Values.PR3, Values.PR4};
+  for(int i = 0; i < 4; i++)
+    if(R[i] > 0)
+      Result.parts << QStringLiteral("R%1 %2 Ohm %3 W").arg(i+1)
+                      .arg(QString::number(R[i], 'f', 1), 10)
+                      .arg(QString::number(PR[i], 'g', 6), 12);
+  return true;
+}
+
+static const char *BatchKeys =
+  "  name          file name of the design\n"
+  "  topology      pi, tee, bridged-tee, reflection, qw-series, qw-shunt, lpad-series,\n"
+  "                lpad-shunt, r-series, r-shunt (pi)\n"
+  "  attenuation   (1 dB)\n"
+  "  zin, zout     (50 Ohm, zin)\n"
+  "  power         input power in W, dBm or dBW (0 dBm)\n"
+  "  freq          frequency of the quarter-wave attenuators (1.5 GHz)\n"
+  "  lumped        quarter-wave line as lumped elements (no)\n"
+  "  highr         reflection attenuator with R > Z0 (no)\n"
+  "  spar          add an S-parameter simulation (no)";
+
+
 int main( int argc, char ** argv )
 {
+  // headless synthesis of a table of attenuators
+  if(synthbatch::requested(argc, argv)) {
+    QCoreApplication a(argc, argv);
+    return synthbatch::run(argc, argv, "attenuator", BatchKeys, batchAttenuator);
+  }
+
   QApplication a( argc, argv );
 
   // apply default settings
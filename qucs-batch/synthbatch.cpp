@@ -0,0 +1,410 @@
+/***************************************************************************
+                              synthbatch.cpp
+                             ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "synthbatch.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSet>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+SynthSpec::SynthSpec(int row, const QMap<QString, QString> &fields)
+    : a_row(row), a_fields(fields)
+{
+}
+
+QString SynthSpec::name(const QString &tool) const
+{
+    QString n = text("name");
+    if (n.isEmpty())
+        n = QStringLiteral("%1_%2").arg(tool).arg(a_row, 4, 10, QChar('0'));
+    // the name becomes a file name
+    static const QRegularExpression invalid("[^A-Za-z0-9_.+-]");
+    return n.replace(invalid, "_");
+}
+
+QString SynthSpec::text(const QString &key, const QString &def) const
+{
+    auto it = a_fields.constFind(key);
+    if (it == a_fields.constEnd() || it->isEmpty())
+        return def;
+    return *it;
+}
+
+bool SynthSpec::toNumber(const QString &text, double &value)
+{
+    // not shared, the workers read numbers at the same time
+    const QRegularExpression re(
+        "^\\s*([+-]?(?:\\d+\\.?\\d*|\\.\\d+)(?:[eE][+-]?\\d+)?)\\s*(.*?)\\s*$");
+    QRegularExpressionMatch m = re.match(text);
+    if (!m.hasMatch())
+        return false;
+    value = m.captured(1).toDouble();
+    QString unit = m.captured(2);
+    if (unit.isEmpty())
+        return true;
+    if (unit.startsWith("meg", Qt::CaseInsensitive)) {
+        value *= 1e6;
+        return true;
+    }
+    // an SI prefix, then the unit which is not checked
+    switch (unit.at(0).unicode()) {
+    case 'f': value *= 1e-15; break;
+    case 'p': value *= 1e-12; break;
+    case 'n': value *= 1e-9; break;
+    case 'u': value *= 1e-6; break;
+    case 'm': value *= 1e-3; break;
+    case 'k': value *= 1e3; break;
+    case 'M': value *= 1e6; break;
+    case 'G': value *= 1e9; break;
+    case 'T': value *= 1e12; break;
+    default: return unit.at(0).isLetter();
+    }
+    return true;
+}
+
+double SynthSpec::number(const QString &key, double def) const
+{
+    QString t = text(key);
+    if (t.isEmpty())
+        return def;
+    double value;
+    if (!toNumber(t, value)) {
+        fail(QStringLiteral("\"%1\" is not a number (%2)").arg(t, key));
+        return def;
+    }
+    return value;
+}
+
+int SynthSpec::choice(const QString &key, const QStringList &names, int def) const
+{
+    QString t = text(key);
+    if (t.isEmpty())
+        return def;
+    int i = names.indexOf(t.toLower());
+    if (i < 0)
+        fail(QStringLiteral("unknown %1 \"%2\", one of %3 is expected")
+             .arg(key, t, names.join(", ")));
+    return i < 0 ? def : i;
+}
+
+bool SynthSpec::flag(const QString &key, bool def) const
+{
+    QString t = text(key).toLower();
+    if (t.isEmpty())
+        return def;
+    if (t == "1" || t == "yes" || t == "true" || t == "on")
+        return true;
+    if (t == "0" || t == "no" || t == "false" || t == "off")
+        return false;
+    fail(QStringLiteral("\"%1\" is not yes or no (%2)").arg(t, key));
+    return def;
+}
+
+void SynthSpec::fail(const QString &message) const
+{
+    if (a_error.isEmpty())
+        a_error = message;
+}
+
+namespace {
+
+void usage(const char *program, const QString &keys)
+{
+    fprintf(stderr,
+            "Usage: %s --batch <specs.csv|specs.json> [-o <directory>] [-j <jobs>]\n\n"
+            "Synthesizes every row of the table and writes <name>.sch and\n"
+            "<name>.txt (component list) to the directory.\n\n"
+            "Keys:\n%s\n",
+            qPrintable(QFileInfo(QString::fromLocal8Bit(program)).fileName()),
+            qPrintable(keys));
+}
+
+// Splits a CSV line, quotes may enclose commas and "" is a quote.
+QStringList splitCsv(const QString &line)
+{
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+    for (int i = 0; i < line.size(); i++) {
+        QChar c = line.at(i);
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line.at(i + 1) == '"') {
+                field += c;
+                i++;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields << field.trimmed();
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields << field.trimmed();
+    return fields;
+}
+
+bool readCsv(const QByteArray &data, QList<SynthSpec> &specs, QString &error)
+{
+    QStringList keys;
+    QStringList lines = QString::fromUtf8(data).split('\n');
+    for (int n = 0; n < lines.size(); n++) {
+        QString line = lines.at(n).trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+        QStringList fields = splitCsv(line);
+        if (keys.isEmpty()) {
+            for (const QString &key : fields)
+                keys << key.toLower();
+            continue;
+        }
+        if (fields.size() > keys.size()) {
+            error = QStringLiteral("line %1: %2 fields, but %3 keys")
+                    .arg(n + 1).arg(fields.size()).arg(keys.size());
+            return false;
+        }
+        QMap<QString, QString> map;
+        for (int i = 0; i < fields.size(); i++)
+            map[keys.at(i)] = fields.at(i);
+        specs.append(SynthSpec(n + 1, map));
+    }
+    return true;
+}
+
+bool readJson(const QByteArray &data, QList<SynthSpec> &specs, QString &error)
+{
+    QJsonParseError parse;
+    QJsonDocument doc = QJsonDocument::fromJson(data, &parse);
+    if (doc.isNull()) {
+        error = parse.errorString();
+        return false;
+    }
+    if (!doc.isArray()) {
+        error = "an array of specifications is expected";
+        return false;
+    }
+    QJsonArray array = doc.array();
+    for (int n = 0; n < array.size(); n++) {
+        QJsonObject object = array.at(n).toObject();
+        QMap<QString, QString> map;
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            QString value;
+            if (it.value().isDouble())
+                value = QString::number(it.value().toDouble(), 'g', 15);
+            else if (it.value().isBool())
+                value = it.value().toBool() ? "1" : "0";
+            else
+                value = it.value().toString();
+            map[it.key().toLower()] = value;
+        }
+        specs.append(SynthSpec(n + 1, map));
+    }
+    return true;
+}
+
+bool writeFile(const QString &fileName, const QString &text)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    QByteArray data = text.toUtf8();
+    return file.write(data) == data.size();
+}
+
+} // namespace
+
+bool synthbatch::requested(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+        if (!strcmp(argv[i], "--batch"))
+            return true;
+    return false;
+}
+
+int synthbatch::run(int argc, char *argv[], const QString &tool,
+                    const QString &keys, const Synthesizer &synthesize)
+{
+    QString specFile, outDir = ".";
+    int jobs = int(std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        QString arg = QString::fromLocal8Bit(argv[i]);
+        bool hasValue = i + 1 < argc;
+        if (arg == "--batch" && hasValue) {
+            specFile = QString::fromLocal8Bit(argv[++i]);
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            outDir = QString::fromLocal8Bit(argv[++i]);
+        } else if ((arg == "-j" || arg == "--jobs") && hasValue) {
+            jobs = QString(argv[++i]).toInt();
+        } else {
+            usage(argv[0], keys);
+            return 1;
+        }
+    }
+    if (specFile.isEmpty()) {
+        usage(argv[0], keys);
+        return 1;
+    }
+
+    QFile file(specFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "cannot read %s\n", qPrintable(specFile));
+        return 1;
+    }
+    QByteArray data = file.readAll();
+    QList<SynthSpec> specs;
+    QString error;
+    bool json = specFile.endsWith(".json", Qt::CaseInsensitive) ||
+                data.trimmed().startsWith('[');
+    if (!(json ? readJson(data, specs, error) : readCsv(data, specs, error))) {
+        fprintf(stderr, "%s: %s\n", qPrintable(specFile), qPrintable(error));
+        return 1;
+    }
+
+    QStringList names;
+    QSet<QString> unique;
+    for (const SynthSpec &spec : specs) {
+        names << spec.name(tool);
+        if (unique.contains(names.last())) {
+            fprintf(stderr, "%s: row %d: the name %s is used twice\n",
+                    qPrintable(specFile), spec.row(), qPrintable(names.last()));
+            return 1;
+        }
+        unique.insert(names.last());
+    }
+    QDir dir(outDir);
+    if (!dir.mkpath(".")) {
+        fprintf(stderr, "cannot create %s\n", qPrintable(outDir));
+        return 1;
+    }
+
+    // every design is synthesized and written by one thread; the messages
+    // are printed afterwards in the order of the table
+    struct Outcome {
+        bool ok = false;
+        QStringList messages;
+    };
+    std::vector<Outcome> outcomes(specs.size());
+    std::atomic<int> next{0};
+    auto work = [&]() {
+        for (;;) {
+            int i = next++;
+            if (i >= specs.size())
+                break;
+            const SynthSpec &spec = specs.at(i);
+            Outcome &out = outcomes[i];
+            SynthResult result;
+            bool ok = synthesize(spec, result) && spec.error().isEmpty() &&
+                      !result.schematic.isEmpty();
+            out.messages = result.warnings;
+            if (!ok) {
+                out.messages << (spec.error().isEmpty() ? QStringLiteral("cannot be realized")
+                                                        : spec.error());
+                continue;
+            }
+            if (result.parts.isEmpty())
+                result.parts = partList(result.schematic);
+            QString base = dir.filePath(names.at(i));
+            if (!writeFile(base + ".sch", result.schematic) ||
+                !writeFile(base + ".txt", result.parts.join('\n') + '\n')) {
+                out.messages << QStringLiteral("cannot write %1").arg(base);
+                continue;
+            }
+            out.ok = true;
+        }
+    };
+    jobs = std::max(1, std::min(jobs, int(specs.size())));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < jobs; t++)
+        workers.emplace_back(work);
+    work();
+    for (std::thread &t : workers)
+        t.join();
+
+    int written = 0;
+    for (int i = 0; i < specs.size(); i++) {
+        const Outcome &out = outcomes[i];
+        for (const QString &message : out.messages)
+            fprintf(stderr, "%s (row %d): %s\n", qPrintable(names.at(i)),
+                    specs.at(i).row(), qPrintable(message));
+        if (out.ok) {
+            printf("%s.sch\n", qPrintable(names.at(i)));
+            written++;
+        }
+    }
+    fprintf(stderr, "%d of %d designs written to %s\n", written, int(specs.size()),
+            qPrintable(QDir::toNativeSeparators(dir.absolutePath())));
+    return written == specs.size() ? 0 : 1;
+}
+
+QStringList synthbatch::partList(const QString &schematic)
+{
+    QStringList parts;
+    bool components = false;
+    for (const QString &l : schematic.split('\n')) {
+        QString line = l.trimmed();
+        if (line == "<Components>") {
+            components = true;
+            continue;
+        }
+        if (line == "</Components>")
+            break;
+        if (!components || !line.startsWith('<') || !line.endsWith('>'))
+            continue;
+
+        // <Model Name active x y tx ty mirror rotate "value" show ...>
+        QStringList fields;
+        QString field;
+        bool quoted = false;
+        for (QChar c : line.mid(1, line.size() - 2)) {
+            if (c == '"') {
+                quoted = !quoted;
+            } else if (c == ' ' && !quoted) {
+                fields << field;
+                field.clear();
+            } else {
+                field += c;
+            }
+        }
+        fields << field;
+        const QString &model = fields.at(0);
+        if (fields.size() < 9 || model.startsWith('.') || model == "GND" ||
+            model == "Eqn" || model == "NutmegEq")
+            continue;
+        QStringList values;
+        for (int i = 9; i + 1 < fields.size(); i += 2)
+            if (fields.at(i + 1) == "1")
+                values << fields.at(i);
+        parts << QStringLiteral("%1 %2 %3").arg(fields.at(1), -8).arg(model, -8)
+                 .arg(values.join("  ")).trimmed();
+    }
+    return parts;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+                               synthbatch.h
+                              --------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SYNTHBATCH_H
+#define SYNTHBATCH_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+/*!
+ * \file synthbatch.h
+ * \brief Headless batch mode shared by the synthesis tools
+ *
+ * The filter, active filter and attenuator tools are started with
+ *
+ *     --batch <specs.csv|specs.json> [-o <directory>] [-j <jobs>]
+ *
+ * to synthesize every row of a table of specifications without a window.
+ * A CSV table has the keys in its first line, a JSON table is an array of
+ * objects. Each design is written as "<name>.sch" and its component list
+ * as "<name>.txt"; the files only depend on the specification, so they
+ * can be compared by regression tests.
+ */
+
+/*!
+ * \brief One row of the specification table.
+ *
+ * The keys are lower case. Missing keys take the default given by the
+ * tool, values which cannot be read are reported by error().
+ */
+class SynthSpec
+{
+public:
+    SynthSpec(int row, const QMap<QString, QString> &fields);
+
+    int row() const { return a_row; }
+    // the "name" key, "<tool>_<row>" if there is none
+    QString name(const QString &tool) const;
+
+    bool contains(const QString &key) const { return a_fields.contains(key); }
+    QString text(const QString &key, const QString &def = QString()) const;
+    // A number with optional SI prefix and unit, e.g. "2.4 GHz" or "50 Ohm".
+    double number(const QString &key, double def) const;
+    // The index of the value in "names" (case is ignored).
+    int choice(const QString &key, const QStringList &names, int def) const;
+    bool flag(const QString &key, bool def) const;
+
+    // Marks the specification as failed, the first message is kept.
+    void fail(const QString &message) const;
+    const QString &error() const { return a_error; }
+
+    // Reads a number as number() does, false if it is none.
+    static bool toNumber(const QString &text, double &value);
+
+private:
+    int a_row;
+    QMap<QString, QString> a_fields;
+    mutable QString a_error;
+};
+
+/*!
+ * \brief The result of one synthesis.
+ */
+struct SynthResult {
+    QString schematic;
+    // component list, taken from the schematic if the tool leaves it empty
+    QStringList parts;
+    QStringList warnings;
+};
+
+namespace synthbatch {
+
+// Synthesizes one design; false (with SynthSpec::fail()) if it cannot be
+// realized. It is called from several threads at once.
+typedef std::function<bool(const SynthSpec &, SynthResult &)> Synthesizer;
+
+// true if the command line asks for the batch mode
+bool requested(int argc, char *argv[]);
+
+// Runs the batch mode, returns the exit code of the program. "tool" names
+// the designs without a name, "keys" lists the keys for the usage text.
+int run(int argc, char *argv[], const QString &tool, const QString &keys,
+        const Synthesizer &synthesize);
+
+// Component list of a Qucs schematic: name, model and the properties
+// shown on the schematic, one component per line.
+QStringList partList(const QString &schematic);
+
+} // namespace synthbatch
+
+#endif // SYNTHBATCH_H
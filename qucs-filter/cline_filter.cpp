@@ -16,16 +16,17 @@
 #endif
 
 #include "cline_filter.h"
+#include "filter_response.h"
 
 #include <QString>
-#include <QMessageBox>
 
 CoupledLine_Filter::CoupledLine_Filter()
 {
 }
 
 // -------------------------------------------------------------------
-QString* CoupledLine_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip)
+QString* CoupledLine_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip,
+                                             FilterResponse *Response)
 {
   int i, x, y, dx;
   double Value, gap, len, dl, width, er_eff, Z0e, Z0o;
@@ -34,6 +35,11 @@ QString* CoupledLine_Filter::createSchematic(tFilter *Filter, tSubstrate *Substr
 
   width = gap = er_eff = 1.0;
 
+  if(Response) {
+    Response->clear();
+    Response->setImpedance(Filter->Impedance);
+  }
+
   // create the Qucs schematic
   QString *s = new QString("<Qucs Schematic " PACKAGE_VERSION ">\n");
 
@@ -67,7 +73,7 @@ QString* CoupledLine_Filter::createSchematic(tFilter *Filter, tSubstrate *Substr
     if(isMicrostrip) {
       sythesizeCoupledMicrostrip(Z0e, Z0o, freq, Substrate, width, gap, er_eff);
       if((width < 1e-7) || (gap < 1e-7)) {
-        QMessageBox::critical(0, "Error", "Filter can't be created.");
+        reportError("Filter can't be created.");
         delete s;
         return NULL;
       }
@@ -75,6 +81,8 @@ QString* CoupledLine_Filter::createSchematic(tFilter *Filter, tSubstrate *Substr
     }
 
     len = LIGHTSPEED / freq / 4.0 / sqrt(er_eff);
+    if(Response)
+      Response->addCoupledLine(Z0e, Z0o, len, er_eff);
 
     if(isMicrostrip) {
       y += 40;
@@ -21,7 +21,7 @@ class CoupledLine_Filter : public TL_Filter {
 public:
   CoupledLine_Filter();
 
-  static QString* createSchematic(tFilter*, tSubstrate*, bool);
+  static QString* createSchematic(tFilter*, tSubstrate*, bool, FilterResponse* = NULL);
 };
 
 #endif
@@ -14,12 +14,41 @@
 #include "lc_filter.h"
 
 #include <QString>
+#include <QStringList>
 #include <QMessageBox>
 
+static thread_local QStringList *collectedErrors = nullptr;
+static thread_local QStringList *collectedWarnings = nullptr;
+
 Filter::Filter()
 {
 }
 
+// -----------------------------------------------------------------------
+void Filter::collectMessages(QStringList *errors, QStringList *warnings)
+{
+  collectedErrors = errors;
+  collectedWarnings = warnings;
+}
+
+// -----------------------------------------------------------------------
+void Filter::reportError(const QString &text)
+{
+  if(collectedErrors)
+    collectedErrors->append(text);
+  else
+    QMessageBox::critical(0, QObject::tr("Error"), text);
+}
+
+// -----------------------------------------------------------------------
+void Filter::reportWarning(const QString &text)
+{
+  if(collectedWarnings)
+    collectedWarnings->append(text);
+  else
+    QMessageBox::warning(0, QObject::tr("Warning"), text);
+}
+
 // -----------------------------------------------------------------------
 // Returns the value of the E6 serie that is the next higher number to "value".
 double Filter::getE6value(double value)
@@ -59,13 +88,13 @@ double Filter::getNormValue(int No, tFilter *theFilter)
       return ButterworthValue(No, theFilter->Order);
     case TYPE_CHEBYSHEV:
       if((theFilter->Order & 1) == 0) {
-        QMessageBox::critical(0, "Error", "Even order Chebyshev can't be realized with passive filters.");
+        reportError("Even order Chebyshev can't be realized with passive filters.");
         return 2e30;
       }
       return ChebyshevValue(No, theFilter->Order, theFilter->Ripple);
   }
 
-  QMessageBox::critical(0, "Error", "Filter type not supported.");
+  reportError("Filter type not supported.");
   return 2e30;
 }
 
@@ -84,7 +113,7 @@ double Filter::getQuadraticNormValues(int No, tFilter *theFilter, double &b)
       return quadraticChebyshevValues(No, theFilter->Order, theFilter->Ripple, b);
   }
 
-  QMessageBox::critical(0, "Error", "Filter type not supported.");
+  reportError("Filter type not supported.");
   return 2e30;
 }
 
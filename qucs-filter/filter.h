@@ -57,6 +57,8 @@ struct tFilter {
 
 
 class QString;
+class QStringList;
+class FilterResponse;
 
 class Filter {
 public:
@@ -72,6 +74,11 @@ public:
   static QString getMS_Via(double height, int x, int y, int rotate);
   static QString getMS_Open(double width, int x, int y, int rotate);
 
+  // Problems of the synthesis are shown in a message box, unless the
+  // calling thread collects them (batch mode, nullptr to stop).
+  static void collectMessages(QStringList *errors, QStringList *warnings);
+  static void reportError(const QString &);
+  static void reportWarning(const QString &);
 
 protected:
   static QString num2str(double);
@@ -0,0 +1,260 @@
+/***************************************************************************
+                             filter_response.cpp
+                            ---------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "filter_response.h"
+#include "filter.h"
+
+#include <algorithm>
+#include <complex>
+
+typedef std::complex<double> cplx;
+
+// keeps poles of ideal elements (tan at 90 degrees, resonances hit
+// exactly) finite, the response is then just very large or very small
+static inline double nonzero(double x)
+{
+  if(fabs(x) < 1e-15)
+    return (x < 0.0) ? -1e-15 : 1e-15;
+  return x;
+}
+
+// impedance of L and C in series (C == 0 means no capacitor)
+static inline cplx seriesLC(double w, double L, double C)
+{
+  double X = w * L;
+  if(C > 0.0)  X -= 1.0 / (w * C);
+  return cplx(0.0, nonzero(X));
+}
+
+// admittance of L and C in parallel (L == 0 means no inductor)
+static inline cplx parallelLC(double w, double L, double C)
+{
+  double B = w * C;
+  if(L > 0.0)  B -= 1.0 / (w * L);
+  return cplx(0.0, nonzero(B));
+}
+
+
+FilterResponse::FilterResponse() : Z0(50.0)
+{
+}
+
+// -----------------------------------------------------------------------
+void FilterResponse::clear()
+{
+  Sections.clear();
+}
+
+// -----------------------------------------------------------------------
+void FilterResponse::addSeries(double L, double C)
+{
+  if((L > 0.0) || (C > 0.0))
+    Sections.push_back(tSection{SERIES, L, C, 0.0});
+}
+
+void FilterResponse::addSeriesTank(double L, double C)
+{
+  if((L > 0.0) || (C > 0.0))
+    Sections.push_back(tSection{SERIES_TANK, L, C, 0.0});
+}
+
+void FilterResponse::addShunt(double L, double C)
+{
+  if((L > 0.0) || (C > 0.0))
+    Sections.push_back(tSection{SHUNT, L, C, 0.0});
+}
+
+void FilterResponse::addShuntTank(double L, double C)
+{
+  if((L > 0.0) || (C > 0.0))
+    Sections.push_back(tSection{SHUNT_TANK, L, C, 0.0});
+}
+
+// -----------------------------------------------------------------------
+void FilterResponse::addLineSection(tKind Kind, double Z1, double Z2,
+                                    double len, double er_eff)
+{
+  if(len <= 0.0)
+    return;
+  Sections.push_back(tSection{Kind, Z1, Z2, 2.0 * pi * len * sqrt(er_eff) / LIGHTSPEED});
+}
+
+void FilterResponse::addLine(double Z, double len, double er_eff)
+{
+  addLineSection(LINE, Z, 0.0, len, er_eff);
+}
+
+void FilterResponse::addStub(double Z, double len, bool shorted, double er_eff)
+{
+  addLineSection(shorted ? SHORT_STUB : OPEN_STUB, Z, 0.0, len, er_eff);
+}
+
+// coupled line pair with the two remaining ends open, the building block
+// of the parallel-coupled band-pass filter
+void FilterResponse::addCoupledLine(double Ze, double Zo, double len, double er_eff)
+{
+  addLineSection(COUPLED_LINE, Ze, Zo, len, er_eff);
+}
+
+// -----------------------------------------------------------------------
+// Computes dB(S21) and dB(S11) of the cascade, terminated with Z0 on both
+// sides. The outer loop runs over the sections, the inner one over the
+// frequencies, so every pass is a plain loop over contiguous arrays.
+void FilterResponse::evaluate(const std::vector<double> &freq,
+                              std::vector<double> &dBS21,
+                              std::vector<double> &dBS11) const
+{
+  const size_t n = freq.size();
+  std::vector<cplx> A(n, 1.0), B(n, 0.0), C(n, 0.0), D(n, 1.0);
+
+  for(const tSection &sec : Sections) {
+    switch(sec.Kind) {
+      case SERIES:
+      case SERIES_TANK:   // [1 Z; 0 1]
+        for(size_t k = 0; k < n; k++) {
+          double w = 2.0 * pi * freq[k];
+          cplx Z = (sec.Kind == SERIES) ? seriesLC(w, sec.v1, sec.v2)
+                                        : 1.0 / parallelLC(w, sec.v1, sec.v2);
+          B[k] += A[k] * Z;
+          D[k] += C[k] * Z;
+        }
+        break;
+
+      case SHUNT:
+      case SHUNT_TANK:    // [1 0; Y 1]
+        for(size_t k = 0; k < n; k++) {
+          double w = 2.0 * pi * freq[k];
+          cplx Y = (sec.Kind == SHUNT) ? 1.0 / seriesLC(w, sec.v1, sec.v2)
+                                       : parallelLC(w, sec.v1, sec.v2);
+          A[k] += B[k] * Y;
+          C[k] += D[k] * Y;
+        }
+        break;
+
+      case SHORT_STUB:
+      case OPEN_STUB:     // shunt admittance of the stub
+        for(size_t k = 0; k < n; k++) {
+          double theta = sec.Beta * freq[k];
+          double Yim = (sec.Kind == SHORT_STUB)
+                     ? -cos(theta) / nonzero(sin(theta))
+                     :  sin(theta) / nonzero(cos(theta));
+          cplx Y(0.0, Yim / sec.v1);
+          A[k] += B[k] * Y;
+          C[k] += D[k] * Y;
+        }
+        break;
+
+      case LINE:
+      case COUPLED_LINE:  // full 2x2 product
+        for(size_t k = 0; k < n; k++) {
+          double theta = sec.Beta * freq[k];
+          double c = cos(theta), s = nonzero(sin(theta));
+          cplx a, b, cc;
+          if(sec.Kind == LINE) {
+            a  = c;
+            b  = cplx(0.0, sec.v1 * s);
+            cc = cplx(0.0, s / sec.v1);
+          }
+          else {
+            double Zs = sec.v1 + sec.v2, Zd = sec.v1 - sec.v2;
+            a  = Zs / Zd * c;
+            b  = cplx(0.0, (Zd*Zd - Zs*Zs*c*c) / (2.0 * Zd * s));
+            cc = cplx(0.0, 2.0 * s / Zd);
+          }
+          cplx A0 = A[k], C0 = C[k];
+          A[k] = A0 * a + B[k] * cc;
+          B[k] = A0 * b + B[k] * a;   // d == a for both symmetric sections
+          C[k] = C0 * a + D[k] * cc;
+          D[k] = C0 * b + D[k] * a;
+        }
+        break;
+    }
+  }
+
+  dBS21.resize(n);
+  dBS11.resize(n);
+  for(size_t k = 0; k < n; k++) {
+    cplx den = A[k] + B[k] / Z0 + C[k] * Z0 + D[k];
+    cplx num = A[k] + B[k] / Z0 - C[k] * Z0 - D[k];
+    dBS21[k] = 10.0 * log10(std::max(std::norm(2.0 / den), 1e-30));
+    dBS11[k] = 10.0 * log10(std::max(std::norm(num / den), 1e-30));
+  }
+}
+
+// -----------------------------------------------------------------------
+std::vector<double> FilterResponse::frequencies(double fstart, double fstop,
+                                                int points, bool logScale)
+{
+  std::vector<double> freq(std::max(points, 2));
+  double step = 1.0 / double(freq.size() - 1);
+  for(size_t k = 0; k < freq.size(); k++) {
+    if(logScale)
+      freq[k] = fstart * pow(fstop / fstart, double(k) * step);
+    else
+      freq[k] = fstart + (fstop - fstart) * double(k) * step;
+  }
+  return freq;
+}
+
+// -----------------------------------------------------------------------
+// The pass band is given by the corner frequencies, the stop band by the
+// "stop band frequency" (Frequency3) of the dialog. Band filters are taken
+// as geometrically symmetric around the center frequency.
+tResponseMetrics FilterResponse::measure(const tFilter *Filter,
+                                         const std::vector<double> &freq,
+                                         const std::vector<double> &dBS21,
+                                         const std::vector<double> &dBS11)
+{
+  tResponseMetrics m = {0.0, 1e300, 1e300};
+  double f1 = Filter->Frequency, f2 = Filter->Frequency2, f3 = Filter->Frequency3;
+  double f0sq = f1 * f2;
+
+  bool hasStop = false;
+  for(size_t k = 0; k < freq.size(); k++) {
+    double f = freq[k];
+    bool pass = false, stop = false;
+    switch(Filter->Class) {
+      case CLASS_LOWPASS:
+        pass = f <= f1;
+        stop = f >= f3;
+        break;
+      case CLASS_HIGHPASS:
+        pass = f >= f1;
+        stop = f <= f3;
+        break;
+      case CLASS_BANDPASS:
+        pass = (f >= f1) && (f <= f2);
+        stop = (f >= f3) || (f <= f0sq / f3);
+        break;
+      case CLASS_BANDSTOP:
+        stop = (f >= f1) && (f <= f2);
+        pass = (f >= f3) || (f <= f0sq / f3);
+        break;
+    }
+    if(pass) {
+      m.PassLoss   = std::max(m.PassLoss, -dBS21[k]);
+      m.ReturnLoss = std::min(m.ReturnLoss, -dBS11[k]);
+    }
+    if(stop) {
+      m.StopAtten = std::min(m.StopAtten, -dBS21[k]);
+      hasStop = true;
+    }
+  }
+  if(!hasStop)
+    m.StopAtten = 0.0;
+  if(m.ReturnLoss > 1e299)
+    m.ReturnLoss = 0.0;
+  return m;
+}
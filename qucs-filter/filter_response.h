@@ -0,0 +1,78 @@
+/***************************************************************************
+                              filter_response.h
+                             -------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef FILTER_RESPONSE_H
+#define FILTER_RESPONSE_H
+
+#include <vector>
+
+struct tFilter;
+
+// figures of merit of a response measured against the filter specification
+struct tResponseMetrics {
+  double PassLoss;    // worst insertion loss in the pass band (dB)
+  double StopAtten;   // least attenuation in the stop band (dB)
+  double ReturnLoss;  // worst return loss in the pass band (dB)
+};
+
+// Two-port cascade of the sections a filter generator places between the
+// ports. The S-parameters are obtained by multiplying ABCD matrices, one
+// section at a time over the whole frequency vector. Transmission lines
+// are ideal and lossless, microstrip realizations enter with their
+// effective permittivity.
+class FilterResponse {
+public:
+  FilterResponse();
+
+  void clear();
+  bool isEmpty() const { return Sections.empty(); }
+  void setImpedance(double Z) { Z0 = Z; }
+
+  // lumped elements, a value of zero omits the element
+  void addSeries(double L, double C);      // L and C in series, in the signal path
+  void addSeriesTank(double L, double C);  // L and C in parallel, in the signal path
+  void addShunt(double L, double C);       // L and C in series, to ground
+  void addShuntTank(double L, double C);   // L and C in parallel, to ground
+
+  // transmission lines with physical length "len" (m)
+  void addLine(double Z, double len, double er_eff = 1.0);
+  void addStub(double Z, double len, bool shorted, double er_eff = 1.0);
+  void addCoupledLine(double Ze, double Zo, double len, double er_eff = 1.0);
+
+  void evaluate(const std::vector<double> &freq,
+                std::vector<double> &dBS21, std::vector<double> &dBS11) const;
+
+  static std::vector<double> frequencies(double fstart, double fstop,
+                                         int points, bool logScale);
+  static tResponseMetrics measure(const tFilter *, const std::vector<double> &freq,
+                                  const std::vector<double> &dBS21,
+                                  const std::vector<double> &dBS11);
+
+private:
+  enum tKind { SERIES, SERIES_TANK, SHUNT, SHUNT_TANK,
+               LINE, SHORT_STUB, OPEN_STUB, COUPLED_LINE };
+  struct tSection {
+    tKind Kind;
+    double v1, v2;  // L and C, or impedances
+    double Beta;    // electrical length per Hz (rad/Hz)
+  };
+
+  void addLineSection(tKind, double, double, double, double);
+
+  std::vector<tSection> Sections;
+  double Z0;
+};
+
+#endif
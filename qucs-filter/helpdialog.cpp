@@ -44,7 +44,14 @@ HelpDialog::HelpDialog(QWidget *parent)
 	       "open an empty schematic and press "
 	       "CTRL-V (paste from clipboard). The filter "
 	       "schematic can now be inserted and "
-	       " simulated. Have lots of fun!"));
+	       " simulated. Have lots of fun!\n\n"
+	       "The window also shows the computed transmission "
+	       "and reflection of the filter. Components are "
+	       "ideal, microstrip lines are taken as ideal lines "
+	       "with their effective permittivity. "
+	       "\"Compare designs...\" ranks all types and orders "
+	       "of the suitable realizations by the attenuation "
+	       "they reach beyond the stop band frequency."));
 
 
   // --------  create dialog widgets  ------------
@@ -16,6 +16,7 @@
 #endif
 
 #include "lc_filter.h"
+#include "filter_response.h"
 
 #include "qucsfilter.h"
 #include "../qucs/extsimkernels/spicecompat.h"
@@ -40,7 +41,8 @@ LC_Filter::LC_Filter()
 //       Frequency  - corner frequency (lowpass and highpass) or
 //                    band start frequency (bandpass and bandstop)
 //       Frequency2 - band stop frequency (only for bandpass and bandstop)
-QString* LC_Filter::createSchematic(tFilter *Filter, bool piType)
+// If "Response" is given, it receives the ladder for the preview.
+QString* LC_Filter::createSchematic(tFilter *Filter, bool piType, FilterResponse *Response)
 {
   double Value, Value2, Omega, Bandwidth;
   if((Filter->Class == CLASS_BANDPASS) || (Filter->Class == CLASS_BANDSTOP))
@@ -59,6 +61,11 @@ QString* LC_Filter::createSchematic(tFilter *Filter, bool piType)
   Bandwidth = fabs(Filter->Frequency2 - Filter->Frequency) / Omega;
   Omega *= 2.0*pi;   // angular frequency
 
+  if(Response) {
+    Response->clear();
+    Response->setImpedance(Filter->Impedance);
+  }
+
   // create the Qucs schematic
   QString *s = new QString("<Qucs Schematic " PACKAGE_VERSION ">\n");
 
@@ -92,6 +99,10 @@ QString* LC_Filter::createSchematic(tFilter *Filter, bool piType)
     switch(Filter->Class) {
 
       case CLASS_LOWPASS:
+        if(Response) {
+          if(i & 1)  Response->addSeries(Value, 0.0);
+          else       Response->addShunt(0.0, Value);
+        }
         if(i & 1)
           *s += QStringLiteral("<L L1 1 %1 %2 -26 10 0 0 \"%3H\" 1>\n").arg(x).arg(yl).arg(num2str(Value));
         else
@@ -101,6 +112,10 @@ QString* LC_Filter::createSchematic(tFilter *Filter, bool piType)
 
       case CLASS_HIGHPASS:
         Value = 1.0 / Omega / Omega / Value;  // transform to highpass
+        if(Response) {
+          if(i & 1)  Response->addSeries(0.0, Value);
+          else       Response->addShunt(Value, 0.0);
+        }
         if(i & 1)
           *s += QStringLiteral("<C C1 1 %1 %2 -27 10 0 0 \"%3F\" 1>\n").arg(x).arg(yl).arg(num2str(Value));
         else
@@ -111,6 +126,10 @@ QString* LC_Filter::createSchematic(tFilter *Filter, bool piType)
       case CLASS_BANDPASS:
         Value /= Bandwidth;    // transform to bandpass
         Value2 = 0.25 / Filter->Frequency / Filter->Frequency2 / pi / pi / Value;
+        if(Response) {
+          if(i & 1)  Response->addSeries(Value, Value2);
+          else       Response->addShuntTank(Value2, Value);
+        }
         if(i & 1) {
           *s += QStringLiteral("<L L1 1 %1 %2 -26 -44 0 0 \"%3H\" 1>\n").arg(x+40).arg(yl).arg(num2str(Value));
           *s += QStringLiteral("<C C1 1 %1 %2 -26 10 0 0 \"%3F\" 1>\n").arg(x-20).arg(yl).arg(num2str(Value2));
@@ -125,6 +144,10 @@ QString* LC_Filter::createSchematic(tFilter *Filter, bool piType)
       case CLASS_BANDSTOP:
         Value2 = 1.0 / Omega / Omega / Bandwidth / Value; // transform to bandstop
         Value *= 0.5 * fabs(Filter->Frequency2/Filter->Frequency - Filter->Frequency/Filter->Frequency2);
+        if(Response) {
+          if(i & 1)  Response->addSeriesTank(Value, Value2);
+          else       Response->addShunt(Value2, Value);
+        }
         if(i & 1) {
           *s += QStringLiteral("<L L1 1 %1 %2 -26 -44 0 0 \"%3H\" 1>\n").arg(x).arg(yl-35).arg(num2str(Value));
           *s += QStringLiteral("<C C1 1 %1 %2 -26 10 0 0 \"%3F\" 1>\n").arg(x).arg(yl).arg(num2str(Value2));
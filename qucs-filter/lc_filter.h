@@ -21,7 +21,7 @@ class LC_Filter : public Filter {
 public:
   LC_Filter();
 
-  static QString* createSchematic(tFilter*, bool);
+  static QString* createSchematic(tFilter*, bool, FilterResponse* = NULL);
 };
 
 #endif
@@ -16,9 +16,9 @@
 #endif
 
 #include "line_filter.h"
+#include "filter_response.h"
 
 #include <QString>
-#include <QMessageBox>
 
 // capacitive end-coupled, half-wavelength bandpass filter
 Line_Filter::Line_Filter()
@@ -26,7 +26,8 @@ Line_Filter::Line_Filter()
 }
 
 // -------------------------------------------------------------------------
-QString* Line_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip)
+QString* Line_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip,
+                                      FilterResponse *Response)
 {
   double Value, Value2, gap, len, dl, width, er_eff, Wh;
   double Omega = (Filter->Frequency2 + Filter->Frequency) / 2.0;
@@ -40,6 +41,11 @@ QString* Line_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bo
 
   Omega *= 2.0*pi;  // angular frequency
 
+  if(Response) {
+    Response->clear();
+    Response->setImpedance(Filter->Impedance);
+  }
+
   // create the Qucs schematic
   QString *s = new QString("<Qucs Schematic " PACKAGE_VERSION ">\n");
 
@@ -73,9 +79,18 @@ QString* Line_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bo
 
     // gap capacitance
     gap = Value / Filter->Impedance / Omega;
+
+    // the preview uses the gap capacitances and the uncorrected line
+    // lengths, the microstrip end effects are what "dl" compensates
+    if(Response && (gap > 0)) {
+      if(i > 0)
+        Response->addLine(Filter->Impedance, LIGHTSPEED / sqrt(er_eff) / Omega
+                          * (pi - 0.5*(atan(2.0*Value) + atan(2.0*Value2))), er_eff);
+      Response->addSeries(0.0, gap);
+    }
     //if(gap < 1e-7) {
     if(gap < 0) {
-      QMessageBox::critical(0, "Error", "Filter bandwidth is too large.");
+      reportError("Filter bandwidth is too large.");
       delete s;
       return NULL;
     }
@@ -97,7 +112,7 @@ QString* Line_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bo
 
     if(isMicrostrip) {
       if(gap < 1e-7) {
-        QMessageBox::critical(0, "Error",
+        reportError(
             "Filter can't be created.\n"
             "A small bandwidth of less than 3\% is possible only.\n"
             "Using a substrate with larger thickness or with smaller permitivity may also help a little bit.");
@@ -21,7 +21,7 @@ class Line_Filter : public TL_Filter {
 public:
   Line_Filter();
 
-  static QString* createSchematic(tFilter*, tSubstrate*, bool);
+  static QString* createSchematic(tFilter*, tSubstrate*, bool, FilterResponse* = NULL);
 };
 
 #endif
@@ -32,7 +32,9 @@
 #include <QSettings>
 
 #include "qucsfilter.h"
+#include "tl_filter.h"
 #include "../qucs/extsimkernels/spicecompat.h"
+#include "../qucs-batch/synthbatch.h"
 
 struct tQucsSettings QucsSettings;
 
@@ -71,6 +73,91 @@ bool saveApplSettings(QucsFilter *qucs)
 
 
 
+// #########################################################################
+// Synthesizes one row of the batch mode.
+static bool batchFilter(const SynthSpec &Row, SynthResult &Result)
+{
+  static const QStringList Realizations = {"lc-pi", "lc-tee", "c-coupled",
+      "end-coupled-microstrip", "coupled", "coupled-microstrip", "stepped",
+      "stepped-microstrip", "quarterwave", "quarterwave-microstrip", "equation"};
+  static const QStringList Types = {"bessel", "butterworth", "chebyshev", "cauer"};
+  static const QStringList Classes = {"lowpass", "highpass", "bandpass", "bandstop"};
+
+  int Realization = Row.choice("realization", Realizations, 0);
+
+  // the line realizations are band pass (quarter wave also band stop),
+  // the stepped-impedance ones low pass, as in the dialog
+  int Fixed = -1;
+  if((Realization >= 2) && (Realization <= 5))
+    Fixed = CLASS_BANDPASS;
+  else if((Realization == 6) || (Realization == 7))
+    Fixed = CLASS_LOWPASS;
+  int Class = CLASS_LOWPASS;
+  if(Fixed >= 0)
+    Class = Fixed;
+  else if((Realization == 8) || (Realization == 9))
+    Class = CLASS_BANDPASS;
+
+  tFilter Filter;
+  Filter.Type = Row.choice("type", Types, TYPE_BESSEL);
+  Filter.Class = Row.choice("class", Classes, Class);
+  Filter.Order = int(Row.number("order", 3));
+  Filter.Ripple = Row.number("ripple", 1.0);
+  Filter.Attenuation = Row.number("attenuation", 20.0);
+  Filter.Impedance = Row.number("impedance", 50.0);
+  Filter.Frequency = Row.number("corner", 1e9);
+  Filter.Frequency2 = Row.number("stop", 2e9);
+  Filter.Frequency3 = Row.number("bandstop", 3e9);
+
+  tSubstrate Substrate;
+  Substrate.er = Row.number("er", 9.8);
+  Substrate.height = Row.number("height", 1e-3);
+  Substrate.thickness = Row.number("thickness", 12.5e-6);
+  Substrate.tand = 0.0;
+  Substrate.resistivity = 1e-10;
+  Substrate.roughness = 0.0;
+  Substrate.minWidth = Row.number("minwidth", 0.4e-3);
+  Substrate.maxWidth = Row.number("maxwidth", 5e-3);
+
+  if((Fixed >= 0) && (Filter.Class != Fixed))
+    Row.fail(QStringLiteral("%1 is a %2 realization").arg(Realizations.at(Realization),
+                                                          Classes.at(Fixed)));
+  if(!Row.error().isEmpty())
+    return false;
+  QString Error = QucsFilter::checkFilter(&Filter);
+  if(!Error.isEmpty()) {
+    Row.fail(Error);
+    return false;
+  }
+
+  QStringList Errors;
+  Filter::collectMessages(&Errors, &Result.warnings);
+  QString *s = QucsFilter::calculateFilter(&Filter, Realization, &Substrate);
+  Filter::collectMessages(nullptr, nullptr);
+  if(!Errors.isEmpty())
+    Row.fail(Errors.join(' '));
+  if(s && Errors.isEmpty())
+    Result.schematic = *s;
+  delete s;
+  return !Result.schematic.isEmpty();
+}
+
+static const char *BatchKeys =
+  "  name                  file name of the design\n"
+  "  realization           lc-pi, lc-tee, c-coupled, end-coupled-microstrip, coupled,\n"
+  "                        coupled-microstrip, stepped, stepped-microstrip, quarterwave,\n"
+  "                        quarterwave-microstrip, equation (lc-pi)\n"
+  "  type                  bessel, butterworth, chebyshev, cauer (bessel)\n"
+  "  class                 lowpass, highpass, bandpass, bandstop (lowpass)\n"
+  "  order                 (3)\n"
+  "  corner, stop          corner and stop frequency (1 GHz, 2 GHz)\n"
+  "  bandstop              stop band frequency (3 GHz)\n"
+  "  ripple, attenuation   pass band ripple, stop band attenuation (1 dB, 20 dB)\n"
+  "  impedance             (50 Ohm)\n"
+  "  er, height, thickness, minwidth, maxwidth\n"
+  "                        microstrip substrate (9.8, 1 mm, 12.5 um, 0.4 mm, 5 mm)\n"
+  "The schematics are made for Qucsator.";
+
 // #########################################################################
 // ##########                                                     ##########
 // ##########                  Program Start                      ##########
@@ -79,6 +166,13 @@ bool saveApplSettings(QucsFilter *qucs)
 
 int main(int argc, char *argv[])
 {
+  // headless synthesis of a table of filters, independent of the settings
+  if(synthbatch::requested(argc, argv)) {
+    QCoreApplication a(argc, argv);
+    QucsSettings.DefaultSimulator = spicecompat::simQucsator;
+    return synthbatch::run(argc, argv, "filter", BatchKeys, batchFilter);
+  }
+
   QApplication a(argc, argv);
 
   // apply default settings
@@ -25,13 +25,14 @@
 
 #include "qucsfilter.h"
 #include "qf_filter.h"
+#include "filter_response.h"
 #include "../qucs/extsimkernels/spicecompat.h"
 
 namespace qf {
 
 filter::filter(qfk kind, qft ttype, qf_float imp, qf_float fc = 1,
                qf_float bw = 0, bool is_tee = false)
-    : type_(ttype), kind_(kind), is_tee_(is_tee), fc_(fc), bw_(bw), imp_(imp),
+    : type_(ttype), kind_(kind), ord_(0), is_tee_(is_tee), fc_(fc), bw_(bw), imp_(imp),
       n_comp_(0) {}
 
 // Destructor of a filter
@@ -141,6 +142,29 @@ QString filter::num2str(qf_float num) {
   return str;
 }
 
+// Feeds the synthesized ladder into the frequency-response preview
+void filter::to_response(FilterResponse *r) const {
+  r->clear();
+  r->setImpedance((double)imp_);
+  for (const auto& subsec : subsecs_) {
+    double L = (double)subsec.indc_v;
+    double C = (double)subsec.capa_v;
+    if (subsec.content == CAPA)  L = 0;
+    if (subsec.content == INDUC) C = 0;
+    if (subsec.wiring == SERIES) {
+      if (subsec.content == PARA_CAPA_INDUC)
+        r->addSeriesTank(L, C);
+      else
+        r->addSeries(L, C);
+    } else {
+      if (subsec.content == PARA_CAPA_INDUC)
+        r->addShuntTank(L, C);
+      else
+        r->addShunt(L, C);
+    }
+  }
+}
+
 QString filter::to_qucs() {
   QString compos = "";
   QString wires  = "";
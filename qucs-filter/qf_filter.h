@@ -24,6 +24,8 @@
 #include <QString>
 #include <vector>
 
+class FilterResponse;
+
 namespace qf {
 enum filter_type { LOWPASS, HIGHPASS, BANDPASS, BANDSTOP };
 
@@ -80,6 +82,7 @@ public:
   int order() { return ord_; }
   virtual void synth() = 0; // Synthesize filter
   QString to_qucs();
+  void to_response(FilterResponse *) const;
 
 private:
   QString num2str(qf_float);
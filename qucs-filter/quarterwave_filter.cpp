@@ -26,25 +26,22 @@
 #endif
 
 #include "quarterwave_filter.h"
+#include "filter_response.h"
 
+#include <QObject>
 #include <QString>
-#include <QMessageBox>
-
-double QuarterWave_Filter::bw = 0;
-double QuarterWave_Filter::fc = 0;
-double QuarterWave_Filter::d_lamdba4 = 0;
 
 QuarterWave_Filter::QuarterWave_Filter()
 {
 }
 
 // -----------------------------------------------------------------------
-QString *QuarterWave_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip)
+QString *QuarterWave_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip,
+                                             FilterResponse *Response)
 {
   if (Filter->Class < 2)
   {
-      QMessageBox::warning(0, QObject::tr("Error"),
-                            QObject::tr("Quarter wave filters do not allow low-pass nor high-pass masks\n"));
+      reportError(QObject::tr("Quarter wave filters do not allow low-pass nor high-pass masks\n"));
       return NULL;
   }
   // Auxiliary variables
@@ -52,10 +49,15 @@ QString *QuarterWave_Filter::createSchematic(tFilter *Filter, tSubstrate *Substr
   double W_line, W_res, er_eff_line, er_eff_res, L_line, L_res;
   double Z0 = Filter->Impedance; // System impedance
 
-  // Set filter main params as static members
-  fc = Filter->Frequency + 0.5 * (Filter->Frequency2 - Filter->Frequency);
-  d_lamdba4 = 0.25 * LIGHTSPEED / fc;
-  QuarterWave_Filter::bw = (Filter->Frequency2 - Filter->Frequency) / (fc);
+  // Filter main params
+  double fc = Filter->Frequency + 0.5 * (Filter->Frequency2 - Filter->Frequency);
+  double d_lamdba4 = 0.25 * LIGHTSPEED / fc;
+  double bw = (Filter->Frequency2 - Filter->Frequency) / (fc);
+  if (Response)
+  {
+      Response->clear();
+      Response->setImpedance(Z0);
+  }
   // create the Qucs schematic
   QString *s = new QString("<Qucs Schematic " PACKAGE_VERSION ">\n");
   QString c_s = "<Components>\n";
@@ -90,6 +92,12 @@ QString *QuarterWave_Filter::createSchematic(tFilter *Filter, tSubstrate *Substr
           L_line = d_lamdba4/sqrt(er_eff_line); // Length of the line
           L_res = d_lamdba4/sqrt(er_eff_res); // Length of the resonator
 
+          if (Response)
+          {
+              Response->addLine(Z0, L_line, er_eff_line);
+              Response->addStub(Zres, L_res, Filter->Class == CLASS_BANDPASS, er_eff_res);
+          }
+
           c_s += getLineString(isMicrostrip, W_line, L_line, x, 180, 0); // Series line
           c_s += getTeeString(x+ 60 + x_space, 180, W_line, W_line, W_res);
           c_s += getLineString(isMicrostrip, W_res, L_res, x + 60 + x_space, 60, 1); // Shunt quarter-wavelength resonator
@@ -104,6 +112,12 @@ QString *QuarterWave_Filter::createSchematic(tFilter *Filter, tSubstrate *Substr
       }
       else
       {// Ideal transmission lines
+          if (Response)
+          {
+              Response->addLine(Z0, d_lamdba4);
+              Response->addStub(Zres, d_lamdba4, Filter->Class == CLASS_BANDPASS);
+          }
+
           c_s += getLineString(isMicrostrip, Z0, d_lamdba4, x, 180, 0); // Series transmission line
           c_s += getLineString(isMicrostrip, Zres, d_lamdba4,  x+60+x_space, 60, 3); // Shunt quarter-wavelength resonator
 
@@ -127,10 +141,14 @@ QString *QuarterWave_Filter::createSchematic(tFilter *Filter, tSubstrate *Substr
   if (isMicrostrip)
   {
       c_s += getLineString(isMicrostrip, W_line, d_lamdba4/sqrt(er_eff_line), x, 180);
+      if (Response)
+          Response->addLine(Z0, d_lamdba4/sqrt(er_eff_line), er_eff_line);
   }
   else
   {// Ideal transmission line
       c_s += getLineString(isMicrostrip, Filter->Impedance, d_lamdba4, x, 180);
+      if (Response)
+          Response->addLine(Z0, d_lamdba4);
   }
 
   // Last power and ground
@@ -19,6 +19,7 @@
 # include <config.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <stdlib.h>
 #include <string>
@@ -33,6 +34,8 @@
 #include "cline_filter.h"
 #include "stepz_filter.h"
 #include "quarterwave_filter.h"
+#include "filter_response.h"
+#include "responseplot.h"
 
 #include "qf_poly.h"
 #include "qf_filter.h"
@@ -281,7 +284,11 @@ QucsFilter::QucsFilter()
   // ...........................................................
   QPushButton *ButtonGo = new QPushButton(tr("Calculate and put into Clipboard"), this);
   connect(ButtonGo, SIGNAL(clicked()), SLOT(slotCalculate()));
-  all->addWidget(ButtonGo, 1, 0, 1, -1);
+  all->addWidget(ButtonGo, 1, 0);
+
+  QPushButton *ButtonSweep = new QPushButton(tr("Compare designs..."), this);
+  connect(ButtonSweep, SIGNAL(clicked()), SLOT(slotSweep()));
+  all->addWidget(ButtonSweep, 1, 1);
 
   LabelResult = new QLabel(this);
   ResultState = 100;
@@ -289,6 +296,14 @@ QucsFilter::QucsFilter()
   LabelResult->setAlignment(Qt::AlignHCenter);
   all->addWidget(LabelResult, 2, 0, 1, -1);
 
+  // ...........................................................
+  QGroupBox *box3 = new QGroupBox(tr("Response Preview"), this);
+  all->addWidget(box3, 3, 0, 1, -1);
+  QVBoxLayout *vbox3 = new QVBoxLayout();
+  box3->setLayout(vbox3);
+  Plot = new ResponsePlot(this);
+  vbox3->addWidget(Plot);
+
   // -------  finally set initial state  --------
   slotTypeChanged(0);
   slotClassChanged(0);
@@ -353,44 +368,55 @@ void QucsFilter::setError(const QString& Message)
 }
 
 // ************************************************************
-QString * QucsFilter::calculateFilter(struct tFilter * Filter)
+// Reads the substrate of the microstrip realizations.
+void QucsFilter::getSubstrate(tSubstrate * Substrate)
+{
+  Substrate->er = ComboEr->currentText().toDouble();
+  Substrate->height = EditHeight->text().toDouble() / 1e3;
+  Substrate->thickness = EditThickness->text().toDouble() / 1e6;
+  Substrate->tand = 0.0;
+  Substrate->resistivity = 1e-10;
+  Substrate->roughness = 0.0;
+  Substrate->minWidth = EditMinWidth->text().toDouble() / 1e3;
+  Substrate->maxWidth = EditMaxWidth->text().toDouble() / 1e3;
+}
+
+// ************************************************************
+// Creates the schematic of the given realization (index into
+// ComboRealize). If "Response" is given, it receives the sections for
+// the preview, it stays empty for equation-defined filters.
+QString * QucsFilter::calculateFilter(struct tFilter * Filter, int Realization,
+                                      tSubstrate * Substrate,
+                                      FilterResponse * Response)
 {
     QString * s = NULL;
+    if(Response)
+      Response->clear();
 
-    tSubstrate Substrate;
-    Substrate.er = ComboEr->currentText().toDouble();
-    Substrate.height = EditHeight->text().toDouble() / 1e3;
-    Substrate.thickness = EditThickness->text().toDouble() / 1e6;
-    Substrate.tand = 0.0;
-    Substrate.resistivity = 1e-10;
-    Substrate.roughness = 0.0;
-    Substrate.minWidth = EditMinWidth->text().toDouble() / 1e3;
-    Substrate.maxWidth = EditMaxWidth->text().toDouble() / 1e3;
-
-    switch(ComboRealize->currentIndex()) {
+    switch(Realization) {
       case 2:  // C-coupled transmission line filter
-        s = Line_Filter::createSchematic(Filter, &Substrate, false);
+        s = Line_Filter::createSchematic(Filter, Substrate, false, Response);
         return s;
       case 3:  // microstrip end-coupled filter
-        s = Line_Filter::createSchematic(Filter, &Substrate, true);
+        s = Line_Filter::createSchematic(Filter, Substrate, true, Response);
         return s;
       case 4:  // coupled transmission line filter
-        s = CoupledLine_Filter::createSchematic(Filter, &Substrate, false);
+        s = CoupledLine_Filter::createSchematic(Filter, Substrate, false, Response);
         return s;
       case 5:  // coupled microstrip line filter
-        s = CoupledLine_Filter::createSchematic(Filter, &Substrate, true);
+        s = CoupledLine_Filter::createSchematic(Filter, Substrate, true, Response);
         return s;
       case 6:  // stepped-impedance transmission line filter
-        s = StepImpedance_Filter::createSchematic(Filter, &Substrate, false);
+        s = StepImpedance_Filter::createSchematic(Filter, Substrate, false, Response);
         return s;
       case 7:  // stepped-impedance microstrip line filter
-        s = StepImpedance_Filter::createSchematic(Filter, &Substrate, true);
+        s = StepImpedance_Filter::createSchematic(Filter, Substrate, true, Response);
         return s;
       case 8: // Quarter wave transmission line filter
-        s = QuarterWave_Filter::createSchematic(Filter, &Substrate, false);
+        s = QuarterWave_Filter::createSchematic(Filter, Substrate, false, Response);
         return s;
       case 9: // Quarter wave microstrip line  filter
-        s = QuarterWave_Filter::createSchematic(Filter, &Substrate, true);
+        s = QuarterWave_Filter::createSchematic(Filter, Substrate, true, Response);
         return s;
       case 10:  // equation defined filter
         s = Equation_Filter::createSchematic(Filter);
@@ -400,10 +426,10 @@ QString * QucsFilter::calculateFilter(struct tFilter * Filter)
     }
 
     if (Filter->Type != TYPE_CAUER) {
-      if(ComboRealize->currentIndex() == 0)
-        s = LC_Filter::createSchematic(Filter, true);
+      if(Realization == 0)
+        s = LC_Filter::createSchematic(Filter, true, Response);
       else
-        s = LC_Filter::createSchematic(Filter, false);
+        s = LC_Filter::createSchematic(Filter, false, Response);
     }
     else  {
       qf::cauer * F = NULL;
@@ -415,7 +441,7 @@ QString * QucsFilter::calculateFilter(struct tFilter * Filter)
       amax = Filter->Attenuation;
       bw = Filter->Frequency2 - fc;
 
-      bool is_tee = ComboRealize->currentIndex() == 1;
+      bool is_tee = Realization == 1;
       switch (Filter->Class) {
       case CLASS_LOWPASS:
         F = new qf::cauer (amin, amax, fc, fs, r, 0, qf::LOWPASS, is_tee);
@@ -432,8 +458,10 @@ QString * QucsFilter::calculateFilter(struct tFilter * Filter)
       }
       if (F) {
         //F->dump();
-        EditOrder->setText(QString::number(F->order()));
+        Filter->Order = F->order();
         s = new QString(F->to_qucs());
+        if(Response)
+          F->to_response(Response);
         delete F;
       }
       else {
@@ -444,7 +472,8 @@ QString * QucsFilter::calculateFilter(struct tFilter * Filter)
   }
 
 // ************************************************************
-void QucsFilter::slotCalculate()
+// Reads the filter specification from the input widgets.
+bool QucsFilter::getFilter(struct tFilter * Filter)
 {
   // get numerical values from input widgets
   double CornerFreq   = EditCorner->text().toDouble();
@@ -456,36 +485,61 @@ void QucsFilter::slotCalculate()
   StopFreq     *= pow(10, double(3*ComboStop->currentIndex()));
   BandStopFreq *= pow(10, double(3*ComboBandStop->currentIndex()));
 
-  tFilter Filter;
-  Filter.Type = ComboType->currentIndex();
-  Filter.Class = ComboClass->currentIndex();
-  Filter.Order = EditOrder->text().toInt();
-  Filter.Ripple = EditRipple->text().toDouble();
-  Filter.Attenuation = EditAtten->text().toDouble();
-  Filter.Impedance = EditImpedance->text().toDouble();
-  Filter.Frequency = CornerFreq;
-  Filter.Frequency2 = StopFreq;
-  Filter.Frequency3 = BandStopFreq;
-
-  if(EditStop->isEnabled())
-    if(Filter.Frequency >= Filter.Frequency2) {
-      setError(tr("Stop frequency must be greater than start frequency."));
-      return;
-    }
+  Filter->Type = ComboType->currentIndex();
+  Filter->Class = ComboClass->currentIndex();
+  Filter->Order = EditOrder->text().toInt();
+  Filter->Ripple = EditRipple->text().toDouble();
+  Filter->Attenuation = EditAtten->text().toDouble();
+  Filter->Impedance = EditImpedance->text().toDouble();
+  Filter->Frequency = CornerFreq;
+  Filter->Frequency2 = StopFreq;
+  Filter->Frequency3 = BandStopFreq;
+
+  QString Error = checkFilter(Filter);
+  if(!Error.isEmpty()) {
+    setError(Error);
+    return false;
+  }
+  return true;
+}
 
-  if(EditOrder->isEnabled()) {
-    if (Filter.Order < 2) {
-      setError(tr("Filter order must not be less than two."));
-      return;
-    }
-    if(Filter.Order > 19) if(Filter.Type == TYPE_BESSEL) {
-      setError(tr("Bessel filter order must not be greater than 19."));
-      return;
-    }
+// ************************************************************
+// Checks a filter specification, returns the error message if it cannot
+// be synthesized.
+QString QucsFilter::checkFilter(const struct tFilter * Filter)
+{
+  if((Filter->Class == CLASS_BANDPASS) || (Filter->Class == CLASS_BANDSTOP))
+    if(Filter->Frequency >= Filter->Frequency2)
+      return tr("Stop frequency must be greater than start frequency.");
+
+  if(Filter->Type != TYPE_CAUER) {
+    if (Filter->Order < 2)
+      return tr("Filter order must not be less than two.");
+    if(Filter->Order > 19) if(Filter->Type == TYPE_BESSEL)
+      return tr("Bessel filter order must not be greater than 19.");
   }
+  return QString();
+}
+
+// ************************************************************
+void QucsFilter::slotCalculate()
+{
+  tFilter Filter;
+  if(!getFilter(&Filter))
+    return;
 
-  QString * s = calculateFilter(&Filter);
-  if(!s) return;
+  tSubstrate Substrate;
+  getSubstrate(&Substrate);
+  FilterResponse Response;
+  int Realization = ComboRealize->currentIndex();
+  QString * s = calculateFilter(&Filter, Realization, &Substrate, &Response);
+  if(!s) {
+    Plot->clear();
+    return;
+  }
+  if(Filter.Type == TYPE_CAUER)
+    EditOrder->setText(QString::number(Filter.Order));
+  showResponse(&Filter, Realization, Response);
 
   // put resulting filter schematic into clipboard
   QClipboard *cb = QApplication::clipboard();
@@ -499,6 +553,203 @@ void QucsFilter::slotCalculate()
   QTimer::singleShot(500, this, SLOT(slotShowResult()));
 }
 
+// ************************************************************
+// Plots the response over a range similar to the S-parameter
+// simulation of the schematic. Transmission line filters are shown on a
+// linear axis up to four times the design frequency, so that their
+// spurious pass bands are visible.
+void QucsFilter::showResponse(const struct tFilter * Filter, int Realization,
+                              const FilterResponse & Response)
+{
+  if(Response.isEmpty()) {
+    Plot->clear();
+    return;
+  }
+
+  double f0 = Filter->Frequency;
+  if((Filter->Class == CLASS_BANDPASS) || (Filter->Class == CLASS_BANDSTOP))
+    f0 = 0.5 * (Filter->Frequency + Filter->Frequency2);
+
+  std::vector<double> freq, dBS21, dBS11;
+  bool logScale = Realization < 2;
+  if(logScale) {
+    double fstop = 10.0 * Filter->Frequency;
+    if((Filter->Class == CLASS_BANDPASS) || (Filter->Class == CLASS_BANDSTOP))
+      fstop = 10.0 * Filter->Frequency2;
+    freq = FilterResponse::frequencies(Filter->Frequency / 10.0, fstop, 2001, true);
+  }
+  else
+    freq = FilterResponse::frequencies(f0 / 100.0, 4.0 * f0, 2001, false);
+
+  Response.evaluate(freq, dBS21, dBS11);
+  Plot->setResponse(freq, dBS21, dBS11, logScale);
+}
+
+// ************************************************************
+// Synthesizes every type and order (up to 10) in all realizations that
+// suit the filter class, and ranks them by their computed response. A
+// design meets the requirement if it attenuates the stop band (beyond
+// the "stop band frequency") by at least the given attenuation; those
+// with the fewest elements and the least pass band loss come first.
+// Double-clicking a row loads that design into the dialog. The messages
+// of designs that cannot be realized are listed below the table instead
+// of popping up one by one.
+void QucsFilter::slotSweep()
+{
+  tFilter Spec;
+  if(!getFilter(&Spec))
+    return;
+
+  // the line realizations are disabled for SPICE simulators
+  QStandardItemModel *model =
+        qobject_cast<QStandardItemModel *>(ComboRealize->model());
+  QList<int> Realizations = {0, 1};
+  QList<int> Lines;
+  if(Spec.Class == CLASS_LOWPASS)
+    Lines << 6 << 7;
+  if(Spec.Class == CLASS_BANDPASS)
+    Lines << 2 << 3 << 4 << 5;
+  if(Spec.Class >= CLASS_BANDPASS)
+    Lines << 8 << 9;
+  for(int Realization : Lines)
+    if(model->item(Realization)->isEnabled())
+      Realizations << Realization;
+
+  double fmax = Spec.Frequency;
+  if(Spec.Class >= CLASS_BANDPASS)
+    fmax = Spec.Frequency2;
+  std::vector<double> freq = FilterResponse::frequencies(
+        std::min(Spec.Frequency, Spec.Frequency3) / 2.0,
+        std::max(fmax, Spec.Frequency3) * 2.0, 1001, true);
+
+  struct tCandidate {
+    int Realization, Type, Order;
+    tResponseMetrics Metrics;
+    bool Meets;
+  };
+  QList<tCandidate> Candidates;
+  QStringList Errors, Warnings;
+  tSubstrate Substrate;
+  getSubstrate(&Substrate);
+  FilterResponse Response;
+  std::vector<double> dBS21, dBS11;
+
+  auto addCandidate = [&](int Realization, int Type, int Order) {
+    tFilter Filter = Spec;
+    Filter.Type = Type;
+    Filter.Order = Order;
+    int nErrors = Errors.size(), nWarnings = Warnings.size();
+    QString *s = calculateFilter(&Filter, Realization, &Substrate, &Response);
+    // name the realization, the first line of a message is enough
+    QString Name = ComboRealize->itemText(Realization) + ": ";
+    for(int i = nErrors; i < Errors.size(); i++)
+      Errors[i] = Name + Errors.at(i).section('\n', 0, 0);
+    for(int i = nWarnings; i < Warnings.size(); i++)
+      Warnings[i] = Name + Warnings.at(i).section('\n', 0, 0);
+    if(!s)
+      return;
+    delete s;
+    if(Response.isEmpty() || (Errors.size() > nErrors))
+      return;
+    Response.evaluate(freq, dBS21, dBS11);
+    tCandidate c;
+    c.Realization = Realization;
+    c.Type = Type;
+    c.Order = Filter.Order;
+    c.Metrics = FilterResponse::measure(&Spec, freq, dBS21, dBS11);
+    c.Meets = c.Metrics.StopAtten >= Spec.Attenuation;
+    Candidates.append(c);
+  };
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  Filter::collectMessages(&Errors, &Warnings);
+  for(int Realization : Realizations) {
+    for(int Type = TYPE_BESSEL; Type <= TYPE_CHEBYSHEV; Type++)
+      for(int Order = 2; Order <= 10; Order++) {
+        // even order Chebyshev is not realizable with passive filters
+        if((Type == TYPE_CHEBYSHEV) && ((Order & 1) == 0))
+          continue;
+        addCandidate(Realization, Type, Order);
+      }
+    // Cauer derives its order from the specification
+    if(Realization < 2)
+      addCandidate(Realization, TYPE_CAUER, 0);
+  }
+  Filter::collectMessages(nullptr, nullptr);
+  QApplication::restoreOverrideCursor();
+  Errors.removeDuplicates();
+  Warnings.removeDuplicates();
+
+  std::stable_sort(Candidates.begin(), Candidates.end(),
+                   [](const tCandidate &a, const tCandidate &b) {
+    if(a.Meets != b.Meets)  return a.Meets;
+    if(a.Order != b.Order)  return a.Order < b.Order;
+    return a.Metrics.PassLoss < b.Metrics.PassLoss;
+  });
+
+  // ...........................................................
+  QDialog *Dia = new QDialog(this);
+  Dia->setAttribute(Qt::WA_DeleteOnClose);
+  Dia->setWindowTitle(tr("Compare designs"));
+  QVBoxLayout *vbox = new QVBoxLayout(Dia);
+  vbox->addWidget(new QLabel(
+      tr("Requirement: %1 dB stop band attenuation. Double-click a design to load it.")
+      .arg(Spec.Attenuation), Dia));
+
+  QTableWidget *Table = new QTableWidget(Candidates.size(), 6, Dia);
+  Table->setHorizontalHeaderLabels(QStringList() << tr("Realization") << tr("Type")
+      << tr("Order") << tr("Pass band loss") << tr("Stop band attenuation") << tr("Return loss"));
+  Table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+  Table->setSelectionBehavior(QAbstractItemView::SelectRows);
+  Table->verticalHeader()->hide();
+  for(int row = 0; row < Candidates.size(); row++) {
+    const tCandidate &c = Candidates.at(row);
+    QStringList cells;
+    cells << ComboRealize->itemText(c.Realization) << ComboType->itemText(c.Type)
+          << QString::number(c.Order)
+          << QStringLiteral("%1 dB").arg(c.Metrics.PassLoss, 0, 'f', 2)
+          << QStringLiteral("%1 dB").arg(c.Metrics.StopAtten, 0, 'f', 1)
+          << QStringLiteral("%1 dB").arg(c.Metrics.ReturnLoss, 0, 'f', 1);
+    for(int col = 0; col < cells.size(); col++) {
+      QTableWidgetItem *item = new QTableWidgetItem(cells.at(col));
+      if(!c.Meets)
+        item->setForeground(palette().brush(QPalette::Disabled, QPalette::Text));
+      Table->setItem(row, col, item);
+    }
+  }
+  Table->resizeColumnsToContents();
+  vbox->addWidget(Table);
+
+  // why some designs are missing or may be inaccurate
+  QStringList Notes;
+  if(!Errors.isEmpty())
+    Notes << tr("Left out:") << Errors;
+  if(!Warnings.isEmpty())
+    Notes << tr("Warnings:") << Warnings;
+  if(!Notes.isEmpty()) {
+    QLabel *LabelNotes = new QLabel(Notes.join("\n"), Dia);
+    LabelNotes->setWordWrap(true);
+    vbox->addWidget(LabelNotes);
+  }
+
+  connect(Table, &QTableWidget::cellDoubleClicked, this,
+          [this, Candidates, Class = Spec.Class](int row, int) {
+    const tCandidate &c = Candidates.at(row);
+    ComboRealize->setCurrentIndex(c.Realization);
+    slotRealizationChanged(c.Realization);
+    ComboClass->setCurrentIndex(Class);  // quarter wave may be band stop
+    slotClassChanged(Class);
+    ComboType->setCurrentIndex(c.Type);
+    slotTypeChanged(c.Type);
+    if(c.Type != TYPE_CAUER)
+      EditOrder->setText(QString::number(c.Order));
+    slotCalculate();
+  });
+
+  Dia->resize(Table->horizontalHeader()->length() + 40, 400);
+  Dia->show();
+}
+
 // ************************************************************
 void QucsFilter::slotShowResult()
 {
@@ -536,26 +787,10 @@ void QucsFilter::slotTypeChanged(int index)
 	LabelRipple_dB->setEnabled(true);
 	break;
   }
-  if (index == TYPE_CAUER) {
-    LabelOrder->setEnabled(false);
-    EditOrder->setEnabled(false);
-    LabelAtten->setEnabled(true);
-    EditAtten->setEnabled(true);
-    LabelAtten_dB->setEnabled(true);
-    LabelBandStop->setEnabled(true);
-    EditBandStop->setEnabled(true);
-    ComboBandStop->setEnabled(true);
-  }
-  else {
-    LabelOrder->setEnabled(true);
-    EditOrder->setEnabled(true);
-    LabelAtten->setEnabled(false);
-    EditAtten->setEnabled(false);
-    LabelAtten_dB->setEnabled(false);
-    LabelBandStop->setEnabled(false);
-    EditBandStop->setEnabled(false);
-    ComboBandStop->setEnabled(false);
-  }
+  // the stop band requirement stays editable for all types, it also
+  // ranks the designs in slotSweep()
+  LabelOrder->setEnabled(index != TYPE_CAUER);
+  EditOrder->setEnabled(index != TYPE_CAUER);
 }
 
 // ************************************************************
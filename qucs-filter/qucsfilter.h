@@ -29,6 +29,10 @@ class QLineEdit;
 class QLabel;
 class QIntValidator;
 class QDoubleValidator;
+class ResponsePlot;
+class FilterResponse;
+struct tFilter;
+struct tSubstrate;
 
 //namespace spicecompat {
 //    enum Simulator {simNgspice = 0, simXyceSer = 1, simXycePar = 2, simSpiceOpus = 3, simQucsator = 4, simNotSpecified=10};
@@ -51,6 +55,11 @@ public:
   QucsFilter();
  ~QucsFilter();
 
+  // The synthesis without the dialog, also used by the batch mode.
+  static QString checkFilter(const struct tFilter *);
+  static QString * calculateFilter(struct tFilter *, int, tSubstrate *,
+                                   FilterResponse * = NULL);
+
 private slots:
   void slotQuit();
   void slotHelpIntro();
@@ -62,10 +71,13 @@ private slots:
   void slotShowResult();
   void slotRealizationChanged(int);
   void slotTakeEr(const QString&);
+  void slotSweep();
 
 private:
   void setError(const QString&);
-  QString * calculateFilter(struct tFilter *);
+  bool getFilter(struct tFilter *);
+  void getSubstrate(tSubstrate *);
+  void showResponse(const struct tFilter *, int, const FilterResponse &);
 
   int ResultState;
 
@@ -78,6 +90,7 @@ private:
   QLabel *LabelAtten, *LabelAtten_dB, *LabelBandStop, *LabelOrder, *LabelImpedance, *LabelOhm;
   QIntValidator *IntVal;
   QDoubleValidator *DoubleVal;
+  ResponsePlot *Plot;
 };
 
 #endif
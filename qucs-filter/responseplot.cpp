@@ -0,0 +1,176 @@
+/***************************************************************************
+                              responseplot.cpp
+                             ------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "responseplot.h"
+
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+ResponsePlot::ResponsePlot(QWidget *parent) : QWidget(parent)
+{
+  LogScale = false;
+  dBmin = -80.0;
+  dBmax = 0.0;
+  Label21 = "dB(S21)";
+  Label11 = "dB(S11)";
+  setMinimumSize(300, 180);
+  setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+QSize ResponsePlot::sizeHint() const
+{
+  return QSize(480, 260);
+}
+
+// -----------------------------------------------------------------------
+void ResponsePlot::setResponse(const std::vector<double> &freq,
+                               const std::vector<double> &dBS21,
+                               const std::vector<double> &dBS11, bool logScale)
+{
+  Freq = freq;
+  S21 = dBS21;
+  S11 = dBS11;
+  LogScale = logScale;
+
+  // scale the y-axis in 20 dB steps from the highest gain (0 dB for
+  // passive filters) to the deepest notch, at most 100 dB
+  double lowest = 0.0, highest = 0.0;
+  for(double v : S21) {
+    lowest = std::min(lowest, v);
+    highest = std::max(highest, v);
+  }
+  dBmax = 20.0 * ceil(highest / 20.0 - 0.01);  // rounding noise above 0 dB
+  dBmin = std::max(dBmax - 100.0, std::min(dBmax - 40.0, 20.0 * floor(lowest / 20.0)));
+  update();
+}
+
+void ResponsePlot::setLabels(const QString &label21, const QString &label11)
+{
+  Label21 = label21;
+  Label11 = label11;
+  update();
+}
+
+void ResponsePlot::clear()
+{
+  Freq.clear();
+  S21.clear();
+  S11.clear();
+  update();
+}
+
+// -----------------------------------------------------------------------
+QString ResponsePlot::freqLabel(double f)
+{
+  if(f >= 1e9)  return QString::number(f / 1e9, 'g', 3) + "G";
+  if(f >= 1e6)  return QString::number(f / 1e6, 'g', 3) + "M";
+  if(f >= 1e3)  return QString::number(f / 1e3, 'g', 3) + "k";
+  return QString::number(f, 'g', 3);
+}
+
+// -----------------------------------------------------------------------
+void ResponsePlot::paintEvent(QPaintEvent *)
+{
+  QPainter p(this);
+  p.fillRect(rect(), palette().base());
+
+  QFontMetrics fm(font());
+  QRectF area(fm.horizontalAdvance("-100 dB") + 8, fm.height(),
+              width() - fm.horizontalAdvance("-100 dB") - 20,
+              height() - 3 * fm.height());
+  if((area.width() < 10) || (area.height() < 10))
+    return;
+
+  p.setPen(palette().color(QPalette::Text));
+  p.drawRect(area);
+  if(Freq.size() < 2) {
+    p.drawText(area, Qt::AlignCenter, QObject::tr("no preview"));
+    return;
+  }
+
+  double fmin = Freq.front(), fmax = Freq.back();
+  auto xpos = [&](double f) {
+    double t = LogScale ? log(f / fmin) / log(fmax / fmin)
+                        : (f - fmin) / (fmax - fmin);
+    return area.left() + t * area.width();
+  };
+  auto ypos = [&](double dB) {
+    dB = std::max(dBmin, std::min(dBmax, dB));
+    return area.top() + (dBmax - dB) / (dBmax - dBmin) * area.height();
+  };
+
+  // grid with labels
+  QPen gridPen(palette().color(QPalette::Mid), 0, Qt::DotLine);
+  for(double dB = dBmax; dB >= dBmin; dB -= 20.0) {
+    double y = ypos(dB);
+    p.setPen(gridPen);
+    p.drawLine(QPointF(area.left(), y), QPointF(area.right(), y));
+    p.setPen(palette().color(QPalette::Text));
+    p.drawText(QRectF(0, y - fm.height(), area.left() - 4, 2 * fm.height()),
+               Qt::AlignRight | Qt::AlignVCenter, QStringLiteral("%1 dB").arg(dB));
+  }
+  std::vector<double> ticks;
+  if(LogScale) {
+    for(double f = pow(10.0, ceil(log10(fmin))); f <= fmax * 1.0001; f *= 10.0)
+      ticks.push_back(f);
+  }
+  else {
+    double step = pow(10.0, floor(log10((fmax - fmin) / 2.0)));
+    if((fmax - fmin) / step > 10.0)  step *= 2.0;
+    for(double f = ceil(fmin / step) * step; f <= fmax * 1.0001; f += step)
+      ticks.push_back(f);
+  }
+  for(double f : ticks) {
+    double x = xpos(f);
+    p.setPen(gridPen);
+    p.drawLine(QPointF(x, area.top()), QPointF(x, area.bottom()));
+    p.setPen(palette().color(QPalette::Text));
+    p.drawText(QRectF(x - 40, area.bottom() + 2, 80, fm.height()),
+               Qt::AlignHCenter | Qt::AlignTop, freqLabel(f) + "Hz");
+  }
+
+  // curves
+  QPolygonF c21, c11;
+  c21.reserve(int(Freq.size()));
+  c11.reserve(int(S11.size()));
+  for(size_t k = 0; k < Freq.size(); k++) {
+    double x = xpos(Freq[k]);
+    c21.append(QPointF(x, ypos(S21[k])));
+    if(k < S11.size())
+      c11.append(QPointF(x, ypos(S11[k])));
+  }
+  p.setRenderHint(QPainter::Antialiasing);
+  p.setClipRect(area);
+  p.setPen(QPen(QColor(0xd0, 0x30, 0x30), 1.5));
+  p.drawPolyline(c11);
+  p.setPen(QPen(QColor(0x20, 0x40, 0xc0), 1.5));
+  p.drawPolyline(c21);
+  p.setClipping(false);
+
+  // legend
+  double y = height() - fm.height();
+  p.setPen(QPen(QColor(0x20, 0x40, 0xc0), 2));
+  p.drawLine(QPointF(area.left(), y + fm.height() / 2), QPointF(area.left() + 20, y + fm.height() / 2));
+  p.setPen(palette().color(QPalette::Text));
+  p.drawText(QPointF(area.left() + 24, y + fm.ascent()), Label21);
+  if(S11.empty())
+    return;
+  double x = area.left() + 34 + fm.horizontalAdvance(Label21);
+  p.setPen(QPen(QColor(0xd0, 0x30, 0x30), 2));
+  p.drawLine(QPointF(x, y + fm.height() / 2), QPointF(x + 20, y + fm.height() / 2));
+  p.setPen(palette().color(QPalette::Text));
+  p.drawText(QPointF(x + 24, y + fm.ascent()), Label11);
+}
@@ -0,0 +1,49 @@
+/***************************************************************************
+                               responseplot.h
+                             ------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef RESPONSEPLOT_H
+#define RESPONSEPLOT_H
+
+#include <QWidget>
+#include <QPolygonF>
+#include <vector>
+
+// Cartesian plot of dB(S21) and dB(S11) over frequency, the second curve
+// is left out if it is empty
+class ResponsePlot : public QWidget {
+public:
+  ResponsePlot(QWidget *parent = 0);
+
+  void setResponse(const std::vector<double> &freq,
+                   const std::vector<double> &dBS21,
+                   const std::vector<double> &dBS11, bool logScale);
+  void setLabels(const QString &label21, const QString &label11);
+  void clear();
+
+  QSize sizeHint() const override;
+
+protected:
+  void paintEvent(QPaintEvent *) override;
+
+private:
+  static QString freqLabel(double);
+
+  std::vector<double> Freq, S21, S11;
+  QString Label21, Label11;
+  bool LogScale;
+  double dBmin, dBmax;
+};
+
+#endif
@@ -16,16 +16,18 @@
 #endif
 
 #include "stepz_filter.h"
+#include "filter_response.h"
 
+#include <QObject>
 #include <QString>
-#include <QMessageBox>
 
 StepImpedance_Filter::StepImpedance_Filter()
 {
 }
 
 // -----------------------------------------------------------------------
-QString* StepImpedance_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip)
+QString* StepImpedance_Filter::createSchematic(tFilter *Filter, tSubstrate *Substrate, bool isMicrostrip,
+                                               FilterResponse *Response)
 {
   int i, x;
   double len, width, er_eff_min, er_eff_max, Z0;
@@ -42,12 +44,17 @@ QString* StepImpedance_Filter::createSchematic(tFilter *Filter, tSubstrate *Subs
                               Filter->Frequency, er_eff_max, Zlow);
 
     if((Substrate->er > 4.0) || (Substrate->height > 0.6))
-      QMessageBox::warning(0, QObject::tr("Warning"),
+      reportWarning(
           QObject::tr("High-impedance is %1 ohms, low-impedance is %2 ohms.\n"
                       "To get acceptable results it is recommended to use\n"
                       "a substrate with lower permittivity and larger height.\n").arg(Zhigh).arg(Zlow));
   }
 
+  if(Response) {
+    Response->clear();
+    Response->setImpedance(Filter->Impedance);
+  }
+
   // create the Qucs schematic
   QString *s = new QString("<Qucs Schematic " PACKAGE_VERSION ">\n");
 
@@ -84,6 +91,9 @@ QString* StepImpedance_Filter::createSchematic(tFilter *Filter, tSubstrate *Subs
       width = Substrate->minWidth;
     }
 
+    if(Response)
+      Response->addLine(Z0, len, (i & 1) ? er_eff_max : er_eff_min);
+
     if(isMicrostrip)
       *s += QStringLiteral("<MLIN MS1 1 %1 180 -26 15 0 0 \"Sub1\" 1 \"%2\" 1 \"%3\" 1 \"Hammerstad\" 0 \"Kirschning\" 0 \"26.85\" 0>\n").arg(x).arg(num2str(width)).arg(num2str(len));
     else
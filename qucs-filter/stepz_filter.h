@@ -21,7 +21,7 @@ class StepImpedance_Filter : public TL_Filter {
 public:
   StepImpedance_Filter();
 
-  static QString* createSchematic(tFilter*, tSubstrate*, bool);
+  static QString* createSchematic(tFilter*, tSubstrate*, bool, FilterResponse* = NULL);
 };
 
 #endif
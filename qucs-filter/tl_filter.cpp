@@ -12,6 +12,7 @@
  ***************************************************************************/
 
 #include "tl_filter.h"
+#include "../qucs-transcalc/tlengine.h"
 
 #define  MAX_ERROR  1e-7
 
@@ -114,33 +115,9 @@ void TL_Filter::calcMicrostrip(tSubstrate *substrate,
 void TL_Filter::getMicrostrip(double Z0, double freq, tSubstrate *substrate,
                               double &width, double &er_eff)
 {
-  int iteration = 0;  // iteration counter
-  double Z0_current, Z0_result, increment;
-
-  width = 1e-3;  // start with 1mm
-
-  do {
-    // compute line parameters
-    calcMicrostrip(substrate, width, freq, er_eff, Z0_current);
-
-    if(fabs(Z0 - Z0_current) < MAX_ERROR)
-      break;  // wanted value was found
-
-    increment = width / 100.0;
-    width += increment;
-
-    // compute line parameters
-    calcMicrostrip(substrate, width, freq, er_eff, Z0_result);
-
-    // Newton iteration: w(n+1) = w(n) - f(w(n))/f'(w(n))
-	//   with f(w(n))  = Z0_current - Z0
-    //   and  f'(w(n)) = (Z0_result - Z0_current) / increment
-    width -= (Z0_current - Z0) / (Z0_result - Z0_current) * increment;
-    if(width <= 0.0)
-      width = increment;
-
-    iteration++;
-  } while(iteration < 150);
+  // the solver and its memo table are shared with qucs-transcalc
+  ms_synth_cache::instance().synthesize(tl_substrate_from(substrate), freq, Z0,
+                                        width, er_eff, MAX_ERROR);
 }
 
 // ---------------------------------------------------------------------
@@ -36,6 +36,7 @@
 
 #include "units.h"
 #include "transline.h"
+#include "tlengine.h"
 #include "coax.h"
 
 coax::coax() : transline()
@@ -52,10 +53,11 @@ coax::~coax()
  */
 void coax::get_coax_sub ()
 {
-  er = getProperty ("Er");
-  mur = getProperty ("Mur");
-  tand = getProperty ("Tand");
-  sigma = getProperty ("Sigma");
+  sub = tl_default_substrate ();
+  sub.er = getProperty ("Er");
+  sub.mur = getProperty ("Mur");
+  sub.tand = getProperty ("Tand");
+  sub.sigma = getProperty ("Sigma");
 }
 
 /*
@@ -73,8 +75,8 @@ void coax::get_coax_comp ()
  */
 void coax::get_coax_elec ()
 {
-  Z0 = getProperty ("Z0", UNIT_RES, RES_OHM);
-  ang_l = getProperty ("Ang_l", UNIT_ANG, ANG_RAD);
+  res.Z0 = getProperty ("Z0", UNIT_RES, RES_OHM);
+  res.ang_l = getProperty ("Ang_l", UNIT_ANG, ANG_RAD);
 }
 
 /*
@@ -83,26 +85,9 @@ void coax::get_coax_elec ()
  */
 void coax::get_coax_phys ()
 {
-  din = getProperty ("din", UNIT_LENGTH, LENGTH_M);
-  dout = getProperty ("dout", UNIT_LENGTH, LENGTH_M);
-  l = getProperty ("L", UNIT_LENGTH, LENGTH_M);
-}
-
-double coax::alphad_coax ()
-{
-  double ad;
-  ad = (pi/C0) * f * sqrt(er) * tand;
-  ad = ad * 20.0 / log(10.0);
-  return ad;
-}
-
-double coax::alphac_coax ()
-{
-  double ac, Rs;
-  Rs = sqrt((pi * f * mur* MU0)/sigma);
-  ac = sqrt(er) * (((1/din) + (1/dout))/log(dout/din)) * (Rs/ZF0);
-  ac = ac * 20.0 / log(10.0);
-  return ac;
+  res.din = getProperty ("din", UNIT_LENGTH, LENGTH_M);
+  res.dout = getProperty ("dout", UNIT_LENGTH, LENGTH_M);
+  res.l = getProperty ("L", UNIT_LENGTH, LENGTH_M);
 }
 
 /*
@@ -110,8 +95,6 @@ double coax::alphac_coax ()
  */
 void coax::analyze ()
 {
-  double lambda_g;
-
   /* Get and assign substrate parameters */
   get_coax_sub();
 
@@ -120,17 +103,12 @@ void coax::analyze ()
       
   /* Get and assign physical parameters */
   get_coax_phys();
- 
-  if (din != 0.0){
-    Z0 = (ZF0/2/pi/sqrt(er))*log(dout/din);
-  }
 
-  lambda_g = (C0/(f))/sqrt(er * mur);
-  /* calculate electrical angle */
-  ang_l = (2.0 * pi * l)/lambda_g;    /* in radians */
-     
-  setProperty ("Z0", Z0, UNIT_RES, RES_OHM);
-  setProperty ("Ang_l", ang_l, UNIT_ANG, ANG_RAD);
+  model.setSubstrate (sub);
+  model.analyze (f, res.din, res.dout, res.l, res);
+
+  setProperty ("Z0", res.Z0, UNIT_RES, RES_OHM);
+  setProperty ("Ang_l", res.ang_l, UNIT_ANG, ANG_RAD);
 
   show_results();
 }
@@ -141,8 +119,6 @@ void coax::analyze ()
  */
 int coax::synthesize ()
 {
-  double lambda_g;
-
   /* Get and assign substrate parameters */
   get_coax_sub();
 
@@ -154,21 +130,15 @@ int coax::synthesize ()
 
   /* Get and assign physical parameters */
   get_coax_phys();
-      
-  if (isSelected ("din")) {
-    /* solve for din */
-    din = dout / exp(Z0*sqrt(er)/ZF0*2*pi);
-    setProperty ("din", din, UNIT_LENGTH, LENGTH_M);
-  } else if (isSelected ("dout")) {
-    /* solve for dout */
-    dout = din * exp(Z0*sqrt(er)/ZF0*2*pi);
-    setProperty ("dout", dout, UNIT_LENGTH, LENGTH_M);
-  }
 
-  lambda_g = (C0/(f))/sqrt(er * mur);
-  /* calculate physical length */
-  l = (lambda_g * ang_l)/(2.0 * pi);    /* in m */
-  setProperty ("L", l, UNIT_LENGTH, LENGTH_M);
+  model.setSubstrate (sub);
+  model.synthesize (f, res.Z0, res.ang_l, isSelected ("din"), res);
+
+  if (isSelected ("din"))
+    setProperty ("din", res.din, UNIT_LENGTH, LENGTH_M);
+  else
+    setProperty ("dout", res.dout, UNIT_LENGTH, LENGTH_M);
+  setProperty ("L", res.l, UNIT_LENGTH, LENGTH_M);
 
   show_results();
 
@@ -181,34 +151,30 @@ int coax::synthesize ()
 void coax::show_results()
 {
   double fc;
-  short m, n;
-
-  atten_dielectric = alphad_coax () * l;
-  atten_cond = alphac_coax () * l;
+  short m;
 
-  setResult (0, atten_cond, "dB");
-  setResult (1, atten_dielectric, "dB");
+  setResult (0, res.atten_cond, "dB");
+  setResult (1, res.atten_dielectric, "dB");
       
-  n = 1;
-  fc = C0 / sqrt (er * mur) / (pi_over_2 * (dout + din)/(double) n);
+  fc = model.fc_te (1);
   setResult (2, "none");
   if (fc <= f) {
     char text[256], txt[256];
     strcpy (text, "TE(1,1) ");
     m = 2;
-    fc = C0 / sqrt (er * mur) / (pi_over_2 * (dout + din)/(double) m);
+    fc = model.fc_te (m);
     while ((fc <= f) && (m<10)) {
       sprintf(txt, "TE(n,%d) ",m);
       strcat(text,txt);
       m++;
-      fc = C0 / sqrt (er * mur) / (pi_over_2 * (dout + din)/(double) m);
+      fc = model.fc_te (m);
     }
     setResult (2, text);
   }
 
   setResult (3, "none");
   m = 1;
-  fc = C0 / sqrt (er * mur) / ((dout - din)/(float) m);
+  fc = model.fc_tm (m);
   if (fc <= f) {
     char text[256], txt[256];
     strcpy (text, "");
@@ -216,7 +182,7 @@ void coax::show_results()
       sprintf(txt, "TM(n,%d) ",m);
       strcat(text,txt);
       m++;
-      fc = C0 / sqrt (er * mur) / ((dout - din)/(double) m);
+      fc = model.fc_tm (m);
     }
     setResult (3, text);
   }
@@ -30,17 +30,9 @@ class coax : public transline {
   ~coax();
 
  private:
-  double er;               /* dielectric constant */
-  double tand;             /* Dielectric Loss Tangent */
-  double din;              /* Inner diameter of cable */
-  double dout;             /* Outer diameter of cable */
-  double l;                /* Length of cable */
-  double Z0;               /* characteristic impedance */
-  double ang_l;            /* Electrical length in angle */
-  double er_eff;           /* Effective dielectric constant */
-  double atten_dielectric; /* Loss in dielectric (dB) */
-  double atten_cond;       /* Loss in conductors (dB) */
-  double fc;               /* Cutoff frequency for higher order modes */
+  coax_model model;        /* headless line model */
+  tl_substrate sub;        /* dielectric and metal parameters */
+  coax_result res;         /* physical and electrical parameters */
 
  public:
   void analyze ();
@@ -51,10 +43,6 @@ class coax : public transline {
   void get_coax_comp();
   void get_coax_phys();
   void get_coax_elec();
-  void fixdin();
-  void fixdout();
-  double alphad_coax();
-  double alphac_coax();
   void show_results();
 };
 
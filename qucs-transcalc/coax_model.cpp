@@ -0,0 +1,146 @@
+/*
+ * coax_model.cpp - headless coaxial line model
+ *
+ * Copyright (C) 2001 Gopal Narayanan <gopal@astro.umass.edu>
+ * Copyright (C) 2002 Claudio Girardi <claudio.girardi@ieee.org>
+ * Copyright (C) 2005, 2006, 2009, 2011 Stefan Jahn <stefan@lkcc.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <cmath>
+
+#include "units.h"
+#include "tlengine.h"
+
+coax_model::coax_model ()
+{
+  setSubstrate (tl_default_substrate ());
+  f = 1e9;
+  din = dout = l = 0.0;
+}
+
+/*
+ * setSubstrate() - assign the dielectric and metal parameters, the
+ * substrate height and thickness are not used
+ */
+void coax_model::setSubstrate (const tl_substrate & s)
+{
+  er = s.er;
+  mur = s.mur;
+  tand = s.tand;
+  sigma = s.sigma;
+}
+
+double coax_model::alphad ()
+{
+  double ad;
+  ad = (pi/C0) * f * sqrt(er) * tand;
+  ad = ad * 20.0 / log(10.0);
+  return ad;
+}
+
+double coax_model::alphac ()
+{
+  double ac, Rs;
+  Rs = sqrt((pi * f * mur* MU0)/sigma);
+  ac = sqrt(er) * (((1/din) + (1/dout))/log(dout/din)) * (Rs/ZF0);
+  ac = ac * 20.0 / log(10.0);
+  return ac;
+}
+
+/*
+ * fc_te() - cutoff frequency of the TE(n,m) modes
+ */
+double coax_model::fc_te (int m)
+{
+  return C0 / sqrt (er * mur) / (pi_over_2 * (dout + din)/(double) m);
+}
+
+/*
+ * fc_tm() - cutoff frequency of the TM(n,m) modes
+ */
+double coax_model::fc_tm (int m)
+{
+  return C0 / sqrt (er * mur) / ((dout - din)/(double) m);
+}
+
+void coax_model::fill_result (double Z0, double ang_l, coax_result & res)
+{
+  res.din = din;
+  res.dout = dout;
+  res.l = l;
+  res.Z0 = Z0;
+  res.ang_l = ang_l;
+  res.atten_dielectric = alphad () * l;
+  res.atten_cond = alphac () * l;
+  res.skindepth = 1.0 / sqrt (pi * f * mur * MU0 * sigma);
+}
+
+/*
+ * analyze() - impedance and electrical length for the given diameters
+ * and length
+ */
+void coax_model::analyze (double freq, double d_in, double d_out,
+			  double length, coax_result & res)
+{
+  double lambda_g, Z0 = 0.0, ang_l;
+
+  f = freq;
+  din = d_in;
+  dout = d_out;
+  l = length;
+
+  if (din != 0.0){
+    Z0 = (ZF0/2/pi/sqrt(er))*log(dout/din);
+  }
+
+  lambda_g = (C0/(f))/sqrt(er * mur);
+  /* calculate electrical angle */
+  ang_l = (2.0 * pi * l)/lambda_g;    /* in radians */
+
+  fill_result (Z0, ang_l, res);
+}
+
+/*
+ * synthesize() - one of the diameters for the wanted impedance, then
+ * the length for the wanted electrical angle
+ */
+int coax_model::synthesize (double freq, double Z0, double ang_l,
+			    bool solve_din, coax_result & res)
+{
+  double lambda_g;
+
+  f = freq;
+  din = res.din;
+  dout = res.dout;
+
+  if (solve_din) {
+    /* solve for din */
+    din = dout / exp(Z0*sqrt(er)/ZF0*2*pi);
+  } else {
+    /* solve for dout */
+    dout = din * exp(Z0*sqrt(er)/ZF0*2*pi);
+  }
+
+  lambda_g = (C0/(f))/sqrt(er * mur);
+  /* calculate physical length */
+  l = (lambda_g * ang_l)/(2.0 * pi);    /* in m */
+
+  fill_result (Z0, ang_l, res);
+  return 0;
+}
@@ -28,34 +28,20 @@ class coplanar : public transline {
  public:
   coplanar();
 
+ protected:
+  cpw_model model;		/* headless line model */
+
  private:
-  double er;			/* dielectric constant */
-  double h;			/* height of substrate */
-  double t;			/* thickness of top metal */
-  double tand;			/* Dielectric Loss Tangent */
-  double w;			/* width of line */
-  double s;			/* width of gap between line and ground */
-  double len;			/* length of line */
-  double Z0;			/* characteristic impedance */
-  double er_eff;		/* effective dielectric constant */
-  double ang_l;			/* Electrical length in angle */
-  double atten_dielectric;	/* Loss in dielectric (dB) */
-  double atten_cond;		/* Loss in conductors (dB) */
+  tl_substrate sub;		/* substrate parameters */
+  cpw_result res;		/* physical and electrical parameters */
 
  public:
   void analyze();
   int synthesize();
 
- protected:
-  bool backMetal;
-
  private:
-  void calc();
   void show_results();
   void getProperties();
-
-  double ellipk(double);
-  double KoverKp(double);
 };
 
 
@@ -29,60 +29,16 @@ class microstrip : public transline {
   microstrip();
   ~microstrip();
 
-  friend class c_microstrip;
-
  private:
-  double er;			/* dielectric constant */
-  double h;			/* height of substrate */
-  double ht;			/* height to the top of box */
-  double t;			/* thickness of top metal */
-  double tand;			/* Dielectric Loss Tangent */
-  double rough;			/* Roughness of top metal */
-  double w;			/* width of line */
-  double l;			/* length of line */
-  double Z0_0;			/* static characteristic impedance */
-  double Z0;			/* characteristic impedance */
-  double ang_l;			/* Electrical length in angle */
-  double er_eff_0;		/* Static effective dielectric constant */
-  double er_eff;		/* Effective dielectric constant */
-  double mur_eff;		/* Effective mag. permeability */
-  double w_eff;			/* Effective width of line */
-  double atten_dielectric;	/* Loss in dielectric (dB) */
-  double atten_cond;		/* Loss in conductors (dB) */
-
-  /* private params */
-  double Z0_h_1;		/* homogeneous stripline impedance */
+  ms_model ms;			/* headless line model */
+  tl_substrate sub;		/* substrate parameters */
+  tl_result res;		/* physical and electrical parameters */
 
  public:
   void analyze();
   int synthesize();
 
  private:
-  double er_eff_freq();
-  double alpha_c();
-  double alpha_c_roughness();
-  double alpha_dielectric();
-  double char_impedance_ht();
-  double synth_width();
-  double ereff_dispersion();
-  double Z0_dispersion();
-  double Z0_homogeneous(double);
-  double delta_Z0_cover(double, double);
-  double filling_factor(double, double);
-  double delta_q_cover(double);
-  double delta_q_thickness(double, double);
-  double e_r_effective(double, double);
-  double delta_u_thickness(double, double, double);
-  double e_r_dispersion(double, double, double);
-  double Z0_dispersion(double, double, double, double, double);
-  double conductor_losses();
-  double dielectric_losses();
-  void microstrip_Z0();
-  void dispersion();
-  void attenuation();
-  void mur_eff_ms();
-  void line_angle();
-  void calc();
   void get_microstrip_sub();
   void get_microstrip_comp();
   void get_microstrip_elec();
@@ -58,6 +58,7 @@
 #include "optionsdialog.h"
 #include "transline.h"
 #include "units.h"
+#include "tlengine.h"
 #include "microstrip.h"
 #include "coplanar.h"
 #include "coax.h"
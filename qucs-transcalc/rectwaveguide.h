@@ -30,31 +30,15 @@ class rectwaveguide : public transline {
   ~rectwaveguide();
 
  private:
-  double er;               /* dielectric constant */
-  double tand;             /* Dielectric Loss Tangent */
-  double tanm;             /* Magnetic Loss Tangent */  
-  double a;                /* width of waveguide */
-  double b;                /* height of waveguide */
-  double l;                /* length of waveguide */
-  double Z0;               /* characteristic impedance */
-  double ang_l;            /* Electrical length in angle */
-  double er_eff;           /* Effective dielectric constant */
-  //double mur_eff;          /* Effective mag. permeability */
-  double atten_dielectric; /* Loss in dielectric (dB) */
-  double atten_cond;       /* Loss in conductors (dB) */
-  //double fc10;             /* Cutoff frequency for TE10 mode */
+  rwg_model model;         /* headless line model */
+  tl_substrate sub;        /* filling and metal parameters */
+  rwg_result res;          /* physical and electrical parameters */
 
  public:
   void analyze ();
   int synthesize ();
 
  private:
-  double kval ();
-  double kc (int, int);
-  double fc (int, int);
-  double alphac ();
-  double alphac_cutoff ();
-  double alphad ();
   void get_rectwaveguide_sub ();
   void get_rectwaveguide_comp ();
   void get_rectwaveguide_phys ();
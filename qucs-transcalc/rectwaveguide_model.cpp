@@ -0,0 +1,250 @@
+/*
+ * rectwaveguide_model.cpp - headless rectangular waveguide model
+ *
+ * Copyright (C) 2001 Gopal Narayanan <gopal@astro.umass.edu>
+ * Copyright (C) 2005, 2006 Stefan Jahn <stefan@lkcc.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <cmath>
+
+#include "units.h"
+#include "tlengine.h"
+
+rwg_model::rwg_model ()
+{
+  setSubstrate (tl_default_substrate ());
+  f = 1e9;
+  a = b = l = 0.0;
+}
+
+/*
+ * setSubstrate() - assign the filling and the metal parameters, the
+ * substrate height and thickness are not used
+ */
+void rwg_model::setSubstrate (const tl_substrate & s)
+{
+  er = s.er;
+  mur = s.mur;
+  sigma = s.sigma;
+  tand = s.tand;
+}
+
+/*
+ * returns k
+ */
+double rwg_model::kval ()
+{
+  double kval;
+  kval = 2.0 * pi * f * sqrt (mur * er) / C0;
+  return kval;
+}
+ 
+/*
+ * given mode numbers m and n 
+ * returns cutoff kc value
+ */
+double rwg_model::kc (int m, int n)
+{
+  double kcval;
+  kcval = sqrt (pow ((m * pi / a), 2.0) + pow ((n * pi / b), 2.0));
+  return kcval;
+}
+
+/*
+ * given mode numbers m and n 
+ * returns cutoff fc value
+ */
+double rwg_model::fc (int m, int n)
+{
+  double fcval;
+  fcval =  kc (m, n) * C0 / (2.0 * pi * sqrt (mur * er));
+  return fcval;
+}
+
+/*
+ * alphac - returns attenuation due to conductor losses for all propagating
+ * modes in the waveguide
+ */
+double rwg_model::alphac ()
+{
+  double Rs, f_c;
+  double ac;
+  short m, n, mmax, nmax;
+
+  Rs = sqrt ((pi * f * mur * MU0) / sigma);
+  ac = 0.0;
+  mmax = (int) floor (f / fc (1,0));
+  nmax = mmax;
+
+  /* below from Ramo, Whinnery & Van Duzer */
+
+  /* TE(m,n) modes */
+  for (n = 0; n<= nmax; n++){
+    for (m = 1; m <= mmax; m++){
+      f_c = fc(m, n);
+      if (f > f_c) {
+	switch (n) {
+	case 0:
+	  ac += (Rs/(b * ZF0 * sqrt(1.0 - pow((f_c/f),2.0)))) *
+	    (1.0 + ((2 * b/a)*pow((f_c/f),2.0)));
+	  break;
+	default:
+	  ac += ((2. * Rs)/(b * ZF0 * sqrt(1.0 - pow((f_c/f),2.0)))) *
+	    (((1. + (b/a))*pow((f_c/f),2.0)) + 
+	     ((1. - pow((f_c/f),2.0)) * (((b/a)*(((b/a)*pow(m,2.)) + pow(n,2.)))/
+					(pow((b*m/a),2.0) + pow(n,2.0)))));
+	  break;
+	}
+      }
+    }
+  }
+
+  /* TM(m,n) modes */
+  for (n = 1; n<= nmax; n++) {
+    for (m = 1; m<= mmax; m++) {
+      f_c = fc(m, n);
+      if (f > f_c) {
+	ac += ((2. * Rs)/(b * ZF0 * sqrt(1.0 - pow((f_c/f),2.0)))) *
+	  (((pow(m,2.0)*pow((b/a),3.0)) + pow(n,2.))/
+	   ((pow((m*b/a),2.)) + pow(n,2.0)));
+      }
+    }
+  }
+  
+  ac = ac * 20.0 * log10 (exp (1.0)); /* convert from Np/m to db/m */
+  return ac;
+}
+
+/*
+ * alphac_cutoff - returns attenuation for a cutoff wg
+ */
+double rwg_model::alphac_cutoff ()
+{
+  double acc;
+  acc = sqrt (pow (kc(1,0), 2.0) - pow (kval (), 2.0));
+  acc = 20 * log10 (exp (1.0)) * acc;
+  return acc;
+}
+
+/*
+ * returns attenuation due to dielectric losses
+ */
+double rwg_model::alphad()
+{
+  double k, beta;
+  double ad;
+
+  k = kval ();
+  beta = sqrt (pow (k, 2.0) - pow (kc (1,0), 2.0));  
+  
+  ad = (pow (k, 2.0) * tand) / (2.0 * beta);
+  ad = ad * 20.0 * log10 (exp (1.0)); /* convert from Np/m to db/m */
+  return ad;
+}
+
+/*
+ * fill_result - losses and effective dielectric constant of the
+ * fundamental mode, an evanescent guide has no impedance
+ */
+void rwg_model::fill_result (rwg_result & res)
+{
+  res.a = a;
+  res.b = b;
+  res.l = l;
+  res.skindepth = 1.0 / sqrt (pi * f * mur * MU0 * sigma);
+  if (kc (1,0) <= kval ()) {
+    /* propagating modes */
+    res.atten_cond = alphac () * l;
+    res.atten_dielectric = alphad () * l;
+    res.er_eff = (1.0 - pow ((fc (1,0) / f), 2.0));
+  } else {
+    /* evanascent modes */
+    res.Z0 = 0;
+    res.ang_l = 0;
+    res.er_eff = 0;
+    res.atten_dielectric = 0.0;
+    res.atten_cond = alphac_cutoff () * l;
+  }
+}
+
+/*
+ * analyze - impedance and electrical length of the fundamental mode
+ */
+void rwg_model::analyze (double freq, double width, double height,
+			 double length, rwg_result & res)
+{
+  double lambda_g;
+  double k;
+  double beta;
+
+  f = freq;
+  a = width;
+  b = height;
+  l = length;
+
+  k = kval ();
+      
+  if (kc (1,0) <= k) {
+    /* propagating modes */
+    beta = sqrt (pow (k, 2.0) - pow (kc (1,0), 2.0));
+    /* Z0 = (k * ZF0) / beta; */
+    res.Z0 = k * ZF0 * sqrt(mur/er) / beta;
+
+    /* calculate electrical angle */
+    lambda_g = 2.0 * pi / beta;
+    res.ang_l = 2.0 * pi * l / lambda_g;    /* in radians */
+  }
+
+  fill_result (res);
+}
+
+/*
+ * synthesize - one of the dimensions for the wanted impedance, then
+ * the length for the wanted electrical angle
+ */
+int rwg_model::synthesize (double freq, double Z0, double ang_l,
+			   bool solve_b, rwg_result & res)
+{
+  double lambda_g, k, beta;
+
+  f = freq;
+  a = res.a;
+  b = res.b;
+
+  if (solve_b) {
+    /* solve for b */
+    b = Z0 * a * sqrt(1.0 - pow((fc(1,0)/f),2.0))/
+      (2. * ZF0);
+  } else {
+    /* solve for a */
+    a = sqrt(pow((2.0 * ZF0 * b/Z0), 2.0) + 
+		 pow((C0/(2.0 * f)),2.0));
+  }
+
+  k = kval ();
+  beta = sqrt(pow(k,2.) - pow(kc(1,0),2.0));
+  lambda_g = (2. * pi)/beta;
+  l = (ang_l * lambda_g)/(2.0 * pi);    /* in m */
+
+  res.Z0 = Z0;
+  res.ang_l = ang_l;
+  fill_result (res);
+
+  return kc (1,0) <= k ? 0 : -1;
+}
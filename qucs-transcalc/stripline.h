@@ -35,18 +35,9 @@ class stripline : public transline {
   ~stripline();
 
  private:
-  double er;               /* dielectric constant */
-  double tand;             /* Dielectric Loss Tangent */
-  double t;                /* Thickness */
-  double h;                /* Substrate height */
-  double W;                /* Width of the conductor strip */
-  double l;                /* Length of cable */
-  double Z0;               /* characteristic impedance */
-  double ang_l;            /* Electrical length in angle */
-  double er_eff;           /* Effective dielectric constant */
-  double atten_dielectric; /* Loss in dielectric (dB) */
-  double atten_cond;       /* Loss in conductors (dB) */
-  double lambda_0;         /* Wavelength */
+  sl_model model;          /* headless line model */
+  tl_substrate sub;        /* substrate parameters */
+  tl_result res;           /* physical and electrical parameters */
 
  public:
   void analyze ();
@@ -57,14 +48,7 @@ class stripline : public transline {
   void get_stripline_comp();
   void get_stripline_phys();
   void get_stripline_elec();
-  void fixdin();
-  void fixdout();
-  double alphad_stripline();
-  double alphac_stripline();
   void show_results();
-  void getStriplineLength();
-  void calculateZ0();
-  double getZ0fromWidth(double);
 };
 
 #endif /* __stripline_H */
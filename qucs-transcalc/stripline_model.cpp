@@ -0,0 +1,170 @@
+/*
+ * stripline_model.cpp - headless symmetric stripline model
+ *
+ * Copyright (C) 2016 Andres Martinez-Mera <andresmartinezmera@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+/*
+Reference:
+[1] Analysis Methods for RF, Microwave and Milimeter-Wave Planar Transmission Line Structures,
+Cam Nguyen. John Wiley and Sons Inc., 2001, Pages 76 - 78
+*/
+
+#include <cmath>
+
+#include "units.h"
+#include "tlengine.h"
+
+sl_model::sl_model ()
+{
+  setSubstrate (tl_default_substrate ());
+  f = 1e9;
+  w = l = Z0 = ang_l = skindepth = 0.0;
+}
+
+/*
+ * setSubstrate() - assign substrate parameters
+ */
+void sl_model::setSubstrate (const tl_substrate & s)
+{
+  er = s.er;
+  mur = s.mur;
+  tand = s.tand;
+  sigma = s.sigma;
+  t = s.t;
+  h = s.h;
+}
+
+/* This function calculates the dielectric attenuation coefficient*/
+double sl_model::alphad ()
+{
+  double lambda_0 = C0/f;
+  return 27.3*sqrt(er)*tand/lambda_0;
+}
+
+/* This function calculates the conductor attenuation coefficient*/
+double sl_model::alphac ()
+{
+  double w_ = 2*pi*f, alpha_c;
+  double mu = mur*pi*4e-7;
+  double Rs = sqrt(w_*mu/(2*sigma));//Skin effect resistance
+  skindepth = sqrt(2/(w_*mu*sigma));
+  double A = 1 + 2*w/(2*h-t) + (1/pi)*((2*h+t)/(2*h-t))*log((4*h-t)/t);
+  double B = 1 + (2*h/(0.5*w+0.7*t))*(0.5 + 0.414*t/w + (1/(2*pi))*log(4*pi*w/t));
+
+  (Z0 < 120/sqrt(er)) ?
+    alpha_c = (23.4e-3*Rs*er*Z0*A)/(30*pi*(2*h-t)) :
+    alpha_c = 1.4*Rs*B/(Z0*2*h);
+
+  return alpha_c;
+}
+
+// This function calculates the characteristic impedance of a symmetric stripline according to [1], eq. 4.80-4.84
+double sl_model::impedance (double W_)
+{
+  double x = t/(2.*h);
+  double m= 2/(1 + 2*x/3*(1-x));
+  double B = (x/(pi*(1-x)))*(1 - 0.5*log(pow(x/(2.-x),2) + pow((0.0796*x)/((W_/(2.*h)) + 1.1*x),m)));
+  double A = 1/((W_/(2*h - t)) + B);
+  // Line impedance
+  return (30/sqrt(er))*log(1 + (4/pi)*A*((8/pi)*A + sqrt(pow((8/pi)*A,2) + 6.27)));
+}
+
+void sl_model::fill_result (tl_result & res)
+{
+  res.w = w;
+  res.l = l;
+  res.Z0 = Z0;
+  res.ang_l = ang_l;
+  res.er_eff = er;
+  res.atten_cond = alphac () * l;
+  res.atten_dielectric = alphad () * l;
+  res.skindepth = skindepth;
+}
+
+/*
+ * analyze() - calculates Z0 and the electrical length for the given
+ * width and length
+ */
+void sl_model::analyze (double freq, double width, double length,
+			tl_result & res)
+{
+  f = freq;
+  w = width;
+  l = length;
+
+  Z0 = impedance (w);
+  double lambda_g = (C0/(f))/sqrt(er * mur);
+  /* calculate electrical angle */
+  ang_l = (2.0 * pi * l)/lambda_g;    /* in radians */
+
+  fill_result (res);
+}
+
+/*
+ * synthesize() - the zero-thickness width refined by Newton's method,
+ * then the length for the wanted electrical angle
+ */
+int sl_model::synthesize (double freq, double Z0_dest, double angle,
+			  tl_result & res)
+{
+  f = freq;
+  Z0 = Z0_dest;
+  ang_l = angle;
+
+  // Zero-thickness approximation
+  double B = exp(Z0*sqrt(er)/30)-1;
+  double C = sqrt(4*B+6.27);
+  double A = 2*B/C;
+  double A1 = 8/(pi*A);
+
+  double x = t/(2*h);
+  double m= 2/(1 + 2*x/3*(1-x));
+  double We = (2*h - t)*A1;
+  double A2 = (x/(pi*(1-x))) * (1 - 0.5*log( (x*x/(4-2*x+x*x)) + pow((0.0796*x/( (We/(2*h)) + 1.1*x)),m) ));
+
+  double Wi = (A1 - A2)*(2*h-t);//Width given by the zero-thickness approximation (Initial guess for the refinement)
+ 
+  double Zi;
+  double dW = Wi*1e-4;//Differential width
+  unsigned int MAX_ITER = 100, iter = 0;
+  double MAX_ERR = 1e-5;
+  double Zi_1 = 0, Zi_diff, step;
+
+
+  // The Newton-Raphson method is employed to refine the width given by the zero-thickness approximation with the analysis formulae.
+  while ((std::abs(Z0 - Zi_1) > MAX_ERR)&&(iter < MAX_ITER))//Stop condition: |Z0 - Z_i| < MAX_ERR or max. number iterations exceeded
+  {
+    Zi = impedance(Wi+dW);
+    Zi_diff = (Zi - Zi_1) / dW;
+    step = (Z0 - Zi_1) / Zi_diff - dW;
+    Wi += step+dW;
+    if (Wi <= 0.0) Wi = dW;
+    Zi_1 = impedance(Wi);
+    iter++;
+  }
+
+  w = Wi;
+  double lambda_g = (C0/f)/sqrt(er * mur);
+  /* calculate physical length */
+  l = (lambda_g * ang_l)/(2.0 * pi);    /* in m */
+
+  fill_result (res);
+  return std::abs(Z0 - Zi_1) > MAX_ERR ? -1 : 0;
+}
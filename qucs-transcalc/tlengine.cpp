@@ -0,0 +1,872 @@
+/*
+ * tlengine.cpp - headless transmission line calculator engine
+ *
+ * Copyright (C) 2001 Gopal Narayanan <gopal@astro.umass.edu>
+ * Copyright (C) 2002 Claudio Girardi <claudio.girardi@ieee.org>
+ * Copyright (C) 2005, 2006 Stefan Jahn <stefan@lkcc.org>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* The microstrip equations used to live in microstrip.cpp and were
+ * only reachable through the QucsTranscalc property sheet.  They are
+ * kept here without any GUI dependency so that the calculator, the
+ * RF design tools and the batch sweep tool share one implementation.
+ * The other line types live in the *_model.cpp files next to their
+ * calculator pages.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <cmath>
+
+#include "units.h"
+#include "tlengine.h"
+
+tl_substrate tl_default_substrate ()
+{
+  tl_substrate s;
+  s.er = 9.8;
+  s.mur = 1.0;
+  s.h = 0.635e-3;
+  s.ht = 1e20;
+  s.t = 0.0;
+  s.sigma = 4.1e7;
+  s.tand = 0.0;
+  s.rough = 0.0;
+  return s;
+}
+
+ms_model::ms_model()
+{
+  setSubstrate (tl_default_substrate ());
+  f = 1e9;
+  w = l = 0.0;
+  Z0_0 = Z0 = ang_l = 0.0;
+  er_eff_0 = er_eff = mur_eff = 1.0;
+  w_eff = atten_dielectric = atten_cond = Z0_h_1 = skindepth = 0.0;
+}
+
+/*
+ * setSubstrate() - assign substrate parameters
+ */
+void ms_model::setSubstrate(const tl_substrate & s)
+{
+  er = s.er;
+  mur = s.mur;
+  h = s.h;
+  ht = s.ht;
+  t = s.t;
+  sigma = s.sigma;
+  tand = s.tand;
+  rough = s.rough;
+}
+
+
+/*
+ * skin_depth - calculate skin depth
+ */
+double ms_model::skin_depth()
+{
+  double depth;
+  depth = 1.0 / (sqrt(pi * f * mur * MU0 * sigma));
+  return depth;
+}
+
+/*
+ * Z0_homogeneous() - compute the impedance for a stripline in a
+ * homogeneous medium, without cover effects
+ */
+double ms_model::Z0_homogeneous(double u)
+{
+  double f, Z0;
+  f = 6.0 + (2.0 * pi - 6.0) * exp(-pow(30.666 / u, 0.7528));
+  Z0 = (ZF0 / (2.0 * pi)) * log(f / u + sqrt(1.0 + 4.0 / (u * u)));
+  return Z0;
+}
+
+
+/*
+ * delta_Z0_cover() - compute the cover effect on impedance for a
+ * stripline in a homogeneous medium
+ */
+double ms_model::delta_Z0_cover(double u, double h2h)
+{
+  double P, Q;
+  double h2hp1;
+  h2hp1 = 1.0 + h2h;
+  P = 270.0 * (1.0 - tanh(1.192 + 0.706 * sqrt(h2hp1) - 1.389 / h2hp1));
+  Q = 1.0109 - atanh((0.012 * u + 0.177 * u * u - 0.027 * u * u * u) / (h2hp1 * h2hp1));
+  return (P * Q);
+}
+
+
+/*
+ * filling_factor() - compute the filling factor for a microstrip
+ * without cover and zero conductor thickness
+ */
+double ms_model::filling_factor(double u, double e_r)
+{
+  double a, b, q_inf;
+  double u2, u3, u4;
+  u2 = u * u;
+  u3 = u2 * u;
+  u4 = u3 * u;
+  a = 1.0 + log((u4 + u2 / 2704) / (u4 + 0.432)) / 49.0 + log(1.0 + u3 / 5929.741) / 18.7;
+  b = 0.564 * pow((e_r - 0.9) / (e_r + 3.0), 0.053);
+  q_inf = pow(1.0 + 10.0 / u, -a * b);
+  return q_inf;
+}
+
+
+/*
+ * delta_q_cover() - compute the cover effect on filling factor
+ */
+double ms_model::delta_q_cover(double h2h)
+{
+  double q_c;
+  q_c = tanh(1.043 + 0.121 * h2h - 1.164 / h2h);
+  return q_c;
+}
+
+
+/*
+ * delta_q_thickness() - compute the thickness effect on filling factor
+ */
+double ms_model::delta_q_thickness(double u, double t_h)
+{
+  double q_t;
+  q_t = (2.0 * log(2.0) / pi) * (t_h / sqrt(u));
+  return q_t;
+}
+
+
+/*
+ * e_r_effective() - compute effective dielectric constant from
+ * material e_r and filling factor
+ */
+double ms_model::e_r_effective(double e_r, double q)
+{
+  double e_r_eff;
+  e_r_eff = 0.5 * (e_r + 1.0) + 0.5 * q * (e_r - 1.0);
+  return e_r_eff;
+}
+
+
+/*
+ * delta_u_thickness - compute the thickness effect on normalized width
+ */
+double ms_model::delta_u_thickness(double u, double t_h, double e_r)
+{
+  double delta_u;
+  if (t_h > 0.0) {
+    /* correction for thickness for a homogeneous microstrip */
+    delta_u = (t_h / pi) * log(1.0 + (4.0 * e) * pow(tanh(sqrt(6.517 * u)), 2.0) / t_h);
+    /* correction for strip on a substrate with relative permettivity e_r */
+    delta_u = 0.5 * delta_u * (1.0 + 1.0 / cosh(sqrt(e_r - 1.0)));
+  } else {
+    delta_u = 0.0;
+  }
+  return delta_u;
+}
+
+
+/*
+ * microstrip_Z0() - compute microstrip static impedance
+ */
+void ms_model::microstrip_Z0()
+{
+  double e_r, h2, h2h, u, t_h;
+  double Z0_h_r, Z0;
+  double delta_u_1, delta_u_r, q_inf, q_c, q_t, e_r_eff, e_r_eff_t, q;
+
+  e_r = er;
+  h2 = ht;
+  h2h = h2 / h;
+  u = w / h;
+  t_h = t / h;
+
+  /* compute normalized width correction for e_r = 1.0 */
+  delta_u_1 = delta_u_thickness(u, t_h, 1.0);
+  /* compute homogeneous stripline impedance */
+  Z0_h_1 = Z0_homogeneous(u + delta_u_1);
+  /* compute normalized width corection */
+  delta_u_r = delta_u_thickness(u, t_h, e_r);
+  u += delta_u_r;
+  /* compute homogeneous stripline impedance */
+  Z0_h_r = Z0_homogeneous(u);
+
+  /* filling factor, with width corrected for thickness */
+  q_inf = filling_factor(u, e_r);
+  /* cover effect */
+  q_c = delta_q_cover(h2h);
+  /* thickness effect */
+  q_t = delta_q_thickness(u, t_h);
+  /* resultant filling factor */
+  q = (q_inf - q_t) * q_c;
+
+  /* e_r corrected for thickness and non homogeneous material */
+  e_r_eff_t = e_r_effective(e_r, q);
+
+  /* effective dielectric constant */
+  e_r_eff = e_r_eff_t * pow(Z0_h_1 / Z0_h_r, 2.0);
+
+  /* characteristic impedance, corrected for thickness, cover */
+  /*   and non homogeneous material */
+  Z0 = Z0_h_r / sqrt(e_r_eff_t);
+
+  w_eff = u * h;
+  er_eff_0 = e_r_eff;
+  Z0_0 = Z0;
+}
+
+
+/*
+ * e_r_dispersion() - computes the dispersion correction factor for
+ * the effective permeability
+ */
+double ms_model::e_r_dispersion(double u, double e_r, double f_n)
+{
+  double P_1, P_2, P_3, P_4, P;
+
+  P_1 = 0.27488 + u * (0.6315 + 0.525 / pow(1.0 + 0.0157 * f_n, 20.0)) - 0.065683 * exp(-8.7513 * u);
+  P_2 = 0.33622 * (1.0 - exp(-0.03442 * e_r));
+  P_3 = 0.0363 * exp(-4.6 * u) * (1.0 - exp(-pow(f_n / 38.7, 4.97)));
+  P_4 = 1.0 + 2.751 * (1.0 - exp(-pow(e_r / 15.916, 8.0)));
+
+  P = P_1 * P_2 * pow((P_3 * P_4 + 0.1844) * f_n, 1.5763);
+
+  return P;
+}
+
+
+/*
+ * Z0_dispersion() - computes the dispersion correction factor for the
+ * characteristic impedance
+ */
+double ms_model::Z0_dispersion(double u, double e_r, double e_r_eff_0, double e_r_eff_f, double f_n)
+{
+  double R_1, R_2, R_3, R_4, R_5, R_6, R_7, R_8, R_9, R_10, R_11, R_12, R_13, R_14, R_15, R_16, R_17, D, tmpf;
+
+  R_1 = 0.03891 * pow(e_r, 1.4);
+  R_2 = 0.267 * pow(u, 7.0);
+  R_3 = 4.766 * exp(-3.228 * pow(u, 0.641));
+  R_4 = 0.016 + pow(0.0514 * e_r, 4.524);
+  R_5 = pow(f_n / 28.843, 12.0);
+  R_6 = 22.2 * pow(u, 1.92);
+  R_7 = 1.206 - 0.3144 * exp(-R_1) * (1.0 - exp(-R_2));
+  R_8 = 1.0 + 1.275 * (1.0 - exp(-0.004625 * R_3 * pow(e_r, 1.674) * pow(f_n / 18.365, 2.745)));
+  tmpf = pow(e_r - 1.0, 6.0);
+  R_9 = 5.086 * R_4 * (R_5 / (0.3838 + 0.386 * R_4)) * (exp(-R_6) / (1.0 + 1.2992 * R_5)) * (tmpf / (1.0 + 10.0 * tmpf));
+  R_10 = 0.00044 * pow(e_r, 2.136) + 0.0184;
+  tmpf = pow(f_n / 19.47, 6.0);
+  R_11 = tmpf / (1.0 + 0.0962 * tmpf);
+  R_12 = 1.0 / (1.0 + 0.00245 * u * u);
+  R_13 = 0.9408 * pow(e_r_eff_f, R_8) - 0.9603;
+  R_14 = (0.9408 - R_9) * pow(e_r_eff_0, R_8) - 0.9603;
+  R_15 = 0.707 * R_10 * pow(f_n / 12.3, 1.097);
+  R_16 = 1.0 + 0.0503 * e_r * e_r * R_11 * (1.0 - exp(-pow(u / 15.0, 6.0)));
+  R_17 = R_7 * (1.0 - 1.1241 * (R_12 / R_16) * exp(-0.026 * pow(f_n, 1.15656) - R_15));
+
+  D = pow(R_13 / R_14, R_17);
+
+  return D;
+}
+
+
+/*
+ * dispersion() - compute frequency dependent parameters of
+ * microstrip
+ */
+void ms_model::dispersion()
+{
+  double e_r, e_r_eff_0;
+  double u, f_n, P, e_r_eff_f, D, Z0_f;
+
+  e_r = er;
+  e_r_eff_0 = er_eff_0;
+  u = w / h;
+
+  /* normalized frequency [GHz * mm] */
+  f_n = f * h / 1e06;
+
+  P = e_r_dispersion(u, e_r, f_n);
+  /* effective dielectric constant corrected for dispersion */
+  e_r_eff_f = e_r - (e_r - e_r_eff_0) / (1.0 + P);
+
+  D = Z0_dispersion(u, e_r, e_r_eff_0, e_r_eff_f, f_n);
+  Z0_f = Z0_0 * D;
+
+  er_eff = e_r_eff_f;
+  Z0 = Z0_f;
+}
+
+
+/*
+ * conductor_losses() - compute microstrip conductor losses per unit
+ * length
+ */
+double ms_model::conductor_losses()
+{
+  double e_r_eff_0, delta;
+  double K, R_s, Q_c, alpha_c;
+
+  e_r_eff_0 = er_eff_0;
+  delta = skindepth;
+
+  if (f > 0.0) {
+    /* current distribution factor */
+    K = exp(-1.2 * pow(Z0_h_1 / ZF0, 0.7));
+    /* skin resistance */
+    R_s = 1.0 / (sigma * delta);
+    
+    /* correction for surface roughness */
+    R_s *= 1.0 + ((2.0 / pi) * atan(1.40 * pow((rough / delta), 2.0)));
+    /* strip inductive quality factor */
+    Q_c = (pi * Z0_h_1 * w * f) / (R_s * C0 * K);
+    alpha_c = (20.0 * pi / log(10.0)) * f * sqrt(e_r_eff_0) / (C0 * Q_c);
+  } else {
+    alpha_c = 0.0;
+  }
+
+  return alpha_c;
+}
+
+
+/*
+ * dielectric_losses() - compute microstrip dielectric losses per unit
+ * length
+ */
+double ms_model::dielectric_losses()
+{
+  double e_r, e_r_eff_0;
+  double alpha_d;
+
+  e_r = er;
+  e_r_eff_0 = er_eff_0;
+
+  alpha_d = (20.0 * pi / log(10.0)) * (f / C0) * (e_r / sqrt(e_r_eff_0)) * ((e_r_eff_0 - 1.0) / (e_r - 1.0)) * tand;
+
+  return alpha_d;
+}
+
+
+/* 
+ * attenuation() - compute attenuation of microstrip
+ */
+void ms_model::attenuation()
+{
+  skindepth = skin_depth();
+
+  atten_cond = conductor_losses() * l;
+  atten_dielectric = dielectric_losses() * l;
+}
+
+
+/*
+ * mur_eff_ms() - returns effective magnetic permeability
+ */
+void ms_model::mur_eff_ms()
+{
+  double mureff;
+
+  mureff = (2.0 * mur) / ((1.0 + mur) + ((1.0 - mur) * pow((1.0 + (10.0 * h / w)), -0.5)));
+
+  mur_eff =  mureff;
+}
+
+
+/*
+ * synth_width - calculate width given Z0 and e_r
+ */
+double ms_model::synth_width()
+{
+  double e_r, a, b;
+  double w_h, w;
+
+
+  e_r = er;
+
+
+  a = ((Z0 / ZF0 / 2 / pi) * sqrt((e_r + 1) / 2.)) + ((e_r - 1) / (e_r + 1) * (0.23 + (0.11 / e_r)));
+  b = ZF0 / 2 * pi / (Z0 * sqrt(e_r));
+
+  if (a > 1.52) {
+    w_h = 8 * exp(a) / (exp(2. * a) - 2);
+  } else {
+    w_h = (2. / pi) * (b - 1. - log((2 * b) - 1.) + ((e_r - 1) / (2 * e_r)) * (log(b - 1.) + 0.39 - 0.61 / e_r));
+  }
+
+  if (h > 0.0) {
+    w = w_h * h;
+    return w;
+  } else {
+    w = 0;
+  }
+  return w;
+}
+
+
+/*
+ * line_angle() - calculate microstrip length in radians
+ */
+void ms_model::line_angle()
+{
+  double e_r_eff;
+  double v, lambda_g;
+
+  e_r_eff = er_eff;
+
+  /* velocity */
+  v = C0 / sqrt(e_r_eff * mur_eff);
+  /* wavelength */
+  lambda_g = v / f;
+  /* electrical angles */
+  ang_l = 2.0 * pi * l / lambda_g;	/* in radians */
+}
+
+
+void ms_model::calc()
+{
+  /* effective permeability */
+  mur_eff_ms();
+  /* static impedance */
+  microstrip_Z0();
+  /* calculate freq dependence of er and Z0 */
+  dispersion();
+  /* calculate electrical lengths */
+  line_angle();
+  /* calculate losses */
+  attenuation();
+}
+
+
+void ms_model::fill_result(tl_result & res)
+{
+  res.w = w;
+  res.l = l;
+  res.Z0 = Z0;
+  res.ang_l = ang_l;
+  res.er_eff = er_eff;
+  res.atten_cond = atten_cond;
+  res.atten_dielectric = atten_dielectric;
+  res.skindepth = skindepth;
+}
+
+
+/*
+ * analyze() - compute all line parameters for the given width and
+ * length
+ */
+void ms_model::analyze(double freq, double width, double length,
+                       tl_result & res)
+{
+  f = freq;
+  w = width;
+  l = length;
+  calc();
+  fill_result(res);
+}
+
+
+/*
+ * impedance() - characteristic impedance only, the losses and the
+ * electrical length are not needed while iterating over the width
+ */
+double ms_model::impedance(double freq, double width)
+{
+  f = freq;
+  w = width;
+  microstrip_Z0();
+  dispersion();
+  return Z0;
+}
+
+
+/*
+ * synthesize() - find the width for the wanted impedance by Newton's
+ * method, then the length for the wanted electrical angle.  A
+ * positive 'w_start' is used as initial value instead of the closed
+ * form estimate.
+ */
+int ms_model::synthesize(double freq, double Z0_dest, double angle,
+                         tl_result & res, double w_start, double tolerance)
+{
+  double Z0_current, Z0_result, increment, slope, error, width;
+  int iteration;
+  const int maxiter = 100;
+
+  f = freq;
+
+  /* calculate width and use for initial value in Newton's method */
+  if (w_start > 0.0) {
+    w = w_start;
+  } else {
+    Z0 = Z0_dest;
+    w = synth_width();
+  }
+
+  /* Newton's method */
+  iteration = 0;
+
+  Z0_current = impedance(f, w);
+  error = std::abs(Z0_dest - Z0_current);
+
+  while (error > tolerance) {
+    iteration++;
+    width = w;
+    increment = (width / 100.0);
+    Z0_result = impedance(f, width + increment);
+    /* f(w(n)) = Z0 - Z0(w(n)) */
+    /* f'(w(n)) = -f'(Z0(w(n))) */
+    /* f'(Z0(w(n))) = (Z0(w(n)) - Z0(w(n+delw))/delw */
+    /* w(n+1) = w(n) - f(w(n))/f'(w(n)) */
+    slope = (Z0_result - Z0_current) / increment;
+    width += (Z0_dest - Z0_current) / slope;
+    if (width <= 0.0)
+      width = increment;
+    /* find new error */
+    Z0_current = impedance(f, width);
+    error = std::abs(Z0_dest - Z0_current);
+    if (iteration > maxiter)
+      break;
+  }
+
+  /* calculate physical length */
+  mur_eff_ms();
+  l = C0 / f / sqrt(er_eff * mur_eff) * angle / 2.0 / pi;    /* in m */
+
+  /* compute microstrip parameters */
+  calc();
+  fill_result(res);
+
+  if (iteration > maxiter)
+    return -1;
+  else
+    return 0;
+}
+
+
+/*
+ * sweep_point() - compute one grid point with the model of the given
+ * line type, the typed results are mapped onto the common columns
+ */
+struct tl_models {
+  ms_model ms;
+  cms_model cms;
+  sl_model sl;
+  cpw_model cpw {false};
+  cpw_model gcpw {true};
+  coax_model coax;
+  rwg_model rwg;
+};
+
+static void sweep_point(tl_type type, tl_models & m, const tl_substrate & s,
+                        const tl_grid & grid, tl_mode mode,
+                        tl_grid_point & p, double w_start)
+{
+  p.s = grid.s;
+  p.odd = tl_result();
+  switch (type) {
+  case TL_MICROSTRIP:
+    m.ms.setSubstrate(s);
+    if (mode == TL_ANALYZE)
+      m.ms.analyze(p.f, p.value, grid.l, p.res);
+    else
+      p.status = m.ms.synthesize(p.f, p.value, grid.ang_l, p.res, w_start);
+    break;
+
+  case TL_STRIPLINE:
+    m.sl.setSubstrate(s);
+    if (mode == TL_ANALYZE)
+      m.sl.analyze(p.f, p.value, grid.l, p.res);
+    else
+      p.status = m.sl.synthesize(p.f, p.value, grid.ang_l, p.res);
+    break;
+
+  case TL_COUPLED_MICROSTRIP: {
+    cms_result r;
+    m.cms.setSubstrate(s);
+    if (mode == TL_ANALYZE)
+      m.cms.analyze(p.f, p.value, grid.s, grid.l, r);
+    else
+      p.status = m.cms.synthesize(p.f, p.value, grid.Z0o, grid.ang_l, r);
+    p.s = r.s;
+    p.res.w = p.odd.w = r.w;
+    p.res.l = p.odd.l = r.l;
+    p.res.skindepth = p.odd.skindepth = r.skindepth;
+    p.res.Z0 = r.Z0e;
+    p.res.ang_l = r.ang_l_e;
+    p.res.er_eff = r.er_eff_e;
+    p.res.atten_cond = r.atten_cond_e;
+    p.res.atten_dielectric = r.atten_dielectric_e;
+    p.odd.Z0 = r.Z0o;
+    p.odd.ang_l = r.ang_l_o;
+    p.odd.er_eff = r.er_eff_o;
+    p.odd.atten_cond = r.atten_cond_o;
+    p.odd.atten_dielectric = r.atten_dielectric_o;
+    break;
+  }
+
+  case TL_COPLANAR:
+  case TL_GROUNDED_COPLANAR: {
+    cpw_model & cpw = type == TL_COPLANAR ? m.cpw : m.gcpw;
+    cpw_result r;
+    cpw.setSubstrate(s);
+    if (mode == TL_ANALYZE) {
+      cpw.analyze(p.f, p.value, grid.s, grid.l, r);
+    } else {
+      /* start from a line as wide as the gap */
+      r.w = grid.s;
+      r.s = grid.s;
+      r.l = 0.0;
+      p.status = cpw.synthesize(p.f, p.value, grid.ang_l, true, r);
+    }
+    p.res.w = r.w;
+    p.res.l = r.l;
+    p.res.Z0 = r.Z0;
+    p.res.ang_l = r.ang_l;
+    p.res.er_eff = r.er_eff;
+    p.res.atten_cond = r.atten_cond;
+    p.res.atten_dielectric = r.atten_dielectric;
+    p.res.skindepth = r.skindepth;
+    break;
+  }
+
+  case TL_COAX: {
+    coax_result r;
+    m.coax.setSubstrate(s);
+    if (mode == TL_ANALYZE) {
+      m.coax.analyze(p.f, p.value, grid.s, grid.l, r);
+    } else {
+      r.din = 0.0;
+      r.dout = grid.s;
+      p.status = m.coax.synthesize(p.f, p.value, grid.ang_l, true, r);
+    }
+    p.res.w = r.din;
+    p.res.l = r.l;
+    p.res.Z0 = r.Z0;
+    p.res.ang_l = r.ang_l;
+    p.res.er_eff = s.er;
+    p.res.atten_cond = r.atten_cond;
+    p.res.atten_dielectric = r.atten_dielectric;
+    p.res.skindepth = r.skindepth;
+    break;
+  }
+
+  case TL_RECTWAVEGUIDE: {
+    rwg_result r;
+    m.rwg.setSubstrate(s);
+    if (mode == TL_ANALYZE) {
+      m.rwg.analyze(p.f, p.value, grid.s, grid.l, r);
+    } else {
+      r.a = 0.0;
+      r.b = grid.s;
+      p.status = m.rwg.synthesize(p.f, p.value, grid.ang_l, false, r);
+    }
+    p.res.w = r.a;
+    p.res.l = r.l;
+    p.res.Z0 = r.Z0;
+    p.res.ang_l = r.ang_l;
+    p.res.er_eff = r.er_eff;
+    p.res.atten_cond = r.atten_cond;
+    p.res.atten_dielectric = r.atten_dielectric;
+    p.res.skindepth = r.skindepth;
+    break;
+  }
+  }
+}
+
+
+/*
+ * tl_sweep() - compute a grid of lines.  The grid is split into
+ * contiguous slices, each worker owns its own model instances.
+ */
+std::vector<tl_grid_point> tl_sweep(tl_type type, const tl_substrate & sub,
+                                    const tl_grid & grid, tl_mode mode,
+                                    unsigned int threads)
+{
+  std::vector<tl_grid_point> points;
+  points.reserve(grid.value.size() * grid.h.size() *
+                 grid.er.size() * grid.f.size());
+
+  for (double value : grid.value)
+    for (double h : grid.h)
+      for (double er : grid.er)
+        for (double f : grid.f) {
+          tl_grid_point p;
+          p.value = value;
+          p.h = h;
+          p.er = er;
+          p.f = f;
+          p.s = grid.s;
+          p.status = 0;
+          points.push_back(p);
+        }
+
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<size_t>(threads, std::max<size_t>(1, points.size()));
+
+  auto worker = [&](size_t begin, size_t end) {
+    tl_models models;
+    tl_substrate s = sub;
+    double w_prev = 0.0;
+    for (size_t i = begin; i < end; i++) {
+      tl_grid_point & p = points[i];
+      s.h = p.h;
+      s.er = p.er;
+      /* neighbouring points differ in frequency only, the previous
+         microstrip width is a much better start value than the closed
+         form */
+      bool warm = mode == TL_SYNTHESIZE && i > begin &&
+        points[i - 1].value == p.value && points[i - 1].h == p.h &&
+        points[i - 1].er == p.er && points[i - 1].status == 0;
+      sweep_point(type, models, s, grid, mode, p, warm ? w_prev : 0.0);
+      /* out of range combinations end up as NaN or as a cut off
+         waveguide without impedance */
+      if (!std::isfinite(p.res.Z0) || !std::isfinite(p.res.w) ||
+          !std::isfinite(p.res.l) || !std::isfinite(p.s) ||
+          p.res.Z0 <= 0.0 || p.res.w <= 0.0)
+        p.status = -1;
+      w_prev = p.res.w;
+    }
+  };
+
+  std::vector<std::thread> pool;
+  size_t chunk = (points.size() + threads - 1) / threads;
+  for (size_t begin = 0; begin < points.size(); begin += chunk)
+    pool.emplace_back(worker, begin, std::min(points.size(), begin + chunk));
+  for (std::thread & t : pool)
+    t.join();
+
+  return points;
+}
+
+std::vector<tl_grid_point> ms_sweep(const tl_substrate & sub,
+                                    const tl_grid & grid, tl_mode mode,
+                                    unsigned int threads)
+{
+  return tl_sweep(TL_MICROSTRIP, sub, grid, mode, threads);
+}
+
+
+/*
+ * quantize() - map a value onto an integer with about nine
+ * significant digits, the order of positive values is preserved
+ */
+static long long quantize(double v)
+{
+  int exp;
+  double m = frexp(v, &exp);
+  return exp * (1LL << 32) + llround(m * 2147483648.0);
+}
+
+
+ms_synth_cache & ms_synth_cache::instance()
+{
+  static ms_synth_cache cache;
+  return cache;
+}
+
+
+void ms_synth_cache::clear()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  table.clear();
+  n_entries = 0;
+  n_hits = 0;
+  n_misses = 0;
+}
+
+
+size_t ms_synth_cache::size()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return n_entries;
+}
+
+
+/*
+ * synthesize() - width and effective dielectric constant for the
+ * given impedance, from the memo table if possible
+ */
+int ms_synth_cache::synthesize(const tl_substrate & sub, double f,
+                               double Z0, double & w, double & er_eff,
+                               double tolerance)
+{
+  line_key key = {{ quantize(sub.er), quantize(sub.mur), quantize(sub.h),
+                    quantize(sub.ht), quantize(sub.t), quantize(sub.sigma),
+                    quantize(sub.tand), quantize(sub.rough), quantize(f) }};
+  long long z0_key = quantize(Z0);
+  double w_start = 0.0;
+
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    z0_table & line = table[key];
+    z0_table::iterator it = line.lower_bound(z0_key);
+    if (it != line.end() && it->first == z0_key &&
+        it->second.tolerance <= tolerance) {
+      n_hits++;
+      w = it->second.w;
+      er_eff = it->second.er_eff;
+      return it->second.status;
+    }
+    n_misses++;
+
+    /* nearest impedance on this line is the warm start */
+    z0_table::iterator near = line.end();
+    if (it != line.end())
+      near = it;
+    if (it != line.begin()) {
+      z0_table::iterator below = std::prev(it);
+      if (near == line.end() || z0_key - below->first < near->first - z0_key)
+        near = below;
+    }
+    if (near != line.end() && near->second.status == 0)
+      w_start = near->second.w;
+  }
+
+  /* solve outside the lock, other threads may use the table */
+  ms_model ms;
+  tl_result res;
+  ms.setSubstrate(sub);
+  int status = ms.synthesize(f, Z0, 0.0, res, w_start, tolerance);
+  if (status != 0 && w_start > 0.0)
+    status = ms.synthesize(f, Z0, 0.0, res, 0.0, tolerance);
+
+  w = res.w;
+  er_eff = res.er_eff;
+
+  std::lock_guard<std::mutex> guard(lock);
+  z0_table & line = table[key];
+  if (line.find(z0_key) == line.end()) {
+    if (n_entries >= max_entries) {
+      /* full, start over rather than grow without bound */
+      table.clear();
+      n_entries = 0;
+    }
+    n_entries++;
+  }
+  entry & e = table[key][z0_key];
+  e.w = w;
+  e.er_eff = er_eff;
+  e.tolerance = tolerance;
+  e.status = status;
+  return status;
+}
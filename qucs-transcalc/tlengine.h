@@ -0,0 +1,493 @@
+/*
+ * tlengine.h - headless transmission line calculator engine
+ *
+ * Copyright (C) 2001 Gopal Narayanan <gopal@astro.umass.edu>
+ * Copyright (C) 2005 Stefan Jahn <stefan@lkcc.org>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef __TLENGINE_H
+#define __TLENGINE_H
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/* The engine does not depend on Qt or on the QucsTranscalc window.
+   All values are passed in SI units (m, Hz, Ohm, rad, S/m). */
+
+/* Substrate and metallization description. */
+struct tl_substrate {
+  double er;			/* dielectric constant */
+  double mur;			/* mag. permeability */
+  double h;			/* height of substrate */
+  double ht;			/* height to the top of box */
+  double t;			/* thickness of top metal */
+  double sigma;			/* conductivity of the metal */
+  double tand;			/* dielectric loss tangent */
+  double rough;			/* roughness of top metal */
+};
+
+/* Results of a single line computation. */
+struct tl_result {
+  double w;			/* width of line */
+  double l;			/* length of line */
+  double Z0;			/* characteristic impedance */
+  double ang_l;			/* electrical length in angle */
+  double er_eff;		/* effective dielectric constant */
+  double atten_cond;		/* loss in conductors (dB) */
+  double atten_dielectric;	/* loss in dielectric (dB) */
+  double skindepth;		/* skin depth */
+};
+
+/* Returns a substrate with the transcalc defaults and no cover. */
+tl_substrate tl_default_substrate ();
+
+/* Converts the tSubstrate structure of the RF design tools (filter,
+   matching, power combining), which give resistivity instead of
+   conductivity. */
+template <class T>
+tl_substrate tl_substrate_from (const T * s)
+{
+  tl_substrate sub = tl_default_substrate ();
+  sub.er = s->er;
+  sub.h = s->height;
+  sub.t = s->thickness;
+  sub.tand = s->tand;
+  sub.rough = s->roughness;
+  if (s->resistivity > 0.0)
+    sub.sigma = 1.0 / s->resistivity;
+  return sub;
+}
+
+/* Microstrip model (Hammerstad/Jensen static, Kirschning/Jansen
+   dispersion).  The state members are public so that other line
+   models (e.g. c_microstrip) can reuse partial results. */
+class ms_model {
+ public:
+  ms_model ();
+
+  void setSubstrate (const tl_substrate &);
+  void analyze (double f, double w, double l, tl_result &);
+  int  synthesize (double f, double Z0, double ang_l, tl_result &,
+		   double w_start = 0.0, double tolerance = 1e-6);
+  double impedance (double f, double w);
+
+  double f;			/* frequency of operation */
+  double sigma;			/* conductivity of the metal */
+  double mur;			/* mag. permeability */
+  double skindepth;		/* skin depth */
+  double er;			/* dielectric constant */
+  double h;			/* height of substrate */
+  double ht;			/* height to the top of box */
+  double t;			/* thickness of top metal */
+  double tand;			/* dielectric loss tangent */
+  double rough;			/* roughness of top metal */
+  double w;			/* width of line */
+  double l;			/* length of line */
+  double Z0_0;			/* static characteristic impedance */
+  double Z0;			/* characteristic impedance */
+  double ang_l;			/* electrical length in angle */
+  double er_eff_0;		/* static effective dielectric constant */
+  double er_eff;		/* effective dielectric constant */
+  double mur_eff;		/* effective mag. permeability */
+  double w_eff;			/* effective width of line */
+  double atten_dielectric;	/* loss in dielectric (dB) */
+  double atten_cond;		/* loss in conductors (dB) */
+  double Z0_h_1;		/* homogeneous stripline impedance */
+
+  void microstrip_Z0 ();
+  void dispersion ();
+  void calc ();
+  double synth_width ();
+  double delta_q_thickness (double, double);
+
+ private:
+  double skin_depth ();
+  double Z0_homogeneous (double);
+  double delta_Z0_cover (double, double);
+  double filling_factor (double, double);
+  double delta_q_cover (double);
+  double e_r_effective (double, double);
+  double delta_u_thickness (double, double, double);
+  double e_r_dispersion (double, double, double);
+  double Z0_dispersion (double, double, double, double, double);
+  double conductor_losses ();
+  double dielectric_losses ();
+  void attenuation ();
+  void mur_eff_ms ();
+  void line_angle ();
+  void fill_result (tl_result &);
+};
+
+/* Coupled microstrip model (Kirschning/Jansen even- and odd-mode).
+   The single line parts are computed by an auxiliary ms_model. */
+struct cms_result {
+  double w;			/* width of lines */
+  double s;			/* spacing of lines */
+  double l;			/* length of lines */
+  double Z0e;			/* even-mode impedance */
+  double Z0o;			/* odd-mode impedance */
+  double ang_l_e;		/* even-mode electrical length in angle */
+  double ang_l_o;		/* odd-mode electrical length in angle */
+  double er_eff_e;		/* even-mode effective dielectric constant */
+  double er_eff_o;		/* odd-mode effective dielectric constant */
+  double atten_cond_e;		/* even-mode conductors losses (dB) */
+  double atten_cond_o;		/* odd-mode conductors losses (dB) */
+  double atten_dielectric_e;	/* even-mode dielectric losses (dB) */
+  double atten_dielectric_o;	/* odd-mode dielectric losses (dB) */
+  double skindepth;		/* skin depth */
+};
+
+class cms_model {
+ public:
+  cms_model ();
+
+  void setSubstrate (const tl_substrate &);
+  void analyze (double f, double w, double s, double l, cms_result &);
+  int  synthesize (double f, double Z0e, double Z0o, double ang_l,
+		   cms_result &);
+
+ private:
+  ms_model aux_ms;		/* single line of the same width */
+  double f;			/* frequency of operation */
+  double sigma;			/* conductivity of the metal */
+  double mur;			/* mag. permeability */
+  double skindepth;		/* skin depth */
+  double er;			/* dielectric constant */
+  double h;			/* height of substrate */
+  double ht;			/* height to the top of box */
+  double t;			/* thickness of top metal */
+  double tand;			/* dielectric loss tangent */
+  double rough;			/* roughness of top metal */
+  double w;			/* width of lines */
+  double w_t_e;			/* even-mode thickness-corrected line width */
+  double w_t_o;			/* odd-mode thickness-corrected line width */
+  double l;			/* length of lines */
+  double s;			/* spacing of lines */
+  double Z0_e_0;		/* static even-mode impedance */
+  double Z0_o_0;		/* static odd-mode impedance */
+  double Z0e;			/* even-mode impedance */
+  double Z0o;			/* odd-mode impedance */
+  double ang_l_e;		/* even-mode electrical length in angle */
+  double ang_l_o;		/* odd-mode electrical length in angle */
+  double er_eff_e;		/* even-mode effective dielectric constant */
+  double er_eff_o;		/* odd-mode effective dielectric constant */
+  double er_eff_e_0;		/* static even-mode effective dielectric constant */
+  double er_eff_o_0;		/* static odd-mode effective dielectric constant */
+  double mur_eff;		/* effective mag. permeability */
+  double atten_dielectric_e;	/* even-mode dielectric losses (dB) */
+  double atten_cond_e;		/* even-mode conductors losses (dB) */
+  double atten_dielectric_o;	/* odd-mode dielectric losses (dB) */
+  double atten_cond_o;		/* odd-mode conductors losses (dB) */
+
+  double delta_u_thickness_single (double, double);
+  void delta_u_thickness ();
+  void compute_single_line ();
+  double filling_factor_even (double, double, double);
+  double filling_factor_odd (double, double, double);
+  double delta_q_cover_even (double);
+  double delta_q_cover_odd (double);
+  void er_eff_static ();
+  double delta_Z0_even_cover (double, double, double);
+  double delta_Z0_odd_cover (double, double, double);
+  void Z0_even_odd ();
+  double calc_mur_eff ();
+  void er_eff_freq ();
+  void conductor_losses ();
+  void dielectric_losses ();
+  void attenuation ();
+  void line_angle ();
+  void syn_err_fun (double *, double *, double, double, double, double,
+		    double);
+  void synth_width ();
+  void Z0_dispersion ();
+  void calc ();
+  void syn_fun (double *, double *, double, double, double, double);
+  void fill_result (cms_result &);
+};
+
+/* Symmetric stripline model (Cam Nguyen, "Analysis Methods for RF,
+   Microwave and Millimeter-Wave Planar Transmission Line Structures").
+   The substrate height h is the distance between the ground planes. */
+class sl_model {
+ public:
+  sl_model ();
+
+  void setSubstrate (const tl_substrate &);
+  void analyze (double f, double w, double l, tl_result &);
+  int  synthesize (double f, double Z0, double ang_l, tl_result &);
+  double impedance (double w);
+
+ private:
+  double f;			/* frequency of operation */
+  double sigma;			/* conductivity of the metal */
+  double mur;			/* mag. permeability */
+  double er;			/* dielectric constant */
+  double h;			/* substrate height */
+  double t;			/* thickness */
+  double tand;			/* dielectric loss tangent */
+  double w;			/* width of the conductor strip */
+  double l;			/* length of line */
+  double Z0;			/* characteristic impedance */
+  double ang_l;			/* electrical length in angle */
+  double skindepth;		/* skin depth */
+
+  double alphad ();
+  double alphac ();
+  void fill_result (tl_result &);
+};
+
+/* Coplanar waveguide with (grounded) or without metal on the backside
+   of the substrate (quasi-static conformal mapping, Ghione losses). */
+struct cpw_result {
+  double w;			/* width of line */
+  double s;			/* width of gap between line and ground */
+  double l;			/* length of line */
+  double Z0;			/* characteristic impedance */
+  double ang_l;			/* electrical length in angle */
+  double er_eff;		/* effective dielectric constant */
+  double atten_cond;		/* loss in conductors (dB) */
+  double atten_dielectric;	/* loss in dielectric (dB) */
+  double skindepth;		/* skin depth */
+};
+
+class cpw_model {
+ public:
+  cpw_model (bool backMetal = false);
+
+  void setSubstrate (const tl_substrate &);
+  void analyze (double f, double w, double s, double l, cpw_result &);
+  /* Solves for the width if 'solve_w' is set, for the gap otherwise.
+     The other dimension is taken from the result structure. */
+  int  synthesize (double f, double Z0, double ang_l, bool solve_w,
+		   cpw_result &);
+
+ private:
+  bool backMetal;		/* backside is metal */
+  double f;			/* frequency of operation */
+  double sigma;			/* conductivity of the metal */
+  double mur;			/* mag. permeability */
+  double er;			/* dielectric constant */
+  double h;			/* height of substrate */
+  double t;			/* thickness of top metal */
+  double tand;			/* dielectric loss tangent */
+  double w;			/* width of line */
+  double s;			/* width of gap between line and ground */
+  double len;			/* length of line */
+  double Z0;			/* characteristic impedance */
+  double er_eff;		/* effective dielectric constant */
+  double ang_l;			/* electrical length in angle */
+  double atten_dielectric;	/* loss in dielectric (dB) */
+  double atten_cond;		/* loss in conductors (dB) */
+  double skindepth;		/* skin depth */
+
+  void calc ();
+  void fill_result (cpw_result &);
+  static double ellipk (double);
+  static double KoverKp (double);
+};
+
+/* Coaxial line, the dielectric fills the space between the
+   conductors. */
+struct coax_result {
+  double din;			/* inner diameter of cable */
+  double dout;			/* outer diameter of cable */
+  double l;			/* length of cable */
+  double Z0;			/* characteristic impedance */
+  double ang_l;			/* electrical length in angle */
+  double atten_cond;		/* loss in conductors (dB) */
+  double atten_dielectric;	/* loss in dielectric (dB) */
+  double skindepth;		/* skin depth */
+};
+
+class coax_model {
+ public:
+  coax_model ();
+
+  void setSubstrate (const tl_substrate &);
+  void analyze (double f, double din, double dout, double l, coax_result &);
+  /* Solves for the inner diameter if 'solve_din' is set, for the outer
+     one otherwise.  The other diameter is taken from the result
+     structure. */
+  int  synthesize (double f, double Z0, double ang_l, bool solve_din,
+		   coax_result &);
+  /* cutoff frequencies of the TE(n,m) and TM(n,m) modes */
+  double fc_te (int m);
+  double fc_tm (int m);
+
+ private:
+  double f;			/* frequency of operation */
+  double sigma;			/* conductivity of the metal */
+  double mur;			/* mag. permeability */
+  double er;			/* dielectric constant */
+  double tand;			/* dielectric loss tangent */
+  double din;			/* inner diameter of cable */
+  double dout;			/* outer diameter of cable */
+  double l;			/* length of cable */
+
+  double alphad ();
+  double alphac ();
+  void fill_result (double Z0, double ang_l, coax_result &);
+};
+
+/* Rectangular waveguide, TE(1,0) fundamental mode. */
+struct rwg_result {
+  double a;			/* width of waveguide */
+  double b;			/* height of waveguide */
+  double l;			/* length of waveguide */
+  double Z0;			/* characteristic impedance */
+  double ang_l;			/* electrical length in angle */
+  double er_eff;		/* effective dielectric constant */
+  double atten_cond;		/* loss in conductors (dB) */
+  double atten_dielectric;	/* loss in dielectric (dB) */
+  double skindepth;		/* skin depth */
+};
+
+class rwg_model {
+ public:
+  rwg_model ();
+
+  void setSubstrate (const tl_substrate &);
+  void analyze (double f, double a, double b, double l, rwg_result &);
+  /* Solves for the height if 'solve_b' is set, for the width
+     otherwise.  The other dimension is taken from the result
+     structure.  Returns -1 if the guide is cut off. */
+  int  synthesize (double f, double Z0, double ang_l, bool solve_b,
+		   rwg_result &);
+  /* cutoff frequency of the TE(m,n) and TM(m,n) modes */
+  double fc (int m, int n);
+
+ private:
+  double f;			/* frequency of operation */
+  double sigma;			/* conductivity of the metal */
+  double mur;			/* mag. permeability */
+  double er;			/* dielectric constant */
+  double tand;			/* dielectric loss tangent */
+  double a;			/* width of waveguide */
+  double b;			/* height of waveguide */
+  double l;			/* length of waveguide */
+
+  double kval ();
+  double kc (int, int);
+  double alphac ();
+  double alphac_cutoff ();
+  double alphad ();
+  void fill_result (rwg_result &);
+};
+
+/* Line types known to the sweep. */
+enum tl_type {
+  TL_MICROSTRIP,
+  TL_COUPLED_MICROSTRIP,
+  TL_STRIPLINE,
+  TL_COPLANAR,
+  TL_GROUNDED_COPLANAR,
+  TL_COAX,
+  TL_RECTWAVEGUIDE
+};
+
+/* One point of a parameter grid.  For analysis 'value' is the first
+   dimension of the line (width, inner diameter of coax, width of
+   waveguide), for synthesis it is the wanted characteristic impedance
+   (even-mode impedance of coupled lines).  The result 'res.w' holds
+   the first dimension, 's' the second one (gap of coplanar lines,
+   spacing of coupled lines, outer diameter of coax, height of
+   waveguide).  For coupled lines 'res' describes the even mode and
+   'odd' the odd mode. */
+struct tl_grid_point {
+  double value;
+  double h;
+  double er;
+  double f;
+  double s;
+  tl_result res;
+  tl_result odd;
+  int status;			/* 0 on success, -1 if not converged or no
+				   valid line (NaN, cut off waveguide) */
+};
+
+/* Parameter grid, the cartesian product of all four axes is computed.
+   'ang_l' is the electrical length used for synthesis, 'l' the
+   physical length used for analysis.  's' is the fixed second
+   dimension, it is not used when synthesizing coupled lines, which
+   take the odd-mode impedance from 'Z0o' instead.  The substrate
+   height is not used by coax and waveguides. */
+struct tl_grid {
+  std::vector<double> value;
+  std::vector<double> h;
+  std::vector<double> er;
+  std::vector<double> f;
+  double l;
+  double ang_l;
+  double s;
+  double Z0o;
+};
+
+enum tl_mode { TL_ANALYZE, TL_SYNTHESIZE };
+
+/* Computes all points of the grid on 'threads' worker threads (0 means
+   one per hardware thread).  Results are ordered with the frequency
+   varying fastest, then er, h and value. */
+std::vector<tl_grid_point> tl_sweep (tl_type, const tl_substrate &,
+				     const tl_grid &, tl_mode,
+				     unsigned int threads = 0);
+std::vector<tl_grid_point> ms_sweep (const tl_substrate &, const tl_grid &,
+				     tl_mode, unsigned int threads = 0);
+
+/* Memo table for microstrip width synthesis.  Generated networks
+   (multistage Wilkinson, tree combiners, filters) ask for the same
+   impedance on the same substrate many times.  Solutions are keyed on
+   the substrate, the frequency and the impedance, all quantized to
+   about nine significant digits.  A miss is solved by Newton's method
+   started from the cached width of the nearest impedance on the same
+   substrate and frequency.  The table holds at most max_entries
+   solutions, it is emptied when it is full. */
+class ms_synth_cache {
+ public:
+  static ms_synth_cache & instance ();
+
+  int synthesize (const tl_substrate &, double f, double Z0,
+		  double & w, double & er_eff, double tolerance = 1e-7);
+  void clear ();
+  size_t size ();
+  unsigned long hits () const { return n_hits; }
+  unsigned long misses () const { return n_misses; }
+
+  static const size_t max_entries = 65536;
+
+ private:
+  struct entry {
+    double w;
+    double er_eff;
+    double tolerance;
+    int status;
+  };
+  typedef std::array<long long, 9> line_key;
+  typedef std::map<long long, entry> z0_table;
+
+  std::mutex lock;
+  std::map<line_key, z0_table> table;
+  size_t n_entries = 0;
+  std::atomic<unsigned long> n_hits {0};
+  std::atomic<unsigned long> n_misses {0};
+};
+
+#endif /* __TLENGINE_H */
@@ -0,0 +1,353 @@
+/*
+ * tlsweep.cpp - command line transmission line sweep, writes CSV lookup
+ * tables
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+
+#include "tlengine.h"
+
+static void usage (const char * prog)
+{
+  fprintf (stderr,
+    "Usage: %s [options]\n"
+    "Computes transmission lines over a parameter grid and prints a CSV table.\n"
+    "Lists are given as 'a,b,c' or as 'start:stop:points'.  SI units.\n\n"
+    "  -T, --type NAME      microstrip (default), coupled, stripline, coplanar,\n"
+    "                       gcoplanar, coax or waveguide\n"
+    "  -a, --analyze        analyze widths given by -W (default)\n"
+    "  -s, --synthesize     synthesize widths for impedances given by -Z\n"
+    "  -W, --width LIST     line widths in m (inner diameters of coax, widths\n"
+    "                       of waveguides)\n"
+    "  -Z, --z0 LIST        characteristic impedances in Ohm (even-mode\n"
+    "                       impedances of coupled lines)\n"
+    "  -S, --spacing VALUE  gap of coplanar lines, spacing of coupled lines,\n"
+    "                       outer diameter of coax, height of waveguides in m\n"
+    "      --z0o VALUE      odd-mode impedance for coupled line synthesis\n"
+    "  -H, --height LIST    substrate heights in m\n"
+    "  -e, --er LIST        dielectric constants\n"
+    "  -f, --freq LIST      frequencies in Hz\n"
+    "  -l, --length VALUE   physical length in m for analysis (1e-3)\n"
+    "  -A, --angle VALUE    electrical length in deg for synthesis (90)\n"
+    "  -t, --thickness V    metal thickness in m (0)\n"
+    "      --ht VALUE       height to the top of box in m (1e20)\n"
+    "      --cond VALUE     metal conductivity in S/m (4.1e7)\n"
+    "      --tand VALUE     dielectric loss tangent (0)\n"
+    "      --rough VALUE    metal roughness in m (0)\n"
+    "      --mur VALUE      magnetic permeability (1)\n"
+    "  -j, --threads N      number of worker threads (all cores)\n"
+    "  -o, --output FILE    write table to FILE instead of stdout\n\n"
+    "Rows that did not converge or have no valid solution, e.g. a waveguide\n"
+    "below cutoff, get a non-zero Status and the exit code is 2.\n",
+    prog);
+}
+
+/* Parses 'a,b,c' or 'start:stop:points' into a list of values. */
+static bool parseList (const char * text, std::vector<double> & list)
+{
+  double start, stop;
+  int points;
+  char dummy;
+
+  list.clear ();
+  if (sscanf (text, "%lf:%lf:%d%c", &start, &stop, &points, &dummy) == 3) {
+    if (points < 1) return false;
+    for (int i = 0; i < points; i++)
+      list.push_back (points > 1 ?
+		      start + (stop - start) * i / (points - 1) : start);
+    return true;
+  }
+
+  const char * p = text;
+  while (*p) {
+    char * end;
+    double v = strtod (p, &end);
+    if (end == p) return false;
+    list.push_back (v);
+    p = end;
+    if (*p == ',') p++;
+    else if (*p) return false;
+  }
+  return !list.empty ();
+}
+
+static bool parseValue (const char * text, double & value)
+{
+  char * end;
+  value = strtod (text, &end);
+  return end != text && *end == '\0';
+}
+
+static const struct {
+  const char * name;
+  tl_type type;
+} types[] = {
+  { "microstrip", TL_MICROSTRIP },
+  { "coupled",    TL_COUPLED_MICROSTRIP },
+  { "stripline",  TL_STRIPLINE },
+  { "coplanar",   TL_COPLANAR },
+  { "gcoplanar",  TL_GROUNDED_COPLANAR },
+  { "coax",       TL_COAX },
+  { "waveguide",  TL_RECTWAVEGUIDE },
+};
+
+static bool parseType (const char * text, tl_type & type)
+{
+  for (const auto & t : types) {
+    if (!strcmp (text, t.name)) {
+      type = t.type;
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Prints the CSV header, the columns depend on the line type. */
+static void printHeader (FILE * out, tl_type type)
+{
+  switch (type) {
+  case TL_MICROSTRIP:
+  case TL_STRIPLINE:
+    fprintf (out, "W,H,Er,Freq,Z0,Er_eff,L,Ang_l,Atten_cond,Atten_diel,"
+	     "Skindepth,Status\n");
+    break;
+  case TL_COPLANAR:
+  case TL_GROUNDED_COPLANAR:
+    fprintf (out, "W,S,H,Er,Freq,Z0,Er_eff,L,Ang_l,Atten_cond,Atten_diel,"
+	     "Skindepth,Status\n");
+    break;
+  case TL_COUPLED_MICROSTRIP:
+    fprintf (out, "W,S,H,Er,Freq,Z0e,Z0o,Er_eff_e,Er_eff_o,L,Ang_l_e,"
+	     "Ang_l_o,Atten_cond_e,Atten_cond_o,Atten_diel_e,Atten_diel_o,"
+	     "Skindepth,Status\n");
+    break;
+  case TL_COAX:
+    fprintf (out, "Din,Dout,Er,Freq,Z0,Er_eff,L,Ang_l,Atten_cond,"
+	     "Atten_diel,Skindepth,Status\n");
+    break;
+  case TL_RECTWAVEGUIDE:
+    fprintf (out, "A,B,Er,Freq,Z0,Er_eff,L,Ang_l,Atten_cond,Atten_diel,"
+	     "Skindepth,Status\n");
+    break;
+  }
+}
+
+static void printPoint (FILE * out, tl_type type, const tl_grid_point & p)
+{
+  const tl_result & r = p.res;
+  double deg = 180.0 / M_PI;
+
+  switch (type) {
+  case TL_MICROSTRIP:
+  case TL_STRIPLINE:
+    fprintf (out, "%.9g,%.9g,%.9g,%.9g,", r.w, p.h, p.er, p.f);
+    break;
+  case TL_COPLANAR:
+  case TL_GROUNDED_COPLANAR:
+  case TL_COUPLED_MICROSTRIP:
+    fprintf (out, "%.9g,%.9g,%.9g,%.9g,%.9g,", r.w, p.s, p.h, p.er, p.f);
+    break;
+  case TL_COAX:
+  case TL_RECTWAVEGUIDE:
+    fprintf (out, "%.9g,%.9g,%.9g,%.9g,", r.w, p.s, p.er, p.f);
+    break;
+  }
+
+  if (type == TL_COUPLED_MICROSTRIP)
+    fprintf (out, "%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,"
+	     "%.9g,%.9g,%d\n", r.Z0, p.odd.Z0, r.er_eff, p.odd.er_eff, r.l,
+	     r.ang_l * deg, p.odd.ang_l * deg, r.atten_cond,
+	     p.odd.atten_cond, r.atten_dielectric, p.odd.atten_dielectric,
+	     r.skindepth, p.status);
+  else
+    fprintf (out, "%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%d\n", r.Z0,
+	     r.er_eff, r.l, r.ang_l * deg, r.atten_cond,
+	     r.atten_dielectric, r.skindepth, p.status);
+}
+
+/* Checks that all values of a list are above 'min' (or at least 'min'
+   if 'equal' is set), reports the first offending value. */
+static bool checkRange (const char * prog, const char * what,
+			const std::vector<double> & list, double min,
+			bool equal = false)
+{
+  for (double v : list) {
+    if (!std::isfinite (v) || v < min || (v == min && !equal)) {
+      fprintf (stderr, "%s: %s must be %s %g, got %g\n", prog, what,
+	       equal ? "at least" : "greater than", min, v);
+      return false;
+    }
+  }
+  return true;
+}
+
+int main (int argc, char ** argv)
+{
+  tl_substrate sub = tl_default_substrate ();
+  tl_grid grid;
+  tl_mode mode = TL_ANALYZE;
+  tl_type type = TL_MICROSTRIP;
+  unsigned int threads = 0;
+  const char * output = NULL;
+  double angle = 90.0;
+  bool ok = true;
+
+  grid.l = 1e-3;
+  grid.s = 0.0;
+  grid.Z0o = 0.0;
+  grid.h.push_back (sub.h);
+  grid.er.push_back (sub.er);
+  grid.f.push_back (1e9);
+
+  for (int i = 1; i < argc; i++) {
+    const char * opt = argv[i];
+    const char * arg = (i + 1 < argc) ? argv[i + 1] : NULL;
+    auto is = [opt] (const char * s, const char * l) {
+      return (s && !strcmp (opt, s)) || !strcmp (opt, l);
+    };
+
+    if (is ("-h", "--help")) {
+      usage (argv[0]);
+      return 0;
+    }
+    else if (is ("-a", "--analyze"))    { mode = TL_ANALYZE; continue; }
+    else if (is ("-s", "--synthesize")) { mode = TL_SYNTHESIZE; continue; }
+
+    if (!arg) {
+      fprintf (stderr, "%s: missing argument for `%s'\n", argv[0], opt);
+      return 1;
+    }
+    i++;
+    if (is ("-T", "--type"))
+      ok = parseType (arg, type);
+    else if (is ("-W", "--width") || is ("-Z", "--z0"))
+      ok = parseList (arg, grid.value);
+    else if (is ("-S", "--spacing")) ok = parseValue (arg, grid.s);
+    else if (is (NULL, "--z0o"))     ok = parseValue (arg, grid.Z0o);
+    else if (is ("-H", "--height"))  ok = parseList (arg, grid.h);
+    else if (is ("-e", "--er"))      ok = parseList (arg, grid.er);
+    else if (is ("-f", "--freq"))    ok = parseList (arg, grid.f);
+    else if (is ("-l", "--length"))  ok = parseValue (arg, grid.l);
+    else if (is ("-A", "--angle"))   ok = parseValue (arg, angle);
+    else if (is ("-t", "--thickness")) ok = parseValue (arg, sub.t);
+    else if (is (NULL, "--ht"))      ok = parseValue (arg, sub.ht);
+    else if (is (NULL, "--cond"))    ok = parseValue (arg, sub.sigma);
+    else if (is (NULL, "--tand"))    ok = parseValue (arg, sub.tand);
+    else if (is (NULL, "--rough"))   ok = parseValue (arg, sub.rough);
+    else if (is (NULL, "--mur"))     ok = parseValue (arg, sub.mur);
+    else if (is ("-j", "--threads")) threads = (unsigned int) atoi (arg);
+    else if (is ("-o", "--output"))  output = arg;
+    else {
+      fprintf (stderr, "%s: unknown option `%s'\n", argv[0], opt);
+      usage (argv[0]);
+      return 1;
+    }
+    if (!ok) {
+      fprintf (stderr, "%s: invalid value `%s' for `%s'\n", argv[0], arg, opt);
+      return 1;
+    }
+  }
+
+  if (grid.value.empty ()) {
+    fprintf (stderr, "%s: no %s given\n", argv[0],
+	     mode == TL_ANALYZE ? "widths (-W)" : "impedances (-Z)");
+    return 1;
+  }
+  bool coupled = type == TL_COUPLED_MICROSTRIP;
+  if (type != TL_MICROSTRIP && type != TL_STRIPLINE &&
+      !(coupled && mode == TL_SYNTHESIZE) && grid.s == 0.0) {
+    fprintf (stderr, "%s: no %s given (-S)\n", argv[0],
+	     type == TL_COAX ? "outer diameter" :
+	     type == TL_RECTWAVEGUIDE ? "waveguide height" :
+	     coupled ? "spacing" : "gap");
+    return 1;
+  }
+  if (coupled && mode == TL_SYNTHESIZE && grid.Z0o == 0.0) {
+    fprintf (stderr, "%s: no odd-mode impedance given (--z0o)\n", argv[0]);
+    return 1;
+  }
+
+  /* the models divide by or take the logarithm of these, a value out
+     of range gives NaN rows instead of an error */
+  const char * prog = argv[0];
+  ok = checkRange (prog, mode == TL_ANALYZE ? "width" : "impedance",
+		   grid.value, 0.0) &&
+    checkRange (prog, "substrate height", grid.h, 0.0) &&
+    checkRange (prog, "dielectric constant", grid.er, 1.0, true) &&
+    checkRange (prog, "frequency", grid.f, 0.0) &&
+    checkRange (prog, "length", { grid.l }, 0.0, true) &&
+    checkRange (prog, "conductivity", { sub.sigma }, 0.0) &&
+    checkRange (prog, "permeability", { sub.mur }, 0.0) &&
+    checkRange (prog, "thickness", { sub.t }, 0.0, true) &&
+    checkRange (prog, "loss tangent", { sub.tand }, 0.0, true) &&
+    checkRange (prog, "roughness", { sub.rough }, 0.0, true) &&
+    checkRange (prog, "box height", { sub.ht }, 0.0);
+  if (ok && (type != TL_MICROSTRIP && type != TL_STRIPLINE &&
+	     !(coupled && mode == TL_SYNTHESIZE)))
+    ok = checkRange (prog, "spacing", { grid.s }, 0.0);
+  if (ok && coupled && mode == TL_SYNTHESIZE)
+    ok = checkRange (prog, "odd-mode impedance", { grid.Z0o }, 0.0);
+  if (ok && type == TL_STRIPLINE) {
+    /* the strip must have a thickness and fit between the grounds */
+    ok = checkRange (prog, "thickness", { sub.t }, 0.0);
+    for (double h : grid.h) {
+      if (ok && sub.t >= 2.0 * h) {
+	fprintf (stderr, "%s: thickness %g does not fit between ground "
+		 "planes %g apart\n", prog, sub.t, 2.0 * h);
+	ok = false;
+      }
+    }
+  }
+  if (ok && type == TL_COAX && mode == TL_ANALYZE) {
+    for (double d : grid.value) {
+      if (ok && d >= grid.s) {
+	fprintf (stderr, "%s: inner diameter %g is not smaller than the "
+		 "outer one %g\n", prog, d, grid.s);
+	ok = false;
+      }
+    }
+  }
+  if (!ok)
+    return 1;
+  grid.ang_l = angle * M_PI / 180.0;
+
+  FILE * out = stdout;
+  if (output && !(out = fopen (output, "w"))) {
+    fprintf (stderr, "%s: cannot open `%s'\n", argv[0], output);
+    return 1;
+  }
+
+  std::vector<tl_grid_point> points =
+    tl_sweep (type, sub, grid, mode, threads);
+
+  int failed = 0;
+  printHeader (out, type);
+  for (const tl_grid_point & p : points) {
+    printPoint (out, type, p);
+    if (p.status) failed++;
+  }
+
+  if (out != stdout) fclose (out);
+  if (failed)
+    fprintf (stderr, "%s: %d point(s) failed\n", argv[0], failed);
+  return failed ? 2 : 0;
+}
@@ -0,0 +1,350 @@
+/***************************************************************************
+                                 bench.cpp
+                                -----------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+/*!
+ * \file bench.cpp
+ * \brief Benchmarks and self checks, built as a separate program from the
+ *        same sources as the application.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <climits>
+#include <locale.h>
+
+#include <QApplication>
+#include <QString>
+#include <QStringList>
+#include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <QProcess>
+
+#include "main.h"
+#include "misc.h"
+#include "module.h"
+#include "schematic.h"
+#include "syntax.h"
+#include "textdoc.h"
+#include "hdlbuild.h"
+#include "components/symbolgeometry.h"
+#include "extsimkernels/spicecompat.h"
+
+/*!
+ * \brief doValueCheck Compare the fast component value conversion for SPICE
+ *        with its regular expression version on a generated corpus.
+ * \return 0 if they agree on every value
+ */
+static int doValueCheck()
+{
+  QStringList failures;
+  int count = spicecompat::check_normalize_value(failures);
+  for (const QString &f : failures)
+    fprintf(stderr, "%s\n", f.toUtf8().data());
+  fprintf(stdout, "%d values checked, %lld differ\n", count,
+          (long long) failures.size());
+  return failures.isEmpty() ? 0 : 1;
+}
+
+/*!
+ * \brief doLoadBenchmark Write synthetic schematics with a chain of resistors
+ *        and wires and measure how fast they are loaded.
+ * \param elements Number of elements (components plus wires), 0 runs the
+ *        default sizes of 10k and 100k elements
+ */
+static int doLoadBenchmark(int elements)
+{
+  QList<int> sizes;
+  if (elements > 0) sizes.append(elements);
+  else sizes << 10000 << 100000;
+
+  QucsSettings.DefaultSimulator = spicecompat::simNgspice;
+  Module::registerModules();
+
+  for (int size : sizes) {
+    QString fname = QucsSettings.tempFilesDir.filePath(
+                      QStringLiteral("bench_load_%1.sch").arg(size));
+    QFile file(fname);
+    if (!file.open(QIODevice::WriteOnly)) {
+      fprintf(stderr, "Error: Could not write %s\n", fname.toLatin1().data());
+      return 1;
+    }
+    QTextStream stream(&file);
+    stream << "<Qucs Schematic " PACKAGE_VERSION ">\n"
+           << "<Properties>\n</Properties>\n<Symbol>\n</Symbol>\n";
+    // Resistor i is connected to resistor i+1 by a wire, 100 per row
+    int count = size/2;
+    stream << "<Components>\n";
+    for (int i = 0; i < count; i++) {
+      stream << QStringLiteral("  <R R%1 1 %2 %3 15 -26 0 0 \"50 Ohm\" 1>\n")
+                  .arg(i+1).arg(120*(i%100)).arg(120*(i/100));
+    }
+    stream << "</Components>\n<Wires>\n";
+    for (int i = 0; i < count; i++) {
+      int x = 120*(i%100), y = 120*(i/100);
+      stream << QStringLiteral("  <%1 %2 %3 %4 \"\" 0 0 0 \"\">\n")
+                  .arg(x+30).arg(y).arg(x+90).arg(y);
+    }
+    stream << "</Wires>\n<Diagrams>\n</Diagrams>\n<Paintings>\n</Paintings>\n";
+    file.close();
+
+    QElapsedTimer timer;
+    timer.start();
+    Schematic *sch = new Schematic(0, fname);
+    if (!sch->loadDocument()) {
+      fprintf(stderr, "Error: Could not load schematic %s\n", fname.toLatin1().data());
+      delete sch;
+      return 1;
+    }
+    qint64 ms = timer.elapsed();
+    int loaded = sch->a_DocComps.count() + sch->a_DocWires.count();
+    fprintf(stdout, "%d elements (%d nodes) loaded in %lld ms, %.0f elements/s\n",
+            loaded, sch->a_DocNodes.count(), (long long) ms,
+            ms > 0 ? 1000.0*loaded/ms : 0.0);
+    fprintf(stdout, "%d shared symbol variants\n", SymbolGeometry::count());
+    delete sch;
+    QFile::remove(fname);
+  }
+  return 0;
+}
+
+/*!
+ * \brief doHighlightBenchmark Write a synthetic SPICE netlist and measure
+ *        how fast it is opened and highlighted in a text document.
+ * \param lines Number of lines, 0 runs the default of one million
+ */
+static int doHighlightBenchmark(int lines)
+{
+  if (lines <= 0) lines = 1000000;
+
+  QString fname = QucsSettings.tempFilesDir.filePath(
+                    QStringLiteral("bench_highlight_%1.cir").arg(lines));
+  QFile file(fname);
+  if (!file.open(QIODevice::WriteOnly)) {
+    fprintf(stderr, "Error: Could not write %s\n", fname.toLatin1().data());
+    return 1;
+  }
+  QTextStream stream(&file);
+  stream << "* synthetic netlist\n";
+  for (int i = 1; i < lines - 1; i++) {
+    switch (i % 8) {
+    case 0: stream << "* stage " << i/8 << "\n"; break;
+    case 1: stream << ".subckt stage" << i << " in out gnd\n"; break;
+    case 2: stream << "R" << i << " in _net" << i << " 1k ; series\n"; break;
+    case 3: stream << "C" << i << " _net" << i << " gnd 10p\n"; break;
+    case 4: stream << "M" << i << " out _net" << i << " gnd gnd nmos w=1u l=180n\n"; break;
+    case 5: stream << ".model nmos" << i << " NMOS (level=1 vto=0.7)\n"; break;
+    case 6: stream << ".ends\n"; break;
+    default: stream << ".param p" << i << "={2*" << i << "}\n"; break;
+    }
+  }
+  stream << ".tran 1n 1u\n";
+  file.close();
+
+  TextDoc *doc = new TextDoc(nullptr, fname);
+  QElapsedTimer timer;
+  timer.start();
+  if (!doc->load()) {
+    fprintf(stderr, "Error: Could not load %s\n", fname.toLatin1().data());
+    delete doc;
+    return 1;
+  }
+  qint64 open = timer.elapsed();
+  timer.restart();
+  while (doc->highlighter()->highlightPending(INT_MAX)) ;
+  qint64 rest = timer.elapsed();
+  fprintf(stdout, "%d lines opened in %lld ms, remaining lines highlighted "
+          "in %lld ms (%.0f lines/s)\n", doc->document()->blockCount(),
+          (long long) open, (long long) rest, rest > 0 ? 1000.0*lines/rest : 0.0);
+  delete doc;
+  QFile::remove(fname);
+  return 0;
+}
+
+/*!
+ * \brief doHdlBenchmark Write a synthetic VHDL design and measure edit and
+ *        rebuild cycles of the digital simulation build (GHDL).
+ *
+ * The design has N cell entities in groups of 20 under a test bench. One
+ * analysis of the whole netlist, as the qucs_run_hdl script does it, is
+ * compared with a build from scratch, a rebuild without changes, a rebuild
+ * after editing one cell and a rebuild after undoing the edit.
+ * \param entities Number of cells, 0 runs the default of 500
+ */
+static int doHdlBenchmark(int entities)
+{
+  if (entities <= 0) entities = 500;
+  int groups = (entities + 19) / 20;
+
+  // the netlist as Qucs writes it, "edited" is the cell with other logic
+  auto design = [&](int edited) {
+    QString net;
+    QTextStream stream(&net);
+    for (int i = 0; i < entities; i++) {
+      stream << "\nlibrary ieee;\nuse ieee.std_logic_1164.all;\n"
+             << "entity cell_" << i << " is\n"
+             << " port (a : in std_logic;\n b : in std_logic;\n y : out std_logic);\n"
+             << "end entity;\nuse work.all;\n"
+             << "architecture Arch_cell_" << i << " of cell_" << i << " is\n"
+             << " signal n0 : std_logic;\nbegin\n"
+             << "  n0 <= a " << (i % 2 ? "xor" : "nand") << " b;\n"
+             << (i == edited ? "  y <= n0 or a;\n" : "  y <= n0 and not a;\n")
+             << "end architecture;\n";
+    }
+    for (int g = 0; g < groups; g++) {
+      stream << "\nlibrary ieee;\nuse ieee.std_logic_1164.all;\n"
+             << "entity group_" << g << " is\n"
+             << " port (a : in std_logic;\n b : in std_logic;\n y : out std_logic);\n"
+             << "end entity;\nuse work.all;\n"
+             << "architecture Arch_group_" << g << " of group_" << g << " is\n";
+      int first = 20*g, last = qMin(entities, first + 20);
+      for (int i = first; i <= last; i++)
+        stream << " signal s" << i << " : std_logic;\n";
+      stream << "begin\n  s" << first << " <= b;\n";
+      for (int i = first; i < last; i++)
+        stream << "  X" << i << ": entity cell_" << i
+               << " port map (a, s" << i << ", s" << i+1 << ");\n";
+      stream << "  y <= s" << last << ";\nend architecture;\n";
+    }
+    stream << "\nlibrary ieee;\nuse ieee.std_logic_1164.all;\n"
+           << "entity TestBench is\nend entity;\nuse work.all;\n"
+           << "architecture Arch_TestBench of TestBench is\n"
+           << "  signal clk : std_logic := '0';\n";
+    for (int g = 0; g <= groups; g++)
+      stream << "  signal net" << g << " : std_logic;\n";
+    stream << "begin\n  clk <= not clk after 5 ns;\n  net0 <= clk;\n";
+    for (int g = 0; g < groups; g++)
+      stream << "  X" << g << ": entity group_" << g
+             << " port map (clk, net" << g << ", net" << g+1 << ");\n";
+    stream << "end architecture;\n";
+    stream.flush();
+    return net;
+  };
+
+  QDir dir(QucsSettings.tempFilesDir.filePath("bench_hdl"));
+  QDir cacheDir(QucsSettings.tempFilesDir.filePath("buildcache/bench-ghdl"));
+  dir.removeRecursively();
+  cacheDir.removeRecursively();
+  if (!dir.mkpath("whole")) {
+    fprintf(stderr, "Error: Could not create %s\n", dir.path().toLatin1().data());
+    return 1;
+  }
+
+  // one analysis of everything, as before
+  QString net = design(-1);
+  QFile file(dir.filePath("whole/digi.vhdl"));
+  if (!file.open(QIODevice::WriteOnly)) {
+    fprintf(stderr, "Error: Could not write %s\n", file.fileName().toLatin1().data());
+    return 1;
+  }
+  file.write(net.toUtf8());
+  file.close();
+  QElapsedTimer timer;
+  timer.start();
+  QProcess ghdl;
+  ghdl.setWorkingDirectory(dir.filePath("whole"));
+  ghdl.setProcessChannelMode(QProcess::MergedChannels);
+  ghdl.start("ghdl", QStringList() << "-a" << "digi.vhdl");
+  if (!ghdl.waitForFinished(-1) || ghdl.exitCode() != 0) {
+    fprintf(stderr, "Error: ghdl failed: %s%s\n", ghdl.errorString().toLatin1().data(),
+            ghdl.readAll().data());
+    return 1;
+  }
+  fprintf(stdout, "%d entities, whole netlist analysed in %lld ms\n",
+          entities + groups + 1, (long long) timer.elapsed());
+
+  struct Cycle {
+    const char *name;
+    int edited;
+  };
+  const Cycle cycles[] = {
+    { "build from scratch", -1 },
+    { "rebuild without changes", -1 },
+    { "rebuild after editing one cell", entities / 2 },
+    { "rebuild after undoing the edit", -1 },
+  };
+  int status = 0;
+  for (const Cycle &cycle : cycles) {
+    HdlBuild build(HdlBuild::VHDL, dir.filePath("units"), "bench-ghdl");
+    timer.restart();
+    if (!build.setNetlist(design(cycle.edited)) ||
+        !build.build([](const QString&) {})) {
+      fprintf(stderr, "Error: %s\n", build.error().toLatin1().data());
+      status = 1;
+      break;
+    }
+    fprintf(stdout, "%s: %lld ms, %d analysed, %d restored, %d up to date\n",
+            cycle.name, (long long) timer.elapsed(), build.analysed(),
+            build.restored(), build.upToDate());
+  }
+
+  dir.removeRecursively();
+  cacheDir.removeRecursively();
+  return status;
+}
+
+int main(int argc, char *argv[])
+{
+  QucsVersion = VersionTriplet(PACKAGE_VERSION);
+  QApplication a(argc, argv);
+  loadSettings();
+  QDir().mkpath(QucsSettings.tempFilesDir.absolutePath());
+  setlocale (LC_NUMERIC, "C");
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "-h") || !strcmp(argv[i], "--help")) {
+      fprintf(stdout,
+  "Usage: %s OPTION\n\n"
+  "  -h, --help      display this help and exit\n"
+  "  --check-values  compare the SPICE value conversion with its reference\n"
+  "  --load [N]      measure loading of synthetic schematics with N elements\n"
+  "                  (default 10000 and 100000)\n"
+  "  --highlight [N] measure opening and highlighting of a synthetic\n"
+  "                  netlist with N lines (default 1000000)\n"
+  "  --hdl [N]       measure GHDL rebuilds of a synthetic design with N\n"
+  "                  entities (default 500)\n"
+  , argv[0]);
+      return 0;
+    }
+    else if (!strcmp(argv[i], "--check-values")) {
+      return doValueCheck();
+    }
+    else if (!strcmp(argv[i], "--load")) {
+      int elements = 0;
+      if (i+1 < argc && isdigit(argv[i+1][0])) elements = atoi(argv[++i]);
+      return doLoadBenchmark(elements);
+    }
+    else if (!strcmp(argv[i], "--highlight")) {
+      int lines = 0;
+      if (i+1 < argc && isdigit(argv[i+1][0])) lines = atoi(argv[++i]);
+      return doHighlightBenchmark(lines);
+    }
+    else if (!strcmp(argv[i], "--hdl")) {
+      int entities = 0;
+      if (i+1 < argc && isdigit(argv[i+1][0])) entities = atoi(argv[++i]);
+      return doHdlBenchmark(entities);
+    }
+    else {
+      fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
+      return -1;
+    }
+  }
+  fprintf(stderr, "Error: Expected an option, see --help\n");
+  return -1;
+}
@@ -0,0 +1,141 @@
+/***************************************************************************
+                              buildcache.cpp
+                              --------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "buildcache.h"
+#include "main.h"
+#include "misc.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTextStream>
+
+/*!
+ * \file buildcache.cpp
+ * \brief Implementation of the BuildCache class
+ */
+
+/*!
+ * \brief BuildCache::BuildCache class constructor
+ * \param tool Build tool name, each tool has its own cache directory
+ */
+BuildCache::BuildCache(const QString &tool) :
+    a_dir(QucsSettings.tempFilesDir.filePath("buildcache/" + tool))
+{
+}
+
+/*!
+ * \brief BuildCache::hashSource Add file contents to hash. Files named by
+ *        the first capture of include_rx are hashed recursively, relative
+ *        names are resolved against the including file.
+ * \param hash Hash under construction
+ * \param file Source file
+ * \param include_rx Matches one include directive per line
+ * \param visited Files already hashed, protects from include loops
+ * \param depth Recursion depth
+ */
+void BuildCache::hashSource(QCryptographicHash &hash, const QString &file,
+                            const QRegularExpression &include_rx,
+                            QSet<QString> &visited, int depth)
+{
+    QFileInfo inf(file);
+    QString path = inf.absoluteFilePath();
+    hash.addData(path.toUtf8());
+    if (visited.contains(path) || depth > 16) return;
+    visited.insert(path);
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        hash.addData(QByteArrayLiteral("<missing>"));
+        return;
+    }
+    QByteArray content = f.readAll();
+    f.close();
+    hash.addData(content);
+
+    QTextStream ts(&content);
+    QString line;
+    while (ts.readLineInto(&line)) {
+        QRegularExpressionMatch m = include_rx.match(line);
+        if (!m.hasMatch()) continue;
+        QFileInfo inc_inf(m.captured(1));
+        if (inc_inf.isRelative()) inc_inf.setFile(inf.absoluteDir(), m.captured(1));
+        hashSource(hash, inc_inf.absoluteFilePath(), include_rx, visited, depth + 1);
+    }
+}
+
+/*!
+ * \brief BuildCache::hashExecutable Identify tool version by size and
+ *        modification time of the executable.
+ * \param hash Hash under construction
+ * \param cmd Tool command, may contain arguments (e.g. mpirun)
+ */
+void BuildCache::hashExecutable(QCryptographicHash &hash, const QString &cmd)
+{
+    hash.addData(cmd.toUtf8());
+    for (QString arg : misc::parseCmdArgs(cmd)) {
+        arg.remove('"');
+        QString exe = QFileInfo(arg).isAbsolute() ? arg : QStandardPaths::findExecutable(arg);
+        QFileInfo inf(exe);
+        if (!exe.isEmpty() && inf.isFile()) {
+            hash.addData(QByteArray::number(inf.size()));
+            hash.addData(QByteArray::number(inf.lastModified().toMSecsSinceEpoch()));
+        }
+    }
+}
+
+/*!
+ * \brief BuildCache::restore Copy cached build outputs
+ * \param key Content hash of the build inputs
+ * \param dest Directory that receives the outputs
+ * \return True if the outputs were found and copied
+ */
+bool BuildCache::restore(const QString &key, const QDir &dest) const
+{
+    QDir entry(a_dir.filePath(key));
+    QStringList files = entry.entryList(QDir::Files);
+    if (key.isEmpty() || files.isEmpty()) return false;
+
+    for (const QString &file : files) {
+        QString target = dest.filePath(file);
+        QFile::remove(target);
+        if (!QFile::copy(entry.filePath(file), target)) return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief BuildCache::store Put build outputs in the cache
+ * \param key Content hash of the build inputs
+ * \param files Output files of the build
+ */
+void BuildCache::store(const QString &key, const QStringList &files)
+{
+    if (key.isEmpty() || files.isEmpty()) return;
+
+    // Fill a temporary directory first, a reader never sees a partial entry
+    QDir tmp(a_dir.filePath(key + ".tmp"));
+    tmp.removeRecursively();
+    if (!tmp.mkpath(".")) return;
+    for (const QString &file : files) {
+        if (!QFile::copy(file, tmp.filePath(QFileInfo(file).fileName()))) {
+            tmp.removeRecursively();
+            return;
+        }
+    }
+    QDir(a_dir.filePath(key)).removeRecursively();
+    a_dir.rename(key + ".tmp", key);
+}
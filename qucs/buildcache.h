@@ -0,0 +1,55 @@
+/***************************************************************************
+                               buildcache.h
+                              --------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef BUILDCACHE_H
+#define BUILDCACHE_H
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QRegularExpression>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+/*!
+ * \file buildcache.h
+ * \brief Declaration of the BuildCache class
+ */
+
+/*!
+ * \brief The BuildCache class keeps the outputs of external build tools
+ *        (OpenVAF, admsXml, ...) under a content hash of their inputs:
+ *        the sources with everything they include, the tool executable
+ *        and its arguments. A build whose key is present is replaced by
+ *        copying the cached outputs.
+ */
+class BuildCache
+{
+public:
+    explicit BuildCache(const QString &tool);
+
+    static void hashSource(QCryptographicHash &hash, const QString &file,
+                           const QRegularExpression &include_rx,
+                           QSet<QString> &visited, int depth = 0);
+    static void hashExecutable(QCryptographicHash &hash, const QString &cmd);
+
+    bool restore(const QString &key, const QDir &dest) const;
+    void store(const QString &key, const QStringList &files);
+
+private:
+    QDir a_dir;
+};
+
+#endif // BUILDCACHE_H
@@ -27,6 +27,7 @@
 #include "schematic.h"
 #include "module.h"
 #include "misc.h"
+#include "symbolgeometry.h"
 
 #include <QPen>
 #include <QString>
@@ -55,6 +56,7 @@ Component::Component() {
     isEquation = false;
     mirroredX = false;
     rotated = 0;
+    symbolShared = false;
     isSelected = false;
     isActive = COMP_IS_ACTIVE;
     showName = true;
@@ -462,6 +464,7 @@ void Component::rotate() {
     if ((Model != "Sub") && (Model != "VHDL") && (Model != "Verilog")
         && (Model != "SpLib")) // skip port count
         if (Ports.count() < 1) return;  // do not rotate components without ports
+    SymbolGeometry::detach(this);
     int tmp, dx, dy;
 
     // rotate all lines
@@ -578,6 +581,7 @@ void Component::mirrorX() {
     if ((Model != "Sub") && (Model != "VHDL") && (Model != "Verilog")
         && (Model != "SpLib")) // skip port count
         if (Ports.count() < 1) return;  // do not rotate components without ports
+    SymbolGeometry::detach(this);
 
     // mirror all lines
     for (qucs::Line *p1: Lines) {
@@ -647,6 +651,7 @@ void Component::mirrorY() {
     if ((Model != "Sub") && (Model != "VHDL") && (Model != "Verilog")
         && (Model != "SpLib")) // skip port count
         if (Ports.count() < 1) return;  // do not rotate components without ports
+    SymbolGeometry::detach(this);
 
     // mirror all lines
     for (qucs::Line *p1: Lines) {
@@ -968,11 +973,15 @@ bool Component::load(const QString &_s) {
     if (s.at(s.length() - 1) != '>') return false;
     s = s.mid(1, s.length() - 2);   // cut off start and end character
 
+    // Tokenize once, QString::section() splits the whole line on every call
+    const QStringList fields = s.split(' ');
+    const QStringList quoted = s.split('"');
+
     QString n;
-    Name = s.section(' ', 1, 1);    // Name
+    Name = fields.value(1);    // Name
     if (Name == "*") Name = "";
 
-    n = s.section(' ', 2, 2);      // isActive
+    n = fields.value(2);      // isActive
     tmp = n.toInt(&ok);
     if (!ok) return false;
     isActive = tmp & 3;
@@ -982,41 +991,47 @@ bool Component::load(const QString &_s) {
     else
         showName = true;
 
-    n = s.section(' ', 3, 3);    // cx
+    n = fields.value(3);    // cx
     cx = n.toInt(&ok);
     if (!ok) return false;
 
-    n = s.section(' ', 4, 4);    // cy
+    n = fields.value(4);    // cy
     cy = n.toInt(&ok);
     if (!ok) return false;
 
-    n = s.section(' ', 5, 5);    // tx
+    n = fields.value(5);    // tx
     ttx = n.toInt(&ok);
     if (!ok) return false;
 
-    n = s.section(' ', 6, 6);    // ty
+    n = fields.value(6);    // ty
     tty = n.toInt(&ok);
     if (!ok) return false;
 
     if (Model.at(0) != '.') {  // is simulation component (dc, ac, ...) ?
 
-        n = s.section(' ', 7, 7);    // mirroredX
-        if (n.toInt(&ok) == 1) mirrorX();
+        n = fields.value(7);    // mirroredX
+        bool mirror = n.toInt(&ok) == 1;
         if (!ok) return false;
 
-        n = s.section(' ', 8, 8);    // rotated
+        n = fields.value(8);    // rotated
         tmp = n.toInt(&ok);
         if (!ok) return false;
         if (rotated > tmp)  // necessary because of historical flaw in ...
             tmp += 4;        // ... components like "volt_dc"
-        for (int z = rotated; z < tmp; z++) rotate();
 
+        // A symbol already seen in this orientation is not transformed
+        // again, only ports, texts and bounds are.
+        QByteArray symbol = SymbolGeometry::fixedKey(this, mirror, tmp);
+        SymbolGeometry::release(this, symbol);
+        if (mirror) mirrorX();
+        for (int z = rotated; z < tmp; z++) rotate();
+        SymbolGeometry::share(this, symbol);
     }
 
     tx = ttx;
     ty = tty; // restore text position (was changed by rotate/mirror)
 
-    unsigned int counts = s.count('"');
+    unsigned int counts = quoted.size() - 1;
     if (Model == "Sub")
         tmp = 2;   // first property (File) already exists
     else if (Model == "Lib")
@@ -1040,7 +1055,7 @@ bool Component::load(const QString &_s) {
     unsigned int z = 0;
     for (auto p1 = Props.begin(); p1 != Props.end(); ++p1) {
         z++;
-        n = s.section('"', z, z);    // property value
+        n = quoted.value(z);    // property value
         n.replace("\\n", "\n");
         n.replace("''", "\"");
         z++;
@@ -1127,7 +1142,7 @@ bool Component::load(const QString &_s) {
         }
         (*p1)->Value = n;
 
-        n = s.section('"', z, z);    // display
+        n = quoted.value(z);    // display
         (*p1)->display = (n.at(1) == '1');
     }
 
@@ -1451,10 +1466,12 @@ void Component::copyComponent(Component *pc) {
     Props = pc->Props;
     Ports = pc->Ports;
     Lines = pc->Lines;
+    Polylines = pc->Polylines;
     Arcs = pc->Arcs;
     Rects = pc->Rects;
     Ellipses = pc->Ellipses;
     Texts = pc->Texts;
+    symbolShared = pc->symbolShared;
 }
 
 
@@ -1473,8 +1490,10 @@ void MultiViewComponent::recreate(Schematic *Doc) {
     Texts.clear();
     Ports.clear();
     Lines.clear();
+    Polylines.clear();
     Rects.clear();
     Arcs.clear();
+    symbolShared = false;
     createSymbol();
 
     bool mmir = mirroredX;
@@ -1490,6 +1509,7 @@ void MultiViewComponent::recreate(Schematic *Doc) {
 
     rotated = rrot;   // restore properties (were changed by rotate/mirror)
     mirroredX = mmir;
+    SymbolGeometry::share(this);
 
     if (Doc) {
         Doc->insertRawComponent(this);
@@ -1823,6 +1843,7 @@ Component *getComponentFromName(QString &Line, Schematic *p) {
     int x = c->tx, y = c->ty;
     c->setSchematic(p);
     c->recreate(0);
+    SymbolGeometry::share(c); // instances of the same symbol variant share geometry
     c->Name = cstr;
     c->tx = x;
     c->ty = y;
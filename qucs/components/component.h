@@ -92,6 +92,7 @@ public:
   QList<Port *>     Ports;
   QList<Text *>     Texts;
   QList<Property*> Props;
+  bool symbolShared; // Lines..Ellipses belong to SymbolGeometry, don't modify
 
   #define COMP_IS_OPEN    0
   #define COMP_IS_ACTIVE  1
@@ -23,14 +23,17 @@
 
 #include "opt_sim.h"
 #include "main.h"
+#include "misc.h"
 
 
 Optimize_Sim::Optimize_Sim()
 {
   Description = QObject::tr("Optimization");
-  Simulator = spicecompat::simQucsator;
+  // ASCO runs Qucsator, Ngspice and Xyce are driven by the Optimizer
+  Simulator = spicecompat::simQucsator | spicecompat::simNgspice | spicecompat::simXyce;
   initSymbol(Description);
   Model = ".Opt";
+  SpiceModel = ".OPT";
   Name  = "Opt";
 
   Props.append(new Property("Sim", "", false, ""));
@@ -241,51 +244,54 @@ bool Optimize_Sim::createASCOnetlist()
 }
 
 // -----------------------------------------------------------
-bool Optimize_Sim::loadASCOout()
+/*!
+ * \brief Optimize_Sim::setVariable Set the initial value of an optimization
+ *  variable, e.g. to the result of an optimization.
+ * \return true if a variable of this name exists
+ */
+bool Optimize_Sim::setVariable(const QString &Name, const QString &Value)
 {
-  bool changed = false;
-  QStringList vars;
   for(int i= 2; i < Props.size();i++) {
     if(Props.at(i)->Name == "Var") {
-      vars += Props.at(i)->Value.section('|',0,0);
+      QStringList val = Props.at(i)->Value.split('|');
+      if(val.size() > 2 && val[0] == Name) {
+        val[2] = Value;
+        Props.at(i)->Value = val.join("|");
+        return true;
+      }
     }
   }
+  return false;
+}
 
+// -----------------------------------------------------------
+bool Optimize_Sim::loadASCOout()
+{
   QFile infile(QucsSettings.tempFilesDir.filePath("asco_out.log"));
   if(!infile.open(QIODevice::ReadOnly)) return false;
-  QTextStream instream(&infile);
+  // we need just the last line with the final result, the log grows
+  // with every iteration
+  qint64 Size = infile.size();
   QString Line;
-  // we need just the last line with the final result
-  while(!instream.atEnd()) Line = instream.readLine();
+  for(qint64 Tail = 4096; Line.isEmpty(); Tail *= 4) {
+    infile.seek(qMax(qint64(0), Size - Tail));
+    QStringList Lines = QString::fromLocal8Bit(infile.readAll())
+                          .split('\n', qucs::SkipEmptyParts);
+    // the first line of a tail may be incomplete
+    if(Lines.size() > 1 || Tail >= Size) {
+      if(!Lines.isEmpty()) Line = Lines.last().trimmed();
+      break;
+    }
+  }
   infile.close();
 
+  bool changed = false;
   QStringList entries = Line.split(':');
-  QStringList::Iterator it;
-  for(it = entries.begin(); it != entries.end(); ++it ) {
-    QString Name = *it;
-    Name = Name.trimmed();
-    if(vars.contains(Name)) {
-      for(int i= 2; i < Props.size();i++) {
-        if(Props.at(i)->Name == "Var") {
-	  QString val[6];
-          val[0] = Props.at(i)->Value.section('|',0,0); // variable name
-	  if(val[0]==Name) {
-            val[1] = Props.at(i)->Value.section('|',1,1);
-            val[2] = Props.at(i)->Value.section('|',2,2);
-            val[3] = Props.at(i)->Value.section('|',3,3);
-            val[4] = Props.at(i)->Value.section('|',4,4);
-            val[5] = Props.at(i)->Value.section('|',5,5);
-	    ++it; // field after variable name is its value
-	    QString Value = *it;
-	    Value = Value.trimmed();
-	    val[2] = Value;
-            Props.at(i)->Value = val[0] + "|" + val[1] + "|" + val[2] + "|" +
-	      val[3] + "|" + val[4] + "|" + val[5];
-	    changed = true;
-	    break;
-	  }
-	}
-      }
+  for(int i = 0; i + 1 < entries.size(); i++) {
+    // field after variable name is its value
+    if(setVariable(entries.at(i).trimmed(), entries.at(i+1).trimmed())) {
+      changed = true;
+      i++;
     }
   }
   return changed;
@@ -30,6 +30,7 @@ public:
   bool createASCOFiles();
   bool createASCOnetlist();
   bool loadASCOout();
+  bool setVariable(const QString &Name, const QString &Value);
 
 protected:
   QString netlist();
@@ -0,0 +1,206 @@
+/***************************************************************************
+                            symbolgeometry.cpp
+                            ------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "symbolgeometry.h"
+#include "component.h"
+#include "vacomponent.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+
+#include <typeinfo>
+
+/*!
+ * \file symbolgeometry.cpp
+ * \brief Implementation of the SymbolGeometry class.
+ */
+
+// -------------------------------------------------------
+// All symbol variants seen so far. Entries live until the program exits,
+// their number is bounded by component types times orientations.
+QHash<QByteArray, SymbolGeometry *> &SymbolGeometry::table() {
+  static QHash<QByteArray, SymbolGeometry *> geometries;
+  return geometries;
+}
+
+// -------------------------------------------------------
+int SymbolGeometry::count() {
+  return table().size();
+}
+
+// -------------------------------------------------------
+// Serializes the symbol primitives of a component. Equal bytes mean the
+// symbols paint identically, so the bytes themselves are used as key.
+QByteArray SymbolGeometry::key(const Component *c) {
+  QByteArray bytes;
+  QDataStream stream(&bytes, QIODevice::WriteOnly);
+
+  stream << qint32(c->Lines.size());
+  for (qucs::Line *p : c->Lines)
+    stream << p->x1 << p->y1 << p->x2 << p->y2 << p->style;
+
+  stream << qint32(c->Polylines.size());
+  for (qucs::Polyline *p : c->Polylines) {
+    stream << quint32(p->points.size());
+    for (const QPointF &pt : p->points)
+      stream << pt;
+    stream << p->pen << p->brush;
+  }
+
+  stream << qint32(c->Arcs.size());
+  for (qucs::Arc *p : c->Arcs)
+    stream << p->x << p->y << p->w << p->h
+           << qint32(p->angle) << qint32(p->arclen) << p->style;
+
+  stream << qint32(c->Rects.size());
+  for (qucs::Rect *p : c->Rects)
+    stream << p->x << p->y << p->w << p->h << p->Pen << p->Brush;
+
+  stream << qint32(c->Ellipses.size());
+  for (qucs::Ellips *p : c->Ellipses)
+    stream << p->x << p->y << p->w << p->h << p->Pen << p->Brush;
+
+  return bytes;
+}
+
+// -------------------------------------------------------
+// Short hash of the symbol primitives, e.g. to name cached icons.
+QByteArray SymbolGeometry::fingerprint(const Component *c) {
+  return QCryptographicHash::hash(key(c), QCryptographicHash::Md5).toHex();
+}
+
+// -------------------------------------------------------
+// Key of the symbol a component gets when it is loaded with the given
+// orientation. Only components whose constructor draws the whole symbol
+// have one: multi-view components redraw it from their properties and
+// Verilog-A components from their symbol file, so they return an empty
+// key and are shared by share(Component*) after recreate().
+QByteArray SymbolGeometry::fixedKey(const Component *c, bool mirrored,
+                                    int rotations) {
+  if (dynamic_cast<const MultiViewComponent *>(c) ||
+      dynamic_cast<const vacomponent *>(c))
+    return QByteArray();
+
+  QByteArray bytes;
+  QDataStream stream(&bytes, QIODevice::WriteOnly);
+  stream << QByteArray(typeid(*c).name()) << c->Model
+         << qint32(c->Lines.size()) << qint32(c->Polylines.size())
+         << qint32(c->Arcs.size()) << qint32(c->Rects.size())
+         << qint32(c->Ellipses.size())
+         << c->x1 << c->y1 << c->x2 << c->y2
+         << mirrored << qint32(rotations);
+  return bytes.prepend('F');   // never equal to a key() of primitives
+}
+
+// -------------------------------------------------------
+// Frees the symbol primitives of a component about to be loaded if the
+// symbol with this key is known already. The following rotate() and
+// mirrorX() then only move ports, texts and bounds.
+void SymbolGeometry::release(Component *c, const QByteArray &key) {
+  if (key.isEmpty() || c->symbolShared || !table().contains(key)) return;
+
+  qDeleteAll(c->Lines);
+  qDeleteAll(c->Polylines);
+  qDeleteAll(c->Arcs);
+  qDeleteAll(c->Rects);
+  qDeleteAll(c->Ellipses);
+  c->Lines.clear();
+  c->Polylines.clear();
+  c->Arcs.clear();
+  c->Rects.clear();
+  c->Ellipses.clear();
+}
+
+// -------------------------------------------------------
+// Shares the symbol of a component loaded with fixedKey() "key". The
+// first component of a key hands its transformed primitives over to the
+// table, later ones were emptied by release() and get the shared ones.
+void SymbolGeometry::share(Component *c, const QByteArray &key) {
+  if (key.isEmpty() || c->symbolShared) return;
+
+  SymbolGeometry *g = table().value(key, nullptr);
+  if (g) {
+    c->Lines     = g->Lines;
+    c->Polylines = g->Polylines;
+    c->Arcs      = g->Arcs;
+    c->Rects     = g->Rects;
+    c->Ellipses  = g->Ellipses;
+  }
+  else {
+    g = new SymbolGeometry;
+    g->Lines     = c->Lines;
+    g->Polylines = c->Polylines;
+    g->Arcs      = c->Arcs;
+    g->Rects     = c->Rects;
+    g->Ellipses  = c->Ellipses;
+    table().insert(key, g);
+  }
+  c->symbolShared = true;
+}
+
+// -------------------------------------------------------
+// Replaces the symbol primitives of the component by the shared ones of
+// an equal symbol. The first component of a variant hands its own
+// primitives over to the table, later ones free their copies.
+void SymbolGeometry::share(Component *c) {
+  if (c->symbolShared) return;
+  if (c->Lines.isEmpty() && c->Polylines.isEmpty() && c->Arcs.isEmpty() &&
+      c->Rects.isEmpty() && c->Ellipses.isEmpty())
+    return;
+
+  QByteArray k = key(c);
+  SymbolGeometry *g = table().value(k, nullptr);
+  if (g) {
+    qDeleteAll(c->Lines);
+    qDeleteAll(c->Polylines);
+    qDeleteAll(c->Arcs);
+    qDeleteAll(c->Rects);
+    qDeleteAll(c->Ellipses);
+    c->Lines     = g->Lines;
+    c->Polylines = g->Polylines;
+    c->Arcs      = g->Arcs;
+    c->Rects     = g->Rects;
+    c->Ellipses  = g->Ellipses;
+  }
+  else {
+    g = new SymbolGeometry;
+    g->Lines     = c->Lines;
+    g->Polylines = c->Polylines;
+    g->Arcs      = c->Arcs;
+    g->Rects     = c->Rects;
+    g->Ellipses  = c->Ellipses;
+    table().insert(k, g);
+  }
+  c->symbolShared = true;
+}
+
+// -------------------------------------------------------
+// Gives the component private copies of its symbol primitives. Must be
+// called before the primitives are modified (rotate, mirror).
+void SymbolGeometry::detach(Component *c) {
+  if (!c->symbolShared) return;
+
+  for (qucs::Line *&p : c->Lines)
+    p = new qucs::Line(*p);
+  for (qucs::Polyline *&p : c->Polylines)
+    p = new qucs::Polyline(*p);
+  for (qucs::Arc *&p : c->Arcs)
+    p = new qucs::Arc(*p);
+  for (qucs::Rect *&p : c->Rects)
+    p = new qucs::Rect(*p);
+  for (qucs::Ellips *&p : c->Ellipses)
+    p = new qucs::Ellips(*p);
+  c->symbolShared = false;
+}
@@ -0,0 +1,55 @@
+/***************************************************************************
+                             symbolgeometry.h
+                            ------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef SYMBOLGEOMETRY_H
+#define SYMBOLGEOMETRY_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+
+#include "element.h"
+
+class Component;
+
+/*!
+ * \brief The SymbolGeometry class holds the drawing primitives of one
+ *        component symbol variant (type, symbol-related properties and
+ *        orientation). Entries are immutable and shared by all components
+ *        whose lines, polylines, arcs, rectangles and ellipses are equal.
+ *        Ports and texts stay per instance.
+ */
+class SymbolGeometry {
+public:
+  static void share(Component *c);
+  static QByteArray fixedKey(const Component *c, bool mirrored, int rotations);
+  static void release(Component *c, const QByteArray &key);
+  static void share(Component *c, const QByteArray &key);
+  static void detach(Component *c);
+  static int count();
+  static QByteArray fingerprint(const Component *c);
+
+private:
+  QList<qucs::Line *>     Lines;
+  QList<qucs::Polyline *> Polylines;
+  QList<qucs::Arc *>      Arcs;
+  QList<qucs::Rect *>     Rects;
+  QList<qucs::Ellips *>   Ellipses;
+
+  static QByteArray key(const Component *c);
+  static QHash<QByteArray, SymbolGeometry *> &table();
+};
+
+#endif // SYMBOLGEOMETRY_H
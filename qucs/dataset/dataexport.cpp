@@ -0,0 +1,156 @@
+/*
+ * dataexport.cpp - command line export of datasets to CSV or columnar files
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this package; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street - Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dataset.h"
+#include "exporter.h"
+
+static void usage (const char * prog)
+{
+  fprintf (stderr,
+    "Usage: %s [options] DATASET\n"
+    "Exports variables of a Qucs dataset or SPICE raw file.  Variables over\n"
+    "the same independent variables share a table, several tables go into\n"
+    "several files.\n\n"
+    "  -o, --output FILE     output file (DATASET with .csv or .qcol suffix)\n"
+    "  -f, --format FORMAT   csv (default) or columns\n"
+    "  -v, --var NAME        export variable NAME, may be repeated (all)\n"
+    "  -d, --delimiter CHAR  CSV delimiter, `tab' for tabs (,)\n"
+    "  -p, --precision N     significant digits 0..17, 0 for exact values (0)\n"
+    "  -j, --threads N       number of worker threads (all cores)\n"
+    "  -l, --list            list the variables and exit\n",
+    prog);
+}
+
+int main (int argc, char ** argv)
+{
+  qucsdata::ExportOptions options;
+  std::vector<std::string> names;
+  const char * input = NULL;
+  std::string output;
+  bool list = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char * opt = argv[i];
+    const char * arg = (i + 1 < argc) ? argv[i + 1] : NULL;
+    auto is = [opt] (const char * s, const char * l) {
+      return (s && !strcmp (opt, s)) || !strcmp (opt, l);
+    };
+
+    if (is ("-h", "--help")) {
+      usage (argv[0]);
+      return 0;
+    }
+    else if (is ("-l", "--list")) { list = true; continue; }
+    else if (opt[0] != '-') {
+      input = opt;
+      continue;
+    }
+
+    if (!arg) {
+      fprintf (stderr, "%s: missing argument for `%s'\n", argv[0], opt);
+      return 1;
+    }
+    i++;
+    if (is ("-o", "--output"))         output = arg;
+    else if (is ("-v", "--var"))       names.push_back (arg);
+    else if (is ("-p", "--precision")) {
+      options.precision = atoi (arg);   // 17 digits give every double exactly
+      options.precision = options.precision < 0 ? 0 : options.precision > 17 ? 17 : options.precision;
+    }
+    else if (is ("-j", "--threads"))   options.threads = atoi (arg);
+    else if (is ("-f", "--format")) {
+      if (!strcmp (arg, "csv"))          options.format = qucsdata::Format::CSV;
+      else if (!strcmp (arg, "columns")) options.format = qucsdata::Format::Columns;
+      else {
+	fprintf (stderr, "%s: unknown format `%s'\n", argv[0], arg);
+	return 1;
+      }
+    }
+    else if (is ("-d", "--delimiter")) {
+      if (!strcmp (arg, "tab")) options.delimiter = '\t';
+      else if (strlen (arg) == 1) options.delimiter = arg[0];
+      else {
+	fprintf (stderr, "%s: invalid delimiter `%s'\n", argv[0], arg);
+	return 1;
+      }
+    }
+    else {
+      fprintf (stderr, "%s: unknown option `%s'\n", argv[0], opt);
+      usage (argv[0]);
+      return 1;
+    }
+  }
+
+  if (!input) {
+    usage (argv[0]);
+    return 1;
+  }
+
+  qucsdata::DataSet data;
+  if (!data.open (input)) {
+    fprintf (stderr, "%s: %s\n", argv[0], data.error ().c_str ());
+    return 1;
+  }
+
+  if (list) {
+    for (int i = 0; i < data.count (); i++) {
+      const qucsdata::Variable & v = data.variable (i);
+      printf ("%s\t%s", v.indep ? "indep" : "dep", v.name.c_str ());
+      for (const std::string & d : v.deps) printf ("\t%s", d.c_str ());
+      printf ("\n");
+    }
+    return 0;
+  }
+
+  std::vector<int> vars;
+  if (names.empty ())
+    for (int i = 0; i < data.count (); i++) vars.push_back (i);
+  for (const std::string & name : names) {
+    int i = data.find (name);
+    if (i < 0) {
+      fprintf (stderr, "%s: no variable `%s' in %s\n", argv[0], name.c_str (), input);
+      return 1;
+    }
+    vars.push_back (i);
+  }
+
+  if (output.empty ()) {
+    output = input;
+    size_t dot = output.rfind ('.'), slash = output.find_last_of ("/\\");
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+      output.erase (dot);
+    output += options.format == qucsdata::Format::CSV ? ".csv" : ".qcol";
+  }
+
+  data.decode (vars, options.threads);
+  std::vector<std::string> written;
+  std::string error;
+  if (!qucsdata::exportData (data, vars, output, options, written, error)) {
+    fprintf (stderr, "%s: %s\n", argv[0], error.c_str ());
+    return 1;
+  }
+  for (const std::string & name : written)
+    fprintf (stderr, "%s\n", name.c_str ());
+  return 0;
+}
@@ -0,0 +1,574 @@
+/***************************************************************************
+                                dataset.cpp
+                               -------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "dataset.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*!
+ * \file dataset.cpp
+ * \brief Implementation of the qucsdata::DataSet class.
+ */
+
+namespace qucsdata {
+
+// -------------------------------------------------------
+// Number parsing. The text must be read the same way in every locale,
+// which rules out strtod(); std::from_chars() is locale independent and
+// much faster where the standard library provides it for doubles.
+
+static inline bool isSpace(char c)
+{
+  return (unsigned char)c <= ' ';
+}
+
+// Slow path for exotic spellings and for standard libraries without
+// floating point from_chars().
+static const char *parseRealSlow(const char *p, const char *end, double &v)
+{
+  const char *q = p;
+  while (q < end && !isSpace(*q) && *q != ',' &&
+         !((*q == '+' || *q == '-') && q > p && q[-1] != 'e' && q[-1] != 'E'))
+    q++;
+  std::string token(p, q);
+  std::string lower = token;
+  std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+  if (lower == "nan" || lower == "-nan") {
+    v = std::numeric_limits<double>::quiet_NaN();
+    return q;
+  }
+  if (lower == "inf" || lower == "infinity") {
+    v = std::numeric_limits<double>::infinity();
+    return q;
+  }
+  if (lower == "-inf" || lower == "-infinity") {
+    v = -std::numeric_limits<double>::infinity();
+    return q;
+  }
+  std::istringstream stream(token);
+  stream.imbue(std::locale::classic());
+  stream >> v;
+  if (stream.fail()) return nullptr;
+  return p + std::streamoff(stream.eof() ? token.size() : std::streamoff(stream.tellg()));
+}
+
+// Parses a real number at p. Returns the position behind it or nullptr.
+static inline const char *parseReal(const char *p, const char *end, double &v)
+{
+  if (p < end && *p == '+') p++;   // from_chars() refuses an explicit plus
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  std::from_chars_result r = std::from_chars(p, end, v);
+  if (r.ec == std::errc()) return r.ptr;
+#endif
+  return parseRealSlow(p, end, v);
+}
+
+// -------------------------------------------------------
+DataSet::DataSet() : a_data(nullptr), a_size(0), a_mapped(false)
+{
+}
+
+DataSet::~DataSet()
+{
+  close();
+}
+
+// -------------------------------------------------------
+// Releases the file and all decoded values.
+void DataSet::close()
+{
+  if (a_mapped && a_data) {
+#ifdef _WIN32
+    UnmapViewOfFile(a_data);
+#else
+    munmap(const_cast<char *>(a_data), a_size);
+#endif
+  }
+  a_mapped = false;
+  a_data = nullptr;
+  a_size = 0;
+  a_buffer.clear();
+  a_buffer.shrink_to_fit();
+  a_vars.clear();
+  a_units.clear();
+  a_index.clear();
+}
+
+// -------------------------------------------------------
+// Opens a dataset and indexes its variables. With "map" set, the file is
+// memory mapped, otherwise it is read into memory. Mapping avoids the copy
+// but keeps the file in use, it does not suit files that a simulator is
+// about to overwrite. The path is UTF-8 encoded.
+bool DataSet::open(const std::string &path, bool map)
+{
+  close();
+  a_error.clear();
+
+#ifdef _WIN32
+  int wlen = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  std::wstring wpath(std::max(wlen, 1), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], wlen);
+  if (map) {
+    HANDLE file = CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      a_error = "cannot open " + path;
+      return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = size.QuadPart > 0
+                   ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                   : nullptr;
+    if (mapping) {
+      a_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+      a_size = size_t(size.QuadPart);
+      a_mapped = a_data != nullptr;
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+  }
+#else
+  if (map) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      a_error = "cannot open " + path;
+      return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        a_data = static_cast<const char *>(p);
+        a_size = size_t(st.st_size);
+        a_mapped = true;
+      }
+    }
+    ::close(fd);
+  }
+#endif
+
+  if (!a_mapped) {   // read the whole file, also the fallback of mapping
+#ifdef _WIN32
+    FILE *f = _wfopen(wpath.c_str(), L"rb");
+#else
+    FILE *f = fopen(path.c_str(), "rb");
+#endif
+    if (!f) {
+      a_error = "cannot open " + path;
+      return false;
+    }
+    char chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+      a_buffer.insert(a_buffer.end(), chunk, chunk + n);
+    fclose(f);
+    a_data = a_buffer.data();
+    a_size = a_buffer.size();
+  }
+
+  if (a_size == 0) {
+    a_error = path + " is empty";
+    close();
+    return false;
+  }
+
+  bool ok;
+  if (a_size > 14 && std::memcmp(a_data, "<Qucs Dataset ", 14) == 0)
+    ok = indexQucs();
+  else
+    ok = indexRaw();
+  if (!ok) {
+    if (a_error.empty()) a_error = path + " is not a Qucs dataset or SPICE raw file";
+    close();
+  }
+  return ok;
+}
+
+// -------------------------------------------------------
+int DataSet::find(const std::string &name) const
+{
+  auto it = a_index.find(name);
+  return it == a_index.end() ? -1 : it->second;
+}
+
+// -------------------------------------------------------
+// Appends a variable and makes it known by name. Should the name be
+// taken already, find() keeps returning the first one.
+int DataSet::addVariable(Variable &&v)
+{
+  int idx = int(a_vars.size());
+  a_vars.push_back(std::move(v));
+  a_index.emplace(a_vars.back().name, idx);
+  return idx;
+}
+
+// -------------------------------------------------------
+// Scans the tags of a Qucs dataset:
+//   <indep name count> values </indep>
+//   <dep name indep1 indep2 ...> values </dep>
+// Values never contain '<', so memchr() finds the next tag.
+bool DataSet::indexQucs()
+{
+  const char *p = a_data, *end = a_data + a_size;
+  int open_var = -1;
+
+  while ((p = static_cast<const char *>(std::memchr(p, '<', size_t(end - p))))) {
+    const char *gt = static_cast<const char *>(std::memchr(p, '>', size_t(end - p)));
+    if (!gt) break;
+
+    std::string tag(p + 1, gt);
+    if (tag.compare(0, 6, "indep ") == 0 || tag.compare(0, 4, "dep ") == 0) {
+      if (open_var >= 0) a_vars[open_var].end = size_t(p - a_data);
+
+      std::istringstream fields(tag);
+      std::string type, word;
+      Variable v;
+      fields >> type >> v.name;
+      v.indep = type == "indep";
+      if (!v.indep)
+        while (fields >> word) v.deps.push_back(word);
+      v.begin = size_t(gt + 1 - a_data);
+      v.end = a_size;
+      v.unit = int(a_units.size());
+
+      a_units.emplace_back();
+      open_var = addVariable(std::move(v));
+      a_units.back().vars.push_back(open_var);
+    }
+    else if (tag == "/indep" || tag == "/dep") {
+      if (open_var >= 0) a_vars[open_var].end = size_t(p - a_data);
+      open_var = -1;
+    }
+    p = gt + 1;
+  }
+  return true;
+}
+
+// -------------------------------------------------------
+// Scans the headers of the plots in a SPICE raw file. Every plot lists
+// its variables, the first one being the scale, and is followed by its
+// values, either in "Binary:" (little endian doubles, point by point) or
+// in "Values:" (ASCII) form.
+bool DataSet::indexRaw()
+{
+  size_t pos = 0;
+  bool complex = false;
+  size_t nvars = 0, npoints = 0;
+  std::vector<std::string> names;
+  int plot = 0;
+
+  auto nextLine = [&](std::string &line) {
+    if (pos >= a_size) return false;
+    const char *start = a_data + pos;
+    const char *nl = static_cast<const char *>(std::memchr(start, '\n', a_size - pos));
+    size_t len = nl ? size_t(nl - start) : a_size - pos;
+    pos += len + (nl ? 1 : 0);
+    if (len > 0 && start[len - 1] == '\r') len--;
+    line.assign(start, len);
+    return true;
+  };
+  auto value = [](const std::string &line) {
+    return std::strtoull(line.c_str() + line.find(':') + 1, nullptr, 10);
+  };
+
+  std::string line;
+  while (nextLine(line)) {
+    if (line.compare(0, 9, "Plotname:") == 0) {
+      complex = false;
+      nvars = npoints = 0;
+      names.clear();
+    }
+    else if (line.compare(0, 6, "Flags:") == 0) {
+      complex = line.find("complex") != std::string::npos;
+    }
+    else if (line.compare(0, 14, "No. Variables:") == 0) {
+      nvars = size_t(value(line));
+    }
+    else if (line.compare(0, 11, "No. Points:") == 0) {
+      npoints = size_t(value(line));
+    }
+    else if (line.compare(0, 10, "Variables:") == 0) {
+      names.clear();
+      for (size_t i = 0; i < nvars && nextLine(line); i++) {
+        std::istringstream fields(line);
+        std::string idx, name;
+        fields >> idx >> name;
+        names.push_back(name);
+      }
+    }
+    else if (line == "Binary:" || line == "Values:") {
+      if (names.empty() || names.size() != nvars) return false;
+
+      Unit &u = a_units.emplace_back();
+      u.raw = true;
+      u.binary = line == "Binary:";
+      u.complex = complex;
+      size_t begin = pos, end;
+      if (u.binary) {
+        size_t row = nvars * (complex ? 16 : 8);
+        npoints = std::min(npoints, (a_size - pos) / row);  // still being written?
+        end = pos + npoints * row;
+      }
+      else {   // up to the next plot
+        end = a_size;
+        for (const char *key : {"\nTitle:", "\nPlotname:"}) {
+          const char *hit = std::search(a_data + pos, a_data + a_size, key, key + std::strlen(key));
+          end = std::min(end, size_t(hit - a_data));
+        }
+      }
+      u.points = npoints;
+
+      for (size_t c = 0; c < nvars; c++) {
+        Variable v;
+        v.name = names[c];
+        // same signal in a later plot: "v(out)#2" for the second one
+        if (find(v.name) >= 0) v.name += "#" + std::to_string(plot + 1);
+        v.indep = c == 0;
+        if (c > 0) v.deps.push_back(a_vars[u.vars.front()].name);
+        v.begin = begin;
+        v.end = end;
+        v.unit = int(a_units.size()) - 1;
+        v.column = int(c);
+        u.vars.push_back(addVariable(std::move(v)));
+      }
+      pos = std::min(end + (u.binary ? 0 : 1), a_size);
+      plot++;
+    }
+  }
+  return !a_vars.empty();
+}
+
+// -------------------------------------------------------
+// Decodes the values of variable i, if not done yet. Safe to call from
+// several threads.
+bool DataSet::decode(int i)
+{
+  if (i < 0 || i >= count()) return false;
+  Unit &u = a_units[a_vars[i].unit];
+  if (u.done.load(std::memory_order_acquire)) return u.ok;
+
+  std::lock_guard<std::mutex> guard(u.lock);
+  if (!u.done.load(std::memory_order_relaxed)) {
+    u.ok = decodeUnit(u);
+    u.done.store(true, std::memory_order_release);
+  }
+  return u.ok;
+}
+
+// -------------------------------------------------------
+// Decodes the variables "vars" and the independent variables they depend
+// on, spread over "threads" threads (0: one per core).
+void DataSet::decode(const std::vector<int> &vars, int threads)
+{
+  std::vector<bool> wanted(a_units.size(), false);
+  std::vector<int> todo;   // one variable of every unit to decode
+  auto add = [this, &wanted, &todo](int i) {
+    if (i < 0 || i >= count() || wanted[a_vars[i].unit]) return;
+    wanted[a_vars[i].unit] = true;
+    todo.push_back(i);
+  };
+  for (int i : vars) {
+    add(i);
+    if (i < 0 || i >= count()) continue;
+    for (const std::string &dep : a_vars[i].deps) add(find(dep));
+  }
+
+  if (threads <= 0) threads = int(std::max(1u, std::thread::hardware_concurrency()));
+  threads = std::min(threads, int(todo.size()));
+
+  std::atomic<size_t> next{0};
+  auto work = [this, &next, &todo]() {
+    for (size_t k; (k = next.fetch_add(1)) < todo.size();)
+      decode(todo[k]);
+  };
+  std::vector<std::thread> pool;
+  for (int t = 1; t < threads; t++) pool.emplace_back(work);
+  work();
+  for (std::thread &t : pool) t.join();
+}
+
+// -------------------------------------------------------
+// Decodes all variables, spread over "threads" threads (0: one per core).
+void DataSet::decodeAll(int threads)
+{
+  if (threads <= 0) threads = int(std::max(1u, std::thread::hardware_concurrency()));
+  threads = std::min(threads, int(a_units.size()));
+
+  std::atomic<size_t> next{0};
+  auto work = [this, &next]() {
+    for (size_t u; (u = next.fetch_add(1)) < a_units.size();)
+      decode(a_units[u].vars.front());
+  };
+  std::vector<std::thread> pool;
+  for (int t = 1; t < threads; t++) pool.emplace_back(work);
+  work();
+  for (std::thread &t : pool) t.join();
+}
+
+// -------------------------------------------------------
+bool DataSet::decodeUnit(Unit &u)
+{
+  if (u.raw) return decodeRaw(u);
+  return decodeQucs(a_vars[u.vars.front()]);
+}
+
+// -------------------------------------------------------
+// Values of a Qucs dataset: one number per line, complex numbers are
+// written as "+1.5e+00-j2.0e-01". Variables named "*.X" hold bit vectors
+// of digital simulations.
+bool DataSet::decodeQucs(Variable &v)
+{
+  const char *p = a_data + v.begin, *end = a_data + v.end;
+
+  if (v.name.size() > 2 && v.name.compare(v.name.size() - 2, 2, ".X") == 0) {
+    v.kind = Kind::Digital;
+    for (;;) {
+      while (p < end && isSpace(*p)) p++;
+      if (p >= end) break;
+      const char *q = p;
+      while (q < end && !isSpace(*q)) q++;
+      v.digital.append(p, q);
+      v.digital.push_back('\0');
+      v.length++;
+      p = q;
+    }
+    return true;
+  }
+
+  std::vector<double> re, im;
+  re.reserve(size_t(end - p) / 20);
+  bool complex = false;
+  for (;;) {
+    while (p < end && isSpace(*p)) p++;
+    if (p >= end) break;
+
+    double x, y = 0.0;
+    const char *q = parseReal(p, end, x);
+    if (!q) return false;
+    if (q + 1 < end && (*q == '+' || *q == '-') && q[1] == 'j') {
+      const char *r = parseReal(q + 2, end, y);
+      if (!r) return false;
+      if (*q == '-') y = -y;
+      if (!complex) {
+        complex = true;
+        im.reserve(re.capacity());
+        im.assign(re.size(), 0.0);
+      }
+      q = r;
+    }
+    if (q < end && !isSpace(*q)) return false;   // garbage behind number
+
+    re.push_back(x);
+    if (complex) im.push_back(y);
+    p = q;
+  }
+
+  v.length = re.size();
+  if (complex) {
+    v.kind = Kind::Complex;
+    v.values.resize(2 * v.length);
+    for (size_t k = 0; k < v.length; k++) {
+      v.values[2 * k] = re[k];
+      v.values[2 * k + 1] = im[k];
+    }
+  }
+  else {
+    v.kind = Kind::Real;
+    v.values = std::move(re);
+  }
+  return true;
+}
+
+// -------------------------------------------------------
+// Values of a SPICE raw plot are stored point by point, all variables of
+// the plot are split into columns in one pass. The scale is always real.
+bool DataSet::decodeRaw(Unit &u)
+{
+  const size_t nvars = u.vars.size();
+  std::vector<Variable *> cols(nvars);
+  for (size_t c = 0; c < nvars; c++) {
+    cols[c] = &a_vars[u.vars[c]];
+    bool cplx = u.complex && c > 0;
+    cols[c]->kind = cplx ? Kind::Complex : Kind::Real;
+    cols[c]->values.reserve(u.points * (cplx ? 2 : 1));
+  }
+  const char *p = a_data + cols[0]->begin, *end = a_data + cols[0]->end;
+
+  if (u.binary) {
+    const size_t stride = u.complex ? 2 : 1;
+    double d[2];
+    for (size_t k = 0; k < u.points; k++)
+      for (size_t c = 0; c < nvars; c++) {
+        std::memcpy(d, p, stride * sizeof(double));
+        p += stride * sizeof(double);
+        cols[c]->values.push_back(d[0]);
+        if (u.complex && c > 0) cols[c]->values.push_back(d[1]);
+      }
+  }
+  else {
+    // "index<tab>value" for the scale, "<tab>value" (or "re,im") for the
+    // other variables of the point
+    size_t k;
+    for (k = 0; k < u.points; k++) {
+      while (p < end && isSpace(*p)) p++;
+      while (p < end && !isSpace(*p)) p++;    // point index
+      size_t c;
+      for (c = 0; c < nvars; c++) {
+        while (p < end && isSpace(*p)) p++;
+        if (p >= end) break;
+        double x, y = 0.0;
+        const char *q = parseReal(p, end, x);
+        if (!q) return false;
+        if (q < end && *q == ',') {
+          q = parseReal(q + 1, end, y);
+          if (!q) return false;
+        }
+        cols[c]->values.push_back(x);
+        if (u.complex && c > 0) cols[c]->values.push_back(y);
+        p = q;
+      }
+      if (c < nvars) {   // truncated file, drop the incomplete point
+        for (size_t r = 0; r < c; r++)
+          cols[r]->values.resize(k * (u.complex && r > 0 ? 2 : 1));
+        break;
+      }
+    }
+    u.points = k;
+  }
+
+  for (Variable *v : cols)
+    v->length = u.points;
+  return true;
+}
+
+} // namespace qucsdata
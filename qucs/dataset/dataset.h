@@ -0,0 +1,111 @@
+/***************************************************************************
+                                 dataset.h
+                                -----------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QUCSDATA_DATASET_H
+#define QUCSDATA_DATASET_H
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * \file dataset.h
+ * \brief Reader for simulation datasets, independent of Qt and of the GUI.
+ *
+ * Two formats are understood: Qucs datasets (text, "<Qucs Dataset ...>")
+ * and SPICE raw files written by Ngspice and Xyce (binary or ASCII).
+ * Opening a file only builds an index of its variables; the values of a
+ * variable are decoded on first access and kept, so repeated access costs
+ * nothing. The C interface in qucsdata.h wraps this class for the Octave
+ * and Python bindings.
+ */
+
+namespace qucsdata {
+
+enum class Kind { Unknown, Real, Complex, Digital };
+
+struct Variable {
+  std::string name;
+  bool indep = false;
+  std::vector<std::string> deps;   // names of the independent variables
+
+  // filled when the variable is decoded
+  Kind kind = Kind::Unknown;
+  size_t length = 0;               // number of values
+  std::vector<double> values;      // real values, or interleaved re/im pairs
+  std::string digital;             // NUL terminated bit vectors ("01XZ...")
+
+  // location in the file
+  size_t begin = 0, end = 0;
+  int unit = -1;                   // decoding unit, see DataSet::Unit
+  int column = 0;                  // column within a SPICE raw plot
+};
+
+class DataSet {
+public:
+  DataSet();
+  ~DataSet();
+  DataSet(const DataSet&) = delete;
+  DataSet& operator=(const DataSet&) = delete;
+
+  bool open(const std::string &path, bool map = true);
+  void close();
+  const std::string &error() const { return a_error; }
+
+  int count() const { return int(a_vars.size()); }
+  int find(const std::string &name) const;
+  const Variable &variable(int i) const { return a_vars[i]; }
+
+  bool decode(int i);
+  void decode(const std::vector<int> &vars, int threads = 0);
+  void decodeAll(int threads = 0);
+
+private:
+  // Values that are decoded together: one variable of a Qucs dataset or
+  // all variables of one SPICE raw plot (values are stored point by point)
+  struct Unit {
+    std::mutex lock;
+    std::atomic<bool> done{false};
+    bool ok = false;
+    bool raw = false, binary = false, complex = false;
+    size_t points = 0;
+    std::vector<int> vars;
+  };
+
+  bool indexQucs();
+  bool indexRaw();
+  int addVariable(Variable &&);
+  bool decodeUnit(Unit &);
+  bool decodeQucs(Variable &);
+  bool decodeRaw(Unit &);
+
+  const char *a_data;
+  size_t a_size;
+  std::vector<char> a_buffer;  // file contents if not mapped
+  bool a_mapped;
+  std::string a_error;
+
+  std::vector<Variable> a_vars;
+  std::deque<Unit> a_units;
+  std::unordered_map<std::string, int> a_index;
+};
+
+} // namespace qucsdata
+
+#endif // QUCSDATA_DATASET_H
@@ -0,0 +1,394 @@
+/***************************************************************************
+                                exporter.cpp
+                               --------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "exporter.h"
+#include "dataset.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/*!
+ * \file exporter.cpp
+ * \brief Implementation of the dataset export, see exporter.h.
+ */
+
+namespace qucsdata {
+
+namespace {
+
+// Variables sharing the same independent variables
+struct Table {
+  std::vector<int> axes;
+  std::vector<int> vars;
+  size_t rows = 1;
+};
+
+FILE *openFile(const std::string &path)
+{
+#ifdef _WIN32
+  int wlen = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  std::wstring wpath(std::max(wlen, 1), L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], wlen);
+  return _wfopen(wpath.c_str(), L"wb");
+#else
+  return fopen(path.c_str(), "wb");
+#endif
+}
+
+// "out.csv" + {"time"} -> "out_time.csv"
+std::string tableFileName(const std::string &path, const DataSet &data, const Table &t)
+{
+  size_t slash = path.find_last_of("/\\");
+  size_t dot = path.rfind('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    dot = path.size();
+
+  std::string name = path.substr(0, dot);
+  for (int a : t.axes) {
+    name += '_';
+    for (char c : data.variable(a).name)
+      name += (isalnum((unsigned char)c) || c == '.' || c == '-') ? c : '_';
+  }
+  return name + path.substr(dot);
+}
+
+// real part of value k of a variable used as axis
+inline double axisValue(const Variable &v, size_t k)
+{
+  return v.values[v.kind == Kind::Complex ? 2 * k : k];
+}
+
+// longest number formatNumber() writes, e.g. "-2.2250738585072014e-308"
+const size_t maxNumber = 32;
+const int maxPrecision = 17;   // enough for every double
+
+// formats "x" into at most maxNumber bytes at "p", returns the end
+inline char *formatNumber(char *p, double x, int precision)
+{
+  precision = std::min(std::max(precision, 0), maxPrecision);
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  std::to_chars_result res = precision > 0
+    ? std::to_chars(p, p + maxNumber, x, std::chars_format::general, precision)
+    : std::to_chars(p, p + maxNumber, x);
+  if (res.ec == std::errc()) return res.ptr;
+#endif
+  int n = snprintf(p, maxNumber, "%.*g", precision > 0 ? precision : maxPrecision, x);
+  return p + std::min(std::max(n, 0), int(maxNumber) - 1);
+}
+
+std::string quoted(const std::string &s)
+{
+  std::string q = "\"";
+  for (char c : s) {
+    if (c == '"') q += '"';
+    q += c;
+  }
+  return q + '"';
+}
+
+// -------------------------------------------------------
+// CSV
+
+class CsvWriter {
+public:
+  CsvWriter(const DataSet &data, const Table &t, const ExportOptions &o)
+    : a_data(data), a_table(t), a_options(o), a_longest(0)
+  {
+    for (int a : t.axes) a_lengths.push_back(data.variable(a).length);
+    a_digital.resize(t.vars.size());
+    for (size_t c = 0; c < t.vars.size(); c++) {
+      const Variable &v = data.variable(t.vars[c]);
+      if (v.kind != Kind::Digital) continue;
+      a_digital[c].reserve(v.length);
+      for (size_t pos = 0, k = 0; k < v.length; k++) {
+        size_t len = std::strlen(v.digital.data() + pos);
+        a_digital[c].push_back(pos);
+        a_longest = std::max(a_longest, len);
+        pos += len + 1;
+      }
+    }
+  }
+
+  std::string header() const
+  {
+    std::string h;
+    const char d = a_options.delimiter;
+    for (int a : a_table.axes)
+      h += quoted(a_data.variable(a).name) + d;
+    for (int i : a_table.vars) {
+      const Variable &v = a_data.variable(i);
+      if (v.kind == Kind::Complex)
+        h += quoted("r " + v.name) + d + quoted("i " + v.name) + d;
+      else
+        h += quoted(v.name) + d;
+    }
+    h.back() = '\n';
+    return h;
+  }
+
+  // formats the rows [r0, r1) into "out"
+  void format(size_t r0, size_t r1, std::string &out) const
+  {
+    const char d = a_options.delimiter;
+    const int prec = std::min(std::max(a_options.precision, 0), maxPrecision);
+    const size_t naxes = a_table.axes.size();
+
+    std::vector<size_t> idx(naxes);
+    size_t rem = r0;
+    for (size_t a = 0; a < naxes; a++) {
+      idx[a] = rem % a_lengths[a];
+      rem /= a_lengths[a];
+    }
+
+    // every column holds a number, two if complex, or a bit vector
+    const size_t rowSize =
+      (maxNumber + 1 + a_longest) * (naxes + 2 * a_table.vars.size());
+
+    out.clear();
+    size_t pos = 0;
+    for (size_t r = r0; r < r1; r++) {
+      if (out.size() < pos + rowSize) out.resize(2 * (pos + rowSize));
+      char *p = &out[pos];
+      for (size_t a = 0; a < naxes; a++) {
+        p = formatNumber(p, axisValue(a_data.variable(a_table.axes[a]), idx[a]), prec);
+        *p++ = d;
+      }
+      for (size_t c = 0; c < a_table.vars.size(); c++) {
+        const Variable &v = a_data.variable(a_table.vars[c]);
+        if (v.kind == Kind::Digital) {
+          const char *bits = v.digital.data() + a_digital[c][r];
+          size_t len = std::strlen(bits);
+          std::memcpy(p, bits, len);
+          p += len;
+        }
+        else if (v.kind == Kind::Complex) {
+          p = formatNumber(p, v.values[2 * r], prec);
+          *p++ = d;
+          p = formatNumber(p, v.values[2 * r + 1], prec);
+        }
+        else
+          p = formatNumber(p, v.values[r], prec);
+        *p++ = d;
+      }
+      p[-1] = '\n';
+      pos = size_t(p - out.data());
+
+      for (size_t a = 0; a < naxes && ++idx[a] == a_lengths[a]; a++)
+        idx[a] = 0;   // carry to the next axis
+    }
+    out.resize(pos);
+  }
+
+private:
+  const DataSet &a_data;
+  const Table &a_table;
+  const ExportOptions &a_options;
+  std::vector<size_t> a_lengths;
+  std::vector<std::vector<size_t>> a_digital;  // offsets of the bit vectors
+  size_t a_longest;                            // longest bit vector
+};
+
+// Chunks of rows are formatted on all cores, batch by batch, while the
+// previous batch is being written.
+bool writeCsv(FILE *f, const DataSet &data, const Table &t, const ExportOptions &o)
+{
+  CsvWriter writer(data, t, o);
+  std::string h = writer.header();
+  if (fwrite(h.data(), 1, h.size(), f) != h.size()) return false;
+
+  const size_t chunk = std::max<size_t>(o.chunkRows, 1);
+  const size_t chunks = (t.rows + chunk - 1) / chunk;
+  size_t threads = o.threads > 0 ? size_t(o.threads)
+                                 : std::max(1u, std::thread::hardware_concurrency());
+  threads = std::max<size_t>(1, std::min(threads, chunks));
+
+  std::vector<std::string> current(threads), previous(threads);
+  std::thread output;
+  bool ok = true;
+
+  for (size_t c0 = 0; c0 < chunks; c0 += threads) {
+    const size_t n = std::min(threads, chunks - c0);
+    auto work = [&writer, &current, &t, chunk, c0](size_t i) {
+      size_t r0 = (c0 + i) * chunk;
+      writer.format(r0, std::min(r0 + chunk, t.rows), current[i]);
+    };
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < n; i++) pool.emplace_back(work, i);
+    work(0);
+    for (std::thread &th : pool) th.join();
+
+    if (output.joinable()) output.join();
+    if (!ok) break;
+    std::swap(current, previous);
+    output = std::thread([f, &previous, &ok, n]() {
+      for (size_t i = 0; i < n && ok; i++)
+        ok = fwrite(previous[i].data(), 1, previous[i].size(), f) == previous[i].size();
+    });
+  }
+  if (output.joinable()) output.join();
+  return ok;
+}
+
+// -------------------------------------------------------
+// columnar files
+
+template <typename T>
+inline bool put(FILE *f, T value)
+{
+  return fwrite(&value, sizeof(T), 1, f) == 1;
+}
+
+bool writeColumns(FILE *f, const DataSet &data, const Table &t, const ExportOptions &o)
+{
+  std::vector<int> cols = t.axes;
+  cols.insert(cols.end(), t.vars.begin(), t.vars.end());
+
+  bool ok = fwrite("QUCSCOL1", 1, 8, f) == 8;
+  ok = ok && put<uint32_t>(f, uint32_t(cols.size())) && put<uint32_t>(f, 0)
+          && put<uint64_t>(f, uint64_t(t.rows));
+  for (size_t c = 0; c < cols.size() && ok; c++) {
+    const Variable &v = data.variable(cols[c]);
+    bool cplx = c >= t.axes.size() && v.kind == Kind::Complex;
+    static const char zeros[8] = {0};
+    ok = put<uint32_t>(f, cplx ? 2 : 1) && put<uint32_t>(f, uint32_t(v.name.size()))
+      && fwrite(v.name.data(), 1, v.name.size(), f) == v.name.size()
+      && fwrite(zeros, 1, (8 - v.name.size() % 8) % 8, f) == (8 - v.name.size() % 8) % 8;
+  }
+
+  // axes are repeated: value (row / stride) % length
+  const size_t chunk = std::max<size_t>(o.chunkRows, 1);
+  std::vector<double> buffer;
+  size_t stride = 1;
+  for (int a : t.axes) {
+    const Variable &v = data.variable(a);
+    for (size_t r0 = 0; r0 < t.rows && ok; r0 += chunk) {
+      size_t r1 = std::min(r0 + chunk, t.rows);
+      buffer.resize(r1 - r0);
+      for (size_t r = r0; r < r1; r++)
+        buffer[r - r0] = axisValue(v, (r / stride) % v.length);
+      ok = fwrite(buffer.data(), sizeof(double), buffer.size(), f) == buffer.size();
+    }
+    stride *= v.length;
+  }
+  // values are written straight from the decoded columns
+  for (int i : t.vars) {
+    const Variable &v = data.variable(i);
+    size_t n = t.rows * (v.kind == Kind::Complex ? 2 : 1);
+    ok = ok && fwrite(v.values.data(), sizeof(double), n, f) == n;
+  }
+  return ok;
+}
+
+} // namespace
+
+// -------------------------------------------------------
+bool exportData(DataSet &data, const std::vector<int> &vars,
+                const std::string &path, const ExportOptions &options,
+                std::vector<std::string> &written, std::string &error)
+{
+  const uint16_t probe = 1;
+  if (options.format == Format::Columns && *reinterpret_cast<const char *>(&probe) != 1) {
+    error = "columnar files can only be written on little endian machines";
+    return false;
+  }
+
+  // group the dependent variables by their independent variables
+  std::vector<Table> tables;
+  for (int i : vars) {
+    if (i < 0 || i >= data.count()) continue;
+    if (!data.decode(i)) {
+      error = "cannot decode " + data.variable(i).name;
+      return false;
+    }
+    const Variable &v = data.variable(i);
+    if (v.indep) continue;
+    if (options.format == Format::Columns && v.kind == Kind::Digital) {
+      error = "digital variable " + v.name + " cannot be written to a columnar file";
+      return false;
+    }
+
+    Table t;
+    for (const std::string &dep : v.deps) {
+      int a = data.find(dep);
+      if (a < 0 || !data.decode(a) || data.variable(a).kind == Kind::Digital) {
+        error = "independent variable " + dep + " of " + v.name + " not found";
+        return false;
+      }
+      t.axes.push_back(a);
+      t.rows *= data.variable(a).length;
+    }
+    if (v.length != t.rows) {
+      error = v.name + " has " + std::to_string(v.length) + " values instead of " + std::to_string(t.rows);
+      return false;
+    }
+
+    auto same = std::find_if(tables.begin(), tables.end(),
+                             [&t](const Table &u) { return u.axes == t.axes; });
+    if (same == tables.end()) {
+      t.vars.push_back(i);
+      tables.push_back(std::move(t));
+    }
+    else
+      same->vars.push_back(i);
+  }
+  // independent variables not already written as axis
+  for (int i : vars) {
+    if (i < 0 || i >= data.count() || !data.variable(i).indep) continue;
+    bool used = std::any_of(tables.begin(), tables.end(), [i](const Table &t) {
+      return std::find(t.axes.begin(), t.axes.end(), i) != t.axes.end();
+    });
+    if (used) continue;
+    Table t;
+    t.axes.push_back(i);
+    t.rows = data.variable(i).length;
+    tables.push_back(std::move(t));
+  }
+  if (tables.empty()) {
+    error = "nothing to export";
+    return false;
+  }
+
+  for (const Table &t : tables) {
+    std::string name = tables.size() > 1 ? tableFileName(path, data, t) : path;
+    FILE *f = openFile(name);
+    if (!f) {
+      error = "cannot create " + name;
+      return false;
+    }
+    std::vector<char> buffer(1 << 20);
+    setvbuf(f, buffer.data(), _IOFBF, buffer.size());
+
+    bool ok = options.format == Format::CSV ? writeCsv(f, data, t, options)
+                                            : writeColumns(f, data, t, options);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+      error = "cannot write " + name;
+      return false;
+    }
+    written.push_back(name);
+  }
+  return true;
+}
+
+} // namespace qucsdata
@@ -0,0 +1,67 @@
+/***************************************************************************
+                                 exporter.h
+                                ------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QUCSDATA_EXPORTER_H
+#define QUCSDATA_EXPORTER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*!
+ * \file exporter.h
+ * \brief Streams variables of a dataset into CSV or columnar files.
+ *
+ * Variables over the same independent variables share a table whose first
+ * columns are these independent variables, repeated as needed (the first
+ * one runs fastest, as in the dataset). Every table goes into a file of
+ * its own. Rows are formatted in chunks on all cores while the previous
+ * chunks are written, so only a few chunks are held in memory.
+ *
+ * The columnar format ("*.qcol") is meant for fast loading elsewhere
+ * (numpy.memmap, see qucsdata.py). All numbers are little endian:
+ *
+ *   "QUCSCOL1"                         magic, 8 bytes
+ *   uint32 columns, uint32 0, uint64 rows
+ *   per column: uint32 kind (1 real, 2 complex), uint32 name length,
+ *               name (UTF-8), zero padding to a multiple of 8
+ *   per column: rows doubles, or rows re/im pairs if complex
+ */
+
+namespace qucsdata {
+
+class DataSet;
+
+enum class Format { CSV, Columns };
+
+struct ExportOptions {
+  Format format = Format::CSV;
+  char delimiter = ',';      // CSV only
+  int precision = 0;         // significant digits, 0: shortest exact form
+  int threads = 0;           // 0: one per core
+  size_t chunkRows = 32768;  // rows formatted as one piece
+};
+
+// Writes the variables "vars" (indices into "data") to "path". If they
+// need several tables, the names of the independent variables are added
+// to the file name: "out_time.csv", "out_frequency.csv". The names of the
+// files written are appended to "written".
+bool exportData(DataSet &data, const std::vector<int> &vars,
+                const std::string &path, const ExportOptions &options,
+                std::vector<std::string> &written, std::string &error);
+
+} // namespace qucsdata
+
+#endif // QUCSDATA_EXPORTER_H
@@ -0,0 +1,143 @@
+/***************************************************************************
+                                qucsdata.cpp
+                               --------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "qucsdata.h"
+#include "dataset.h"
+
+/*!
+ * \file qucsdata.cpp
+ * \brief C interface of the dataset reader, see qucsdata.h.
+ */
+
+struct qucsdata_file {
+  qucsdata::DataSet set;
+};
+
+static thread_local std::string last_error;
+
+static inline bool valid(const qucsdata_file *ds, int var)
+{
+  return ds && var >= 0 && var < ds->set.count();
+}
+
+// returns the variable decoded, or nullptr
+static const qucsdata::Variable *decoded(qucsdata_file *ds, int var)
+{
+  if (!valid(ds, var) || !ds->set.decode(var)) return nullptr;
+  return &ds->set.variable(var);
+}
+
+// -------------------------------------------------------
+int qucsdata_abi_version(void)
+{
+  return QUCSDATA_ABI_VERSION;
+}
+
+qucsdata_file *qucsdata_open(const char *path)
+{
+  if (!path) {
+    last_error = "no file name";
+    return nullptr;
+  }
+  qucsdata_file *ds = new qucsdata_file;
+  if (!ds->set.open(path)) {
+    last_error = ds->set.error();
+    delete ds;
+    return nullptr;
+  }
+  return ds;
+}
+
+const char *qucsdata_last_error(void)
+{
+  return last_error.c_str();
+}
+
+void qucsdata_close(qucsdata_file *ds)
+{
+  delete ds;
+}
+
+// -------------------------------------------------------
+int qucsdata_count(const qucsdata_file *ds)
+{
+  return ds ? ds->set.count() : 0;
+}
+
+int qucsdata_find(const qucsdata_file *ds, const char *name)
+{
+  return (ds && name) ? ds->set.find(name) : -1;
+}
+
+const char *qucsdata_name(const qucsdata_file *ds, int var)
+{
+  return valid(ds, var) ? ds->set.variable(var).name.c_str() : nullptr;
+}
+
+int qucsdata_is_indep(const qucsdata_file *ds, int var)
+{
+  return valid(ds, var) && ds->set.variable(var).indep;
+}
+
+int qucsdata_dep_count(const qucsdata_file *ds, int var)
+{
+  return valid(ds, var) ? int(ds->set.variable(var).deps.size()) : 0;
+}
+
+const char *qucsdata_dep_name(const qucsdata_file *ds, int var, int dep)
+{
+  if (!valid(ds, var) || dep < 0 || dep >= qucsdata_dep_count(ds, var))
+    return nullptr;
+  return ds->set.variable(var).deps[dep].c_str();
+}
+
+// -------------------------------------------------------
+void qucsdata_decode_all(qucsdata_file *ds, int threads)
+{
+  if (ds) ds->set.decodeAll(threads);
+}
+
+int qucsdata_kind(qucsdata_file *ds, int var)
+{
+  const qucsdata::Variable *v = decoded(ds, var);
+  if (!v) return QUCSDATA_UNKNOWN;
+  switch (v->kind) {
+  case qucsdata::Kind::Real:    return QUCSDATA_REAL;
+  case qucsdata::Kind::Complex: return QUCSDATA_COMPLEX;
+  case qucsdata::Kind::Digital: return QUCSDATA_DIGITAL;
+  default:                      return QUCSDATA_UNKNOWN;
+  }
+}
+
+size_t qucsdata_length(qucsdata_file *ds, int var)
+{
+  const qucsdata::Variable *v = decoded(ds, var);
+  return v ? v->length : 0;
+}
+
+const double *qucsdata_values(qucsdata_file *ds, int var)
+{
+  const qucsdata::Variable *v = decoded(ds, var);
+  if (!v || v->kind == qucsdata::Kind::Digital) return nullptr;
+  return v->values.data();
+}
+
+const char *qucsdata_digital(qucsdata_file *ds, int var, size_t *bytes)
+{
+  const qucsdata::Variable *v = decoded(ds, var);
+  if (!v || v->kind != qucsdata::Kind::Digital) return nullptr;
+  if (bytes) *bytes = v->digital.size();
+  return v->digital.data();
+}
@@ -0,0 +1,92 @@
+/***************************************************************************
+                                 qucsdata.h
+                                ------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef QUCSDATA_H
+#define QUCSDATA_H
+
+#include <stddef.h>
+
+/*!
+ * \file qucsdata.h
+ * \brief C interface of the dataset reader (libqucsdata).
+ *
+ * This interface is kept stable for scripts and other tools: functions are
+ * only ever added, and qucsdata_abi_version() is raised when that happens.
+ * Variables are addressed by index (0 .. qucsdata_count()-1). Values are
+ * decoded on first access and stay owned by the dataset handle until
+ * qucsdata_close(); the returned pointers can be used without copying.
+ */
+
+#if defined(_WIN32)
+#  if defined(QUCSDATA_BUILD)
+#    define QUCSDATA_API __declspec(dllexport)
+#  elif defined(QUCSDATA_STATIC)
+#    define QUCSDATA_API
+#  else
+#    define QUCSDATA_API __declspec(dllimport)
+#  endif
+#else
+#  define QUCSDATA_API __attribute__((visibility("default")))
+#endif
+
+#define QUCSDATA_ABI_VERSION 1
+
+/* kind of a variable */
+#define QUCSDATA_UNKNOWN 0
+#define QUCSDATA_REAL    1
+#define QUCSDATA_COMPLEX 2
+#define QUCSDATA_DIGITAL 3
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct qucsdata_file qucsdata_file;
+
+QUCSDATA_API int qucsdata_abi_version(void);
+
+/* Opens a Qucs dataset or SPICE raw file (UTF-8 path). Returns NULL on
+   failure, qucsdata_last_error() then tells why. */
+QUCSDATA_API qucsdata_file *qucsdata_open(const char *path);
+QUCSDATA_API const char *qucsdata_last_error(void);
+QUCSDATA_API void qucsdata_close(qucsdata_file *ds);
+
+QUCSDATA_API int qucsdata_count(const qucsdata_file *ds);
+QUCSDATA_API int qucsdata_find(const qucsdata_file *ds, const char *name);
+QUCSDATA_API const char *qucsdata_name(const qucsdata_file *ds, int var);
+QUCSDATA_API int qucsdata_is_indep(const qucsdata_file *ds, int var);
+QUCSDATA_API int qucsdata_dep_count(const qucsdata_file *ds, int var);
+QUCSDATA_API const char *qucsdata_dep_name(const qucsdata_file *ds, int var, int dep);
+
+/* Decodes all variables using "threads" threads (0: one per core). */
+QUCSDATA_API void qucsdata_decode_all(qucsdata_file *ds, int threads);
+
+/* The functions below decode the variable if necessary. */
+QUCSDATA_API int qucsdata_kind(qucsdata_file *ds, int var);
+QUCSDATA_API size_t qucsdata_length(qucsdata_file *ds, int var);
+
+/* Real: "length" doubles. Complex: 2*"length" doubles, re/im interleaved.
+   NULL for digital variables and on errors. */
+QUCSDATA_API const double *qucsdata_values(qucsdata_file *ds, int var);
+
+/* Digital: "length" NUL terminated bit strings back to back, the total
+   size in bytes is stored in *bytes. NULL for other variables. */
+QUCSDATA_API const char *qucsdata_digital(qucsdata_file *ds, int var, size_t *bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QUCSDATA_H */
@@ -30,9 +30,11 @@
 
 #endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
 #include <cfloat>
+#include <cstring>
 
 #if HAVE_IEEEFP_H
 # include <ieeefp.h>
@@ -47,11 +49,14 @@
 
 #include "rect3ddiagram.h"
 #include "misc.h"
+#include "tracing.h"
+#include "dataset.h"
 
 #include <QTextStream>
 #include <QMessageBox>
 #include <QRegularExpression>
 #include <QDateTime>
+#include <QCryptographicHash>
 #include <QPainter>
 #include <QDebug>
 
@@ -705,6 +710,7 @@ void Diagram::getAxisLimits(Graph *pg) {
 
 // --------------------------------------------------------------------------
 void Diagram::loadGraphData(const QString &defaultDataSet) {
+    QUCS_TRACE("Diagram::loadGraphData");
     int yNum = yAxis.numGraphs;
     int zNum = zAxis.numGraphs;
     yAxis.numGraphs = zAxis.numGraphs = 0;
@@ -722,6 +728,8 @@ void Diagram::loadGraphData(const QString &defaultDataSet) {
         getAxisLimits(pg);
     }
 
+    Graph::releaseDataSet();   // the graphs keep their own copies
+
     if (No <= 0) {   // All dataset files unchanged ?
         yAxis.numGraphs = yNum;  // rebuild scrollbar position
         zAxis.numGraphs = zNum;
@@ -789,9 +797,12 @@ void Diagram::updateGraphData() {
         pg->clear();
         if ((valid & (pg->yAxisNo + 1)) != 0)
             calcData(pg);   // calculate screen coordinates
-        else if (pg->cPointsY) {
-            delete[] pg->cPointsY;
-            pg->cPointsY = 0;
+        else {
+            if (pg->cPointsY) {
+                delete[] pg->cPointsY;
+                pg->cPointsY = 0;
+            }
+            pg->cDigital.clear();
         }
     }
 
@@ -856,6 +867,7 @@ int Graph::loadDatFile(const QString &fileName) {
         delete[] g->cPointsY;
         g->cPointsY = 0;
     }
+    g->cDigital.clear();
     if (Variable.isEmpty()) return 0;
 
 #if 0 // FIXME encapsulation. implement digital waves later.
@@ -874,68 +886,30 @@ int Graph::loadDatFile(const QString &fileName) {
     }
 
 
-    if (!file.open(QIODevice::ReadOnly)) return 0;
-
-    // *****************************************************************
-    // To strongly speed up the file read operation the whole file is
-    // read into the memory in one piece.
-    QByteArray FileContent;
-    FileContent = file.readAll();
-    file.close();
-    char *FileString = FileContent.data();
-    if (!FileString) return 0;
-    char *pPos = FileString + FileContent.size() - 1;
-    if (*pPos > ' ') if (*pPos != '>') return 0;
-    *pPos = 0;
-
+    qucsdata::DataSet *data = openDataSet(file.fileName());
+    if (!data) return 0;
 
     // *****************************************************************
     // look for variable name in data file  ****************************
-    bool isIndep = false;
-    Variable = "dep " + Variable + " ";
-    // "pFile" is used through-out the whole function and must NOT used
-    // for other purposes!
-    char *pFile = strstr(FileString, Variable.toLatin1());
-    while (pFile) {
-        if (*(pFile - 1) == '<')     // is dependent variable ?
-            break;
-        else if (strncmp(pFile - 3, "<in", 3) == 0) {  // is independent variable ?
-            isIndep = true;
-            break;
-        }
-        pFile = strstr(pFile + 4, Variable.toLatin1());
-    }
-
-    if (!pFile) return 0;   // data not found
-
-    QString Line, tmp;
-    pFile += Variable.length();
-    pPos = strchr(pFile, '>');
-    if (!pPos) return 0;   // file corrupt
-    *pPos = 0;
-    Line = QString(pFile);
-    *pPos = '>';
-    pFile = pPos + 1;
+    int idx = data->find(Variable.toStdString());
+    if (idx < 0) return 0;   // data not found
+    bool isIndep = data->variable(idx).indep;
     if (!isIndep) {
-        pos = 0;
-        tmp = Line.section(' ', pos, pos);
-        while (!tmp.isEmpty()) {
-            if (hasExplIndep)g->mutable_axes().push_back(new DataX(ExplIndep));
-            else g->mutable_axes().push_back(new DataX(tmp));  // name of independent variable
-            pos++;
-            tmp = Line.section(' ', pos, pos);
+        for (const std::string &dep : data->variable(idx).deps) {
+            if (hasExplIndep) g->mutable_axes().push_back(new DataX(ExplIndep));
+            else g->mutable_axes().push_back(new DataX(QString::fromStdString(dep)));  // name of independent variable
         }
     }
+    if (!data->decode(idx)) return 0;   // file corrupt
+    const qucsdata::Variable &var = data->variable(idx);
 
     // *****************************************************************
     // get independent variable ****************************************
-    bool ok = true;
     double *p;
     int counting = 0;
     if (isIndep) {    // create independent variable by myself ?
-        counting = Line.toInt(&ok);  // get number of values
+        counting = int(var.length);  // get number of values
         g->mutable_axes().push_back(new DataX("number", 0, counting));
-        if (!ok) return 0;
 
         p = new double[counting];  // memory of new independent variable
         g->countY = 1;
@@ -947,25 +921,9 @@ int Graph::loadDatFile(const QString &fileName) {
     } else {  // ...................................
         // get independent variables from data file
         g->countY = 1;
-#if 0 // FIXME: we do not have a Name.
-        DataX *bLast = 0;
-        if(Name == "Rect3D")  bLast = g->axis(1);  // y axis for Rect3D
-#endif
-
-#if 0 // FIXME: this is about diagram. do after load.
-        double min_tmp = xAxis.min, max_tmp = xAxis.max;
-#endif
         DataX const *pD;
         for (int ii = g->numAxes(); (pD = g->axis(--ii));) {
-#if 0 // FIXME: this is about diagram. do after load.
-            pa = &xAxis;
-            if(pD == g->axis(0)) {
-              xAxis.min = min_tmp;    // only count first independent variable
-              xAxis.max = max_tmp;
-            }
-            else if(pD == bLast)  pa = &yAxis;   // y axis for Rect3D
-#endif
-            counting = loadIndepVarData(pD->Var, FileString, mutable_axis(ii));
+            counting = loadIndepVarData(pD->Var, *data, mutable_axis(ii));
             if (counting <= 0) return 0;
 
             g->countY *= counting;
@@ -977,96 +935,32 @@ int Graph::loadDatFile(const QString &fileName) {
     // *****************************************************************
     // get dependent variables *****************************************
     counting *= g->countY;
-    p = new double[2 * counting]; // memory for dependent variables
-    g->cPointsY = p;
-#if 0 // FIXME: what does this do?!
-    if(g->yAxisNo == 0)  pa = &yAxis;   // for which axis
-    else  pa = &zAxis;
-    (pa->numGraphs)++;    // count graphs
-#endif
+    if (var.length < size_t(counting)) return 0;   // file corrupt
 
-    char *pEnd;
-    double x, y;
-    pPos = pFile;
+    if (var.kind != qucsdata::Kind::Digital) {
+        p = new double[2 * counting]; // memory for dependent variables
+        g->cPointsY = p;
 
-    if (Variable.right(3) != ".X ") { // not "digital"
-
-        for (int z = counting; z > 0; z--) {
-            pEnd = 0;
-            while ((*pPos) && (*pPos <= ' ')) pPos++; // find start of next number
-            x = strtod(pPos, &pEnd);  // real part
-            pPos = pEnd + 1;
-            if (*pEnd < ' ')   // is there an imaginary part ?
-                y = 0.0;
-            else {
-                if (((*pEnd != '+') && (*pEnd != '-')) || (*pPos != 'j')) {
-                    delete[] g->cPointsY;
-                    g->cPointsY = 0;
-                    return 0;
-                }
-                *pPos = *pEnd;  // overwrite 'j' with sign
-                pEnd = 0;
-                y = strtod(pPos, &pEnd); // imaginary part
-                *pPos = 'j';   // write back old character
-                pPos = pEnd;
-            }
+        const double *v = var.values.data();
+        const bool cplx = var.kind == qucsdata::Kind::Complex;
+        auto Axis = g->mutable_axes().back();
+        for (int z = 0; z < counting; z++) {
+            double x = cplx ? v[2 * z] : v[z];
+            double y = cplx ? v[2 * z + 1] : 0.0;
             *(p++) = x;
             *(p++) = y;
-#if 0 // FIXME there is no Name here.
-            if(Name[0] != 'C')
-#endif
-            {
-                if (fabs(y) >= 1e-250) x = sqrt(x * x + y * y);
-                if (std::isfinite(x)) {
-                    auto Axis = g->mutable_axes().back();
-                    Axis->min(x);
-                    Axis->max(x);
-                }
-            }
-
-#if 0 // this is not location curve code.
-            else {   // location curve needs different treatment
-              if(std::isfinite(x)) {
-                if(x > xAxis.max) xAxis.max = x;
-                if(x < xAxis.min) xAxis.min = x;
-              }
-              if(std::isfinite(y)) {
-                if(y > pa->max) pa->max = y;
-                if(y < pa->min) pa->min = y;
-              }
-            }
-#endif
-        }
-
-    } else {  // of "if not digital"
-
-        char *pc = (char *) p;
-        pEnd = pc + 2 * (counting - 1) * sizeof(double);
-        // for digital variables (e.g. 100ZX0):
-        for (int z = counting; z > 0; z--) {
 
-            while ((*pPos) && (*pPos <= ' ')) pPos++; // find start of next bit vector
-            if (*pPos == 0) {
-                delete[] g->cPointsY;
-                g->cPointsY = 0;
-                return 0;
-            }
-
-            while (*pPos > ' ') {    // copy bit vector
-                *(pc++) = *(pPos++);
-                if (pEnd <= pc) {
-                    counting = pc - (char *) g->cPointsY;
-                    pc = (char *) realloc(g->cPointsY, counting + 1024);
-                    pEnd = pc;
-                    g->cPointsY = (double *) pEnd;
-                    pc += counting;
-                    pEnd += counting + 1020;
-                }
+            if (fabs(y) >= 1e-250) x = sqrt(x * x + y * y);
+            if (std::isfinite(x)) {
+                Axis->min(x);
+                Axis->max(x);
             }
-            *(pc++) = 0;   // terminate each vector with NULL
         }
 
-    }  // of "if not digital"
+    } else {
+        // digital variables (e.g. 100ZX0) are kept as their transitions
+        g->cDigital.encode(var.digital.data(), counting);
+    }
 
     lastLoaded = QDateTime::currentDateTime();
     return 2;
@@ -1076,94 +970,113 @@ int Graph::loadDatFile(const QString &fileName) {
    Reads the data of an independent variable. Returns the number of points.
 */
 int Graph::loadIndepVarData(const QString &Variable,
-                            char *FileString, DataX *pD) {
-    bool isIndep = false;
-    QString Line, tmp;
-
-    /* WORK-AROUND: A bug in SCIM (libscim) which Qt is linked to causes
-       to change the locale to the default. */
-    setlocale(LC_NUMERIC, "C");
-
-    Line = "dep " + Variable + " ";
-    // "pFile" is used through-out the whole function and must NOT used
-    // for other purposes!
-    char *pFile = strstr(FileString, Line.toLatin1());
-    while (pFile) {
-        if (*(pFile - 1) == '<')     // is dependent variable ?
-            break;
-        else if (strncmp(pFile - 3, "<in", 3) == 0) {  // is independent variable ?
-            isIndep = true;
-            break;
-        }
-        pFile = strstr(pFile + 4, Line.toLatin1());
-    }
-
-    if (!pFile) return -1;   // data not found
-
-    pFile += Line.length();
-    char *pPos = strchr(pFile, '>');
-    if (!pPos) return -1;   // file corrupt
-    *pPos = 0;
-    Line = QString(pFile);
-    *pPos = '>';
-    pFile = pPos + 1;
-    char *pEnd;
-    if (!isIndep) {           // dependent variable can also be used...
-        if (Line.indexOf(' ') >= 0) return -1; // ...if only one dependency
-        Line = "<indep " + Line + " ";
-        pPos = strstr(FileString, Line.toLatin1());
-        if (!pPos) return -1;
-        pPos += Line.length();
-        pEnd = strchr(pPos, '>');
-        if (!pEnd) return -1;   // file corrupt
-        *pEnd = 0;
-        Line = QString(pPos);
-        *pEnd = '>';
-    }
-
-
-    bool ok;
-    int n = Line.toInt(&ok);  // number of values
-    if (!ok) return -1;
-
+                            qucsdata::DataSet &data, DataX *pD) {
+    int idx = data.find(Variable.toStdString());
+    if (idx < 0) return -1;   // data not found
+
+    // dependent variable can also be used if only one dependency
+    if (!data.variable(idx).indep && data.variable(idx).deps.size() != 1)
+        return -1;
+    if (!data.decode(idx)) return -1;   // file corrupt
+    const qucsdata::Variable &var = data.variable(idx);
+    if (var.kind == qucsdata::Kind::Digital) return -1;
+
+    int n = int(var.length);   // number of values
     double *p = new double[n];     // memory for new independent variable
-//  DataX *pD = pg->mutable_axes().back();
     pD->Points = p;
     pD->count = n;
 
+    // drop imaginary part because complex number on X-axis has no sense
+    const size_t step = (var.kind == qucsdata::Kind::Complex) ? 2 : 1;
+    for (int z = 0; z < n; z++)
+        *(p++) = var.values[z * step];
 
-    double x;
-    pPos = pFile;
-    // find first position containing no whitespace
-    while ((*pPos) && (*pPos <= ' ')) pPos++;
+    return n;   // return number of independent data
+}
 
-    for (int z = 0; z < n; z++) {
-        pEnd = 0;
-        x = strtod(pPos, &pEnd);  // real part
+namespace {
+// The dataset kept by Graph::openDataSet()
+struct CachedDataSet {
+    qucsdata::DataSet data;
+    QString name;
+    qint64 modified = -1;   // ms since epoch
+    qint64 size = -1;
+    QByteArray tail;        // hash of the last bytes of the file
+    int holds = 0;          // nested Graph::holdDataSet() calls
+};
 
-        if (*pEnd > ' ')  // drop imaginary part because
-            while (*pEnd > ' ') pEnd++; // Complex number on X-axis has no sense
+CachedDataSet &cachedDataSet() {
+    static CachedDataSet cached;
+    return cached;
+}
+}
 
-        if (pPos == pEnd) {
-            delete[] pD->Points;
-            pD->Points = 0;
-            return -1;
-        }
+/*!
+   Returns the dataset "fileName", indexed by the qucsdata reader. The file
+   is kept until releaseDataSet(), so all graphs of the diagrams loaded in
+   between share one read and every variable is decoded only once. It is
+   identified by path, modification time in ms, size and a hash of its last
+   4 KiB. Returns NULL on errors and for truncated Qucs datasets.
+*/
+qucsdata::DataSet *Graph::openDataSet(const QString &fileName) {
+    CachedDataSet &cached = cachedDataSet();
 
-        *(p++) = x;
-#if 0 // this is not location curve code
-        if(Name[0] != 'C')   // not for location curves
-          if(std::isfinite(x)) {
-            if(x > pa->max) pa->max = x;
-            if(x < pa->min) pa->min = x;
-          }
-#endif
+    QFileInfo Info(fileName);
+    QFile file(Info.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) return nullptr;
+    qint64 size = file.size();
+    char first = 0;
+    file.getChar(&first);
+    file.seek(std::max<qint64>(size - 4096, 0));
+    QByteArray end = file.readAll();
+    file.close();
 
-        pPos = pEnd;
-        while ((*pPos) && (*pPos <= ' ')) pPos++;  // find start of next number
+    // a Qucs dataset is complete if it ends with '>' (white space aside)
+    QByteArray last = end.trimmed();
+    if (first == '<' && !last.isEmpty() && !last.endsWith('>')) return nullptr;
+
+    QByteArray tail = QCryptographicHash::hash(end, QCryptographicHash::Md5);
+    qint64 modified = Info.lastModified().toMSecsSinceEpoch();
+    if (cached.name == Info.absoluteFilePath() && cached.modified == modified &&
+        cached.size == size && cached.tail == tail)
+        return &cached.data;
+
+    cached.name.clear();
+    // read, not mapped: the simulator overwrites the file on the next run
+    if (!cached.data.open(Info.absoluteFilePath().toStdString(), false)) {
+        qDebug() << "Graph::openDataSet:" << QString::fromStdString(cached.data.error());
+        return nullptr;
     }
+    cached.name = Info.absoluteFilePath();
+    cached.modified = modified;
+    cached.size = size;
+    cached.tail = tail;
+    return &cached.data;
+}
 
-    return n;   // return number of independent data
+/*!
+   Frees the dataset kept by openDataSet(), unless holdDataSet() keeps it
+   for further diagrams.
+*/
+void Graph::releaseDataSet() {
+    CachedDataSet &cached = cachedDataSet();
+    if (cached.holds > 0) return;
+    cached.data.close();
+    cached.name.clear();
+}
+
+/*!
+   Keeps the dataset of openDataSet() across Diagram::loadGraphData() calls
+   while "hold" is true, e.g. while all diagrams of a schematic are loaded.
+   Calls nest, the last holdDataSet(false) releases the dataset.
+*/
+void Graph::holdDataSet(bool hold) {
+    CachedDataSet &cached = cachedDataSet();
+    if (hold) {
+        cached.holds++;
+    } else if (cached.holds > 0 && --cached.holds == 0) {
+        releaseDataSet();
+    }
 }
 
 /*!
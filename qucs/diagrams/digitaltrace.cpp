@@ -0,0 +1,81 @@
+/***************************************************************************
+                              digitaltrace.cpp
+                             ------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+ * \file digitaltrace.cpp
+ * \brief Implementation of the DigitalTrace class
+ */
+
+#include "digitaltrace.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <cstring>
+
+
+void DigitalTrace::encode(const char *values, int count)
+{
+  clear();
+
+  QHash<QByteArray, int> known;  // position of every value in a_text
+  const char *last = 0;
+  int length;
+  for(int z = 0; z < count; z++, values += length + 1) {
+    length = strlen(values);
+    if(last && strcmp(last, values) == 0)
+      continue;   // run goes on
+    last = values;
+
+    QByteArray v(values, length);
+    QHash<QByteArray, int>::const_iterator it = known.constFind(v);
+    int pos;
+    if(it == known.constEnd()) {
+      pos = a_text.size();
+      a_text.append(v);
+      a_text.append('\0');
+      known.insert(v, pos);
+      if(length > a_width)
+        a_width = length;
+    }
+    else
+      pos = it.value();
+
+    a_start.append(z);
+    a_value.append(pos);
+  }
+
+  a_count = count;
+  a_start.squeeze();
+  a_value.squeeze();
+}
+
+void DigitalTrace::clear()
+{
+  a_start.clear();
+  a_value.clear();
+  a_text.clear();
+  a_count = a_width = 0;
+}
+
+int DigitalTrace::run(int sample) const
+{
+  // the last run starting at or before "sample"
+  QVector<int>::const_iterator it =
+    std::upper_bound(a_start.constBegin(), a_start.constEnd(), sample);
+  if(it == a_start.constBegin())
+    return 0;
+  return int(it - a_start.constBegin()) - 1;
+}
@@ -0,0 +1,70 @@
+/***************************************************************************
+                               digitaltrace.h
+                              ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef DIGITALTRACE_H
+#define DIGITALTRACE_H
+
+#include <QByteArray>
+#include <QVector>
+
+/*!
+ * \file digitaltrace.h
+ * \brief Declaration of the DigitalTrace class
+ */
+
+/*!
+ * \brief The DigitalTrace class keeps the values of a digital variable
+ *        (e.g. "100ZX0") run-length encoded.
+ *
+ * A digital simulation writes one sample per time step of the whole
+ * design, but a single signal changes in few of them. So the trace stores
+ * only its transitions: the first sample of every run of equal values and
+ * the value of the run. Each different value is stored once. The value of
+ * any sample is found by a binary search over the runs, which lets the
+ * diagrams look at the visible window only.
+ */
+class DigitalTrace
+{
+public:
+  DigitalTrace() : a_count(0), a_width(0) {}
+
+  // Encodes "count" NUL terminated values stored back to back.
+  void encode(const char *values, int count);
+  void clear();
+
+  bool isEmpty() const { return a_count == 0; }
+  int count() const { return a_count; }         // number of samples
+  int runs() const { return a_start.size(); }
+  int width() const { return a_width; }         // longest value
+
+  // The run "sample" belongs to (0 <= sample < count()).
+  int run(int sample) const;
+  int runStart(int run) const { return a_start.at(run); }
+  int runEnd(int run) const
+    { return run+1 < a_start.size() ? a_start.at(run+1) : a_count; }
+  // Runs with equal values have equal ids.
+  int valueId(int run) const { return a_value.at(run); }
+  const char *value(int run) const
+    { return a_text.constData() + a_value.at(run); }
+  const char *at(int sample) const { return value(run(sample)); }
+
+private:
+  QVector<int> a_start;   // first sample of each run
+  QVector<int> a_value;   // position of the value of each run in a_text
+  QByteArray a_text;      // the different values, NUL terminated
+  int a_count, a_width;
+};
+
+#endif // DIGITALTRACE_H
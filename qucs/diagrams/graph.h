@@ -21,6 +21,7 @@
 
 #include "marker.h"
 #include "element.h"
+#include "digitaltrace.h"
 
 #include <cmath>
 #include <QColor>
@@ -50,6 +51,7 @@ inline graphstyle_t toGraphStyle(int x){
 }
 
 class Diagram;
+namespace qucsdata { class DataSet; }
 
 
 struct DataX {
@@ -126,7 +128,10 @@ public:
   typedef container::const_iterator const_iterator;
 
   int loadDatFile(const QString& filename);
-  int loadIndepVarData(const QString&, char* datfilecontent, DataX* where);
+  int loadIndepVarData(const QString&, qucsdata::DataSet& data, DataX* where);
+  static qucsdata::DataSet* openDataSet(const QString& filename);
+  static void releaseDataSet();
+  static void holdDataSet(bool hold);
 
   void    paint(QPainter* painter);
   void    paintLines(QPainter* painter);
@@ -155,6 +160,7 @@ public:
   QDateTime lastLoaded;  // when it was loaded into memory
   int     yAxisNo;       // which y axis is used
   double *cPointsY;
+  DigitalTrace cDigital;  // digital variables (e.g. 100ZX0) instead of cPointsY
   int     countY;    // number of curves
   QString Var;
   QColor  Color;
@@ -256,11 +256,10 @@ int TabDiagram::calcDiagram()
     Texts.append(new Text(x, y2-2, Str));  // dependent variable
 
 
-    startWriting = int(xAxis.limit_min + 0.5); // when to reach visible area
-    py = g->cPointsY - 2;
+    startWriting = int(xAxis.limit_min + 0.5); // first visible row
     if(g->axis(0)) {
 
-      if (!g->cPointsY) {   // no data points
+      if (!g->cPointsY && g->cDigital.isEmpty()) {   // no data points
 	Str = QObject::tr("invalid");
 	colWidth = checkColumnWidth(Str, metrics, colWidth, x, y);
 	if(colWidth < 0)  goto funcEnd;
@@ -270,10 +269,13 @@ int TabDiagram::calcDiagram()
         int z=g->axis(0)->count * g->countY;
         if(z > NumAll)  NumAll = z;
 
-        if(g->Var.right(2) != ".X")
+        if(startWriting > z)  startWriting = z;
+        z -= startWriting;   // go straight to the visible area
+
+        if(g->cPointsY) {
+          py = g->cPointsY + 2*startWriting - 2;
           for(; z>0; z--) {
             py += 2;
-            if(startWriting-- > 0) continue; // reached visible area ?
             if(y < tHeight) break;           // no room for more rows ?
             switch(g->numMode) {
               case 0: Str = misc::complexRect(*py, *(py+1), g->Precision); break;
@@ -287,22 +289,18 @@ int TabDiagram::calcDiagram()
             Texts.append(new Text(x, y, Str));
             y -= tHeight;
           }
-
+        }
         else {  // digital data
-          char *pcy = (char*)g->cPointsY;
-          for(; z>0; z--) {
-            if(startWriting-- > 0) {  // reached visible area ?
-              pcy += strlen(pcy) + 1;
-              continue;
-            }
+          int run = g->cDigital.run(startWriting);
+          for(int n = startWriting; z>0; z--, n++) {
             if(y < tHeight) break;           // no room for more rows ?
-            Str = QString(pcy);
+            if(n >= g->cDigital.runEnd(run))  run++;
+            Str = QString(g->cDigital.value(run));
 
             colWidth = checkColumnWidth(Str, metrics, colWidth, x, y);
             if(colWidth < 0)  goto funcEnd;
 
             Texts.append(new Text(x, y, Str));
-            pcy += strlen(pcy) + 1;
             y -= tHeight;
           }
         }
@@ -21,6 +21,7 @@
 */
 
 #include "timingdiagram.h"
+#include "digitaltrace.h"
 #include "main.h"
 #include "misc.h"
 
@@ -37,6 +38,8 @@ TimingDiagram::TimingDiagram(int _cx, int _cy) : TabDiagram(_cx, _cy)
   y2 = 200;
   Name = "Time";
   xAxis.limit_min = 0.0;  // scroll bar position (needs to be saved in file)
+  xAxis.step = 1.0;       // time steps per column (also saved in file)
+  StepWidth = 40;
 
   calcDiagram();
 }
@@ -122,6 +125,19 @@ void TimingDiagram::paintDiagram(QPainter *painter) {
   painter->restore();
 }
 
+// ------------------------------------------------------------
+// vertical position of a single bit in its row
+static int bitLevel(char bit, int tHeight)
+{
+  switch(bit) {
+    case '0':  // low
+      return tHeight - 5;
+    case '1':  // high
+      return 1;
+  }
+  return 1 + ((tHeight - 6) >> 1);
+}
+
 // ------------------------------------------------------------
 int TimingDiagram::calcDiagram()
 {
@@ -189,22 +205,18 @@ int TimingDiagram::calcDiagram()
 
   // First check the maximum bit number of all vectors.
   colWidth = 0;
-  for (Graph *g : Graphs)
-    if(g->cPointsY) {
-      if(g->Var.right(2) == ".X") {
-        z = strlen((char*)g->cPointsY);
-        if(z > colWidth)
-          colWidth = z;
-      }
-      else {
-        z = 8;
-        if(z > colWidth)
-          colWidth = z;
-      }
-    }
+  for (Graph *g : Graphs) {
+    if(g->cPointsY)
+      z = 8;
+    else
+      z = g->cDigital.width();
+    if(z > colWidth)
+      colWidth = z;
+  }
   int TimeStepWidth = colWidth * metrics.boundingRect("X").width() + 8;
   if(TimeStepWidth < 40)
     TimeStepWidth = 40;
+  StepWidth = TimeStepWidth;
 
 
   colWidth = 0;
@@ -244,7 +256,16 @@ if(!firstGraph->isEmpty()) {
   xStart = x;
 
 
-  invisibleCount = NumAll - (x2-xAxis.numGraphs)/TimeStepWidth;
+  // A column shows "xAxis.step" time steps, but not more than needed to
+  // show all of them.
+  z = (x2-xAxis.numGraphs)/TimeStepWidth;  // number of columns
+  if(z < 1)  z = 1;
+  if(xAxis.step > double(NumAll) / double(z))
+    xAxis.step = double(NumAll) / double(z);
+  if(xAxis.step < 1.0)
+    xAxis.step = 1.0;
+
+  invisibleCount = NumAll - int(double(z) * xAxis.step + 0.5);
   if(invisibleCount <= 0)  xAxis.limit_min = 0.0;  // longer than needed
   else {
     NumLeft = invisibleCount - int(xAxis.limit_min + 0.5);
@@ -255,12 +276,8 @@ if(!firstGraph->isEmpty()) {
 
   // write independent variable values (usually time)
   y = y2-tHeight-4;
-  px = pD->Points;
-  z = int(xAxis.limit_min + 0.5);
-  px += z;
-  z = pD->count - z;
-  for( ; z>0; z--) {
-    Str = misc::num2str(*(px++));
+  for(double n = int(xAxis.limit_min + 0.5); n < pD->count; n += xAxis.step) {
+    Str = misc::num2str(pD->Points[int(n)]);
     colWidth = metrics.boundingRect(Str).width();  // width of text
     if(x+colWidth+2 >= x2)  break;
 
@@ -290,7 +307,7 @@ if(!firstGraph->isEmpty()) {
     x = xStart + 5;
     colWidth = 0;
 
-    if(g->cPointsY == 0) {
+    if(!g->cPointsY && g->cDigital.isEmpty()) {
       Str = QObject::tr("no data");
       colWidth = checkColumnWidth(Str, metrics, colWidth, x, y);
       if(colWidth < 0)  goto funcEnd;
@@ -316,15 +333,14 @@ if(!firstGraph->isEmpty()) {
     }
 
     z = int(xAxis.limit_min + 0.5);
-    if(g->Var.right(2) != ".X") {  // not digital variable ?
-      px = g->cPointsY;
-      px += 2 * z;
-      z = g->axis(0)->count - z;
+    if(g->cPointsY) {  // not digital variable ?
+      // value at the start of every column
       yNow = 1 + ((tHeight - 6) >> 1);
       Lines.append(new qucs::Line(x, y-yNow, x+2, y-1, Pen));
       Lines.append(new qucs::Line(x+2, y-tHeight+5, x, y-yNow, Pen));
-      for( ; z>0; z--) {
+      for(double n = z; n < g->axis(0)->count; n += xAxis.step) {
         if(x+TimeStepWidth >= x2) break;
+        px = g->cPointsY + 2 * int(n);
         Lines.append(new qucs::Line(x+2, y-1, x+TimeStepWidth-2, y-1, Pen));
         Lines.append(new qucs::Line(x+2, y-tHeight+5, x+TimeStepWidth-2, y-tHeight+5, Pen));
 
@@ -336,7 +352,6 @@ if(!firstGraph->isEmpty()) {
 	  Texts.append(new Text(x+3, y,
               QString::number(sqrt((*px)*(*px) + (*(px+1))*(*(px+1))))));
 
-        px += 2;
         x += TimeStepWidth;
         Lines.append(new qucs::Line(x-2, y-tHeight+5, x+2, y-1, Pen));
         Lines.append(new qucs::Line(x+2, y-tHeight+5, x-2, y-1, Pen));
@@ -347,38 +362,27 @@ if(!firstGraph->isEmpty()) {
 
 
     // digital variable !!!
-    char *pcx = (char*)g->cPointsY;
-    pcx += z * (strlen(pcx)+1);
+    const DigitalTrace &trace = g->cDigital;
+    if(xAxis.step > 1.0) {  // several time steps per column ?
+      calcDigitalLod(trace, z, x, y, tHeight, TimeStepWidth, xAxis.step,
+                     Pen, metrics);
+      y -= tHeight;
+      continue;
+    }
 
-    if(strlen(pcx) < 2) {   // vector or single bit ?
+    int run = trace.run(z);
+    const char *pcx = trace.value(run);
 
-      // It is single "bit".
-      yLast = 0;
-      if(z > 0)  yLast += 2; // vertical line before first value ?
-      switch(*(pcx-yLast)) {  // high or low ?
-        case '0':  // low
-          yLast = tHeight - 5;
-          break;
-        case '1':  // high
-          yLast = 1;
-          break;
-        default:
-          yLast = 1 + ((tHeight - 6) >> 1);
-      }
+    if(trace.width() < 2) {   // vector or single bit ?
 
-      z = g->axis(0)->count - z;
-      for( ; z>0; z--) {
+      // It is single "bit".
+      // vertical line before first value ?
+      yLast = bitLevel(z > 0 ? *trace.at(z-1) : *pcx, tHeight);
 
-        switch(*pcx) {
-          case '0':  // low
-            yNow = tHeight - 5;
-            break;
-          case '1':  // high
-            yNow = 1;
-            break;
-          default:
-            yNow = 1 + ((tHeight - 6) >> 1);
-        } 
+      for( ; z < trace.count(); z++) {
+        if(z >= trace.runEnd(run))
+          pcx = trace.value(++run);
+        yNow = bitLevel(*pcx, tHeight);
 
         if(yLast != yNow)
           Lines.append(new qucs::Line(x, y-yLast, x, y-yNow, Pen));
@@ -397,25 +401,24 @@ if(!firstGraph->isEmpty()) {
 
         yLast = yNow;
         x += TimeStepWidth;
-        pcx += 2;
       }
 
     }
     else {  // It is a bit vector !!!
 
-      z = g->axis(0)->count - z;
       yNow = 1 + ((tHeight - 6) >> 1);
       Lines.append(new qucs::Line(x, y-yNow, x+2, y-1, Pen));
       Lines.append(new qucs::Line(x+2, y-tHeight+5, x, y-yNow, Pen));
-      for( ; z>0; z--) {
+      for( ; z < trace.count(); z++) {
         if(x+TimeStepWidth >= x2) break;
+        if(z >= trace.runEnd(run))
+          pcx = trace.value(++run);
         Lines.append(new qucs::Line(x+2, y-1, x+TimeStepWidth-2, y-1, Pen));
         Lines.append(new qucs::Line(x+2, y-tHeight+5, x+TimeStepWidth-2, y-tHeight+5, Pen));
 
         Texts.append(new Text(x+3, y, QString(pcx)));
 
         x += TimeStepWidth;
-        pcx += strlen(pcx) + 1;
         Lines.append(new qucs::Line(x-2, y-tHeight+5, x+2, y-1, Pen));
         Lines.append(new qucs::Line(x+2, y-tHeight+5, x-2, y-1, Pen));
       }
@@ -463,6 +466,96 @@ funcEnd:
   return 1;
 }
 
+// ------------------------------------------------------------
+/*!
+  Draws the digital variable "trace" from time step "first" on, if every
+  column shows more than one time step. Each pixel column is looked at
+  once: runs of equal values become lines (single bits) or boxes (bit
+  vectors), and pixels with more than one transition are merged into an
+  activity bar. So the work depends on the width of the diagram, not on
+  the length of the trace.
+*/
+void TimingDiagram::calcDigitalLod(const DigitalTrace &trace, int first,
+                                   int x, int y, int tHeight, int stepWidth,
+                                   double step, const QPen &Pen,
+                                   const QFontMetrics &metrics)
+{
+  double perPixel = step / double(stepWidth);  // time steps per pixel
+  int count = trace.count();
+  bool isBit = trace.width() < 2;
+  int yMid = 1 + ((tHeight - 6) >> 1);
+
+  // whole columns only, and not beyond the last time step
+  int width = (x2 - x - 1) / stepWidth * stepWidth;
+  if(double(width) > double(count - first) / perPixel)
+    width = int(ceil(double(count - first) / perPixel));
+  if(width <= 0)  return;
+
+  QPen Activity(QBrush(Pen.color(), Qt::Dense4Pattern), tHeight - 6,
+                Qt::SolidLine, Qt::FlatCap);
+
+  int run = trace.run(first > 0 ? first-1 : 0);  // run left of the diagram
+  int yLast = isBit ? bitLevel(*trace.value(run), tHeight) : yMid;
+  int segStart = 0, segRun = run, nextRun;
+  for(int p = 0; p <= width; p++) {
+    if(p < width) {
+      // last time step within this pixel
+      int last = first + int(double(p+1) * perPixel) - 1;
+      int start = first + int(double(p) * perPixel);
+      if(last < start)  last = start;
+      if(last >= count)  last = count - 1;
+
+      nextRun = run;
+      if(last >= trace.runEnd(nextRun)) {
+        nextRun++;
+        if(last >= trace.runEnd(nextRun))
+          nextRun = trace.run(last);
+      }
+      bool busy = nextRun - run > 1;  // more than one transition ?
+      run = nextRun;
+      if(busy)  nextRun = -1;
+      if(p == 0) {
+        segRun = nextRun;
+        continue;
+      }
+      if(nextRun == segRun)  continue;
+    }
+
+    // draw the pixels from "segStart" to "p"
+    int xa = x + segStart, xb = x + p;
+    const char *value = segRun < 0 ? 0 : trace.value(segRun);
+    if(!value) {   // activity bar
+      Lines.append(new qucs::Line(xa, y-yMid, xb, y-yMid, Activity));
+      Lines.append(new qucs::Line(xa, y-1, xb, y-1, Pen));
+      Lines.append(new qucs::Line(xa, y-tHeight+5, xb, y-tHeight+5, Pen));
+      yLast = -1;
+    }
+    else if(isBit && (*value & 254) == '0') {   // low or high
+      int yNow = bitLevel(*value, tHeight);
+      if(yLast >= 0 && yLast != yNow)
+        Lines.append(new qucs::Line(xa, y-yLast, xa, y-yNow, Pen));
+      Lines.append(new qucs::Line(xa, y-yNow, xb, y-yNow, Pen));
+      yLast = yNow;
+    }
+    else {   // box with the value, if it fits
+      if(isBit && yLast >= 0 && yLast != yMid)
+        Lines.append(new qucs::Line(xa, y-yLast, xa, y-yMid, Pen));
+      Lines.append(new qucs::Line(xa, y-yMid, xa+2, y-1, Pen));
+      Lines.append(new qucs::Line(xa, y-yMid, xa+2, y-tHeight+5, Pen));
+      Lines.append(new qucs::Line(xa+2, y-1, xb-2, y-1, Pen));
+      Lines.append(new qucs::Line(xa+2, y-tHeight+5, xb-2, y-tHeight+5, Pen));
+      Lines.append(new qucs::Line(xb-2, y-1, xb, y-yMid, Pen));
+      Lines.append(new qucs::Line(xb-2, y-tHeight+5, xb, y-yMid, Pen));
+      if(metrics.boundingRect(value).width() + 6 <= xb - xa)
+        Texts.append(new Text(xa+3, y, QString(value)));
+      yLast = yMid;
+    }
+
+    segStart = p;
+    segRun = nextRun;
+  }
+}
+
 // ------------------------------------------------------------
 int TimingDiagram::scroll(int clickPos)
 {
@@ -470,14 +563,14 @@ int TimingDiagram::scroll(int clickPos)
   int tmp = int(xAxis.limit_min + 0.5);
 
   int x = cx;
-  if(clickPos > (cx+x2-20)) {  // scroll one value to the right ?
-    xAxis.limit_min++;
+  if(clickPos > (cx+x2-20)) {  // scroll one column to the right ?
+    xAxis.limit_min += xAxis.step;
   }
   else {
     x += xAxis.numGraphs + 20;
-    if(clickPos < x) {  // scroll bar one value to the left ?
+    if(clickPos < x) {  // scroll bar one column to the left ?
       if(xAxis.limit_min <= 0.0)  return 0;
-      xAxis.limit_min--;
+      xAxis.limit_min -= xAxis.step;
     }
     else {
       x = cx + yAxis.numGraphs;
@@ -515,6 +608,30 @@ bool TimingDiagram::scrollTo(int initial, int dx, int)
   return true;
 }
 
+// ------------------------------------------------------------
+bool TimingDiagram::zoom(double factor, int x)
+{
+  double step  = xAxis.step;
+  int    first = int(xAxis.limit_min + 0.5);
+
+  x -= xAxis.numGraphs + 11;   // relative to the first column
+  if(x < 0)  x = 0;
+  if(x > x2)  x = x2;
+
+  // keep the time step at "x" where it is
+  double at = double(first) + double(x) * step / double(StepWidth);
+  xAxis.step *= factor;
+  if(xAxis.step < 1.0)
+    xAxis.step = 1.0;
+  xAxis.limit_min = floor(at - double(x) * xAxis.step / double(StepWidth) + 0.5);
+
+  calcDiagram();
+  if(step == xAxis.step && first == int(xAxis.limit_min + 0.5))
+    return false;   // did anything change ?
+
+  return true;
+}
+
 // ------------------------------------------------------------
 Diagram* TimingDiagram::newOne()
 {
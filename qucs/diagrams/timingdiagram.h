@@ -20,6 +20,9 @@
 
 #include "tabdiagram.h"
 
+class DigitalTrace;
+class QFontMetrics;
+
 
 class TimingDiagram : public TabDiagram  {
 public: 
@@ -33,6 +36,15 @@ public:
   int calcDiagram();
   int scroll(int);
   bool scrollTo(int, int, int);
+  // Changes the number of time steps per column by "factor", keeping the
+  // time step at "x" (relative to the diagram) in place.
+  bool zoom(double factor, int x);
+
+private:
+  void calcDigitalLod(const DigitalTrace&, int, int, int, int, int, double,
+                      const QPen&, const QFontMetrics&);
+
+  int StepWidth;  // width of a column in pixels, set by calcDiagram()
 };
 
 #endif
@@ -95,7 +95,7 @@ int TruthDiagram::calcDiagram()
   int NumAll=0;   // how many numbers per column
   int NumLeft=0;  // how many numbers could not be written
 
-  char *py;
+  const char *py;
   int counting, invisibleCount=0;
   int startWriting, z;
 
@@ -163,16 +163,16 @@ int TruthDiagram::calcDiagram()
     Texts.append(new Text(x, y2-2, Str));  // dependent variable
 
 
-    startWriting = int(xAxis.limit_min + 0.5);  // when to reach visible area
+    startWriting = int(xAxis.limit_min + 0.5);  // first visible row
+    if(startWriting > NumAll)  startWriting = NumAll;
     if(g->axis(0)) {
 
       if(sameDependencies(g, firstGraph)) {
 
-        if(g->Var.right(2) != ".X") {  // not a digital variable ?
-          double *pdy = g->cPointsY - 2;
-          for(z = NumAll; z>0; z--) {
+        if(g->cPointsY) {  // not a digital variable ?
+          double *pdy = g->cPointsY + 2*startWriting - 2;
+          for(z = NumAll-startWriting; z>0; z--) {
             pdy += 2;
-            if(startWriting-- > 0) continue; // reached visible area ?
             if(y < tHeight) break;           // no room for more rows ?
             Str = QString::number(sqrt((*pdy)*(*pdy) + (*(pdy+1))*(*(pdy+1))));
 
@@ -184,9 +184,8 @@ int TruthDiagram::calcDiagram()
           }
         }
 
-        else {  // digital variable !!!
-          py = (char*)g->cPointsY;
-          counting = strlen((char*)py);    // count number of "bits"
+        else if(!g->cDigital.isEmpty()) {  // digital variable !!!
+          counting = g->cDigital.width();    // count number of "bits"
 
           digitWidth = metrics.boundingRect("X").width() + 2;
           if((x+digitWidth*counting) >= x2) {    // enough space for "bit vector" ?
@@ -194,20 +193,17 @@ int TruthDiagram::calcDiagram()
             goto funcEnd;
           }
 
-          for(z = NumAll; z>0; z--) {
-            if(startWriting-- > 0) {   // reached visible area ?
-              py += counting + 1;
-              continue;
-            }
+          int run = g->cDigital.run(startWriting);
+          for(z = startWriting; z<NumAll; z++) {
             if(y < tHeight) break;    // no room for more rows ?
+            if(z >= g->cDigital.runEnd(run))  run++;
 
             zi = 0;
-            while(*py) {
-              Str = *(py++);
+            for(py = g->cDigital.value(run); *py; py++) {
+              Str = *py;
               Texts.append(new Text(x + zi, y, Str));
               zi += digitWidth;
             }
-            py++;
             y -= tHeight;
           }
 
@@ -0,0 +1,255 @@
+/***************************************************************************
+                          exportdatasetdialog.cpp
+                         -------------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "exportdatasetdialog.h"
+#include "dataset.h"
+#include "exporter.h"
+
+#include <QApplication>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+ExportDatasetDialog::ExportDatasetDialog(const QString &dataSet, QWidget *parent)
+  : QDialog(parent), a_data(new qucsdata::DataSet)
+{
+  setWindowTitle(tr("Export dataset"));
+
+  // the dataset of every simulator that was run
+  a_inputCombo = new QComboBox;
+  for (const char *suffix : {"", ".ngspice", ".xyce", ".spopus"}) {
+    QFileInfo Info(dataSet + suffix);
+    if (Info.exists())
+      a_inputCombo->addItem(Info.fileName(), Info.absoluteFilePath());
+  }
+  QPushButton *browseInput = new QPushButton(tr("Browse"));
+  connect(browseInput, SIGNAL(clicked()), SLOT(slotBrowseInput()));
+  QHBoxLayout *inputRow = new QHBoxLayout;
+  inputRow->addWidget(a_inputCombo, 1);
+  inputRow->addWidget(browseInput);
+
+  a_varList = new QListWidget;
+  QPushButton *selectAll = new QPushButton(tr("Select all"));
+  connect(selectAll, SIGNAL(clicked()), SLOT(slotSelectAll()));
+
+  a_formatCombo = new QComboBox;
+  a_formatCombo->addItem(tr("CSV (*.csv)"));
+  a_formatCombo->addItem(tr("Columnar binary (*.qcol)"));
+  a_delimiterCombo = new QComboBox;
+  a_delimiterCombo->addItem(tr("Comma"), QChar(','));
+  a_delimiterCombo->addItem(tr("Semicolon"), QChar(';'));
+  a_delimiterCombo->addItem(tr("Tab"), QChar('\t'));
+  a_precisionSpin = new QSpinBox;
+  a_precisionSpin->setRange(0, 17);
+  a_precisionSpin->setSpecialValueText(tr("exact"));
+
+  a_outputEdit = new QLineEdit;
+  QPushButton *browseOutput = new QPushButton(tr("Browse"));
+  connect(browseOutput, SIGNAL(clicked()), SLOT(slotBrowseOutput()));
+  QHBoxLayout *outputRow = new QHBoxLayout;
+  outputRow->addWidget(a_outputEdit, 1);
+  outputRow->addWidget(browseOutput);
+
+  QFormLayout *form = new QFormLayout;
+  form->addRow(tr("Dataset:"), inputRow);
+  form->addRow(tr("Format:"), a_formatCombo);
+  form->addRow(tr("Delimiter:"), a_delimiterCombo);
+  form->addRow(tr("Significant digits:"), a_precisionSpin);
+  form->addRow(tr("Output file:"), outputRow);
+
+  QDialogButtonBox *buttons = new QDialogButtonBox;
+  buttons->addButton(tr("Export"), QDialogButtonBox::AcceptRole);
+  buttons->addButton(QDialogButtonBox::Cancel);
+  connect(buttons, SIGNAL(accepted()), SLOT(slotExport()));
+  connect(buttons, SIGNAL(rejected()), SLOT(reject()));
+
+  QVBoxLayout *all = new QVBoxLayout(this);
+  all->addLayout(form);
+  all->addWidget(new QLabel(tr("Variables (those over the same independent "
+                               "variables share a file):")));
+  all->addWidget(a_varList, 1);
+  all->addWidget(selectAll, 0, Qt::AlignLeft);
+  all->addWidget(buttons);
+
+  connect(a_inputCombo, SIGNAL(currentIndexChanged(int)), SLOT(slotDataSetChanged()));
+  connect(a_formatCombo, SIGNAL(currentIndexChanged(int)), SLOT(slotFormatChanged()));
+  slotDataSetChanged();
+  resize(460, 520);
+}
+
+ExportDatasetDialog::~ExportDatasetDialog()
+{
+  if (a_exportThread.joinable()) {   // closed while exporting
+    a_exportThread.join();
+    QApplication::restoreOverrideCursor();
+  }
+}
+
+// -----------------------------------------------------------
+// Indexes the chosen dataset and lists its variables, all selected.
+void ExportDatasetDialog::slotDataSetChanged()
+{
+  a_varList->clear();
+  QString file = a_inputCombo->currentData().toString();
+  if (file.isEmpty())
+    return;
+
+  if (!a_data->open(file.toStdString(), false)) {
+    a_varList->addItem(QString::fromStdString(a_data->error()));
+    return;
+  }
+  for (int i = 0; i < a_data->count(); i++) {
+    const qucsdata::Variable &v = a_data->variable(i);
+    QStringList deps;
+    for (const std::string &d : v.deps)
+      deps.append(QString::fromStdString(d));
+    QListWidgetItem *item = new QListWidgetItem(v.indep
+        ? QString::fromStdString(v.name)
+        : QStringLiteral("%1 (%2)").arg(QString::fromStdString(v.name), deps.join(", ")));
+    item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+    item->setCheckState(Qt::Checked);
+    item->setData(Qt::UserRole, i);
+    a_varList->addItem(item);
+  }
+  slotFormatChanged();   // suggest an output file name
+}
+
+// -----------------------------------------------------------
+void ExportDatasetDialog::slotBrowseInput()
+{
+  QString s = QFileDialog::getOpenFileName(this, tr("Open dataset"),
+      QFileInfo(a_inputCombo->currentData().toString()).absolutePath(),
+      tr("Datasets") + " (*.dat *.dat.ngspice *.dat.xyce *.dat.spopus *.raw);;" +
+      tr("Any File") + " (*)");
+  if (s.isEmpty())
+    return;
+  QFileInfo Info(s);
+  a_inputCombo->addItem(Info.fileName(), Info.absoluteFilePath());
+  a_inputCombo->setCurrentIndex(a_inputCombo->count() - 1);
+}
+
+// -----------------------------------------------------------
+void ExportDatasetDialog::slotBrowseOutput()
+{
+  bool csv = a_formatCombo->currentIndex() == 0;
+  QString s = QFileDialog::getSaveFileName(this, tr("Enter an Output File Name"),
+      a_outputEdit->text(), a_formatCombo->currentText() + ";;" + tr("Any File") + " (*)");
+  if (s.isEmpty())
+    return;
+  if (QFileInfo(s).suffix().isEmpty())
+    s += csv ? ".csv" : ".qcol";
+  a_outputEdit->setText(s);
+}
+
+// -----------------------------------------------------------
+void ExportDatasetDialog::slotFormatChanged()
+{
+  bool csv = a_formatCombo->currentIndex() == 0;
+  a_delimiterCombo->setEnabled(csv);
+  a_precisionSpin->setEnabled(csv);
+
+  QString input = a_inputCombo->currentData().toString();
+  if (input.isEmpty())
+    return;
+  QFileInfo Info(input);
+  a_outputEdit->setText(Info.absolutePath() + QDir::separator() +
+                        Info.completeBaseName().section('.', 0, 0) +
+                        (csv ? ".csv" : ".qcol"));
+}
+
+// -----------------------------------------------------------
+void ExportDatasetDialog::slotSelectAll()
+{
+  bool all = true;
+  for (int i = 0; i < a_varList->count(); i++)
+    all = all && a_varList->item(i)->checkState() == Qt::Checked;
+  for (int i = 0; i < a_varList->count(); i++)
+    a_varList->item(i)->setCheckState(all ? Qt::Unchecked : Qt::Checked);
+}
+
+// -----------------------------------------------------------
+void ExportDatasetDialog::slotExport()
+{
+  std::vector<int> vars;
+  for (int i = 0; i < a_varList->count(); i++) {
+    QListWidgetItem *item = a_varList->item(i);
+    if (item->checkState() == Qt::Checked && item->data(Qt::UserRole).isValid())
+      vars.push_back(item->data(Qt::UserRole).toInt());
+  }
+  if (vars.empty()) {
+    QMessageBox::critical(this, tr("Error"), tr("Please select the variables to export!"));
+    return;
+  }
+  QString output = a_outputEdit->text();
+  if (output.isEmpty()) {
+    QMessageBox::critical(this, tr("Error"), tr("Please enter an output file name!"));
+    return;
+  }
+
+  qucsdata::ExportOptions options;
+  options.format = a_formatCombo->currentIndex() == 0 ? qucsdata::Format::CSV
+                                                      : qucsdata::Format::Columns;
+  options.delimiter = a_delimiterCombo->currentData().toChar().toLatin1();
+  options.precision = a_precisionSpin->value();
+
+  // Only the selected variables and their independent variables are
+  // decoded. The export runs on a worker thread, the dialog is disabled
+  // meanwhile so the dataset stays as it is.
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  setEnabled(false);
+  a_exportThread = std::thread([this, vars, output, options]() {
+    std::vector<std::string> written;
+    std::string error;
+    a_data->decode(vars);
+    bool ok = qucsdata::exportData(*a_data, vars, output.toStdString(), options, written, error);
+    QMetaObject::invokeMethod(this, [this, ok, written, error]() {
+      exportFinished(ok, written, error);
+    }, Qt::QueuedConnection);
+  });
+}
+
+// -----------------------------------------------------------
+// Reports the result of the export started by slotExport().
+void ExportDatasetDialog::exportFinished(bool ok, const std::vector<std::string> &written,
+                                         const std::string &error)
+{
+  a_exportThread.join();
+  setEnabled(true);
+  QApplication::restoreOverrideCursor();
+
+  if (!ok) {
+    QMessageBox::critical(this, tr("Error"), QString::fromStdString(error));
+    return;
+  }
+  if (written.size() > 1) {
+    QStringList files;
+    for (const std::string &name : written)
+      files.append(QFileInfo(QString::fromStdString(name)).fileName());
+    QMessageBox::information(this, tr("Export dataset"),
+        tr("The variables were written to these files:") + "\n" + files.join("\n"));
+  }
+  accept();
+}
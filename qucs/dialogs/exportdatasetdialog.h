@@ -0,0 +1,69 @@
+/***************************************************************************
+                           exportdatasetdialog.h
+                          -----------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef EXPORTDATASETDIALOG_H
+#define EXPORTDATASETDIALOG_H
+
+#include <QDialog>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace qucsdata { class DataSet; }
+
+class QComboBox;
+class QLineEdit;
+class QListWidget;
+class QSpinBox;
+
+/*!
+ * \brief Exports variables of a dataset to CSV or columnar files.
+ *
+ * Lists the dataset files of the document (one per simulator) and their
+ * variables; the export itself is done by qucsdata::exportData() on a
+ * worker thread.
+ */
+class ExportDatasetDialog : public QDialog {
+  Q_OBJECT
+public:
+  ExportDatasetDialog(const QString &dataSet, QWidget *parent = nullptr);
+  ~ExportDatasetDialog() override;
+
+private slots:
+  void slotDataSetChanged();
+  void slotBrowseInput();
+  void slotBrowseOutput();
+  void slotFormatChanged();
+  void slotSelectAll();
+  void slotExport();
+
+private:
+  void exportFinished(bool ok, const std::vector<std::string> &written,
+                      const std::string &error);
+
+  QComboBox *a_inputCombo;
+  QListWidget *a_varList;
+  QComboBox *a_formatCombo;
+  QComboBox *a_delimiterCombo;
+  QSpinBox *a_precisionSpin;
+  QLineEdit *a_outputEdit;
+
+  std::unique_ptr<qucsdata::DataSet> a_data;
+  std::thread a_exportThread;
+};
+
+#endif // EXPORTDATASETDIALOG_H
@@ -287,7 +287,7 @@ bool ExportDialog::needsInkscape()
     QString nam = editFilename->text();
     QStringList filetypes;
     QFileInfo inf(nam);
-    filetypes<<"pdf"<<"pdf_tex"<<"eps"<<"PDF"<<"PDF_TEX"<<"EPS";
+    filetypes<<"pdf"<<"pdf_tex"<<"PDF"<<"PDF_TEX";
 
     if (filetypes.contains(inf.suffix())) {
         return true;
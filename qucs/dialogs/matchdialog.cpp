@@ -31,6 +31,7 @@
 #endif
 
 #include "../../qucs-filter/material_props.h"
+#include "../../qucs-transcalc/tlengine.h"
 #include "main.h"
 #include "matchdialog.h"
 #include "misc.h"
@@ -1052,94 +1053,9 @@ QString MatchDialog::flipLadderCode(QString laddercode) {
   return flipped_laddercode;
 }
 
-// FUNCTIONS FOR THE MICROSTRIP LINE SYNTHESIS. JUST COPIED FROM THE QUCS-FILTER
-// TOOL
+// MICROSTRIP LINE SYNTHESIS. THE LINE MODEL IS SHARED WITH QUCS-TRANSCALC
 /////////////////////////////////////////////////////////////////////////////////////////////////
 #define MAX_ERROR 1e-7
-void calcMicrostrip(tSubstrate *substrate, double width, double freq,
-                    double &er_eff, double &zl) {
-  double a, b;
-  double h = substrate->height;
-  double t = substrate->thickness;
-  double er = substrate->er;
-  double Wh = width / h;
-  t /= h;
-
-  // quasi-static models by Hammerstad
-
-  double w1 = Wh;
-  if (t > 1e-100) { // width correction due to metal thickness?
-    a = coth(sqrt(6.517 * Wh));
-    b = t / pi * log(1.0 + 10.873127 / t / a / a);
-    w1 += b;
-    Wh += 0.5 * b * (1.0 + sech(sqrt(er - 1.0)));
-  }
-
-  // relative effective permittivity
-  a = Wh * Wh;
-  b = a * a;
-  er_eff = -0.564 * pow((er - 0.9) / (er + 3.0), 0.053);
-  er_eff *= 1.0 + log((b + a / 2704.0) / (b + 0.432)) / 49.0 +
-            log(1.0 + a * Wh / 5929.741) / 18.7;
-  er_eff = (er + 1.0) / 2.0 + (er - 1.0) / 2.0 * pow(1.0 + 10.0 / Wh, er_eff);
-
-  // characteristic impedance
-  zl = 6.0 + 0.2831853 * exp(-pow(30.666 / Wh, 0.7528));
-  zl = Z_FIELD / 2.0 / pi * log(zl / Wh + sqrt(1.0 + 4.0 / Wh / Wh));
-
-  // characteristic impedance (same again for "w1")
-  a = 6.0 + 0.2831853 * exp(-pow(30.666 / w1, 0.7528));
-  a = Z_FIELD / 2.0 / pi * log(a / w1 + sqrt(1.0 + 4.0 / w1 / w1));
-
-  a /= zl;
-  zl /= sqrt(er_eff);
-  er_eff *= a * a;
-
-  // dispersion models by Kirschning
-
-  freq *= h / 1e6; // normalize frequency into GHz*mm
-
-  // relative effective permittivity
-  a = 0.0363 * exp(-4.6 * Wh) * (1.0 - exp(-pow(freq / 38.7, 4.97)));
-  a *= 1.0 + 2.751 * (1.0 - exp(-pow(er / 15.916, 8.0)));
-  a = pow((0.1844 + a) * freq, 1.5763);
-  a *= 0.27488 + Wh * (0.6315 + 0.525 / pow(1.0 + 0.0157 * freq, 20.0)) -
-       0.065683 * exp(-8.7513 * Wh);
-  a *= 0.33622 * (1.0 - exp(-0.03442 * er));
-  double er_freq = er - (er - er_eff) / (1.0 + a);
-
-  // characteristic impedance
-  a = -0.03891 * pow(er, 1.4);
-  b = -0.267 * pow(Wh, 7.0);
-  double R7 = 1.206 - 0.3144 * exp(a) * (1.0 - exp(b));
-
-  a = 0.016 + pow(0.0514 * er, 4.524);
-  b = pow(freq / 28.843, 12.0);
-  a = 5.086 * a * b / (0.3838 + 0.386 * a) / (1.0 + 1.2992 * b);
-  b = -22.2 * pow(Wh, 1.92);
-  a *= exp(b);
-  b = pow(er - 1.0, 6.0);
-  double R9 = a * b / (1.0 + 10.0 * b);
-
-  a = 4.766 * exp(-3.228 * pow(Wh, 0.641)); // = R3
-  a = 1.0 + 1.275 * (1.0 - exp(-0.004625 * a * pow(er, 1.674) *
-                               pow(freq / 18.365, 2.745))); // = R8
-
-  b = 0.9408 * pow(er_freq, a) - 0.9603; // = R13
-  b /= (0.9408 - R9) * pow(er_eff, a) - 0.9603;
-  R9 = b; // = R13 / R14
-
-  a = 0.00044 * pow(er, 2.136) + 0.0184; // = R10
-  a *= 0.707 * pow(freq / 12.3, 1.097);  // = R15
-  a = exp(-0.026 * pow(freq, 1.15656) - a);
-  b = pow(freq / 19.47, 6.0);
-  b /= 1.0 + 0.0962 * b;                                            // = R11
-  b = 1.0 + 0.0503 * er * er * b * (1.0 - exp(-pow(Wh / 15, 6.0))); // = R16
-  R7 *= (1.0 - 1.1241 * a / b / (1.0 + 0.00245 * Wh * Wh));         // = R17
-
-  zl *= pow(R9, R7);
-  er_eff = er_freq;
-}
 
 // -------------------------------------------------------------------
 // Calculates the width 'width' and the relative effective permittivity 'er_eff'
@@ -1147,33 +1063,8 @@ void calcMicrostrip(tSubstrate *substrate, double width, double freq,
 // synthesis equations doesn't exist.
 void MatchDialog::getMicrostrip(double Z0, double freq, tSubstrate *substrate,
                                 double &width, double &er_eff) {
-  int iteration = 0; // iteration counter
-  double Z0_current, Z0_result, increment;
-
-  width = 1e-3; // start with 1mm
-
-  do {
-    // compute line parameters
-    calcMicrostrip(substrate, width, freq, er_eff, Z0_current);
-
-    if (fabs(Z0 - Z0_current) < MAX_ERROR)
-      break; // wanted value was found
-
-    increment = width / 100.0;
-    width += increment;
-
-    // compute line parameters
-    calcMicrostrip(substrate, width, freq, er_eff, Z0_result);
-
-    // Newton iteration: w(n+1) = w(n) - f(w(n))/f'(w(n))
-    //   with f(w(n))  = Z0_current - Z0
-    //   and  f'(w(n)) = (Z0_result - Z0_current) / increment
-    width -= (Z0_current - Z0) / (Z0_result - Z0_current) * increment;
-    if (width <= 0.0)
-      width = increment;
-
-    iteration++;
-  } while (iteration < 150);
+  ms_synth_cache::instance().synthesize(tl_substrate_from(substrate), freq, Z0,
+                                        width, er_eff, MAX_ERROR);
 }
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
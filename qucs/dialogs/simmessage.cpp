@@ -40,6 +40,7 @@
 #include <filesystem>
 
 #include "simmessage.h"
+#include "hdlbuild.h"
 #include "main.h"
 #include "module.h"
 #include "qucs.h"
@@ -48,6 +49,7 @@
 #include "components/opt_sim.h"
 #include "components/vhdlfile.h"
 #include "misc.h"
+#include "settings.h"
 
 #if defined(_WIN32) || defined(__MINGW32__)
 #define executableSuffix ".exe"
@@ -97,6 +99,7 @@ SimMessage::SimMessage(QWidget *w, QWidget *parent)
   ProgText->setMinimumSize(400,80);
   wasLF = false;
   simKilled = false;
+  HdlBuilder = nullptr;
 
   QGroupBox *HGroup = new QGroupBox();
   QHBoxLayout *hbox = new QHBoxLayout();
@@ -145,6 +148,11 @@ SimMessage::SimMessage(QWidget *w, QWidget *parent)
 SimMessage::~SimMessage()
 {
   if(SimProcess.state()==QProcess::Running)  SimProcess.kill();
+  if(HdlThread.joinable()) {
+    HdlBuilder->cancel();
+    HdlThread.join();
+  }
+  delete HdlBuilder;
   delete all;
 }
 
@@ -164,7 +172,8 @@ bool SimMessage::startProcess()
 
   SimProcess.blockSignals(false);
  /* On Qt4 it shows as running even before we .start it. FIXME*/
-  if(SimProcess.state()==QProcess::Running ||SimProcess.state()==QProcess::Starting) {
+  if(SimProcess.state()==QProcess::Running ||SimProcess.state()==QProcess::Starting ||
+     HdlThread.joinable()) {
     qDebug() << "running!";
     ErrText->appendPlainText(tr("ERROR: Simulator is still running!"));
     FinishSimulation(-1);
@@ -172,6 +181,7 @@ bool SimMessage::startProcess()
   }
 
   Collect.clear();  // clear list for NodeSets, SPICE components etc.
+  HdlConvert.clear();
   ProgText->appendPlainText(tr("creating netlist... "));
   NetlistFile.setFileName(QucsSettings.tempFilesDir.filePath("netlist.txt"));
    if(!NetlistFile.open(QIODevice::WriteOnly)) {
@@ -365,7 +375,7 @@ void SimMessage::startSimulator()
 #endif
   SimOpt = NULL;
   bool isVerilog = false;
-  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  bool hdlBuild = _settings::Get().item<bool>("HdlIncrementalBuild");
 
   // Simulate text window.
   if(QucsApp::isTextDocument(DocWidget)) {
@@ -406,6 +416,11 @@ void SimMessage::startSimulator()
       Arguments  << QucsSettings.tempFilesDir.filePath("netlist.txt")
                  << DataSet << SimTime.remove(" ") << pathName(SimPath)
                  << pathName(QucsSettings.BinDir) << libs;
+      // the build does not link extra libraries, the script does
+      if (hdlBuild && Doc->Libraries.trimmed().isEmpty()) {
+        startHdlBuild(false, SimTime, QString(), Arguments);
+        return;
+      }
     }
     // Module.
     else {
@@ -581,9 +596,25 @@ void SimMessage::startSimulator()
 
 #endif
       }
+      if (hdlBuild) {
+        // GHDL expects the time without spaces
+        startHdlBuild(isVerilog, isVerilog ? SimTime : SimTime.remove(" "), "-c", Arguments);
+        return;
+      }
     }
   }
 
+  launchSimulator(Arguments);
+}
+
+/*!
+ * \brief SimMessage::launchSimulator starts the simulator process.
+ * \param Arguments Command line arguments of the Program
+ * \param WorkDir Working directory of the process, empty for the current one
+ */
+void SimMessage::launchSimulator(const QStringList &Arguments, const QString &WorkDir)
+{
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
   disconnect(&SimProcess, 0, 0, 0);
   connect(&SimProcess, SIGNAL(readyReadStandardError()), SLOT(slotDisplayErr()));
   connect(&SimProcess, SIGNAL(readyReadStandardOutput()), SLOT(slotDisplayMsg()));
@@ -637,11 +668,110 @@ void SimMessage::startSimulator()
   }
   SimProcess.setProcessEnvironment(env);
 
+  SimProcess.setWorkingDirectory(WorkDir);
+
   qDebug() << "Command :" << Program << Arguments.join(" ");
   SimProcess.start(Program, Arguments); // launch the program
 
 }
 
+/*!
+ * \brief SimMessage::startHdlBuild analyses (compiles) the digital netlist
+ *        on a worker thread and starts the simulation afterwards. Only the
+ *        design units changed since the last simulation are analysed again,
+ *        see HdlBuild. If the build fails, the script in Program is run
+ *        instead.
+ * \param isVerilog True for a Verilog netlist, false for VHDL
+ * \param SimTime Simulation time, for GHDL
+ * \param convOption Option of the VCD to dataset conversion
+ * \param ScriptArguments Command line arguments of the script
+ */
+void SimMessage::startHdlBuild(bool isVerilog, const QString &SimTime,
+                               const QString &convOption,
+                               const QStringList &ScriptArguments)
+{
+  HdlScript = Program;
+  HdlScriptArguments = ScriptArguments;
+
+  QString netlist;
+  if(NetlistFile.open(QIODevice::ReadOnly)) {
+    netlist = QString::fromUtf8(NetlistFile.readAll());
+    NetlistFile.close();
+  }
+  if(netlist.isEmpty()) {
+    ErrText->appendPlainText(tr("ERROR: Cannot read netlist!"));
+    FinishSimulation(-1);
+    return;
+  }
+
+  delete HdlBuilder;
+  HdlBuilder = new HdlBuild(isVerilog ? HdlBuild::Verilog : HdlBuild::VHDL,
+    QucsSettings.tempFilesDir.filePath(isVerilog ? "hdl/verilog" : "hdl/vhdl"));
+  if(!HdlBuilder->setNetlist(netlist)) {
+    ErrText->appendPlainText(HdlBuilder->error());
+    startHdlScript();
+    return;
+  }
+
+  HdlSimTime = SimTime;
+  HdlConvert.clear();
+  if(!convOption.isEmpty()) HdlConvert << convOption;
+  HdlConvert << "-if" << "vcd" << "-of" << "qucsdata"
+             << "-i" << QDir::toNativeSeparators(QucsSettings.tempFilesDir.filePath("digi.vcd"))
+             << "-o" << DataSet;
+
+  ProgText->appendPlainText(tr("analysing %1 design units...")
+                            .arg(HdlBuilder->units().size()));
+  HdlThread = std::thread([this]() {
+    bool ok = HdlBuilder->build([this](const QString &msg) {
+      QMetaObject::invokeMethod(this, [this, msg]() {
+        ProgText->appendPlainText(msg);
+      }, Qt::QueuedConnection);
+    });
+    QMetaObject::invokeMethod(this, [this, ok]() { hdlBuildFinished(ok); },
+                              Qt::QueuedConnection);
+  });
+}
+
+/*!
+ * \brief SimMessage::hdlBuildFinished runs the simulator on the analysed
+ *        design, called when the build thread is done.
+ * \param ok False if the build failed or was aborted
+ */
+void SimMessage::hdlBuildFinished(bool ok)
+{
+  HdlThread.join();
+  if(!ok) {
+    if(!HdlBuilder->error().isEmpty())
+      ErrText->appendPlainText(HdlBuilder->error());
+    if(simKilled)
+      FinishSimulation(-1);
+    else
+      startHdlScript();
+    return;
+  }
+
+  Program = HdlBuilder->program();
+  QString vcd = QDir::toNativeSeparators(QucsSettings.tempFilesDir.filePath("digi.vcd"));
+  QFile::remove(vcd);
+  launchSimulator(HdlBuilder->arguments(HdlSimTime, vcd),
+                  QucsSettings.tempFilesDir.absolutePath());
+}
+
+/*!
+ * \brief SimMessage::startHdlScript runs the digital simulation with the
+ *        qucs_run_hdl or qucs_run_verilog script, which analyses the whole
+ *        netlist, after the build with HdlBuild failed.
+ */
+void SimMessage::startHdlScript()
+{
+  ProgText->appendPlainText(tr("build failed, running %1...")
+                            .arg(QFileInfo(HdlScript).fileName()));
+  HdlConvert.clear();  // the script converts the waveforms itself
+  Program = HdlScript;
+  launchSimulator(HdlScriptArguments);
+}
+
 // ------------------------------------------------------------------------
 Component * SimMessage::findOptimization(Schematic *Doc) {
   Component *pc;
@@ -797,6 +927,14 @@ void SimMessage::slotSimEnded(int exitCode, QProcess::ExitStatus exitStatus )
     ErrText->appendPlainText(tr("ERROR: Simulator crashed!"));
     ErrText->appendPlainText(tr("Please report this error to qucs-bugs@lists.sourceforge.net"));
   }
+  if(stat == 0 && !simKilled && !HdlConvert.isEmpty()) {
+    // digital simulation: convert the waveforms into the dataset
+    QStringList Arguments = HdlConvert;
+    HdlConvert.clear();
+    Program = QucsSettings.Qucsconv;
+    launchSimulator(Arguments);
+    return;
+  }
   FinishSimulation(stat); // 0 = normal , !=0 = error
 }
 
@@ -884,6 +1022,7 @@ void SimMessage::AbortSim()
 {
   ErrText->appendPlainText(tr("Simulation aborted by the user!"));
   simKilled = true;
+  if(HdlThread.joinable()) HdlBuilder->cancel();
   SimProcess.kill();
 }
 
@@ -25,6 +25,8 @@
 #include <QTextStream>
 #include <QVBoxLayout>
 
+#include <thread>
+
 class QPlainTextEdit;
 class QTextStream;
 class QVBoxLayout;
@@ -34,6 +36,7 @@ class QProcess;
 class QFile;
 class Component;
 class Schematic;
+class HdlBuild;
 
 // #define SPEEDUP_PROGRESSBAR
 
@@ -79,6 +82,11 @@ private:
   void FinishSimulation(int);
   void nextSPICE();
   void startSimulator();
+  void launchSimulator(const QStringList &Arguments, const QString &WorkDir = QString());
+  void startHdlBuild(bool isVerilog, const QString &SimTime, const QString &convOption,
+                     const QStringList &ScriptArguments);
+  void hdlBuildFinished(bool ok);
+  void startHdlScript();
   Component * findOptimization(Schematic *);
 
 public:
@@ -106,6 +114,14 @@ public:
   QVBoxLayout  *all;
 protected:
   QString Program;
+
+private:
+  HdlBuild       *HdlBuilder;   // digital simulations: analyses the netlist
+  std::thread    HdlThread;
+  QString        HdlSimTime;
+  QStringList    HdlConvert;    // VCD conversion after the simulation
+  QString        HdlScript;     // qucs_run_hdl/qucs_run_verilog, the fallback
+  QStringList    HdlScriptArguments;
 };
 
 #endif
@@ -20,8 +20,8 @@
 
 #include <QGridLayout>
 #include "main.h"
-#include "../diagrams/graph.h"
 #include "misc.h"
+#include "dataset.h"
 
 #include <QLabel>
 #include <QLineEdit>
@@ -72,18 +72,18 @@ SweepDialog::SweepDialog(Schematic *Doc_,QHash<QString,double> *NodeVals)
   isSpice = false;
   if (QucsSettings.DefaultSimulator != spicecompat::simQucsator) {
       isSpice = true;
-      if (NodeVals) pGraph = setBiasPoints(NodeVals);
+      if (NodeVals) setBiasPoints(NodeVals);
       return;
   }
 
-  pGraph = setBiasPoints();
+  setBiasPoints();
   // if simulation has no sweeps, terminate dialog before showing it
-  if(!pGraph->numAxes()) {
+  if(AxisNames.isEmpty()) {
     reject();
     return;
   }
-  if(pGraph->numAxes() <= 1)
-    if(pGraph->axis(0)->count <= 1) {
+  if(AxisNames.size() <= 1)
+    if(AxisPoints.first().size() <= 1) {
       reject();
       return;
     }
@@ -93,24 +93,16 @@ SweepDialog::SweepDialog(Schematic *Doc_,QHash<QString,double> *NodeVals)
 
   int i = 0;
   // ...........................................................
-  QGridLayout *all = new QGridLayout(this);//, pGraph->cPointsX.count()+2,2,3,3);
+  QGridLayout *all = new QGridLayout(this);
   all->setContentsMargins(5,5,5,5);
   all->setSpacing(5);
   all->setColumnStretch(1,5);
 
-  DataX const *pD;
   mySpinBox *Box;
 
-  for(unsigned ii=0; (pD=pGraph->axis(ii)); ++ii) {
-    all->addWidget(new QLabel(pD->Var, this), i,0);
-    //cout<<"count: "<<pD->count-1<<", points: "<<*pD->Points<<endl;
-    //works only for linear:
-    /*double Min = pD->Points[0];
-    double Max = pD->Points[pD->count-1];
-    double Step = (Max-Min)/(pD->count);
-    cout<<"Min: "<<Min<<", Max: "<<Max<<", Step: "<<Step<<endl;
-    Box = new mySpinBox(Min, Max, Step, pD->Points, this);*/
-    Box = new mySpinBox(0, pD->count-1, 1, pD->Points, this);
+  for(int ii=0; ii < AxisNames.size(); ++ii) {
+    all->addWidget(new QLabel(AxisNames.at(ii), this), i,0);
+    Box = new mySpinBox(0, AxisPoints[ii].size()-1, 1, AxisPoints[ii].data(), this);
     Box->setValue(0);
     all->addWidget(Box, i++,1);
     connect(Box, SIGNAL(valueChanged(int)), SLOT(slotNewValue(int)));
@@ -127,40 +119,105 @@ SweepDialog::SweepDialog(Schematic *Doc_,QHash<QString,double> *NodeVals)
 
 SweepDialog::~SweepDialog()
 {
-  delete pGraph;
-
-  while(!ValueList.isEmpty()) {
-    delete ValueList.takeFirst();
-  }
 }
 
 // ---------------------------------------------------------------
 void SweepDialog::slotNewValue(int)
 {
-  DataX const*pD = pGraph->axis(0);
-
   int Factor = 1, Index = 0;
-  QList<mySpinBox *>::const_iterator it;
-  for(it = BoxList.constBegin(); it != BoxList.constEnd(); it++) {
-    Index  += (*it)->value() * Factor;
-    Factor *= pD->count;
+  for(int i = 0; i < BoxList.size(); i++) {
+    Index  += BoxList.at(i)->value() * Factor;
+    Factor *= AxisPoints.at(i).size();
   }
-  Index *= 2;  // because of complex values
-
-  QList<Node *>::iterator node_it;
-  QList<double *>::const_iterator value_it = ValueList.begin();
-  for(node_it = NodeList.begin(); node_it != NodeList.end(); node_it++) {
-    qDebug() << "SweepDialog::slotNewValue:(*node_it)->Name:" << (*node_it)->Name;
-    (*node_it)->Name = misc::num2str(*((*value_it)+Index));
-    (*node_it)->Name += ((*node_it)->x1 & 0x10)? "A" : "V";
-    value_it++;
+
+  // only the texts that change are repainted
+  QList<QPair<Node*, QString>> Changed;
+  const double *pv = Values.constData() + Index * NodeList.size();
+  for(Node *pn : NodeList) {
+    QString Text = misc::num2str(*(pv++)) + ((pn->x1 & 0x10)? "A" : "V");
+    if(Text == pn->Name) continue;
+    Changed.append(qMakePair(pn, pn->Name));
+    pn->Name = Text;
   }
 
-  Doc->viewport()->update();
+  Doc->updateBiasPoints(Changed);
 }
 
 // ---------------------------------------------------
-Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
+// Loads the values of the variables "Vars" (one for each node in NodeList)
+// at all sweep points. Nodes without values are removed from NodeList.
+void SweepDialog::loadValues(const QString &DataSet, const QStringList &Vars)
+{
+  AxisNames.clear();
+  AxisPoints.clear();
+  Values.clear();
+
+  qucsdata::DataSet Data;
+  if(!Data.open(DataSet.toStdString(), false)) {
+    qDebug() << "SweepDialog::loadValues:" << QString::fromStdString(Data.error());
+    NodeList.clear();
+    return;
+  }
+
+  // the sweep is taken from the first variable found
+  QVector<int> Found;
+  std::vector<std::string> Deps;
+  size_t Count = 0;
+  bool hasSweep = false;
+  for(int i = 0; i < Vars.size(); i++) {
+    int idx = Data.find(Vars.at(i).toStdString());
+    if(idx >= 0 && !hasSweep) {
+      if(!Data.decode(idx)) idx = -1;
+      else {
+        Deps = Data.variable(idx).deps;
+        Count = Data.variable(idx).length;
+        hasSweep = true;
+      }
+    }
+    Found.append(idx);
+  }
+  for(const std::string &Dep : Deps) {
+    int idx = Data.find(Dep);
+    if(idx < 0 || !Data.decode(idx)) {
+      NodeList.clear();
+      return;
+    }
+    const qucsdata::Variable &v = Data.variable(idx);
+    int Stride = (v.kind == qucsdata::Kind::Complex)? 2 : 1;
+    QVector<double> Points(int(v.length));
+    for(size_t p = 0; p < v.length; p++)
+      Points[int(p)] = v.values[p*Stride];
+    AxisNames.append(QString::fromStdString(Dep));
+    AxisPoints.append(Points);
+  }
+
+  // one row of all node values per sweep point
+  QList<Node *> Nodes;
+  QList<int> Columns;
+  for(int i = 0; i < NodeList.size(); i++) {
+    int idx = Found.at(i);
+    if(idx < 0 || !Data.decode(idx)) continue;
+    const qucsdata::Variable &v = Data.variable(idx);
+    if(v.deps != Deps || v.length != Count) continue;
+    Nodes.append(NodeList.at(i));
+    Columns.append(idx);
+  }
+  NodeList = Nodes;
+
+  int Width = NodeList.size();
+  Values.resize(int(Count) * Width);
+  for(int n = 0; n < Width; n++) {
+    const qucsdata::Variable &v = Data.variable(Columns.at(n));
+    int Stride = (v.kind == qucsdata::Kind::Complex)? 2 : 1;
+    const double *pv = v.values.data();
+    double *pd = Values.data() + n;
+    for(size_t p = 0; p < Count; p++, pv += Stride, pd += Width)
+      *pd = *pv;
+  }
+}
+
+// ---------------------------------------------------
+void SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
 {
   // When this function is entered, a simulation was performed.
   // Thus, the node names are still in "node->Name".
@@ -168,19 +225,15 @@ Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
   qDebug() << "SweepDialog::setBiasPoints()";
 
   bool hasNoComp;
-  Graph *pg = new Graph(NULL, ""); // HACK!
   QFileInfo Info(Doc->getDocName());
   QString DataSet = Info.absolutePath() + QDir::separator() + Doc->getDataSet();
 
   Node *pn;
 
-  // Note 1:
-  // Invalidate it so that "Graph::loadDatFile()" does not check for the previously loaded time.
-  // This is a current hack as "Graph::loadDatFile()" does not support multi-node data loading
-  // from the simulation results without refreshing (changing) or invalidating the timestamp.
-
+  // The values are loaded afterwards, all at once. Until then, the nodes
+  // in NodeList show zero and "Vars" holds the variable of each of them.
   NodeList.clear();
-  ValueList.clear();
+  QStringList Vars;
 
   // create DC voltage for all nodes
   for(pn = Doc->a_Nodes->first(); pn != 0; pn = Doc->a_Nodes->next()) {
@@ -213,16 +266,9 @@ Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
     }
 
     if (!isSpice) {
-        pg->Var = pn->Name + ".V";
-        pg->lastLoaded = QDateTime(); // Note 1 at the start of this function
-        if(pg->loadDatFile(DataSet) == 2) {
-          pn->Name = misc::num2str(*(pg->cPointsY)) + "V";
-          NodeList.append(pn);             // remember node ...
-          ValueList.append(pg->cPointsY);  // ... and all of its values
-          pg->cPointsY = 0;   // do not delete it next time !
-        }
-        else
-          pn->Name = "0V";
+        Vars.append(pn->Name + ".V");
+        NodeList.append(pn);
+        pn->Name = "0V";
     } else {
         if (NodeVals->contains(pn->Name.toLower())) {
                   double volts = NodeVals->value(pn->Name.toLower());
@@ -250,16 +296,13 @@ Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
 
       pn->x1 = 0x10;   // mark current
       if (!isSpice) {
-          pg->Var = pc->Name + ".I";
-          pg->lastLoaded = QDateTime(); // Note 1 at the start of this function
-          if(pg->loadDatFile(DataSet) == 2) {
-            pn->Name = misc::num2str(*(pg->cPointsY)) + "A";
-            NodeList.append(pn);             // remember node ...
-            ValueList.append(pg->cPointsY);  // ... and all of its values
-            pg->cPointsY = 0;   // do not delete it next time !
+          int k = NodeList.indexOf(pn);   // current replaces voltage
+          if(k < 0) {
+            Vars.append(pc->Name + ".I");
+            NodeList.append(pn);
           }
-          else
-            pn->Name = "0A";
+          else  Vars[k] = pc->Name + ".I";
+          pn->Name = "0A";
       } else {
           QString src_nam = QStringLiteral("V%1#branch").arg(pc->Name).toLower();
           if (NodeVals->contains(src_nam)) {
@@ -298,7 +341,22 @@ Graph* SweepDialog::setBiasPoints(QHash<QString,double> *NodeVals)
     }
 
 
-  Doc->setShowBias(1);
+  if (!isSpice) {
+    // drop the nodes whose text was removed by a neighbour
+    for(int i = NodeList.size()-1; i >= 0; i--)
+      if(NodeList.at(i)->Name.isEmpty()) {
+        NodeList.removeAt(i);
+        Vars.removeAt(i);
+      }
 
-  return pg;
+    QList<Node *> All = NodeList;
+    loadValues(DataSet, Vars);
+    for(Node *p : All)
+      p->Name = (p->x1 & 0x10)? "0A" : "0V";   // no values
+    const double *pv = Values.constData();
+    for(Node *p : NodeList)
+      p->Name = misc::num2str(*(pv++)) + ((p->x1 & 0x10)? "A" : "V");
+  }
+
+  Doc->setShowBias(1);
 }
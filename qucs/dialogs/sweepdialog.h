@@ -21,13 +21,13 @@
 #include <QDialog>
 #include <QRegularExpression>
 #include <QList>
+#include <QVector>
 
 #include <QSpinBox>
 #include <QGridLayout>
 
 #include "node.h"
 
-class Graph;
 class Schematic;
 class QGridLayout;
 
@@ -55,15 +55,19 @@ private slots:
   void slotNewValue(int);
 
 private:
-  Graph* setBiasPoints(QHash<QString,double> *NodeVals = 0);
+  void setBiasPoints(QHash<QString,double> *NodeVals = 0);
+  void loadValues(const QString &DataSet, const QStringList &Vars);
 
   QGridLayout *all;   // the mother of all widgets
   QList<mySpinBox *> BoxList;
 
-  Graph *pGraph;
   Schematic *Doc;
   QList<Node *> NodeList;
-  QList<double *> ValueList;
+  QStringList AxisNames;          // independent variables of the sweep ...
+  QVector<QVector<double>> AxisPoints;   // ... and their values
+  // values of all nodes in NodeList at all sweep points, the values of
+  // one sweep point follow each other: Values[Index*NodeList.size() + Node]
+  QVector<double> Values;
   bool isSpice;
 };
 
@@ -0,0 +1,381 @@
+/***************************************************************************
+                             epsgenerator.cpp
+                            ------------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file epsgenerator.cpp
+  \brief Implementation of the EpsGenerator class
+*/
+
+#include "epsgenerator.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QImage>
+#include <QPaintEngine>
+#include <QPainterPath>
+#include <QPixmap>
+
+#include <climits>
+#include <cmath>
+
+/*!
+ * \brief Paint engine of EpsGenerator. Paths are transformed here and
+ *        written in device coordinates, so the PostScript graphics state
+ *        only holds colors, line styles and the clipping.
+ */
+class EpsPaintEngine : public QPaintEngine
+{
+public:
+    EpsPaintEngine()
+        : QPaintEngine(QPaintEngine::AllFeatures & ~QPaintEngine::PatternBrush &
+                       ~QPaintEngine::PerspectiveTransform &
+                       ~QPaintEngine::ConicalGradientFill & ~QPaintEngine::PorterDuff),
+          a_clipEnabled(false)
+    {}
+
+    bool begin(QPaintDevice *device) override;
+    bool end() override;
+    void updateState(const QPaintEngineState &state) override;
+    void drawPath(const QPainterPath &path) override;
+    void drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode) override;
+    void drawPixmap(const QRectF &r, const QPixmap &pm, const QRectF &sr) override;
+    void drawImage(const QRectF &r, const QImage &image, const QRectF &sr,
+                   Qt::ImageConversionFlags flags) override;
+    Type type() const override { return QPaintEngine::User; }
+
+    QString a_fileName;
+    QSize a_size;
+
+private:
+    static QByteArray number(double value);
+    void writePath(const QPainterPath &path);
+    void writeColor(const QColor &color);
+    void beginClip();
+    void endClip();
+
+    QFile a_file;
+    QPen a_pen;
+    QBrush a_brush;
+    QTransform a_transform;
+    bool a_clipEnabled;
+    QPainterPath a_clip;       // device coordinates
+    QByteArray a_lineStyle;    // last written line style
+};
+
+bool EpsPaintEngine::begin(QPaintDevice *)
+{
+    a_file.setFileName(a_fileName);
+    if (!a_file.open(QIODevice::WriteOnly))
+        return false;
+
+    QByteArray w = QByteArray::number(a_size.width());
+    QByteArray h = QByteArray::number(a_size.height());
+    a_file.write("%!PS-Adobe-3.0 EPSF-3.0\n"
+                 "%%BoundingBox: 0 0 " + w + " " + h + "\n"
+                 "%%Creator: " + QCoreApplication::applicationName().toUtf8() + "\n"
+                 "%%LanguageLevel: 2\n"
+                 "%%Pages: 1\n"
+                 "%%EndComments\n"
+                 "%%BeginProlog\n"
+                 "/m {moveto} bind def /l {lineto} bind def /c {curveto} bind def\n"
+                 "/h {closepath} bind def /rg {setrgbcolor} bind def\n"
+                 "/f {fill} bind def /ef {eofill} bind def /s {stroke} bind def\n"
+                 "%%EndProlog\n"
+                 "%%Page: 1 1\n"
+                 "save\n"
+                 "0 " + h + " translate 1 -1 scale\n");   // y downwards as in Qt
+
+    a_pen = QPen();
+    a_brush = QBrush();
+    a_transform = QTransform();
+    a_clipEnabled = false;
+    a_clip = QPainterPath();
+    a_lineStyle.clear();
+    return true;
+}
+
+bool EpsPaintEngine::end()
+{
+    a_file.write("restore\nshowpage\n%%EOF\n");
+    a_file.close();
+    return a_file.error() == QFileDevice::NoError;
+}
+
+void EpsPaintEngine::updateState(const QPaintEngineState &state)
+{
+    QPaintEngine::DirtyFlags flags = state.state();
+    if (flags & DirtyPen)
+        a_pen = state.pen();
+    if (flags & DirtyBrush)
+        a_brush = state.brush();
+    if (flags & DirtyTransform)
+        a_transform = state.transform();
+    if (flags & (DirtyClipPath | DirtyClipRegion)) {
+        QPainterPath clip;
+        if (flags & DirtyClipPath)
+            clip = state.clipPath();
+        else
+            clip.addRegion(state.clipRegion());
+        clip = a_transform.map(clip);
+        switch (state.clipOperation()) {
+        case Qt::NoClip:
+            a_clipEnabled = false;
+            break;
+        case Qt::IntersectClip:
+            a_clip = a_clipEnabled ? a_clip.intersected(clip) : clip;
+            a_clipEnabled = true;
+            break;
+        default:
+            a_clip = clip;
+            a_clipEnabled = true;
+        }
+    }
+    if (flags & DirtyClipEnabled)
+        a_clipEnabled = state.isClipEnabled() && !a_clip.isEmpty();
+}
+
+void EpsPaintEngine::drawPath(const QPainterPath &path)
+{
+    bool fill = a_brush.style() != Qt::NoBrush && a_brush.color().alpha() > 0;
+    bool stroke = a_pen.style() != Qt::NoPen && a_pen.color().alpha() > 0;
+    if (!fill && !stroke)
+        return;
+
+    beginClip();
+    writePath(a_transform.map(path));
+    if (fill) {
+        if (stroke)
+            a_file.write("gsave ");
+        writeColor(a_brush.color());
+        a_file.write(path.fillRule() == Qt::WindingFill ? "f\n" : "ef\n");
+        if (stroke)
+            a_file.write("grestore\n");
+    }
+    if (stroke) {
+        // pen widths are given in logical coordinates, unless cosmetic
+        double width = a_pen.widthF();
+        if (width <= 0)
+            width = 1;
+        else if (!a_pen.isCosmetic())
+            width *= std::sqrt(std::abs(a_transform.determinant()));
+
+        QByteArray style = number(width) + " setlinewidth ";
+        switch (a_pen.joinStyle()) {
+        case Qt::RoundJoin: style += "1 setlinejoin "; break;
+        case Qt::BevelJoin: style += "2 setlinejoin "; break;
+        default:            style += "0 setlinejoin ";
+        }
+        switch (a_pen.capStyle()) {
+        case Qt::RoundCap:  style += "1 setlinecap "; break;
+        case Qt::SquareCap: style += "2 setlinecap "; break;
+        default:            style += "0 setlinecap ";
+        }
+        style += "[";
+        if (a_pen.style() != Qt::SolidLine)
+            for (qreal dash : a_pen.dashPattern())
+                style += number(dash * width) + " ";
+        style += "] 0 setdash\n";
+        if (style != a_lineStyle) {
+            a_file.write(style);
+            a_lineStyle = style;
+        }
+        writeColor(a_pen.color());
+        a_file.write("s\n");
+    }
+    endClip();
+}
+
+void EpsPaintEngine::drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode)
+{
+    QPainterPath path;
+    path.addPolygon(QPolygonF(QVector<QPointF>(points, points + pointCount)));
+    if (mode == PolylineMode) {
+        QBrush brush = a_brush;
+        a_brush = QBrush();
+        drawPath(path);
+        a_brush = brush;
+        return;
+    }
+    path.closeSubpath();
+    path.setFillRule(mode == WindingMode ? Qt::WindingFill : Qt::OddEvenFill);
+    drawPath(path);
+}
+
+void EpsPaintEngine::drawPixmap(const QRectF &r, const QPixmap &pm, const QRectF &sr)
+{
+    drawImage(r, pm.toImage(), sr, Qt::AutoColor);
+}
+
+void EpsPaintEngine::drawImage(const QRectF &r, const QImage &image, const QRectF &sr,
+                               Qt::ImageConversionFlags)
+{
+    QImage img = image.copy(sr.toRect()).convertToFormat(QImage::Format_RGB888);
+    if (img.isNull())
+        return;
+
+    beginClip();
+    QByteArray iw = QByteArray::number(img.width()), ih = QByteArray::number(img.height());
+    const QTransform &t = a_transform;
+    a_file.write("gsave [" + number(t.m11()) + " " + number(t.m12()) + " " + number(t.m21()) +
+                 " " + number(t.m22()) + " " + number(t.dx()) + " " + number(t.dy()) +
+                 "] concat " + number(r.x()) + " " + number(r.y()) + " translate " +
+                 number(r.width()) + " " + number(r.height()) + " scale\n"
+                 "/pix " + iw + " 3 mul string def\n" +
+                 iw + " " + ih + " 8 [" + iw + " 0 0 " + ih + " 0 0] "
+                 "{currentfile pix readhexstring pop} false 3 colorimage\n");
+    for (int y = 0; y < img.height(); y++) {
+        const char *line = reinterpret_cast<const char*>(img.constScanLine(y));
+        a_file.write(QByteArray::fromRawData(line, 3 * img.width()).toHex());
+        a_file.write("\n");
+    }
+    a_file.write("grestore\n");
+    a_lineStyle.clear();
+    endClip();
+}
+
+QByteArray EpsPaintEngine::number(double value)
+{
+    QByteArray s = QByteArray::number(value, 'f', 3);
+    while (s.endsWith('0'))
+        s.chop(1);
+    if (s.endsWith('.'))
+        s.chop(1);
+    return s == "-0" ? "0" : s;
+}
+
+void EpsPaintEngine::writePath(const QPainterPath &path)
+{
+    QByteArray out;
+    QPointF start, last;
+    auto close = [&]() {
+        if (!out.isEmpty() && last == start)
+            out += "h\n";
+    };
+    for (int i = 0; i < path.elementCount(); i++) {
+        QPainterPath::Element e = path.elementAt(i);
+        switch (e.type) {
+        case QPainterPath::MoveToElement:
+            close();
+            out += number(e.x) + " " + number(e.y) + " m\n";
+            start = e;
+            break;
+        case QPainterPath::LineToElement:
+            out += number(e.x) + " " + number(e.y) + " l\n";
+            break;
+        case QPainterPath::CurveToElement: {
+            QPainterPath::Element c2 = path.elementAt(i + 1);
+            QPainterPath::Element to = path.elementAt(i + 2);
+            out += number(e.x) + " " + number(e.y) + " " + number(c2.x) + " " +
+                   number(c2.y) + " " + number(to.x) + " " + number(to.y) + " c\n";
+            e = to;
+            i += 2;
+            break;
+        }
+        default:
+            break;
+        }
+        last = e;
+    }
+    close();
+    a_file.write(out);
+}
+
+void EpsPaintEngine::writeColor(const QColor &color)
+{
+    a_file.write(number(color.redF()) + " " + number(color.greenF()) + " " +
+                 number(color.blueF()) + " rg ");
+}
+
+void EpsPaintEngine::beginClip()
+{
+    if (!a_clipEnabled)
+        return;
+    a_file.write("gsave ");
+    writePath(a_clip);
+    a_file.write(a_clip.fillRule() == Qt::WindingFill ? "clip newpath\n" : "eoclip newpath\n");
+}
+
+void EpsPaintEngine::endClip()
+{
+    if (!a_clipEnabled)
+        return;
+    a_file.write("grestore\n");
+    a_lineStyle.clear();   // restored with the graphics state
+}
+
+
+EpsGenerator::EpsGenerator()
+    : a_engine(new EpsPaintEngine)
+{
+}
+
+EpsGenerator::~EpsGenerator()
+{
+}
+
+void EpsGenerator::setFileName(const QString &fileName)
+{
+    a_engine->a_fileName = fileName;
+}
+
+QString EpsGenerator::fileName() const
+{
+    return a_engine->a_fileName;
+}
+
+void EpsGenerator::setSize(const QSize &size)
+{
+    a_engine->a_size = size;
+}
+
+QSize EpsGenerator::size() const
+{
+    return a_engine->a_size;
+}
+
+QPaintEngine *EpsGenerator::paintEngine() const
+{
+    return a_engine.get();
+}
+
+int EpsGenerator::metric(PaintDeviceMetric metric) const
+{
+    const QSize &size = a_engine->a_size;
+    switch (metric) {
+    case PdmWidth:
+        return size.width();
+    case PdmHeight:
+        return size.height();
+    case PdmWidthMM:
+        return qRound(size.width() * 25.4 / 72);
+    case PdmHeightMM:
+        return qRound(size.height() * 25.4 / 72);
+    case PdmNumColors:
+        return INT_MAX;
+    case PdmDepth:
+        return 32;
+    case PdmDpiX:
+    case PdmDpiY:
+    case PdmPhysicalDpiX:
+    case PdmPhysicalDpiY:
+        return 72;   // one unit is one point
+    case PdmDevicePixelRatio:
+        return 1;
+    case PdmDevicePixelRatioScaled:
+        return qRound(QPaintDevice::devicePixelRatioFScale());
+    default:
+        return QPaintDevice::metric(metric);
+    }
+}
@@ -0,0 +1,60 @@
+/***************************************************************************
+                              epsgenerator.h
+                             ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef EPSGENERATOR_H
+#define EPSGENERATOR_H
+
+#include <QPaintDevice>
+#include <QSize>
+#include <QString>
+
+#include <memory>
+
+class EpsPaintEngine;
+
+/*!
+ * \file epsgenerator.h
+ * \brief Declaration of the EpsGenerator class
+ */
+
+/*!
+ * \brief The EpsGenerator class is a paint device that writes
+ *        Encapsulated PostScript, used like QSvgGenerator.
+ *
+ * Everything is written as paths (texts as their outlines), one unit of
+ * the device is one point. Gradients and patterns are drawn with the
+ * color of the brush.
+ */
+class EpsGenerator : public QPaintDevice
+{
+public:
+    EpsGenerator();
+    ~EpsGenerator() override;
+
+    void setFileName(const QString &fileName);
+    QString fileName() const;
+    void setSize(const QSize &size);
+    QSize size() const;
+
+    QPaintEngine *paintEngine() const override;
+
+protected:
+    int metric(PaintDeviceMetric metric) const override;
+
+private:
+    std::unique_ptr<EpsPaintEngine> a_engine;
+};
+
+#endif // EPSGENERATOR_H
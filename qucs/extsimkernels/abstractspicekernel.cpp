@@ -23,14 +23,17 @@
 #endif
 
 #include "abstractspicekernel.h"
+#include "simresultcache.h"
 #include "misc.h"
 #include "main.h"
+#include "tracing.h"
 #include "../paintings/id_text.h"
 #include "dialogs/sweepdialog.h"
 #include "components/subcircuit.h"
 
 
 #include <QPlainTextEdit>
+#include <QTimer>
 #include <algorithm>
 
 /*!
@@ -50,8 +53,9 @@ AbstractSpiceKernel::AbstractSpiceKernel(Schematic *schematic, QObject *parent)
     a_workdir(),
     a_simulator_cmd(),
     a_simulator_parameters(),
-    a_output(),
+    a_log(),
     a_simProcess(new QProcess(this)),
+    a_consoleTimer(new QTimer(this)),
     a_console(nullptr),
     a_sims(),
     a_vars(),
@@ -60,7 +64,18 @@ AbstractSpiceKernel::AbstractSpiceKernel(Schematic *schematic, QObject *parent)
     a_needsPrefix(false),
     a_schematic(schematic),
     a_parseFourTHD(false),
-    a_parsePZzeros(false)
+    a_parsePZzeros(false),
+    a_cancelled(false),
+    a_phase(PhaseNetlist),
+    a_runCount(1),
+    a_runsDone(0),
+    a_phaseTimer(),
+    a_phaseTraceStart(-1),
+    a_cacheKey(),
+    a_cacheHit(false),
+    a_convertThread(),
+    a_conversionId(0),
+    a_datasetWritten(false)
 {
     if (!checkDCSimulation()) { // Run Show bias mode automatically
         a_DC_OP_only = true;      // If schematic contains DC simulation only
@@ -80,11 +95,20 @@ AbstractSpiceKernel::AbstractSpiceKernel(Schematic *schematic, QObject *parent)
     connect(a_simProcess,SIGNAL(errorOccurred(QProcess::ProcessError)),this,SLOT(slotErrors(QProcess::ProcessError)));
     connect(this,SIGNAL(destroyed()),this,SLOT(killThemAll()));
 
+    // Chatty simulators would otherwise stall the GUI with console updates
+    a_consoleTimer->setSingleShot(true);
+    a_consoleTimer->setInterval(100);
+    connect(a_consoleTimer,SIGNAL(timeout()),this,SLOT(slotFlushConsole()));
+
 }
 
 
 AbstractSpiceKernel::~AbstractSpiceKernel()
 {
+    if (a_convertThread.joinable()) {
+        a_cancelled = true;
+        a_convertThread.join();
+    }
     killThemAll();
 }
 
@@ -95,6 +119,88 @@ void AbstractSpiceKernel::killThemAll()
     }
 }
 
+/*!
+ * \brief AbstractSpiceKernel::slotCancel Cancel simulation in any phase. A
+ *        running simulator is killed, the dataset conversion stops at the
+ *        next check and leaves the existing dataset untouched.
+ */
+void AbstractSpiceKernel::slotCancel()
+{
+    a_cancelled = true;
+    killThemAll();
+}
+
+/*!
+ * \brief AbstractSpiceKernel::startProgress Reset progress and cancellation
+ *        state at the beginning of a simulation.
+ * \param run_count Number of simulator runs
+ */
+void AbstractSpiceKernel::startProgress(int run_count)
+{
+    if (a_convertThread.joinable()) { // drop the previous conversion
+        a_cancelled = true;
+        a_convertThread.join();
+        a_conversionId++;
+    }
+    a_cancelled = false;
+    a_runCount = std::max(run_count, 1);
+    a_runsDone = 0;
+    a_phase = -1;
+    setPhase(PhaseNetlist, 0);
+}
+
+/*!
+ * \brief AbstractSpiceKernel::setPhase Report progress as overall percentage
+ *        and as phase description with the estimated remaining time.
+ * \param phase SimPhase
+ * \param percent Progress of the phase, 0..100
+ */
+void AbstractSpiceKernel::setPhase(int phase, int percent)
+{
+    // Share of the phases in overall progress
+    static const int phase_start[] = { 0, 5, 85, 97, 100 };
+    static const char *phase_names[] = {
+        QT_TR_NOOP("Netlisting"), QT_TR_NOOP("Simulating"),
+        QT_TR_NOOP("Reading results"), QT_TR_NOOP("Writing dataset") };
+    static const char *trace_names[] = {
+        "sim:netlist", "sim:simulate", "sim:parse", "sim:write" };
+
+    if (phase != a_phase) {
+        if (a_phase >= 0 && a_phaseTraceStart >= 0) {
+            Tracer::record(trace_names[a_phase], a_phaseTraceStart, Tracer::now());
+        }
+        a_phaseTraceStart = Tracer::enabled() ? Tracer::now() : -1;
+        a_phase = phase;
+        a_phaseTimer.start();
+    }
+    percent = std::min(std::max(percent, 0), 100);
+    if (phase == PhaseWrite && percent == 100 && a_phaseTraceStart >= 0) {
+        Tracer::record(trace_names[phase], a_phaseTraceStart, Tracer::now());
+        a_phaseTraceStart = -1;
+    }
+    int total = phase_start[phase] + (phase_start[phase+1] - phase_start[phase])*percent/100;
+
+    QString msg = tr(phase_names[phase]);
+    qint64 elapsed = a_phaseTimer.elapsed();
+    if (percent > 0 && percent < 100 && elapsed > 2000) {
+        qint64 left = elapsed*(100 - percent)/percent/1000; // seconds
+        msg += tr(", about %1:%2 left").arg(left/60).arg(left%60, 2, 10, QChar('0'));
+    }
+    emit progress(total);
+    emit phaseChanged(msg);
+}
+
+/*!
+ * \brief AbstractSpiceKernel::checkCancelled Check for cancellation during
+ *        long conversions. The conversion runs on a worker thread when it
+ *        is started by convertToQucsDataAsync().
+ * \return True if the simulation is cancelled
+ */
+bool AbstractSpiceKernel::checkCancelled()
+{
+    return a_cancelled;
+}
+
 /*!
  * \brief AbstractSpiceKernel::prepareSpiceNetlist Fill components nodes
  *        with approate node numbers
@@ -108,7 +214,7 @@ bool AbstractSpiceKernel::prepareSpiceNetlist(QTextStream &stream, bool isSubckt
     QStringList collect;
     QPlainTextEdit *err = new QPlainTextEdit;
     if (a_schematic->prepareNetlist(stream,collect,err)==-10) { // Broken netlist
-        a_output.append(err->toPlainText());
+        a_log.append(err->toPlainText());
         delete err;
         return false;
     }
@@ -1136,9 +1242,50 @@ int AbstractSpiceKernel::checkRawOutupt(QString ngspice_file, QStringList &value
  *        text output files (given in outputs_files property) into single XML
  *        Qucs Dataset.
  * \param qucs_dataset A file name of Qucs Dataset to create
- * \param xyce True if Xyce simulator was used.
  */
 void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
+{
+    QUCS_TRACE("AbstractSpiceKernel::convertToQucsData");
+    if (convertWithoutParsing(qucs_dataset)) return;
+    writeDataset(qucs_dataset);
+    finishConversion(qucs_dataset);
+}
+
+/*!
+ * \brief AbstractSpiceKernel::convertToQucsDataAsync Like convertToQucsData(),
+ *        but the simulator outputs are read and the dataset is written on a
+ *        worker thread, so the GUI stays responsive. converted() is emitted
+ *        when the dataset is complete, slotCancel() stops the conversion.
+ * \param qucs_dataset A file name of Qucs Dataset to create
+ */
+void AbstractSpiceKernel::convertToQucsDataAsync(const QString &qucs_dataset)
+{
+    if (a_convertThread.joinable()) a_convertThread.join();
+    if (convertWithoutParsing(qucs_dataset)) {
+        emit converted();
+        return;
+    }
+
+    int id = ++a_conversionId;
+    a_convertThread = std::thread([this, qucs_dataset, id]() {
+        writeDataset(qucs_dataset);
+        QMetaObject::invokeMethod(this, [this, qucs_dataset, id]() {
+            if (id != a_conversionId) return; // superseded by a newer one
+            if (a_convertThread.joinable()) a_convertThread.join();
+            finishConversion(qucs_dataset);
+            emit converted();
+        }, Qt::QueuedConnection);
+    });
+}
+
+/*!
+ * \brief AbstractSpiceKernel::convertWithoutParsing Handle the simulations
+ *        whose results are not converted: DC bias is shown on the schematic
+ *        and cached results are restored.
+ * \param qucs_dataset A file name of Qucs Dataset to create
+ * \return True if nothing is left to convert
+ */
+bool AbstractSpiceKernel::convertWithoutParsing(const QString &qucs_dataset)
 {
     if (a_DC_OP_only) { // Don't touch existing datasets when only DC was simulated
         // It's need to show DC bias on schematic only
@@ -1149,9 +1296,27 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
             } else if (outputfile.endsWith(".dc_op_xyce")) {
                 parseDC_OPoutputXY(full_outfile); }
         }
-        return;
+        return true;
     }
 
+    if (a_cacheHit) { // Simulator was not started, restore previous results
+        SimResultCache cache(a_schematic->getDocName());
+        if (cache.restore(a_cacheKey, qucs_dataset)) return true;
+    }
+    return false;
+}
+
+/*!
+ * \brief AbstractSpiceKernel::writeDataset Parse the simulator outputs and
+ *        write them as Qucs dataset. It neither touches the schematic nor
+ *        the GUI and may run on a worker thread.
+ * \param qucs_dataset A file name of Qucs Dataset to create
+ */
+void AbstractSpiceKernel::writeDataset(const QString &qucs_dataset)
+{
+    QUCS_TRACE("AbstractSpiceKernel::writeDataset");
+    a_datasetWritten = false;
+
     // Merge all outputs in a single Qucs dataset otherwise
     QString ds_str;
     QTextStream ds_stream(&ds_str);
@@ -1161,7 +1326,10 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
     QString sim,indep;
     QStringList indep_vars;
 
+    int files_done = 0;
     for (const QString& ngspice_output_filename : a_output_files) { // For every simulation convert results to Qucs dataset
+        setPhase(PhaseParse, 100*files_done++/a_output_files.count());
+        if (checkCancelled()) break;
         QList< QList<double> > sim_points;
         QStringList var_list;
         QString swp_var,swp_var2;
@@ -1314,6 +1482,7 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
         }
 
         for(int i=1;i<var_list.count();i++) { // output dep var
+            if (checkCancelled()) break;
             if (indep.isEmpty()) ds_stream<<QStringLiteral("<indep %1 %2>\n").arg(var_list.at(i)).arg(sim_points.count());
             else ds_stream<<QStringLiteral("<dep %1 %2>\n").arg(var_list.at(i)).arg(indep);
             for (auto& sim_point : sim_points) {
@@ -1335,17 +1504,43 @@ void AbstractSpiceKernel::convertToQucsData(const QString &qucs_dataset)
         }
     }
 
+    if (a_cancelled) return; // keep the previous dataset
+
+    setPhase(PhaseWrite, 0);
     QFile dataset(qucs_dataset);
     if (dataset.open(QFile::WriteOnly)) {
         QTextStream ts(&dataset);
         ts<<ds_str;
         dataset.close();
+        a_datasetWritten = true;
+    }
+}
+
+/*!
+ * \brief AbstractSpiceKernel::finishConversion Report the result of
+ *        writeDataset() and store the dataset in the result cache.
+ * \param qucs_dataset A file name of Qucs Dataset
+ */
+void AbstractSpiceKernel::finishConversion(const QString &qucs_dataset)
+{
+    if (a_cancelled) { // the previous dataset is kept
+        a_log.append(tr("Simulation cancelled, dataset is not written.\n"));
+        finishLog();
+        return;
+    }
+
+    if (a_datasetWritten) {
+        if (!a_cacheKey.isEmpty()) {
+            SimResultCache cache(a_schematic->getDocName());
+            cache.store(a_cacheKey, qucs_dataset, a_log.tail());
+        }
     } else {
         QFileInfo inf(qucs_dataset);
         QMessageBox::warning(nullptr, tr("Simulate"),
                              tr("Failed to create dataset file ") + qucs_dataset + "\n"
                              + tr("Check write permission of the directory ") + inf.path());
     }
+    setPhase(PhaseWrite, 100);
 #ifdef NDEBUG
     removeAllSimulatorOutputs();
 #endif
@@ -1445,6 +1640,7 @@ void AbstractSpiceKernel::normalizeVarsNames(QStringList &var_list, const QStrin
  */
 void AbstractSpiceKernel::slotErrors(QProcess::ProcessError err)
 {
+    if (a_cancelled) return; // killed on request
     emit errors(err);
 }
 
@@ -1453,8 +1649,8 @@ void AbstractSpiceKernel::slotErrors(QProcess::ProcessError err)
  */
 void AbstractSpiceKernel::slotFinished()
 {
-    //a_output.clear();
-    a_output += a_simProcess->readAllStandardOutput();
+    appendOutput(a_simProcess->readAllStandardOutput());
+    finishLog();
     emit finished();
     emit progress(100);
 }
@@ -1464,7 +1660,57 @@ void AbstractSpiceKernel::slotFinished()
  */
 void AbstractSpiceKernel::slotProcessOutput()
 {
+    appendOutput(a_simProcess->readAllStandardOutput());
+}
+
+/*!
+ * \brief AbstractSpiceKernel::slotFlushConsole Show output received since
+ *        the last console update.
+ */
+void AbstractSpiceKernel::slotFlushConsole()
+{
+    if (a_console == nullptr || !a_log.hasPending()) return;
+    a_console->moveCursor(QTextCursor::End);
+    a_console->insertPlainText(a_log.takePending());
+    a_console->moveCursor(QTextCursor::End);
+}
+
+/*!
+ * \brief AbstractSpiceKernel::startLog Start a new simulation log. The
+ *        complete log is written to spice4qucs.log in the working directory.
+ */
+void AbstractSpiceKernel::startLog()
+{
+    a_consoleTimer->stop();
+    a_log.begin(a_workdir + QDir::separator() + "spice4qucs.log",
+                QucsSettings.DefaultSimulator);
+}
+
+/*!
+ * \brief AbstractSpiceKernel::appendOutput Add simulator output to the log,
+ *        report progress and schedule a console update.
+ * \param text Output chunk
+ */
+void AbstractSpiceKernel::appendOutput(const QString &text)
+{
+    int percent = a_log.progress();
+    a_log.append(text);
+    if (a_log.progress() != percent) {
+        setPhase(PhaseSimulate, (a_runsDone*100 + std::max(a_log.progress(), 0))/a_runCount);
+    }
+    if (a_console != nullptr && !a_consoleTimer->isActive())
+        a_consoleTimer->start();
+}
 
+/*!
+ * \brief AbstractSpiceKernel::finishLog Complete the log and show the rest
+ *        of it in the console.
+ */
+void AbstractSpiceKernel::finishLog()
+{
+    a_log.finish();
+    a_consoleTimer->stop();
+    slotFlushConsole();
 }
 
 /*!
@@ -1474,7 +1720,7 @@ void AbstractSpiceKernel::slotProcessOutput()
  */
 QString AbstractSpiceKernel::getOutput()
 {
-    return a_output;
+    return a_log.tail();
 }
 
 /*!
@@ -1520,11 +1766,61 @@ void AbstractSpiceKernel::SaveNetlist(QString)
 
 }
 
+/*!
+ * \brief AbstractSpiceKernel::createBatch Describe the simulation of the
+ *        schematic as files and commands. Reimplemented in Ngspice and
+ *        Xyce classes.
+ * \param[out] batch Netlists, output files and simulator command
+ * \return False if the schematic cannot be simulated this way
+ */
+bool AbstractSpiceKernel::createBatch(Batch &)
+{
+    return false;
+}
+
 bool AbstractSpiceKernel::waitEndOfSimulation()
 {
+    if (a_cacheHit) return true;
     return a_simProcess->waitForFinished(10000);
 }
 
+/*!
+ * \brief AbstractSpiceKernel::restoreFromCache Look up the result cache before
+ *        the simulator is started. On a hit the simulation is reported as
+ *        finished without spawning the simulator and convertToQucsData()
+ *        restores the cached dataset. On a miss the key is remembered and the
+ *        dataset is stored after conversion. The caller has started the
+ *        log, the cached log is added to it.
+ * \param netlists Netlists passed to the simulator
+ * \param extra_files Other input files of the simulator
+ * \return True if the dataset is found in cache
+ */
+bool AbstractSpiceKernel::restoreFromCache(const QStringList &netlists,
+                                           const QStringList &extra_files)
+{
+    a_cacheKey.clear();
+    a_cacheHit = false;
+    // DC bias is back-annotated to the schematic, there is no dataset to restore
+    if (a_DC_OP_only || !SimResultCache::isEnabled()) return false;
+
+    SimResultCache cache(a_schematic->getDocName());
+    a_cacheKey = cache.computeKey(netlists, extra_files,
+                                  a_simulator_cmd, a_simulator_parameters,
+                                  a_output_files);
+    if (!cache.contains(a_cacheKey)) return false;
+
+    a_cacheHit = true;
+    a_log.append(cache.log(a_cacheKey));
+    a_log.append(tr("\nNetlist and models are unchanged, results are restored from cache.\n"));
+    emit started();
+    finishLog();
+    QTimer::singleShot(0, this, [this]() {
+        emit finished();
+        emit progress(100);
+    });
+    return true;
+}
+
 QString AbstractSpiceKernel::collectSpiceLibs(Schematic* sch)
 {
   QStringList collected_spicelib;
@@ -21,13 +21,20 @@
 #define ABSTRACTSPICEKERNEL_H
 
 #include <QList>
+#include <QMap>
 #include <QString>
 #include <QStringList>
 #include <QDataStream>
 #include <QTextStream>
 #include <QProcess>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <thread>
 
 #include "schematic.h"
+#include "simlogsink.h"
 
 class QPlainTextEdit;
 
@@ -60,8 +67,9 @@ protected:
     QString a_workdir;
     QString a_simulator_cmd;
     QString a_simulator_parameters;
-    QString a_output;
+    SimLogSink a_log;
     QProcess *a_simProcess;
+    QTimer *a_consoleTimer;
 
     QPlainTextEdit *a_console;
     QStringList a_sims;
@@ -75,6 +83,20 @@ protected:
     bool a_parseFourTHD;  // Fourier output is parsed twice, first freqencies, then THD
     bool a_parsePZzeros;  // PZ output is parsed twice, first poles, then zeros
 
+    std::atomic<bool> a_cancelled; // Simulation is cancelled by user, skip remaining work
+    int a_phase;          // Current SimPhase
+    int a_runCount;       // Simulator runs of this simulation (Xyce runs one per analysis)
+    int a_runsDone;
+    QElapsedTimer a_phaseTimer;
+    qint64 a_phaseTraceStart; // Tracer timestamp of the current phase
+
+    QString a_cacheKey;   // Result cache key of the current simulation
+    bool a_cacheHit;      // Dataset is restored from cache, simulator not started
+
+    std::thread a_convertThread; // convertToQucsDataAsync() worker
+    int a_conversionId;          // the conversion whose result is reported
+    bool a_datasetWritten;       // result of writeDataset()
+
     bool prepareSpiceNetlist(QTextStream &stream, bool isSubckt = false);
     virtual void startNetlist(QTextStream& stream, bool xyce = false);
     virtual void createNetlist(QTextStream& stream, int NumPorts,QStringList& simulations,
@@ -84,9 +106,32 @@ protected:
     bool checkSimulations();
     bool checkDCSimulation();
     QString collectSpiceLibs(Schematic* sch);
+    bool restoreFromCache(const QStringList &netlists, const QStringList &extra_files);
+    void startLog();
+    void appendOutput(const QString &text);
+    void finishLog();
+    void startProgress(int run_count = 1);
+    void setPhase(int phase, int percent);
+    bool checkCancelled();
+    bool convertWithoutParsing(const QString &qucs_dataset);
+    void writeDataset(const QString &qucs_dataset);
+    void finishConversion(const QString &qucs_dataset);
 
 public:
 
+    /*! Simulation phases reported by progress() and phaseChanged() */
+    enum SimPhase { PhaseNetlist = 0, PhaseSimulate, PhaseParse, PhaseWrite };
+
+    /*! Everything needed to run the simulation of the schematic without
+     *  this object, e.g. many times in parallel by the Optimizer */
+    struct Batch {
+        QMap<QString, QString> files; // file name -> contents, put into the work directory
+        QStringList netlists;         // netlists among the files, simulated in this order
+        QStringList outputs;          // files written by the simulator
+        QString program;              // simulator command, the netlist is appended
+        QStringList arguments;
+    };
+
     explicit AbstractSpiceKernel(Schematic *schematic, QObject *parent = 0);
     ~AbstractSpiceKernel();
 
@@ -122,12 +167,18 @@ public:
                            QStringList &var_list);
     void parseResFile(QString resfile, QString &var, QStringList &values);
     void convertToQucsData(const QString &qucs_dataset);
+    void convertToQucsDataAsync(const QString &qucs_dataset);
     QString getOutput();
+    QString getLogFile() const { return a_log.spillFile(); }
+    bool logHasErrors() const { return a_log.hasErrors(); }
+    bool logHasWarnings() const { return a_log.hasWarnings(); }
+    bool wasCancelled() const { return a_cancelled; }
 
     virtual void setSimulatorCmd(QString cmd);
     virtual void setSimulatorParameters(QString parameters);
     void setWorkdir(QString path);
     virtual void SaveNetlist(QString filename);
+    virtual bool createBatch(Batch &batch);
     virtual bool waitEndOfSimulation();
     void setConsole(QPlainTextEdit *console) { a_console = console; }
 
@@ -136,14 +187,18 @@ signals:
     void finished();
     void errors(QProcess::ProcessError);
     void progress(int);
+    void phaseChanged(const QString &);
+    void converted();
 
 protected slots:
     virtual void slotFinished();
     virtual void slotProcessOutput();
+    void slotFlushConsole();
 
 public slots:
     virtual void slotSimulate();
     void killThemAll();
+    void slotCancel();
     void slotErrors(QProcess::ProcessError err);
 
 };
@@ -21,6 +21,8 @@
 
 #include "externsimdialog.h"
 #include "simsettingsdialog.h"
+#include "optimizer.h"
+#include "components/opt_sim.h"
 #include "main.h"
 #include "qucs.h"
 
@@ -36,7 +38,9 @@ ExternSimDialog::ExternSimDialog(Schematic *sch, bool netlist_mode) :
     a_ngspice(new Ngspice(sch,this)),
     a_xyce(new Xyce(sch,this)),
     a_wasSimulated(true),
-    a_hasError(false)
+    a_hasError(false),
+    a_optimizer(nullptr),
+    a_optThread()
 {
     const QString workdir(QucsSettings.S4Qworkdir);
 
@@ -52,8 +56,7 @@ ExternSimDialog::ExternSimDialog(Schematic *sch, bool netlist_mode) :
         dir.mkpath(workdir);
     }
 
-    connect(a_buttonStopSim,SIGNAL(clicked()),a_ngspice,SLOT(killThemAll()));
-    connect(a_buttonStopSim,SIGNAL(clicked()),a_xyce,SLOT(killThemAll()));
+    connect(a_buttonStopSim,SIGNAL(clicked()),this,SLOT(slotStop()));
     a_buttonStopSim->setEnabled(false);
 
     connect(a_buttonSaveNetlist,SIGNAL(clicked()),this,SLOT(slotSaveNetlist()));
@@ -70,6 +73,7 @@ ExternSimDialog::ExternSimDialog(Schematic *sch, bool netlist_mode) :
     font.setPointSize(10);
     a_editSimConsole->setFont(font);
     a_editSimConsole->setReadOnly(true);
+    a_editSimConsole->setMaximumBlockCount(10000); // complete log goes to file
     vbl1->addWidget(a_editSimConsole);
     grp_1->setLayout(vbl1);
     a_ngspice->setConsole(a_editSimConsole);
@@ -77,6 +81,8 @@ ExternSimDialog::ExternSimDialog(Schematic *sch, bool netlist_mode) :
 
     connect(a_ngspice,SIGNAL(progress(int)),a_simProgress,SLOT(setValue(int)));
     connect(a_xyce,SIGNAL(progress(int)),a_simProgress,SLOT(setValue(int)));
+    connect(a_ngspice,SIGNAL(phaseChanged(QString)),this,SLOT(slotSimPhase(QString)));
+    connect(a_xyce,SIGNAL(phaseChanged(QString)),this,SLOT(slotSimPhase(QString)));
 
     QVBoxLayout *vl_top = new QVBoxLayout;
     vl_top->addWidget(grp_1,3);
@@ -97,6 +103,11 @@ ExternSimDialog::ExternSimDialog(Schematic *sch, bool netlist_mode) :
 
 ExternSimDialog::~ExternSimDialog()
 {
+    if (a_optThread.joinable()) {
+        a_optimizer->cancel();
+        a_optThread.join();
+    }
+    delete a_optimizer;
     a_ngspice->killThemAll();
 }
 
@@ -107,6 +118,7 @@ void ExternSimDialog::slotSetSimulator()
         a_xyce->setParallel(false);
         connect(a_ngspice,SIGNAL(started()),this,SLOT(slotNgspiceStarted()));
         connect(a_ngspice,SIGNAL(finished()),this,SLOT(slotProcessOutput()));
+        connect(a_ngspice,SIGNAL(converted()),this,SLOT(slotConverted()));
         connect(a_ngspice,SIGNAL(errors(QProcess::ProcessError)),this,SLOT(slotNgspiceStartError(QProcess::ProcessError)));
         QString cmd;
         if (QFileInfo(QucsSettings.NgspiceExecutable).isRelative()) { // this check is related to MacOS
@@ -126,6 +138,7 @@ void ExternSimDialog::slotSetSimulator()
         a_xyce->setParallel(false);
         connect(a_xyce,SIGNAL(started()),this,SLOT(slotNgspiceStarted()));
         connect(a_xyce,SIGNAL(finished()),this,SLOT(slotProcessOutput()));
+        connect(a_xyce,SIGNAL(converted()),this,SLOT(slotConverted()));
         connect(a_xyce,SIGNAL(errors(QProcess::ProcessError)),this,SLOT(slotNgspiceStartError(QProcess::ProcessError)));
         a_xyce->setSimulatorParameters(QucsSettings.SimParameters);
     }
@@ -147,6 +160,7 @@ void ExternSimDialog::slotSetSimulator()
         a_xyce->setParallel(false);
         connect(a_ngspice,SIGNAL(started()),this,SLOT(slotNgspiceStarted()),Qt::UniqueConnection);
         connect(a_ngspice,SIGNAL(finished()),this,SLOT(slotProcessOutput()),Qt::UniqueConnection);
+        connect(a_ngspice,SIGNAL(converted()),this,SLOT(slotConverted()),Qt::UniqueConnection);
         connect(a_ngspice,SIGNAL(errors(QProcess::ProcessError)),this,SLOT(slotNgspiceStartError(QProcess::ProcessError)),Qt::UniqueConnection);
         a_ngspice->setSimulatorCmd(QucsSettings.SpiceOpusExecutable);
         a_ngspice->setSimulatorParameters(QucsSettings.SimParameters);
@@ -160,38 +174,43 @@ void ExternSimDialog::slotSetSimulator()
 void ExternSimDialog::slotProcessOutput()
 {
     a_buttonSaveNetlist->setEnabled(true);
-    a_buttonStopSim->setEnabled(false);
-    QString out;
+    // Stop button stays enabled, dataset conversion can be cancelled too
 
     // Set temporary safe output name
 
     QString ext;
+    AbstractSpiceKernel *kernel = nullptr;
     switch (QucsSettings.DefaultSimulator) {
     case spicecompat::simNgspice:
         ext = ".dat.ngspice";
-        out = a_ngspice->getOutput();
+        kernel = a_ngspice;
         break;
     case spicecompat::simXyce:
         ext = ".dat.xyce";
-        out = a_xyce->getOutput();
+        kernel = a_xyce;
         break;
     case spicecompat::simSpiceOpus:
-        out = a_ngspice->getOutput();
+        kernel = a_ngspice;
         ext = ".dat.spopus";
         break;
     default:
-        out = "dummy";
         ext = ".dat";
         break;
     }
 
-    if (logContainsError(out)) {
+    // The log is classified line by line while it arrives
+    if (kernel != nullptr && kernel->wasCancelled()) {
+        addLogEntry(tr("Simulation cancelled by user."),
+                    this->style()->standardIcon(QStyle::SP_MessageBoxWarning));
+        a_hasError = true;
+        a_wasSimulated = false;
+    } else if (kernel != nullptr && kernel->logHasErrors()) {
         addLogEntry(tr("There were simulation errors. Please check log."),
                     this->style()->standardIcon(QStyle::SP_MessageBoxCritical));
         a_hasError = true;
         a_wasSimulated = false;
         emit warnings();
-    } else if (logContainsWarning(out)) {
+    } else if (kernel != nullptr && kernel->logHasWarnings()) {
         addLogEntry(tr("There were simulation warnings. Please check log."),
                     this->style()->standardIcon(QStyle::SP_MessageBoxWarning));
         addLogEntry(tr("Simulation finished. Now place diagram on schematic to plot the result."),
@@ -207,25 +226,31 @@ void ExternSimDialog::slotProcessOutput()
     //a_editSimConsole->clear();
     /*a_editSimConsole->insertPlainText(out);
     a_editSimConsole->moveCursor(QTextCursor::End);*/
-    saveLog();
+    saveLog(kernel);
     a_editSimConsole->insertPlainText("Simulation finished\n");
 
-    if ( !a_hasError ) {
+    if ( !a_hasError && kernel != nullptr ) {
         QFileInfo inf(a_schematic->getDocName());
         //QString qucs_dataset = inf.canonicalPath()+QDir::separator()+inf.baseName()+"_ngspice.dat";
         QString qucs_dataset = inf.canonicalPath()+QDir::separator()+inf.completeBaseName()+ext;
-        switch (QucsSettings.DefaultSimulator) {
-            case spicecompat::simNgspice:
-            case spicecompat::simSpiceOpus:
-                a_ngspice->convertToQucsData(qucs_dataset);
-                break;
-            case spicecompat::simXyce:
-                a_xyce->convertToQucsData(qucs_dataset);
-                break;
-            default:
-                break;
-        }
+        // The dataset is written on a worker thread, slotConverted() follows
+        kernel->convertToQucsDataAsync(qucs_dataset);
+        return;
     }
+    slotConverted();
+}
+
+void ExternSimDialog::slotConverted()
+{
+    AbstractSpiceKernel *kernel = a_ngspice;
+    if (QucsSettings.DefaultSimulator == spicecompat::simXyce) kernel = a_xyce;
+    kernel->setWorkdir(QucsSettings.S4Qworkdir); // back from the optimizer results
+    if (!a_hasError && kernel->wasCancelled()) {
+        addLogEntry(tr("Simulation cancelled by user."),
+                    this->style()->standardIcon(QStyle::SP_MessageBoxWarning));
+        a_wasSimulated = false;
+    }
+    a_buttonStopSim->setEnabled(false);
     //a_wasSimulated = true;
     //if (out.contains("error",Qt::CaseInsensitive))
     //    a_hasError = true;
@@ -271,6 +296,17 @@ void ExternSimDialog::slotStart()
 {
     a_buttonStopSim->setEnabled(true);
     a_buttonSaveNetlist->setEnabled(false);
+    Optimize_Sim *opt = Optimizer::find(a_schematic);
+    if (opt != nullptr && a_schematic->getShowBias() != 0 &&
+        QucsSettings.DefaultSimulator != spicecompat::simSpiceOpus) {
+        startOptimization(opt);
+        return;
+    }
+    simulate();
+}
+
+void ExternSimDialog::simulate()
+{
     switch (QucsSettings.DefaultSimulator) {
     case spicecompat::simNgspice:
         a_ngspice->slotSimulate();
@@ -285,11 +321,100 @@ void ExternSimDialog::slotStart()
     }
 }
 
+/*!
+ * \brief ExternSimDialog::startOptimization Run the Optimizer on its own
+ *        thread, then show the simulation of the best point found.
+ */
+void ExternSimDialog::startOptimization(Optimize_Sim *opt)
+{
+    AbstractSpiceKernel *kernel = a_ngspice;
+    if (QucsSettings.DefaultSimulator == spicecompat::simXyce) kernel = a_xyce;
+
+    delete a_optimizer;
+    a_optimizer = new Optimizer(opt);
+    AbstractSpiceKernel::Batch batch;
+    if (!kernel->createBatch(batch) ||
+        !a_optimizer->setBatch(batch, QucsSettings.S4Qworkdir)) {
+        QString msg = a_optimizer->error();
+        if (msg.isEmpty()) msg = tr("Cannot create the netlist for the optimization.");
+        addLogEntry(msg, this->style()->standardIcon(QStyle::SP_MessageBoxCritical));
+        a_wasSimulated = false;
+        a_hasError = true;
+        a_buttonStopSim->setEnabled(false);
+        a_buttonSaveNetlist->setEnabled(true);
+        return;
+    }
+    a_optimizer->setLog(Optimizer::logFile(a_schematic->getDocName()));
+
+    a_editSimConsole->clear();
+    addLogEntry(tr("Optimization started on: ") + QDateTime::currentDateTime().toString(),
+                this->style()->standardIcon(QStyle::SP_MessageBoxInformation));
+    a_simProgress->setRange(0, 0);
+    a_simProgress->setFormat(tr("Optimizing"));
+
+    a_optThread = std::thread([this]() {
+        bool ok = a_optimizer->run([this](const QString &msg) {
+            QMetaObject::invokeMethod(this, [this, msg]() {
+                a_editSimConsole->appendPlainText(msg);
+            }, Qt::QueuedConnection);
+        });
+        QMetaObject::invokeMethod(this, [this, ok]() { optimizationFinished(ok); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void ExternSimDialog::optimizationFinished(bool ok)
+{
+    a_optThread.join();
+    a_simProgress->setRange(0, 100);
+    a_simProgress->setValue(100);
+
+    if (!ok) {
+        QString msg = a_optimizer->error();
+        if (msg.isEmpty()) msg = tr("Optimization cancelled by user.");
+        addLogEntry(msg, this->style()->standardIcon(QStyle::SP_MessageBoxWarning));
+        a_wasSimulated = false;
+        a_hasError = true;
+        a_buttonStopSim->setEnabled(false);
+        a_buttonSaveNetlist->setEnabled(true);
+        return;
+    }
+
+    // the best values become the initial values, as after ASCO
+    Optimize_Sim *opt = Optimizer::find(a_schematic);
+    const QVector<Optimizer::Variable> &vars = a_optimizer->variables();
+    for (int i = 0; i < vars.size(); i++) {
+        if (!vars.at(i).active) continue;
+        if (opt != nullptr) opt->setVariable(vars.at(i).name, a_optimizer->valueText(i));
+        a_editSimConsole->appendPlainText(vars.at(i).name + " = " + a_optimizer->valueText(i));
+    }
+    const QVector<Optimizer::Goal> &goals = a_optimizer->goals();
+    for (int i = 0; i < goals.size(); i++)
+        a_editSimConsole->appendPlainText(QStringLiteral("%1 = %2")
+            .arg(goals.at(i).name).arg(a_optimizer->goalValues().value(i)));
+    a_schematic->setChanged(true, true);
+    addLogEntry(tr("Optimization finished after %1 simulations.").arg(a_optimizer->evaluations()),
+                QIcon(":/bitmaps/svg/ok_apply.svg"));
+
+    // the dataset is made of the outputs of the best point
+    AbstractSpiceKernel *kernel = a_ngspice;
+    if (QucsSettings.DefaultSimulator == spicecompat::simXyce) kernel = a_xyce;
+    kernel->setWorkdir(a_optimizer->resultDir()); // restored by slotConverted()
+    slotProcessOutput();
+}
+
 void ExternSimDialog::slotStop()
 {
     a_buttonStopSim->setEnabled(false);
     a_buttonSaveNetlist->setEnabled(true);
-    a_ngspice->killThemAll();
+    if (a_optimizer != nullptr) a_optimizer->cancel();
+    a_ngspice->slotCancel();
+    a_xyce->slotCancel();
+}
+
+void ExternSimDialog::slotSimPhase(const QString &phase)
+{
+    a_simProgress->setFormat(phase + " (%p%)");
 }
 
 void ExternSimDialog::slotSaveNetlist()
@@ -328,9 +453,13 @@ void ExternSimDialog::slotExit()
     accept();
 }
 
-void ExternSimDialog::saveLog()
+void ExternSimDialog::saveLog(AbstractSpiceKernel *kernel)
 {
+    // The console shows only the tail of long logs, copy the complete one
     QString filename = QucsSettings.tempFilesDir.filePath("log.txt");
+    QFile::remove(filename);
+    if (kernel != nullptr && QFile::copy(kernel->getLogFile(), filename)) return;
+
     QFile log(filename);
     if (log.open(QIODevice::WriteOnly)) {
         QTextStream ts_log(&log);
@@ -348,55 +477,3 @@ void ExternSimDialog::addLogEntry(const QString &text, const QIcon &icon)
     a_simStatusLog->addItem(itm);
 }
 
-bool ExternSimDialog::logContainsError(const QString &out)
-{
-    bool found = false;
-    QStringList err_patterns;
-    switch (QucsSettings.DefaultSimulator) {
-    case spicecompat::simNgspice:
-        err_patterns<<"Error:"<<"ERROR"<<"Error "
-                    <<"Syntax error:"<<"Expression err:"
-                    <<"errors:"<<"simulation(s) aborted"
-                    <<"simulation aborted"<<"analysis aborted";
-        break;
-    case spicecompat::simXyce:
-        err_patterns<<"Error:"<<"ERROR"<<"MSG_ERROR"
-                    <<"error:"<<"MSG_FATAL";
-        break;
-    default: err_patterns<<"error";
-        break;
-    }
-    for(const auto &err_str: err_patterns) {
-        if (out.contains(err_str)) {
-            found = true;
-            break;
-        }
-    }
-    return found;
-}
-
-bool ExternSimDialog::logContainsWarning(const QString &out)
-{
-    bool found = false;
-    QStringList warn_patterns;
-    switch (QucsSettings.DefaultSimulator) {
-    case spicecompat::simNgspice:
-        warn_patterns<<"Warning:"<<"WARNING"<<"Warning "
-                    <<"warning:";
-        break;
-    case spicecompat::simXyce:
-        warn_patterns<<"Warning:"<<"WARNING"<<"Warning "
-                    <<"warning:";
-        break;
-    default: warn_patterns<<"warning";
-        break;
-    }
-    for(const auto &warn_str: warn_patterns) {
-        if (out.contains(warn_str)) {
-            found = true;
-            break;
-        }
-    }
-    return found;
-}
-
@@ -25,6 +25,11 @@
 #include "xyce.h"
 #include "spicecompat.h"
 
+#include <thread>
+
+class Optimizer;
+class Optimize_Sim;
+
 class ExternSimDialog : public QDialog
 {
     Q_OBJECT
@@ -47,6 +52,9 @@ private:
     bool a_wasSimulated;
     bool a_hasError;
 
+    Optimizer *a_optimizer;
+    std::thread a_optThread;
+
 public:
     explicit ExternSimDialog(Schematic *sch,
                              bool netlist_mode = false);
@@ -56,10 +64,11 @@ public:
     bool hasError() const { return a_hasError; }
 
 private:
-    void saveLog();
+    void saveLog(AbstractSpiceKernel *kernel);
     void addLogEntry(const QString&text, const QIcon &icon);
-    bool logContainsError(const QString &out);
-    bool logContainsWarning(const QString &out);
+    void simulate();
+    void startOptimization(Optimize_Sim *opt);
+    void optimizationFinished(bool ok);
 
 signals:
     void simulated(ExternSimDialog *);
@@ -72,10 +81,12 @@ public slots:
 
 private slots:
     void slotProcessOutput();
+    void slotConverted();
     //void slotProcessXyceOutput();
     void slotNgspiceStarted();
     void slotNgspiceStartError(QProcess::ProcessError err);
     void slotStop();
+    void slotSimPhase(const QString &phase);
     void slotSetSimulator();
     void slotExit();
 };
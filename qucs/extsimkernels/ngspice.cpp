@@ -59,6 +59,97 @@ Ngspice::Ngspice(Schematic *schematic, QObject *parent) :
     a_spinit_name = QDir::toNativeSeparators(QucsSettings.S4Qworkdir+"/.spiceinit");
 }
 
+/*!
+ * \brief collectModelTypes Collect the device types of the .model
+ *        cards of a netlist text and, recursively, of the files it includes.
+ * \param text Netlist or library text
+ * \param dir Directory relative include paths are resolved against
+ * \param[out] types Lower case device types
+ * \param visited Absolute paths of the files already scanned
+ * \return False if an included file could not be read
+ */
+static bool collectModelTypes(const QString &text, const QDir &dir,
+                              QSet<QString> &types, QSet<QString> &visited)
+{
+    static const QRegularExpression model_rx(
+        "^\\s*\\.model\\s+\\S+\\s+([A-Za-z_][\\w$]*)",
+        QRegularExpression::CaseInsensitiveOption | QRegularExpression::MultilineOption);
+    static const QRegularExpression include_rx(
+        "^\\s*\\.(?:inc(?:lude)?|lib)\\s+(?:\"([^\"]+)\"|'([^']+)'|(\\S+))",
+        QRegularExpression::CaseInsensitiveOption | QRegularExpression::MultilineOption);
+
+    QRegularExpressionMatchIterator it = model_rx.globalMatch(text);
+    while (it.hasNext()) types.insert(it.next().captured(1).toLower());
+
+    bool complete = true;
+    QRegularExpressionMatchIterator inc = include_rx.globalMatch(text);
+    while (inc.hasNext()) {
+        QRegularExpressionMatch m = inc.next();
+        QString name = m.captured(1) + m.captured(2) + m.captured(3);
+        QFileInfo inf(dir, name);
+        QString path = inf.absoluteFilePath();
+        if (visited.contains(path)) continue;
+        visited.insert(path);
+        QFile lib(path);
+        if (!lib.open(QIODevice::ReadOnly)) {
+            complete = false;
+            continue;
+        }
+        complete &= collectModelTypes(QString::fromUtf8(lib.readAll()),
+                                      inf.absoluteDir(), types, visited);
+    }
+    return complete;
+}
+
+/*!
+ * \brief Ngspice::referencedOsdiFiles Find the OSDI files of the project
+ *        directory a netlist uses. A module is used if a .model card of the
+ *        netlist, or of a file it includes directly or indirectly, names it
+ *        as device type. An OSDI file provides the modules declared in the
+ *        Verilog-A source of the same name, or the module named like the
+ *        file if there is no source. All OSDI files are used if an included
+ *        file can't be read, since its models are unknown then.
+ * \param netlist Netlist text
+ * \return Absolute file names
+ */
+QStringList Ngspice::referencedOsdiFiles(const QString &netlist)
+{
+    QStringList result;
+    QDir work_dir = QucsSettings.QucsWorkDir;
+    QStringList osdi_files = work_dir.entryList(QStringList("*.osdi"), QDir::Files);
+    if (osdi_files.isEmpty()) return result;
+
+    static const QRegularExpression module_rx(
+        "^\\s*module\\s+([A-Za-z_][\\w$]*)", QRegularExpression::MultilineOption);
+
+    // model cards of the netlist and of the libraries it includes
+    QSet<QString> types;
+    QSet<QString> visited;
+    if (!collectModelTypes(netlist, work_dir, types, visited)) {
+        for (const QString &file : osdi_files)
+            result.append(work_dir.absoluteFilePath(file));
+        return result;
+    }
+    if (types.isEmpty()) return result;
+
+    for (const QString &file : osdi_files) {
+        QFileInfo inf(work_dir.filePath(file));
+        QStringList modules(inf.completeBaseName());
+        QFile va(work_dir.filePath(inf.completeBaseName() + ".va"));
+        if (va.open(QIODevice::ReadOnly)) {
+            QRegularExpressionMatchIterator it = module_rx.globalMatch(QString::fromUtf8(va.readAll()));
+            while (it.hasNext()) modules.append(it.next().captured(1));
+        }
+        for (const QString &module : modules) {
+            if (types.contains(module.toLower())) {
+                result.append(inf.absoluteFilePath());
+                break;
+            }
+        }
+    }
+    return result;
+}
+
 /*!
  * \brief Ngspice::createNetlist Output Ngspice-style netlist to text stream.
  *        Netlist contains sections necessary for Ngspice.
@@ -81,9 +172,16 @@ void Ngspice::createNetlist(QTextStream &stream, int ,
     if (found && QucsSettings.DefaultSimulator != spicecompat::simSpiceOpus)
         stream<<QStringLiteral(".INCLUDE \"%1\"\n").arg(mathf_inc);
 
-    stream<<collectSpiceLibs(a_schematic); // collect libraries on the top of netlist
-    if(!prepareSpiceNetlist(stream)) return; // Unable to perform spice simulation
-    startNetlist(stream); // output .PARAM and components
+    QString libs = collectSpiceLibs(a_schematic);
+    stream<<libs; // collect libraries on the top of netlist
+    // subcircuits and components are kept to look up the used osdi modules
+    QString devices;
+    QTextStream dev_stream(&devices);
+    bool prepared = prepareSpiceNetlist(dev_stream);
+    if (prepared) startNetlist(dev_stream); // output .PARAM and components
+    dev_stream.flush();
+    stream<<devices;
+    if (!prepared) return; // Unable to perform spice simulation
 
     if (a_DC_OP_only) {
         stream<<".control\n"  // Execute only DC OP analysis
@@ -130,13 +228,9 @@ void Ngspice::createNetlist(QTextStream &stream, int ,
 
     if (QucsMain != nullptr) { // if not run from CLI
         if (!QucsMain->ProjName.isEmpty()) {
-            // always load osdi from the project directory
-            QStringList osdi_ext;
-            osdi_ext<<"*.osdi";
-            QStringList osdi_files = QucsSettings.QucsWorkDir.entryList(osdi_ext,QDir::Files);
-            for(const auto &file : osdi_files) {
-                QString abs_file = QucsSettings.QucsWorkDir.absolutePath() +
-                        QDir::separator() + file;
+            // load the osdi modules of the project directory used by the netlist
+            QStringList osdi_files = referencedOsdiFiles(libs + devices);
+            for(const auto &abs_file : osdi_files) {
                 stream<<QStringLiteral("pre_osdi '%1'\n").arg(abs_file);
             }
         }
@@ -411,52 +505,52 @@ QString Ngspice::getParentSWPscript(Component *pc_swp, QString sim, bool before,
  */
 void Ngspice::slotSimulate()
 {
-    a_output.clear();
+    startProgress();
+    startLog();
 
     QString mathf_inc; // drain
     if (!findMathFuncInc(mathf_inc)) {
-        a_output.append("[Warning!] " + mathf_inc + " file not found!\n");
+        a_log.append("[Warning!] " + mathf_inc + " file not found!\n");
     }
 
     bool checker_error = false;
     QStringList incompat;
     if (!checkSchematic(incompat)) {
         QString s = incompat.join("; ");
-        a_output.append("There were SPICE-incompatible components. Simulator cannot proceed.");
-        a_output.append("Incompatible components are: " + s + "\n");
+        a_log.append("There were SPICE-incompatible components. Simulator cannot proceed.");
+        a_log.append("Incompatible components are: " + s + "\n");
         checker_error = true;
     }
 
     if (!checkGround()) {
-        a_output.append("No Ground found. Please add at least one ground!\n"
-                      "Press Insert->Ground in the main menu and connect ground to one "
-                      "of the schematic nodes.\n");
+        a_log.append("No Ground found. Please add at least one ground!\n"
+                   "Press Insert->Ground in the main menu and connect ground to one "
+                   "of the schematic nodes.\n");
         checker_error = true;
     }
 
     if (!checkSimulations()) {
-        a_output.append("No simulation found. Please add at least one simulation!\n"
-                      "Navigate to the \"simulations\" group in the components panel (left)"
-                      " and drag simulation to the schematic sheet. Then define its parameters.\n");
+        a_log.append("No simulation found. Please add at least one simulation!\n"
+                   "Navigate to the \"simulations\" group in the components panel (left)"
+                   " and drag simulation to the schematic sheet. Then define its parameters.\n");
         checker_error = true;
     }
 
     if (!checkDCSimulation()) {
-        a_output.append("Only DC simulation found in the schematic. It has no effect!"
-                      " Add TRAN, AC, or Sweep simulation to proceed.\n");
+        a_log.append("Only DC simulation found in the schematic. It has no effect!"
+                   " Add TRAN, AC, or Sweep simulation to proceed.\n");
         checker_error = true;
     }
 
     if (!checkNodeNames(incompat)) {
         QString s = incompat.join("; ");
-        a_output.append("There were Nutmeg-incompatible node names. Simulator cannot proceed.\n");
-        a_output.append("Incompatible node names are: " + s + "\n");
+        a_log.append("There were Nutmeg-incompatible node names. Simulator cannot proceed.\n");
+        a_log.append("Incompatible node names are: " + s + "\n");
         checker_error = true;
     }
 
     if (checker_error) {
-        if (a_console != nullptr)
-            a_console->insertPlainText(a_output);
+        finishLog();
         //emit finished();
         emit errors(QProcess::FailedToStart);
         return;
@@ -465,6 +559,7 @@ void Ngspice::slotSimulate()
     QString netfile = "spice4qucs.cir";
     QString tmp_path = QDir::toNativeSeparators(a_workdir+QDir::separator()+netfile);
     SaveNetlist(tmp_path);
+    setPhase(PhaseNetlist, 100);
 
     removeAllSimulatorOutputs();
 
@@ -480,7 +575,10 @@ void Ngspice::slotSimulate()
     cleanSpiceinit();
     createSpiceinit(/*initial_spiceinit=*/collectSpiceinit(a_schematic));
 
+    if (restoreFromCache(QStringList(tmp_path), QStringList(a_spinit_name))) return;
+
     //startNgSpice(tmp_path);
+    setPhase(PhaseSimulate, 0);
     a_simProcess->setWorkingDirectory(a_workdir);
     qDebug()<<a_workdir;
     QString cmd = QStringLiteral("\"%1\" %2 %3").arg(a_simulator_cmd,a_simulator_parameters,netfile);
@@ -560,25 +658,6 @@ bool Ngspice::findMathFuncInc(QString &mathf_inc)
     return QFile::exists(mathf_inc);
 }
 
-/*!
- * \brief Ngspice::slotProcessOutput Process Ngspice output and report completion
- *        percentage.
- */
-void Ngspice::slotProcessOutput()
-{
-    QString s = a_simProcess->readAllStandardOutput();
-    QRegularExpression percentage_pattern("^%\\d\\d*\\.\\d\\d.*$");
-    if (percentage_pattern.match(s).hasMatch()) {
-        int percent = round(s.mid(1,5).toFloat());
-        emit progress(percent);
-    }
-    a_output += s;
-    if (a_console != nullptr) {
-        a_console->insertPlainText(s);
-        a_console->moveCursor(QTextCursor::End);
-    }
-}
-
 /*!
  * \brief Ngspice::SaveNetlist Create netlist and save it to file without execution
  *        of simulator.
@@ -604,6 +683,43 @@ void Ngspice::SaveNetlist(QString filename)
     }
 }
 
+/*!
+ * \brief Ngspice::createBatch Describe the simulation as one netlist and the
+ *        .spiceinit file next to it.
+ * \param[out] batch Netlists, output files and simulator command
+ * \return False if the netlist cannot be created
+ */
+bool Ngspice::createBatch(Batch &batch)
+{
+    int num=0;
+    a_sims.clear();
+    a_vars.clear();
+    a_output_files.clear();
+
+    QString netlist;
+    QTextStream stream(&netlist);
+    createNetlist(stream,num,a_sims,a_vars,a_output_files);
+    stream.flush();
+    if (a_output_files.isEmpty()) return false; // broken netlist or nothing to simulate
+
+    batch.files.clear();
+    batch.files.insert("spice4qucs.cir", netlist);
+    cleanSpiceinit();
+    createSpiceinit(/*initial_spiceinit=*/collectSpiceinit(a_schematic));
+    QFile spinit(a_spinit_name);
+    if (spinit.open(QIODevice::ReadOnly)) {
+        batch.files.insert(QFileInfo(a_spinit_name).fileName(), QString::fromUtf8(spinit.readAll()));
+        spinit.close();
+    }
+    batch.netlists = QStringList("spice4qucs.cir");
+    batch.outputs = a_output_files;
+
+    QString cmd = QStringLiteral("\"%1\" %2").arg(a_simulator_cmd,a_simulator_parameters);
+    batch.arguments = misc::parseCmdArgs(cmd);
+    batch.program = batch.arguments.takeFirst();
+    return true;
+}
+
 void Ngspice::setSimulatorCmd(QString cmd)
 {
     if (cmd.contains(QRegularExpression("spiceopus(....|)$"))) {
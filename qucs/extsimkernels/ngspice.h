@@ -47,10 +47,12 @@ private:
     QString getParentSWPCntVar(Component *pc_swp, QString sim);
     void cleanSpiceinit();
     void createSpiceinit(const QString &initial_spiceinit);
+    static QStringList referencedOsdiFiles(const QString &netlist);
 
 public:
     explicit Ngspice(Schematic *schematic, QObject *parent = 0);
     void SaveNetlist(QString filename);
+    bool createBatch(Batch &batch);
     void setSimulatorCmd(QString cmd);
     void setSimulatorParameters(QString parameters);
 
@@ -60,9 +62,6 @@ protected:
 
 public slots:
     void slotSimulate();
-
-protected slots:
-    void slotProcessOutput();
 };
 
 #endif // NGSPICE_H
@@ -0,0 +1,636 @@
+/***************************************************************************
+                               optimizer.cpp
+                              ---------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "optimizer.h"
+#include "components/opt_sim.h"
+#include "dataset.h"
+#include "main.h"
+#include "misc.h"
+#include "schematic.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+/*!
+  \file optimizer.cpp
+  \brief Implementation of the Optimizer class
+*/
+
+// cost of a point that could not be simulated or misses a goal
+static const double FailedCost = 1e30;
+
+static double toNumber(const QString &s)
+{
+    double Number, Factor = 1.0;
+    QString Unit;
+    misc::str2num(s, Number, Unit, Factor);
+    return Number * Factor;
+}
+
+// Nearest value of an E series (E3 ... E192) to v.
+static double nearestESeries(double v, int n)
+{
+    static const double E3[] = {1.0, 2.2, 4.7};
+    static const double E6[] = {1.0, 1.5, 2.2, 3.3, 4.7, 6.8};
+    static const double E12[] = {1.0, 1.2, 1.5, 1.8, 2.2, 2.7, 3.3, 3.9, 4.7, 5.6, 6.8, 8.2};
+    static const double E24[] = {1.0, 1.1, 1.2, 1.3, 1.5, 1.6, 1.8, 2.0, 2.2, 2.4, 2.7, 3.0,
+                                 3.3, 3.6, 3.9, 4.3, 4.7, 5.1, 5.6, 6.2, 6.8, 7.5, 8.2, 9.1};
+    if (v <= 0.0) return v;
+    double decade = std::pow(10.0, std::floor(std::log10(v)));
+    double m = v / decade;
+
+    double best = 10.0;   // 1.0 of the next decade
+    auto consider = [&](double e) {
+        if (std::fabs(std::log(e / m)) < std::fabs(std::log(best / m))) best = e;
+    };
+    switch (n) {
+    case 3:  for (double e : E3) consider(e); break;
+    case 6:  for (double e : E6) consider(e); break;
+    case 12: for (double e : E12) consider(e); break;
+    case 24: for (double e : E24) consider(e); break;
+    default: // E48 and up are rounded geometric series
+        for (int i = 0; i < n; i++) {
+            double e = std::round(100.0 * std::pow(10.0, double(i) / n)) / 100.0;
+            if (n == 192 && i == 185) e = 9.20;   // the one exception
+            consider(e);
+        }
+    }
+    return best * decade;
+}
+
+// -----------------------------------------------------------
+Optimizer::Optimizer(Optimize_Sim *opt) :
+    a_jobs(0),
+    a_cancelled(false),
+    a_evaluations(0),
+    a_bestCost(FailedCost)
+{
+    QString de = opt->Props.at(1)->Value;
+    a_method = qBound(1, de.section('|',0,0).toInt(), 10);
+    a_maxIter = qMax(1, de.section('|',1,1).toInt());
+    a_refresh = qMax(1, de.section('|',2,2).toInt());
+    a_NP = de.section('|',3,3).toInt();
+    a_F = toNumber(de.section('|',4,4));
+    a_CR = toNumber(de.section('|',5,5));
+    a_seed = de.section('|',6,6).toUInt();
+    a_minCostVariance = toNumber(de.section('|',7,7));
+    a_costObjectives = toNumber(de.section('|',8,8));
+    a_costConstraints = toNumber(de.section('|',9,9));
+
+    for (int i = 2; i < opt->Props.size(); i++) {
+        QStringList val = opt->Props.at(i)->Value.split('|');
+        if (opt->Props.at(i)->Name == "Var" && val.size() >= 6) {
+            Variable v;
+            v.name = val.at(0);
+            v.active = val.at(1) == "yes";
+            v.value = toNumber(val.at(2));
+            v.min = toNumber(val.at(3));
+            v.max = toNumber(val.at(4));
+            v.type = val.at(5);
+            if (v.active && v.max > v.min) a_active.append(a_vars.size());
+            a_vars.append(v);
+        } else if (opt->Props.at(i)->Name == "Goal" && val.size() >= 3) {
+            a_goals.append({val.at(0), val.at(1), toNumber(val.at(2))});
+        }
+    }
+    // a mutation takes up to five members besides the parent
+    a_NP = qMax(a_NP, 6);
+}
+
+// -----------------------------------------------------------
+Optimize_Sim *Optimizer::find(Schematic *sch)
+{
+    for (Component *pc : *sch->a_Components)
+        if (pc->isActive && pc->Model == ".Opt")
+            return static_cast<Optimize_Sim*>(pc);
+    return nullptr;
+}
+
+QString Optimizer::logFile(const QString &docName)
+{
+    if (docName.isEmpty())
+        return QDir(QucsSettings.S4Qworkdir).filePath("spice4qucs.opt.log");
+    QFileInfo Info(docName);
+    return Info.dir().filePath(Info.completeBaseName() + ".opt.log");
+}
+
+// -----------------------------------------------------------
+bool Optimizer::setBatch(const AbstractSpiceKernel::Batch &batch, const QString &workDir)
+{
+    static const QRegularExpression param_rx("^\\s*(\\.param|let)\\s+([A-Za-z_]\\w*)\\s*=",
+                                             QRegularExpression::CaseInsensitiveOption);
+    a_batch = batch;
+    a_workDir = workDir;
+    a_lines.clear();
+    a_lineVar.clear();
+
+    QVector<bool> found(a_vars.size(), false);
+    for (const QString &name : batch.netlists) {
+        QStringList lines = batch.files.value(name).split('\n');
+        QVector<int> vars(lines.size(), -1);
+        for (int i = 0; i < lines.size(); i++) {
+            QRegularExpressionMatch m = param_rx.match(lines.at(i));
+            if (!m.hasMatch()) continue;
+            for (int v = 0; v < a_vars.size(); v++) {
+                if (a_vars.at(v).name.compare(m.captured(2), Qt::CaseInsensitive) == 0) {
+                    lines[i] = lines.at(i).left(m.capturedEnd());
+                    vars[i] = v;
+                    found[v] = true;
+                    break;
+                }
+            }
+        }
+        a_lines.append(lines);
+        a_lineVar.append(vars);
+    }
+    for (int v : a_active) {
+        if (!found.at(v)) {
+            a_error = QObject::tr("The optimization variable \"%1\" is not defined "
+                                  "by an equation of the schematic.").arg(a_vars.at(v).name);
+            return false;
+        }
+    }
+    if (a_goals.isEmpty()) {
+        a_error = QObject::tr("The optimization has no goals.");
+        return false;
+    }
+
+    // an earlier log is used only for the same problem
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (auto it = batch.files.constBegin(); it != batch.files.constEnd(); ++it)
+        hash.addData((it.key() + '\n' + it.value()).toUtf8());
+    QString setup = QStringLiteral("%1|%2|%3|%4|%5|%6|%7|%8|%9")
+        .arg(a_method).arg(a_maxIter).arg(a_NP).arg(a_F, 0, 'g', 17).arg(a_CR, 0, 'g', 17)
+        .arg(a_seed).arg(a_minCostVariance, 0, 'g', 17).arg(a_costObjectives, 0, 'g', 17)
+        .arg(a_costConstraints, 0, 'g', 17);
+    for (const Variable &v : a_vars)
+        setup += QStringLiteral("\n%1|%2|%3|%4|%5|%6").arg(v.name).arg(int(v.active))
+            .arg(v.value, 0, 'g', 17).arg(v.min, 0, 'g', 17).arg(v.max, 0, 'g', 17).arg(v.type);
+    for (const Goal &g : a_goals)
+        setup += QStringLiteral("\n%1|%2|%3").arg(g.name, g.type).arg(g.value, 0, 'g', 17);
+    hash.addData(setup.toUtf8());
+    a_logKey = QString::fromLatin1(hash.result().toHex());
+    return true;
+}
+
+// -----------------------------------------------------------
+// Value of variable "var" at the scaled point x, as simulated.
+double Optimizer::value(int var, const QVector<double> &x) const
+{
+    const Variable &v = a_vars.at(var);
+    int k = a_active.indexOf(var);
+    if (k < 0) return v.value;
+
+    double t = qBound(0.0, x.at(k), 1.0);
+    bool log = v.type.startsWith("LOG") || v.type.startsWith('E');
+    double r = (log && v.min > 0.0) ? v.min * std::pow(v.max / v.min, t)
+                                    : v.min + t * (v.max - v.min);
+    if (v.type.endsWith("_INT")) return std::round(r);
+    if (v.type.startsWith('E')) return nearestESeries(r, v.type.mid(1).toInt());
+    return r;
+}
+
+QString Optimizer::valueText(int var) const
+{
+    return QString::number(a_vars.at(var).value, 'g', 12);
+}
+
+// -----------------------------------------------------------
+double Optimizer::costOf(const QVector<double> &goals) const
+{
+    double cost = 0.0;
+    for (int i = 0; i < a_goals.size(); i++) {
+        const Goal &g = a_goals.at(i);
+        if (g.type == "MON") continue;
+        double v = goals.at(i);
+        if (std::isnan(v)) return FailedCost;
+
+        double scale = g.value != 0.0 ? std::fabs(g.value) : 1.0;
+        if (g.type == "MIN") cost += a_costObjectives * v;
+        else if (g.type == "MAX") cost -= a_costObjectives * v;
+        else if (g.type == "LE" && v > g.value) cost += a_costConstraints * (v - g.value) / scale;
+        else if (g.type == "GE" && v < g.value) cost += a_costConstraints * (g.value - v) / scale;
+        else if (g.type == "EQ") cost += a_costConstraints * std::fabs(v - g.value) / scale;
+    }
+    return cost;
+}
+
+void Optimizer::keepBest(const Point &p)
+{
+    if (a_bestX.isEmpty() || p.cost < a_bestCost) {
+        a_bestCost = p.cost;
+        a_bestX = p.x;
+        a_bestGoals = p.goals;
+    }
+}
+
+// -----------------------------------------------------------
+// Runs the simulation of point p in the work directory of "job", false if
+// the simulator could not be started.
+bool Optimizer::simulate(int job, Point &p)
+{
+    QDir dir(QDir(a_workDir).filePath(QStringLiteral("opt%1").arg(job)));
+    p.goals.fill(std::numeric_limits<double>::quiet_NaN(), a_goals.size());
+    p.cost = FailedCost;
+
+    for (int f = 0; f < a_lines.size(); f++) {
+        QFile file(dir.filePath(a_batch.netlists.at(f)));
+        if (!file.open(QIODevice::WriteOnly)) return true;
+        QTextStream stream(&file);
+        const QStringList &lines = a_lines.at(f);
+        for (int i = 0; i < lines.size(); i++) {
+            stream << lines.at(i);
+            if (a_lineVar.at(f).at(i) >= 0)
+                stream << QString::number(value(a_lineVar.at(f).at(i), p.x), 'g', 12);
+            if (i + 1 < lines.size()) stream << '\n';
+        }
+        file.close();
+    }
+    for (const QString &out : a_batch.outputs)
+        dir.remove(out);
+
+    for (const QString &netlist : a_batch.netlists) {
+        QProcess proc;
+        proc.setWorkingDirectory(dir.absolutePath());
+        proc.setProcessChannelMode(QProcess::MergedChannels);
+        proc.setStandardOutputFile(dir.filePath("spice4qucs.log"));
+        proc.start(a_batch.program, a_batch.arguments + QStringList(netlist));
+        if (!proc.waitForStarted(-1)) return false;
+        proc.closeWriteChannel();
+        while (!proc.waitForFinished(100) && proc.state() != QProcess::NotRunning) {
+            if (a_cancelled) {
+                proc.kill();
+                proc.waitForFinished(-1);
+                return true;
+            }
+        }
+        if (proc.exitStatus() != QProcess::NormalExit) return true;
+    }
+
+    // the goals are scalar equations, the first value of each is taken
+    QStringList outputs = a_batch.outputs;
+    outputs.removeDuplicates();
+    for (const QString &out : outputs) {
+        QString path = dir.filePath(out);
+        if (!QFileInfo::exists(path)) continue;
+        qucsdata::DataSet data;
+        if (!data.open(path.toStdString(), false)) continue;   // not a raw file
+        for (int v = 0; v < data.count(); v++) {
+            QString name = QString::fromStdString(data.variable(v).name);
+            for (int g = 0; g < a_goals.size(); g++) {
+                if (!std::isnan(p.goals.at(g))) continue;
+                if (a_goals.at(g).name.compare(name, Qt::CaseInsensitive) != 0) continue;
+                if (data.decode(v) && data.variable(v).length > 0)
+                    p.goals[g] = data.variable(v).values.front();
+            }
+        }
+    }
+    p.cost = costOf(p.goals);
+    return true;
+}
+
+// -----------------------------------------------------------
+// Simulates the points concurrently, or takes them from the log of an
+// earlier run. False if cancelled or the simulator cannot be run.
+bool Optimizer::evaluate(QVector<Point> &points)
+{
+    QVector<int> todo;
+    for (int i = 0; i < points.size(); i++) {
+        int index = a_evaluations + i;
+        if (index < a_logged.size() && a_logged.at(index).x == points.at(i).x) {
+            points[i].cost = a_logged.at(index).cost;
+            points[i].goals = a_logged.at(index).goals;
+        } else {
+            if (index < a_logged.size()) {
+                // the earlier run went another way from here
+                a_logged.resize(index);
+                QFile::remove(a_logFile);
+                for (const Point &p : std::as_const(a_logged)) appendLog(p);
+            }
+            todo.append(i);
+        }
+    }
+
+    std::atomic<int> next(0);
+    std::atomic<bool> started(true);
+    auto work = [&](int job) {
+        for (int i = next++; i < todo.size() && !a_cancelled; i = next++) {
+            if (!simulate(job, points[todo.at(i)])) {
+                started = false;
+                return;
+            }
+        }
+    };
+    int threads = qMin(a_jobs, int(todo.size()));
+    std::vector<std::thread> pool;
+    for (int j = 1; j < threads; j++) pool.emplace_back(work, j);
+    if (!todo.isEmpty()) work(0);
+    for (std::thread &t : pool) t.join();
+
+    if (!started) {
+        a_error = QObject::tr("Could not start the simulator \"%1\".").arg(a_batch.program);
+        return false;
+    }
+    if (a_cancelled) return false;
+
+    for (int i = 0; i < points.size(); i++) {
+        if (a_evaluations >= a_logged.size()) appendLog(points.at(i));
+        keepBest(points.at(i));
+        a_evaluations++;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------
+// Line per evaluation: cost, scaled variables, ";", goal values.
+void Optimizer::appendLog(const Point &p)
+{
+    QFile file(a_logFile);
+    bool header = !file.exists();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) return;
+    QTextStream stream(&file);
+    if (header) {
+        stream << "# Qucs-S optimizer log " << a_logKey << '\n';
+        stream << "# cost";
+        for (int k : a_active) stream << ' ' << a_vars.at(k).name;
+        stream << " ;";
+        for (const Goal &g : a_goals) stream << ' ' << g.name;
+        stream << '\n';
+    }
+    stream << QString::number(p.cost, 'g', 17);
+    for (double x : p.x) stream << ' ' << QString::number(x, 'g', 17);
+    stream << " ;";
+    for (double g : p.goals) stream << ' ' << QString::number(g, 'g', 17);
+    stream << '\n';
+}
+
+bool Optimizer::readLog()
+{
+    a_logged.clear();
+    QFile file(a_logFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    QTextStream stream(&file);
+    if (stream.readLine() != "# Qucs-S optimizer log " + a_logKey) {
+        file.close();
+        file.remove();   // another schematic or other settings
+        return false;
+    }
+    while (!stream.atEnd()) {
+        QString line = stream.readLine();
+        if (line.startsWith('#')) continue;
+        QStringList parts = line.split(' ', qucs::SkipEmptyParts);
+        int semicolon = parts.indexOf(";");
+        if (semicolon != a_active.size() + 1 || parts.size() != semicolon + 1 + a_goals.size())
+            break;   // cut off when the last run was stopped
+        Point p;
+        p.cost = parts.at(0).toDouble();
+        for (int i = 1; i < semicolon; i++) p.x.append(parts.at(i).toDouble());
+        for (int i = semicolon + 1; i < parts.size(); i++) p.goals.append(parts.at(i).toDouble());
+        a_logged.append(p);
+    }
+    file.close();
+
+    // rewrite complete lines only
+    file.remove();
+    for (const Point &p : std::as_const(a_logged)) appendLog(p);
+    return !a_logged.isEmpty();
+}
+
+// -----------------------------------------------------------
+bool Optimizer::run(const std::function<void(const QString&)> &report)
+{
+    a_cancelled = false;
+    a_error.clear();
+    a_evaluations = 0;
+    a_bestCost = FailedCost;
+    a_bestX.clear();
+    a_bestGoals.clear();
+    a_random.seed(a_seed);
+    if (a_jobs <= 0) a_jobs = qMax(1, int(std::thread::hardware_concurrency()));
+
+    // every job simulates in a directory of its own
+    for (int j = 0; j < a_jobs; j++) {
+        QString path = QDir(a_workDir).filePath(QStringLiteral("opt%1").arg(j));
+        if (!QDir().mkpath(path)) {
+            a_error = QObject::tr("Cannot create the directory %1").arg(path);
+            return false;
+        }
+        for (auto it = a_batch.files.constBegin(); it != a_batch.files.constEnd(); ++it) {
+            if (a_batch.netlists.contains(it.key())) continue;
+            QFile file(QDir(path).filePath(it.key()));
+            if (file.open(QIODevice::WriteOnly)) {
+                file.write(it.value().toUtf8());
+                file.close();
+            }
+        }
+    }
+    if (readLog())
+        report(QObject::tr("Resuming: %1 evaluations are taken from %2")
+               .arg(a_logged.size()).arg(a_logFile));
+
+    // the initial values are the first member of the population
+    QVector<Point> population(a_active.isEmpty() ? 1 : a_NP);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (int i = 0; i < population.size(); i++) {
+        for (int k : a_active) {
+            const Variable &v = a_vars.at(k);
+            double t = uniform(a_random);
+            if (i == 0) {
+                bool log = (v.type.startsWith("LOG") || v.type.startsWith('E')) && v.min > 0.0;
+                t = log ? std::log(v.value / v.min) / std::log(v.max / v.min)
+                        : (v.value - v.min) / (v.max - v.min);
+                if (std::isnan(t)) t = 0.5;
+                t = qBound(0.0, t, 1.0);
+            }
+            population[i].x.append(t);
+        }
+    }
+    report(QObject::tr("Optimizing %1 variables with %2 parallel jobs")
+           .arg(a_active.size()).arg(a_jobs));
+    if (!evaluate(population)) return false;
+
+    if (!a_active.isEmpty()) {
+        if (!differentialEvolution(population, report)) return false;
+        if (!nelderMead(report)) return false;
+    }
+
+    for (int k : a_active) a_vars[k].value = value(k, a_bestX);
+    if (a_bestCost >= FailedCost) {
+        a_error = QObject::tr("No simulation gave all goals. Check that the goals are "
+                              "equations written to the simulation output.");
+        return false;
+    }
+    report(QObject::tr("Optimization finished after %1 evaluations, cost %2")
+           .arg(a_evaluations).arg(a_bestCost));
+
+    // leave the outputs of the best point behind, see resultDir()
+    Point best;
+    best.x = a_bestX;
+    return simulate(0, best) && !a_cancelled;
+}
+
+QString Optimizer::resultDir() const
+{
+    return QDir(a_workDir).filePath("opt0");
+}
+
+// -----------------------------------------------------------
+// The strategies of the optimization dialog (numbered as ASCO does):
+// 1 best/1/exp, 2 rand/1/exp, 3 rand-to-best/1/exp, 4 best/2/exp,
+// 5 rand/2/exp, 6...10 the same with binomial crossover.
+bool Optimizer::differentialEvolution(QVector<Point> &population,
+                                      const std::function<void(const QString&)> &report)
+{
+    const int NP = population.size(), D = a_active.size();
+    const int strategy = (a_method - 1) % 5;
+    const bool binomial = a_method > 5;
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::uniform_int_distribution<int> member(0, NP - 1), dimension(0, D - 1);
+
+    for (int gen = 1; gen <= a_maxIter; gen++) {
+        int best = 0;
+        for (int i = 1; i < NP; i++)
+            if (population.at(i).cost < population.at(best).cost) best = i;
+
+        QVector<Point> trials(NP);
+        for (int i = 0; i < NP; i++) {
+            int r[5];
+            for (int n = 0; n < 5; n++) {
+                do r[n] = member(a_random);
+                while (r[n] == i || std::find(r, r + n, r[n]) != r + n);
+            }
+            auto x = [&](int m, int j) { return population.at(m).x.at(j); };
+            const QVector<double> &parent = population.at(i).x;
+            QVector<double> trial = parent;
+
+            auto mutate = [&](int j) {
+                switch (strategy) {
+                case 0: return x(best, j) + a_F * (x(r[0], j) - x(r[1], j));
+                case 1: return x(r[0], j) + a_F * (x(r[1], j) - x(r[2], j));
+                case 2: return parent.at(j) + a_F * (x(best, j) - parent.at(j))
+                             + a_F * (x(r[0], j) - x(r[1], j));
+                case 3: return x(best, j) + a_F * (x(r[0], j) + x(r[1], j) - x(r[2], j) - x(r[3], j));
+                default: return x(r[4], j) + a_F * (x(r[0], j) + x(r[1], j) - x(r[2], j) - x(r[3], j));
+                }
+            };
+            int j = dimension(a_random);
+            if (binomial) {
+                for (int L = 0; L < D; L++, j = (j + 1) % D)
+                    if (uniform(a_random) < a_CR || L == D - 1) trial[j] = mutate(j);
+            } else {
+                int L = 0;
+                do {
+                    trial[j] = mutate(j);
+                    j = (j + 1) % D;
+                } while (uniform(a_random) < a_CR && ++L < D);
+            }
+            // out of range: halfway between the parent and the bound
+            for (int k = 0; k < D; k++) {
+                if (trial.at(k) < 0.0) trial[k] = parent.at(k) / 2.0;
+                else if (trial.at(k) > 1.0) trial[k] = (parent.at(k) + 1.0) / 2.0;
+            }
+            trials[i].x = trial;
+        }
+
+        if (!evaluate(trials)) return false;
+        for (int i = 0; i < NP; i++)
+            if (trials.at(i).cost <= population.at(i).cost) population[i] = trials.at(i);
+
+        double mean = 0.0, variance = 0.0;
+        for (const Point &p : std::as_const(population)) mean += p.cost / NP;
+        for (const Point &p : std::as_const(population)) variance += (p.cost - mean) * (p.cost - mean) / NP;
+        if (gen % a_refresh == 0 || gen == a_maxIter)
+            report(QObject::tr("Generation %1: best cost %2, cost variance %3")
+                   .arg(gen).arg(a_bestCost).arg(variance));
+        if (a_bestCost < FailedCost && variance < a_minCostVariance) break;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------
+// Nelder-Mead from the best point. The four candidates of a step
+// (reflection, expansion and both contractions) are simulated together.
+bool Optimizer::nelderMead(const std::function<void(const QString&)> &report)
+{
+    const int D = a_active.size();
+    QVector<Point> simplex(D + 1);
+    simplex[0].x = a_bestX;
+    simplex[0].cost = a_bestCost;
+    simplex[0].goals = a_bestGoals;
+    QVector<Point> vertices(D);
+    for (int k = 0; k < D; k++) {
+        vertices[k].x = a_bestX;
+        vertices[k].x[k] += a_bestX.at(k) > 0.9 ? -0.05 : 0.05;
+    }
+    if (!evaluate(vertices)) return false;
+    std::copy(vertices.begin(), vertices.end(), simplex.begin() + 1);
+
+    auto along = [&](const QVector<double> &c, const QVector<double> &w, double t) {
+        QVector<double> x(D);
+        for (int k = 0; k < D; k++) x[k] = qBound(0.0, c.at(k) + t * (c.at(k) - w.at(k)), 1.0);
+        return x;
+    };
+    for (int it = 1; it <= a_maxIter; it++) {
+        std::stable_sort(simplex.begin(), simplex.end(),
+                         [](const Point &a, const Point &b) { return a.cost < b.cost; });
+        double size = 0.0;
+        for (int i = 1; i <= D; i++)
+            for (int k = 0; k < D; k++)
+                size = qMax(size, std::fabs(simplex.at(i).x.at(k) - simplex.at(0).x.at(k)));
+        if (simplex.at(D).cost - simplex.at(0).cost < a_minCostVariance || size < 1e-6)
+            break;
+
+        QVector<double> c(D, 0.0);
+        for (int i = 0; i < D; i++)
+            for (int k = 0; k < D; k++) c[k] += simplex.at(i).x.at(k) / D;
+        const QVector<double> &w = simplex.at(D).x;
+        QVector<Point> step(4);
+        step[0].x = along(c, w, 1.0);    // reflection
+        step[1].x = along(c, w, 2.0);    // expansion
+        step[2].x = along(c, w, 0.5);    // outside contraction
+        step[3].x = along(c, w, -0.5);   // inside contraction
+        if (!evaluate(step)) return false;
+
+        const Point &r = step.at(0);
+        if (r.cost < simplex.at(0).cost)
+            simplex[D] = step.at(1).cost < r.cost ? step.at(1) : r;
+        else if (r.cost < simplex.at(D - 1).cost)
+            simplex[D] = r;
+        else if (r.cost < simplex.at(D).cost && step.at(2).cost <= r.cost)
+            simplex[D] = step.at(2);
+        else if (r.cost >= simplex.at(D).cost && step.at(3).cost < simplex.at(D).cost)
+            simplex[D] = step.at(3);
+        else {   // shrink towards the best vertex
+            QVector<Point> shrunk(D);
+            for (int i = 0; i < D; i++)
+                shrunk[i].x = along(simplex.at(0).x, simplex.at(i + 1).x, -0.5);
+            if (!evaluate(shrunk)) return false;
+            std::copy(shrunk.begin(), shrunk.end(), simplex.begin() + 1);
+        }
+        if (it % a_refresh == 0)
+            report(QObject::tr("Nelder-Mead step %1: best cost %2").arg(it).arg(a_bestCost));
+    }
+    return true;
+}
@@ -0,0 +1,145 @@
+/***************************************************************************
+                                optimizer.h
+                               -------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "abstractspicekernel.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <random>
+
+class Optimize_Sim;
+class Schematic;
+
+/*!
+  \file optimizer.h
+  \brief Declaration of the Optimizer class
+*/
+
+/*!
+ * \brief Optimizes the variables of an optimization component with
+ *        Ngspice or Xyce, without ASCO.
+ *
+ * Differential evolution (the DE strategies of the optimization dialog)
+ * searches the variable ranges, Nelder-Mead refines the best point
+ * afterwards. Every member of a generation, and the trial points of a
+ * Nelder-Mead step, are simulated at the same time: each job runs the
+ * simulator on its own copy of the netlist, with the .PARAM lines (and the
+ * matching "let" lines of Ngspice) of the variables replaced. The goals are
+ * read from the raw files the simulator writes.
+ *
+ * Every evaluation is appended to a log. The search is deterministic for a
+ * given seed, so when it is started again on the same netlist and settings
+ * the logged evaluations are taken instead of simulated, and an interrupted
+ * optimization continues where it stopped.
+ */
+class Optimizer
+{
+public:
+  struct Variable {
+    QString name;
+    bool active;          // optimized, otherwise kept at its value
+    double value, min, max;
+    QString type;         // LIN_DOUBLE, LOG_DOUBLE, LIN_INT, LOG_INT, E3...E192
+  };
+  struct Goal {
+    QString name;
+    QString type;         // MIN, MAX, MON, LE, GE, EQ
+    double value;
+  };
+
+  explicit Optimizer(Optimize_Sim *opt);
+
+  // The optimization component of a schematic, nullptr if there is none.
+  static Optimize_Sim *find(Schematic *sch);
+  // Log of the optimization of a schematic, next to it.
+  static QString logFile(const QString &docName);
+
+  // Prepares the simulation jobs, false (see error()) if the variables
+  // cannot be set in the netlists.
+  bool setBatch(const AbstractSpiceKernel::Batch &batch, const QString &workDir);
+  void setJobs(int jobs) { a_jobs = jobs; }
+  void setLog(const QString &file) { a_logFile = file; }
+
+  // Runs the optimization, progress messages go to "report" (called from
+  // the thread that runs this). Returns false on errors or if cancelled.
+  bool run(const std::function<void(const QString&)> &report);
+  // May be called from any thread.
+  void cancel() { a_cancelled = true; }
+
+  const QString &error() const { return a_error; }
+  // Variables with the best values found, goals at that point.
+  const QVector<Variable> &variables() const { return a_vars; }
+  const QVector<Goal> &goals() const { return a_goals; }
+  const QVector<double> &goalValues() const { return a_bestGoals; }
+  double cost() const { return a_bestCost; }
+  int evaluations() const { return a_evaluations; }
+  // Value of a variable as it is written into the netlist.
+  QString valueText(int var) const;
+  // Work directory with the simulator outputs of the best point, after run().
+  QString resultDir() const;
+
+private:
+  struct Point {
+    QVector<double> x;    // active variables scaled to 0..1
+    double cost;
+    QVector<double> goals;
+  };
+
+  bool evaluate(QVector<Point> &points);
+  bool simulate(int job, Point &p);
+  bool readLog();
+  void appendLog(const Point &p);
+  double value(int var, const QVector<double> &x) const;
+  double costOf(const QVector<double> &goals) const;
+  void keepBest(const Point &p);
+
+  bool differentialEvolution(QVector<Point> &population,
+                             const std::function<void(const QString&)> &report);
+  bool nelderMead(const std::function<void(const QString&)> &report);
+
+  QVector<Variable> a_vars;
+  QVector<int> a_active;              // indices of the optimized variables
+  QVector<Goal> a_goals;
+  int a_method, a_maxIter, a_refresh, a_NP;
+  double a_F, a_CR, a_minCostVariance, a_costObjectives, a_costConstraints;
+  unsigned a_seed;
+  int a_jobs;
+
+  AbstractSpiceKernel::Batch a_batch;
+  QString a_workDir;
+  // netlist lines, the value of variable a_lineVar[file][i] (or -1) is
+  // appended to a_lines[file][i]
+  QVector<QStringList> a_lines;
+  QVector<QVector<int>> a_lineVar;
+
+  QString a_logFile, a_logKey;
+  QVector<Point> a_logged;            // evaluations of an earlier run
+  std::mt19937 a_random;
+
+  QString a_error;
+  std::atomic<bool> a_cancelled;
+  int a_evaluations;
+  double a_bestCost;
+  QVector<double> a_bestX, a_bestGoals;
+};
+
+#endif // OPTIMIZER_H
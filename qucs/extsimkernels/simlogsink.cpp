@@ -0,0 +1,207 @@
+/***************************************************************************
+                              simlogsink.cpp
+                             ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "simlogsink.h"
+#include "spicecompat.h"
+
+/*!
+  \file simlogsink.cpp
+  \brief Implementation of the SimLogSink class
+*/
+
+// A line without terminator is parsed anyway when it gets that long
+static const int MAX_LINE = 64*1024;
+
+/*!
+ * \brief SimLogSink::SimLogSink class constructor
+ * \param max_chars Number of characters of the log tail kept in memory
+ */
+SimLogSink::SimLogSink(int max_chars) :
+    a_spill(),
+    a_tail(),
+    a_pending(),
+    a_partial(),
+    a_maxChars(max_chars),
+    a_truncated(false),
+    a_skippedChars(0),
+    a_errPatterns(),
+    a_warnPatterns(),
+    a_progressPattern(),
+    a_hasErrors(false),
+    a_hasWarnings(false),
+    a_progress(-1)
+{
+}
+
+SimLogSink::~SimLogSink()
+{
+    a_spill.close();
+}
+
+/*!
+ * \brief SimLogSink::begin Start a new log.
+ * \param spill_file File that receives the complete log
+ * \param simulator Simulator (spicecompat::Simulator), selects the
+ *        error, warning and progress patterns
+ */
+void SimLogSink::begin(const QString &spill_file, int simulator)
+{
+    a_spill.close();
+    a_tail.clear();
+    a_pending.clear();
+    a_partial.clear();
+    a_truncated = false;
+    a_skippedChars = 0;
+    a_hasErrors = false;
+    a_hasWarnings = false;
+    a_progress = -1;
+
+    a_errPatterns.clear();
+    a_warnPatterns.clear();
+    switch (simulator) {
+    case spicecompat::simNgspice:
+        a_errPatterns<<"Error:"<<"ERROR"<<"Error "
+                     <<"Syntax error:"<<"Expression err:"
+                     <<"errors:"<<"simulation(s) aborted"
+                     <<"simulation aborted"<<"analysis aborted";
+        a_warnPatterns<<"Warning:"<<"WARNING"<<"Warning "
+                      <<"warning:";
+        a_progressPattern.setPattern("^%(\\d+\\.\\d+)");
+        break;
+    case spicecompat::simXyce:
+        a_errPatterns<<"Error:"<<"ERROR"<<"MSG_ERROR"
+                     <<"error:"<<"MSG_FATAL";
+        a_warnPatterns<<"Warning:"<<"WARNING"<<"Warning "
+                      <<"warning:";
+        a_progressPattern.setPattern("Percent complete:\\s*(\\d+(?:\\.\\d*)?)");
+        break;
+    default:
+        a_errPatterns<<"error";
+        a_warnPatterns<<"warning";
+        a_progressPattern.setPattern(QString());
+        break;
+    }
+
+    a_spill.setFileName(spill_file);
+    if (!spill_file.isEmpty()) {
+        a_spill.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+}
+
+/*!
+ * \brief SimLogSink::append Add simulator output. Only complete lines are
+ *        parsed, the rest waits for the next chunk.
+ * \param text Output chunk
+ */
+void SimLogSink::append(const QString &text)
+{
+    if (text.isEmpty()) return;
+    if (a_spill.isOpen()) a_spill.write(text.toUtf8());
+
+    a_tail += text;
+    if (a_tail.size() > 2*a_maxChars) {
+        trimFront(a_tail, a_maxChars);
+        a_truncated = true;
+    }
+    a_pending += text;
+    if (a_pending.size() > 2*a_maxChars) {
+        int size = a_pending.size();
+        trimFront(a_pending, a_maxChars);
+        a_skippedChars += size - a_pending.size();
+    }
+
+    a_partial += text;
+    int start = 0;
+    for (int i = 0; i < a_partial.size(); i++) {
+        QChar c = a_partial.at(i);
+        if (c == '\n' || c == '\r') {
+            if (i > start) parseLine(a_partial.mid(start, i - start));
+            start = i + 1;
+        }
+    }
+    a_partial.remove(0, start);
+    if (a_partial.size() > MAX_LINE) {
+        parseLine(a_partial);
+        a_partial.clear();
+    }
+}
+
+/*!
+ * \brief SimLogSink::finish Parse the unterminated last line and flush the
+ *        spill file. The log may be continued with append().
+ */
+void SimLogSink::finish()
+{
+    if (!a_partial.isEmpty()) {
+        parseLine(a_partial);
+        a_partial.clear();
+    }
+    if (a_spill.isOpen()) a_spill.flush();
+}
+
+/*!
+ * \brief SimLogSink::takePending
+ * \return Text received since the last call. If the console could not keep
+ *         up, the head of it is replaced by a note.
+ */
+QString SimLogSink::takePending()
+{
+    QString s;
+    if (a_skippedChars > 0) {
+        s = QStringLiteral("[... %1 characters skipped, complete log is in %2 ...]\n")
+                .arg(a_skippedChars).arg(a_spill.fileName());
+        a_skippedChars = 0;
+    }
+    s += a_pending;
+    a_pending.clear();
+    return s;
+}
+
+void SimLogSink::parseLine(const QString &line)
+{
+    if (!a_hasErrors) {
+        for (const QString &pat : a_errPatterns) {
+            if (line.contains(pat)) {
+                a_hasErrors = true;
+                break;
+            }
+        }
+    }
+    if (!a_hasWarnings) {
+        for (const QString &pat : a_warnPatterns) {
+            if (line.contains(pat)) {
+                a_hasWarnings = true;
+                break;
+            }
+        }
+    }
+    if (!a_progressPattern.pattern().isEmpty()) {
+        QRegularExpressionMatch m = a_progressPattern.match(line);
+        if (m.hasMatch()) a_progress = qRound(m.captured(1).toDouble());
+    }
+}
+
+/*!
+ * \brief SimLogSink::trimFront Drop the head of a buffer, cut at a line
+ *        boundary if possible.
+ */
+void SimLogSink::trimFront(QString &buf, int max_chars)
+{
+    int cut = buf.size() - max_chars;
+    int nl = buf.indexOf('\n', cut);
+    if (nl >= 0 && nl < buf.size() - 1) cut = nl + 1;
+    buf.remove(0, cut);
+}
@@ -0,0 +1,80 @@
+/***************************************************************************
+                               simlogsink.h
+                             ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef SIMLOGSINK_H
+#define SIMLOGSINK_H
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+/*!
+  \file simlogsink.h
+  \brief Declaration of the SimLogSink class
+*/
+
+/*!
+ * \brief The SimLogSink class collects simulator output. The complete log
+ *        is written to a spill file as it arrives, only the tail is kept in
+ *        memory. Output is split into lines once and every line is checked
+ *        for progress, warning and error messages, so the log never has to
+ *        be scanned again. Text not yet shown in the console is buffered
+ *        until the next (throttled) console update.
+ */
+class SimLogSink
+{
+
+private:
+    QFile a_spill;
+    QString a_tail;
+    QString a_pending;
+    QString a_partial;
+    int a_maxChars;
+    bool a_truncated;
+    qint64 a_skippedChars;
+
+    QStringList a_errPatterns;
+    QStringList a_warnPatterns;
+    QRegularExpression a_progressPattern;
+    bool a_hasErrors;
+    bool a_hasWarnings;
+    int a_progress;
+
+    void parseLine(const QString &line);
+    static void trimFront(QString &buf, int max_chars);
+
+public:
+    explicit SimLogSink(int max_chars = 1024*1024);
+    ~SimLogSink();
+
+    void begin(const QString &spill_file, int simulator);
+    void append(const QString &text);
+    void finish();
+
+    QString tail() const { return a_tail; }
+    QString takePending();
+    bool hasPending() const { return !a_pending.isEmpty(); }
+    QString spillFile() const { return a_spill.fileName(); }
+    bool isTruncated() const { return a_truncated; }
+
+    bool hasErrors() const { return a_hasErrors; }
+    bool hasWarnings() const { return a_hasWarnings; }
+    int progress() const { return a_progress; }
+    void resetProgress() { a_progress = -1; }
+};
+
+#endif // SIMLOGSINK_H
@@ -0,0 +1,303 @@
+/***************************************************************************
+                             simresultcache.cpp
+                             ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include "simresultcache.h"
+#include "buildcache.h"
+#include "main.h"
+#include "settings.h"
+
+/*!
+  \file simresultcache.cpp
+  \brief Implementation of the SimResultCache class
+*/
+
+// Bump this if the dataset conversion changes, old entries become unreachable.
+static const char *CACHE_FORMAT = "simresultcache-1";
+
+/*!
+ * \brief SimResultCache::SimResultCache class constructor
+ * \param schematic_file Schematic file name. Its directory identifies the
+ *        project and selects the cache directory.
+ */
+SimResultCache::SimResultCache(const QString &schematic_file) :
+    a_dir(),
+    a_maxSize(qint64(_settings::Get().item<int>("SimCacheSizeMB")) * 1024 * 1024)
+{
+    QString project = QFileInfo(schematic_file).absolutePath();
+    QString project_hash = QCryptographicHash::hash(project.toUtf8(),
+                                                    QCryptographicHash::Sha1).toHex();
+    a_dir.setPath(QucsSettings.tempFilesDir.filePath("simcache/" + project_hash));
+}
+
+/*!
+ * \brief SimResultCache::isEnabled
+ * \return True if the result cache is switched on in the settings
+ */
+bool SimResultCache::isEnabled()
+{
+    return _settings::Get().item<bool>("SimResultCache");
+}
+
+/*!
+ * \brief SimResultCache::hashFile Add file contents to hash. Files included
+ *        by .include, .lib, .hdl or pre_osdi lines are hashed recursively.
+ *        Every other existing file a line refers to (PWL and data file
+ *        sources, Touchstone files, files read by .control scripts, ...)
+ *        is hashed as well, without looking into it.
+ * \param hash Hash under construction
+ * \param file File to hash
+ * \param visited Files already hashed, protects from include loops
+ * \param depth Recursion depth
+ */
+void SimResultCache::hashFile(QCryptographicHash &hash, const QString &file,
+                              QSet<QString> &visited, int depth)
+{
+    static const QRegularExpression include_rx(
+        "^\\s*(?:\\.inc(?:lude)?|\\.lib|\\.hdl|pre_osdi)\\s+\"?([^\"\\s]+)\"?",
+        QRegularExpression::CaseInsensitiveOption);
+
+    QFileInfo inf(file);
+    QString path = inf.absoluteFilePath();
+    hash.addData(path.toUtf8());
+    if (visited.contains(path) || depth > 16) return;
+    visited.insert(path);
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) {
+        hash.addData(QByteArrayLiteral("<missing>"));
+        return;
+    }
+    QByteArray content = f.readAll();
+    f.close();
+    hash.addData(content);
+
+    // Binary model files (e.g. OSDI) don't include anything
+    if (path.endsWith(".osdi", Qt::CaseInsensitive)) return;
+
+    QTextStream ts(&content);
+    QString line;
+    QSet<QString> checked; // tokens already looked up in this file
+    while (ts.readLineInto(&line)) {
+        QRegularExpressionMatch m = include_rx.match(line);
+        if (m.hasMatch()) {
+            QString inc = m.captured(1);
+            QFileInfo inc_inf(inc);
+            if (inc_inf.isRelative()) inc_inf.setFile(inf.absoluteDir(), inc);
+            if (inc_inf.isFile()) {
+                hashFile(hash, inc_inf.absoluteFilePath(), visited, depth + 1);
+            }
+            continue;
+        }
+        hashReferences(hash, line, inf.absoluteDir(), visited, checked);
+    }
+}
+
+/*!
+ * \brief SimResultCache::hashReferences Add the contents of all existing
+ *        files named on a netlist line to hash
+ * \param hash Hash under construction
+ * \param line Netlist line
+ * \param dir Directory relative file names are resolved against
+ * \param visited Files already hashed
+ * \param checked Tokens already looked up, saves repeated file system access
+ */
+void SimResultCache::hashReferences(QCryptographicHash &hash, const QString &line,
+                                    const QDir &dir, QSet<QString> &visited,
+                                    QSet<QString> &checked)
+{
+    // quoted strings and words separated by blanks, '=', ',' or brackets
+    static const QRegularExpression token_rx(
+        "\"([^\"]+)\"|'([^']+)'|([^\\s=,()\\[\\]{}\"']+)");
+
+    if (line.trimmed().startsWith('*')) return; // comment
+
+    QRegularExpressionMatchIterator it = token_rx.globalMatch(line);
+    while (it.hasNext()) {
+        QRegularExpressionMatch m = it.next();
+        QString token = m.captured(1);
+        if (token.isEmpty()) token = m.captured(2);
+        if (token.isEmpty()) token = m.captured(3);
+
+        // file names have an extension or a directory, numbers don't count
+        if (!token.contains('.') && !token.contains('/') && !token.contains('\\'))
+            continue;
+        QChar first = token.at(0);
+        if (first.isDigit() || first == '-' || first == '+' ||
+            (first == '.' && token.size() > 1 && token.at(1).isLetter()))
+            continue; // value or dot command
+        if (checked.contains(token)) continue;
+        checked.insert(token);
+
+        QFileInfo ref(token);
+        if (ref.isRelative()) ref.setFile(dir, token);
+        if (!ref.isFile()) continue;
+
+        QString path = ref.absoluteFilePath();
+        if (visited.contains(path)) continue;
+        visited.insert(path);
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) continue;
+        hash.addData(path.toUtf8());
+        hash.addData(&f);
+    }
+}
+
+/*!
+ * \brief SimResultCache::computeKey Content hash of a simulation
+ * \param netlists Netlist files passed to the simulator
+ * \param extra_files Other files read by the simulator (e.g. .spiceinit)
+ * \param simulator_cmd Simulator executable
+ * \param parameters Simulator command line parameters
+ * \param outputs Files written by the simulator, relative to the netlists.
+ *        They are named in the netlists but are not part of the key.
+ * \return Hexadecimal key
+ */
+QString SimResultCache::computeKey(const QStringList &netlists, const QStringList &extra_files,
+                                   const QString &simulator_cmd, const QString &parameters,
+                                   const QStringList &outputs) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(QByteArray(CACHE_FORMAT));
+    hash.addData(QByteArray(PACKAGE_VERSION));
+    BuildCache::hashExecutable(hash, simulator_cmd);
+    hash.addData(parameters.toUtf8());
+
+    QSet<QString> visited;
+    for (const QString &netlist : netlists) {
+        QDir dir = QFileInfo(netlist).absoluteDir();
+        for (const QString &output : outputs) {
+            visited.insert(QFileInfo(dir, output).absoluteFilePath());
+        }
+    }
+    for (const QString &netlist : netlists) {
+        hashFile(hash, netlist, visited, 0);
+    }
+    for (const QString &file : extra_files) {
+        if (QFileInfo::exists(file)) hashFile(hash, file, visited, 0);
+    }
+    return hash.result().toHex();
+}
+
+QString SimResultCache::entryPath(const QString &key, const QString &suffix) const
+{
+    return a_dir.filePath(key + suffix);
+}
+
+/*!
+ * \brief SimResultCache::contains
+ * \param key Key returned by computeKey()
+ * \return True if a dataset is stored under the key
+ */
+bool SimResultCache::contains(const QString &key) const
+{
+    return !key.isEmpty() && QFileInfo::exists(entryPath(key, ".dat"));
+}
+
+/*!
+ * \brief SimResultCache::log
+ * \param key Key returned by computeKey()
+ * \return Simulator log of the cached run
+ */
+QString SimResultCache::log(const QString &key) const
+{
+    QFile log_file(entryPath(key, ".log"));
+    if (!log_file.open(QIODevice::ReadOnly)) return QString();
+    return QString::fromUtf8(log_file.readAll());
+}
+
+/*!
+ * \brief SimResultCache::restore Copy cached dataset to its destination
+ * \param key Key returned by computeKey()
+ * \param dataset Destination dataset file
+ * \return True on success
+ */
+bool SimResultCache::restore(const QString &key, const QString &dataset)
+{
+    if (!contains(key)) return false;
+
+    QString cached = entryPath(key, ".dat");
+    if (QFile::exists(dataset)) QFile::remove(dataset);
+    if (!QFile::copy(cached, dataset)) return false;
+
+    // Mark entry as recently used for eviction
+    QFile entry(cached);
+    if (entry.open(QIODevice::ReadWrite)) {
+        entry.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        entry.close();
+    }
+    return true;
+}
+
+/*!
+ * \brief SimResultCache::store Put converted dataset in the cache
+ * \param key Key returned by computeKey()
+ * \param dataset Dataset file produced by the simulation
+ * \param log Simulator log
+ */
+void SimResultCache::store(const QString &key, const QString &dataset, const QString &log)
+{
+    if (key.isEmpty() || !QFileInfo::exists(dataset)) return;
+    if (QFileInfo(dataset).size() > a_maxSize) return; // would evict everything
+    if (!a_dir.exists()) a_dir.mkpath(".");
+
+    // Copy to a temporary name first, a reader never sees a partial entry
+    QString cached = entryPath(key, ".dat");
+    QString tmp = entryPath(key, ".tmp");
+    QFile::remove(tmp);
+    if (!QFile::copy(dataset, tmp)) return;
+
+    QFile log_file(entryPath(key, ".log"));
+    if (log_file.open(QIODevice::WriteOnly)) {
+        log_file.write(log.toUtf8());
+        log_file.close();
+    }
+
+    QFile::remove(cached);
+    QFile::rename(tmp, cached);
+    evict();
+}
+
+/*!
+ * \brief SimResultCache::evict Remove least recently used entries until
+ *        the cache fits into its size limit.
+ */
+void SimResultCache::evict()
+{
+    QFileInfoList entries = a_dir.entryInfoList(QStringList("*.dat"), QDir::Files, QDir::Time);
+    qint64 total = 0;
+    for (const QFileInfo &inf : entries) {
+        total += inf.size();
+    }
+    // Newest first, so remove from the end of the list
+    while (total > a_maxSize && !entries.isEmpty()) {
+        QFileInfo oldest = entries.takeLast();
+        total -= oldest.size();
+        QFile::remove(oldest.absoluteFilePath());
+        QFile::remove(a_dir.filePath(oldest.completeBaseName() + ".log"));
+    }
+}
+
+/*!
+ * \brief SimResultCache::clear Remove all entries of this project
+ */
+void SimResultCache::clear()
+{
+    a_dir.removeRecursively();
+}
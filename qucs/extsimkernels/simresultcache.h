@@ -0,0 +1,68 @@
+/***************************************************************************
+                              simresultcache.h
+                             ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef SIMRESULTCACHE_H
+#define SIMRESULTCACHE_H
+
+#include <QtCore>
+
+/*!
+  \file simresultcache.h
+  \brief Declaration of the SimResultCache class
+*/
+
+/*!
+ * \brief The SimResultCache class stores converted Qucs datasets on disk
+ *        under a content hash of everything the simulator reads: the
+ *        netlist(s), all included model and library files, every other
+ *        file the netlists refer to (data files, PWL sources), the simulator
+ *        command line and the simulator executable. A repeated simulation
+ *        of an unchanged schematic restores the dataset instead of
+ *        spawning the simulator. Each project has its own cache directory
+ *        limited to a maximum size, the least recently used entries are
+ *        evicted first.
+ */
+class SimResultCache
+{
+
+private:
+    QDir a_dir;
+    qint64 a_maxSize;
+
+    static void hashFile(QCryptographicHash &hash, const QString &file,
+                         QSet<QString> &visited, int depth);
+    static void hashReferences(QCryptographicHash &hash, const QString &line,
+                               const QDir &dir, QSet<QString> &visited,
+                               QSet<QString> &checked);
+    QString entryPath(const QString &key, const QString &suffix) const;
+    void evict();
+
+public:
+    explicit SimResultCache(const QString &schematic_file);
+
+    static bool isEnabled();
+
+    QString computeKey(const QStringList &netlists, const QStringList &extra_files,
+                       const QString &simulator_cmd, const QString &parameters,
+                       const QStringList &outputs = QStringList()) const;
+    bool contains(const QString &key) const;
+    QString log(const QString &key) const;
+    bool restore(const QString &key, const QString &dataset);
+    void store(const QString &key, const QString &dataset, const QString &log);
+    void clear();
+};
+
+#endif // SIMRESULTCACHE_H
@@ -36,6 +36,7 @@ SimSettingsDialog::SimSettingsDialog(QWidget *parent) :
     a_lblSimParam(new QLabel(tr("Extra simulator parameters"))),
     a_lblCompatMode(new QLabel(tr("Ngspice compatibility mode"))),
     a_cbxCompatMode(new QComboBox),
+    a_chkHdlBuild(new QCheckBox(tr("Analyse only the changed design units"))),
     //a_cbxSimulator(new QComboBox(this)),
     a_edtNgspice(new QLineEdit(QucsSettings.NgspiceExecutable)),
     a_edtSpiceOpus(new QLineEdit(QucsSettings.SpiceOpusExecutable)),
@@ -83,6 +84,10 @@ SimSettingsDialog::SimSettingsDialog(QWidget *parent) :
     a_cbxCompatMode->addItems(lst_modes);
     auto compat_mode = _settings::Get().item<int>("NgspiceCompatMode");
     a_cbxCompatMode->setCurrentIndex(compat_mode);
+    a_chkHdlBuild->setChecked(_settings::Get().item<bool>("HdlIncrementalBuild"));
+    a_chkHdlBuild->setToolTip(tr("Otherwise the qucs_run_hdl and qucs_run_verilog scripts "
+                                 "analyse the whole netlist on every simulation. They are "
+                                 "also used if the incremental build fails."));
 
     QVBoxLayout *top = new QVBoxLayout;
 
@@ -149,6 +154,14 @@ SimSettingsDialog::SimSettingsDialog(QWidget *parent) :
 
     top->addWidget(gbp2);
 
+    QGroupBox *gbp3 = new QGroupBox;
+    gbp3->setTitle(tr("Digital simulation (GHDL, Icarus Verilog)"));
+    QVBoxLayout *top4 = new QVBoxLayout;
+    top4->addWidget(a_chkHdlBuild);
+    gbp3->setLayout(top4);
+
+    top->addWidget(gbp3);
+
     QHBoxLayout *h3 = new QHBoxLayout;
     h3->addWidget(a_btnOK);
     h3->addWidget(a_btnCancel);
@@ -187,6 +200,7 @@ void SimSettingsDialog::slotApply()
 //    QucsSettings.DefaultSimulator = a_cbxSimulator->currentIndex();
     settingsManager& qs = _settings::Get();
     qs.setItem<int>("NgspiceCompatMode", a_cbxCompatMode->currentIndex());
+    qs.setItem<bool>("HdlIncrementalBuild", a_chkHdlBuild->isChecked());
     accept();
     saveApplSettings();
   }
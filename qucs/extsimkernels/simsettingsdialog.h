@@ -38,6 +38,7 @@ private:
     QLabel *a_lblCompatMode;
 
     QComboBox *a_cbxCompatMode;
+    QCheckBox *a_chkHdlBuild;
     //QComboBox *a_cbxSimulator;
 
     QLineEdit *a_edtNgspice;
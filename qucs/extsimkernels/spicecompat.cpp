@@ -4,6 +4,9 @@
 
 #include <QDebug>
 #include <QRegularExpression>
+#include <QVarLengthArray>
+
+#include <cstring>
 
 /*!
  * \brief spicecompat::check_refdes If starting letters of the component name
@@ -22,29 +25,45 @@ QString spicecompat::check_refdes(QString &Name,QString &SpiceModel)
     }
 }
 
+// Units removed from component values, tried in this order.
+struct ValueUnit {
+    const char *unit;
+    bool signs;     // may be preceded by '+' and '-'
+    bool meg;       // 'M' becomes "Meg"
+};
+static const ValueUnit ValueUnits[] = {
+    { "Ohm", false, true }, { "F", false, true }, { "H", false, true },
+    { "V", false, true },   { "A", false, true }, { "Hz", false, true },
+    { "S", false, true },   { "s", false, true }, { "dBm", true, false },
+};
+
+static inline bool endsWithUnit(const QChar *s, int n, const char *unit, int len)
+{
+    if (n < len) return false;
+    for (int i = 0; i < len; i++)
+        if (s[n-len+i] != QLatin1Char(unit[i])) return false;
+    return true;
+}
+
 /*!
- * \brief spicecompat::normalize_value Remove units from component values and
- *        replace Spice-incompatible factors (i.e M, Meg). Wrap value in braces
- *        if it contains variables.
- * \param[in] Value Qucs-style component value
- * \return Spice-style component value
+ * \brief normalize_value_generic Regular expression version of
+ *        spicecompat::normalize_value(), for values with non-ASCII or
+ *        control characters.
  */
-QString spicecompat::normalize_value(QString Value)
+static QString normalize_value_generic(QString Value)
 {
-    const QRegularExpression r_pattern("^[0-9]+.*Ohm$");
-    const QRegularExpression p_pattern("^[+-]*[0-9]+.*dBm$");
-    const QRegularExpression c_pattern("^[0-9]+.*F$");
-    const QRegularExpression l_pattern("^[0-9]+.*H$");
-    const QRegularExpression v_pattern("^[0-9]+.*V$");
-    const QRegularExpression i_pattern("^[0-9]+.*A$");
-    const QRegularExpression hz_pattern("^[0-9]+.*Hz$");
-    const QRegularExpression s_pattern("^[0-9]+.*S$");
-    const QRegularExpression sec_pattern("^[0-9]+.*s$");
-    const QRegularExpression var_pattern("^[A-Za-z].*$");
-
-    QString s = Value.remove(' ');
-    if (s.startsWith('\'')&&s.endsWith('\'')) return Value; // Expression detected
+    static const QRegularExpression r_pattern("^[0-9]+.*Ohm$");
+    static const QRegularExpression p_pattern("^[+-]*[0-9]+.*dBm$");
+    static const QRegularExpression c_pattern("^[0-9]+.*F$");
+    static const QRegularExpression l_pattern("^[0-9]+.*H$");
+    static const QRegularExpression v_pattern("^[0-9]+.*V$");
+    static const QRegularExpression i_pattern("^[0-9]+.*A$");
+    static const QRegularExpression hz_pattern("^[0-9]+.*Hz$");
+    static const QRegularExpression s_pattern("^[0-9]+.*S$");
+    static const QRegularExpression sec_pattern("^[0-9]+.*s$");
+    static const QRegularExpression var_pattern("^[A-Za-z].*$");
 
+    QString s = Value;
     if (r_pattern.match(s).hasMatch()) { // Component value
         s.remove("Ohm");
         s.replace("M","Meg");
@@ -78,6 +97,140 @@ QString spicecompat::normalize_value(QString Value)
     return s.toUpper();
 }
 
+/*!
+ * \brief spicecompat::normalize_value Remove units from component values and
+ *        replace Spice-incompatible factors (i.e M, Meg). Wrap value in braces
+ *        if it contains variables.
+ *
+ * A value starting with a digit (after signs for dBm) and ending with one
+ * of the units in ValueUnits loses every occurrence of the unit. The value
+ * is scanned once into a buffer on the stack.
+ * \param[in] Value Qucs-style component value
+ * \return Spice-style component value
+ */
+QString spicecompat::normalize_value(QString Value)
+{
+    Value.remove(' ');
+    if (Value.startsWith('\'')&&Value.endsWith('\'')) return Value; // Expression detected
+
+    const QChar *s = Value.constData();
+    const int n = Value.size();
+    for (int i = 0; i < n; i++)
+        if (s[i].unicode() < 0x20 || s[i].unicode() >= 0x7f)
+            return normalize_value_generic(Value);
+
+    auto isDigit = [](QChar c) { return c >= QLatin1Char('0') && c <= QLatin1Char('9'); };
+    int digit = 0;   // position of the first digit
+    while (digit < n && (s[digit] == QLatin1Char('+') || s[digit] == QLatin1Char('-')))
+        digit++;
+
+    const ValueUnit *unit = nullptr;
+    int unitLen = 0;
+    for (const ValueUnit &u : ValueUnits) {
+        int first = u.signs ? digit : 0;
+        if (first >= n || !isDigit(s[first]))
+            continue;
+        int len = int(strlen(u.unit));
+        if (endsWithUnit(s, n, u.unit, len)) {
+            unit = &u;
+            unitLen = len;
+            break;
+        }
+    }
+    bool variable = !unit && n > 0 &&
+        ((s[0] >= QLatin1Char('A') && s[0] <= QLatin1Char('Z')) ||
+         (s[0] >= QLatin1Char('a') && s[0] <= QLatin1Char('z')));
+
+    QVarLengthArray<QChar, 128> out;
+    if (variable) out.append(QLatin1Char('{'));
+    bool changed = variable;
+    for (int i = 0; i < n; i++) {
+        if (unit && i + unitLen <= n && endsWithUnit(s, i + unitLen, unit->unit, unitLen)) {
+            i += unitLen - 1;   // unit dropped
+            changed = true;
+            continue;
+        }
+        QChar c = s[i];
+        if (unit && unit->meg && c == QLatin1Char('M')) {
+            out.append(QLatin1Char('M'));
+            out.append(QLatin1Char('E'));
+            out.append(QLatin1Char('G'));
+            changed = true;
+            continue;
+        }
+        if (c >= QLatin1Char('a') && c <= QLatin1Char('z')) {
+            c = QChar(c.unicode() - 'a' + 'A');
+            changed = true;
+        }
+        out.append(c);
+    }
+    if (variable) out.append(QLatin1Char('}'));
+
+    if (!changed) return Value;   // shares the data, nothing allocated
+    return QString(out.constData(), out.size());
+}
+
+/*!
+ * \brief spicecompat::check_normalize_value Compare normalize_value() with
+ *        its regular expression version on a generated corpus: numbers with
+ *        signs, exponents and scale suffixes followed by units, variables,
+ *        expressions, non-ASCII and malformed values, and pseudo-random
+ *        strings over the same characters.
+ * \param[out] failures The values both disagree on, with both results
+ * \return Number of values compared
+ */
+int spicecompat::check_normalize_value(QStringList &failures)
+{
+    static const char *numbers[] = {
+        "", "0", "1", "10", "1.5", "2.", ".5", "1e3", "1E-3", "12e+2",
+        "+1", "-1", "+-3", "--2", "1k5", "3M3", "1 0" };
+    static const char *scales[] = {
+        "", "f", "p", "n", "u", "m", "M", "Meg", "MEG", "k", "K", "G", "T", "mil" };
+    static const char *units[] = {
+        "", "Ohm", "F", "H", "V", "A", "Hz", "S", "s", "dBm", "Ohms", "ohm",
+        "mOhm", "OhmOhm", "FF", "Hzs", "dB", "m", " Ohm" };
+    static const char *others[] = {
+        "R1", "x", "{a}", "a+b", "_v", "'1+2'", "'", "''", "'a", "M", "MOhm",
+        "Ohm", "dBm", "-dBm", "1.5e", "e3", "1..2", "1e3e3", "(1)", "1k*x" };
+    static const char16_t *unicode[] = {
+        u"1µF", u"10kΩ", u"µ", u"Ω", u"1 µHz", u"1\tV",
+        u"1\nOhm", u"é", u"2 A", u"1Möhm", u"-3 dBm" };
+
+    QStringList corpus;
+    for (const char *n : numbers)
+        for (const char *sc : scales)
+            for (const char *u : units)
+                corpus.append(QString::fromLatin1(n) + sc + u);
+    for (const char *o : others) corpus.append(QString::fromLatin1(o));
+    for (const char16_t *u : unicode) corpus.append(QString::fromUtf16(u));
+
+    // fixed seed, the corpus is the same on every run
+    static const QString alphabet = QString::fromUtf16(
+        u"0123456789.+-eEkmMuUnpfGTOhHFVASzdBs '{}x_\tµΩ");
+    quint32 seed = 12345;
+    for (int k = 0; k < 20000; k++) {
+        seed = seed * 1103515245u + 12345u;
+        QString v;
+        for (int len = (seed >> 16) % 10; len > 0; len--) {
+            seed = seed * 1103515245u + 12345u;
+            v += alphabet.at((seed >> 16) % alphabet.size());
+        }
+        corpus.append(v);
+    }
+
+    for (const QString &value : corpus) {
+        QString expected = value;
+        expected.remove(' ');
+        if (!(expected.startsWith('\'') && expected.endsWith('\'')))
+            expected = normalize_value_generic(expected);
+        QString result = normalize_value(value);
+        if (result != expected)
+            failures.append(QStringLiteral("\"%1\": \"%2\", expected \"%3\"")
+                            .arg(value, result, expected));
+    }
+    return corpus.size();
+}
+
 /*!
  * \brief spicecompat::convert_functions Convert Qucs mathematical function name
  *        to Spice mathematical function name.
@@ -12,6 +12,7 @@
 namespace spicecompat {
      QString check_refdes(QString &Name, QString &Model);
      QString normalize_value(QString Value);
+     int check_normalize_value(QStringList &failures);
      QString convert_function(QString tok, bool isXyce);
      void convert_functions(QStringList &tokens, bool isXyce);
      void splitEqn(QString &eqn, QStringList &tokens);
@@ -283,30 +283,31 @@ void Xyce::createNetlist(QTextStream &stream, int , QStringList &simulations,
  */
 void Xyce::slotSimulate()
 {
+    startProgress();
+    startLog();
 
     QStringList incompat;
     bool checker_error = false;
     if (!checkSchematic(incompat)) {
         QString s = incompat.join("; ");
-        a_output.append("There were SPICE-incompatible components. Simulator cannot proceed.");
-        a_output.append("Incompatible components are: " + s + "\n");
+        a_log.append("There were SPICE-incompatible components. Simulator cannot proceed.");
+        a_log.append("Incompatible components are: " + s + "\n");
         checker_error = true;
     }
 
     if (!checkGround()) {
-        a_output.append("No Ground found. Please add at least one ground!\n");
+        a_log.append("No Ground found. Please add at least one ground!\n");
         checker_error = true;
     }
 
     if (!checkDCSimulation()) {
-        a_output.append("Only DC simulation found in the schematic. It has no effect!"
-                      " Add TRAN, AC, or Sweep simulation to proceed.\n");
+        a_log.append("Only DC simulation found in the schematic. It has no effect!"
+                   " Add TRAN, AC, or Sweep simulation to proceed.\n");
         checker_error = true;
     }
 
     if (checker_error) {
-        if (a_console != nullptr)
-            a_console->insertPlainText(a_output);
+        finishLog();
         //emit finished();
         emit errors(QProcess::FailedToStart);
         return;
@@ -337,8 +338,15 @@ void Xyce::slotSimulate()
         }
     }
 
-    a_output.clear();
+    setPhase(PhaseNetlist, 100);
+    a_runCount = qMax(int(a_netlistQueue.count()), 1);
+
+    if (restoreFromCache(a_netlistQueue, QStringList())) {
+        a_netlistQueue.clear();
+        return;
+    }
     emit started();
+    setPhase(PhaseSimulate, 0);
     nextSimulation();
 
 }
@@ -360,26 +368,72 @@ void Xyce::SaveNetlist(QString filename)
     }
 }
 
+/*!
+ * \brief Xyce::createBatch Describe the simulation as one netlist per
+ *        analysis, like slotSimulate() runs it.
+ * \param[out] batch Netlists, output files and simulator command
+ * \return False if there is nothing to simulate
+ */
+bool Xyce::createBatch(Batch &batch)
+{
+    int num = 0;
+    a_simulationsQueue.clear();
+    a_output_files.clear();
+    if (a_DC_OP_only) {
+        a_simulationsQueue.append("dc");
+    } else  determineUsedSimulations();
+
+    batch.files.clear();
+    batch.netlists.clear();
+    for (const QString& sim : a_simulationsQueue) {
+        QStringList sim_lst(sim);
+        QString netlist;
+        QTextStream stream(&netlist);
+        createNetlist(stream,num,sim_lst,a_vars,a_output_files);
+        stream.flush();
+        QString name = "spice4qucs."+sim+".cir";
+        batch.files.insert(name, netlist);
+        batch.netlists.append(name);
+    }
+    a_simulationsQueue.clear();
+    if (batch.netlists.isEmpty()) return false;
+    batch.outputs = a_output_files;
+
+    QString cmd = QStringLiteral("%1 %2").arg(a_simulator_cmd,a_simulator_parameters);
+    batch.arguments = misc::parseCmdArgs(cmd);
+    batch.program = batch.arguments.takeFirst();
+    return true;
+}
+
 /*!
  * \brief Xyce::slotFinished Simulator finished handler. End simulation or
  *        execute the next simulation from queue.
  */
 void Xyce::slotFinished()
 {
-    a_output += a_simProcess->readAllStandardOutput();;
+    appendOutput(a_simProcess->readAllStandardOutput());
+    a_runsDone++;
+    a_log.resetProgress();
+    if (a_cancelled) a_netlistQueue.clear();
 
     if (a_Noisesim) {
-        QFile logfile(a_workdir + QDir::separator() + "spice4qucs.noise_log");
-        if (logfile.open(QIODevice::WriteOnly)) {
-            QTextStream ts(&logfile);
-            ts<<a_output;
-            logfile.close();
+        a_log.finish();
+        QString noise_log = a_workdir + QDir::separator() + "spice4qucs.noise_log";
+        QFile::remove(noise_log);
+        if (!QFile::copy(a_log.spillFile(), noise_log)) {
+            QFile logfile(noise_log);
+            if (logfile.open(QIODevice::WriteOnly)) {
+                QTextStream ts(&logfile);
+                ts<<a_log.tail();
+                logfile.close();
+            }
         }
         a_Noisesim = false;
         a_output_files.append("spice4qucs.noise_log");
     }
 
     if (a_netlistQueue.isEmpty()) {
+        finishLog();
         emit finished();
         emit progress(100);
         return;
@@ -390,6 +444,7 @@ void Xyce::slotFinished()
 
 bool Xyce::waitEndOfSimulation()
 {
+    if (a_cacheHit) return true;
     bool ok = false;
     while (!a_netlistQueue.isEmpty()) {
         ok = a_simProcess->waitForFinished(10000);
@@ -398,24 +453,6 @@ bool Xyce::waitEndOfSimulation()
     return ok;
 }
 
-/*!
- * \brief Xyce::slotProcessOutput Process Xyce output and report progress.
- */
-void Xyce::slotProcessOutput()
-{
-    //***** Percent complete: 85.4987 %
-    QString s = a_simProcess->readAllStandardOutput();
-    if (s.contains("Percent complete:")) {
-        int percent = round(s.section(' ',3,3,QString::SectionSkipEmpty).toFloat());
-        emit progress(percent);
-    }
-    a_output += s;
-    if (a_console != nullptr) {
-        a_console->insertPlainText(s);
-        a_console->moveCursor(QTextCursor::End);
-    }
-}
-
 /*!
  * \brief Xyce::nextSimulation Execute the next simulation from queue.
  */
@@ -431,10 +468,11 @@ void Xyce::nextSimulation()
         cmd_args.removeAt(0);
         a_simProcess->start(xyce_cmd,cmd_args);
     } else {
-        a_output += "No simulation found. Please add at least one simulation!\n"
+        a_log.append("No simulation found. Please add at least one simulation!\n"
                   "Navigate to the \"simulations\" group in the components panel (left)"
                   " and drag simulation to the schematic sheet. Then define its parameters.\n"
-                  "Exiting...\n";
+                  "Exiting...\n");
+        finishLog();
         emit progress(100);
         emit finished(); // nothing to simulate
     }
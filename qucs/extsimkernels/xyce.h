@@ -49,6 +49,7 @@ public:
     explicit Xyce(Schematic *schematic, QObject *parent = 0);
 
     void SaveNetlist(QString filename);
+    bool createBatch(Batch &batch);
     void setParallel(bool par);
     bool waitEndOfSimulation();
 
@@ -57,7 +58,6 @@ protected:
                   QStringList &vars, QStringList &outputs);
 protected slots:
     void slotFinished();
-    void slotProcessOutput();
 
 public slots:
     void slotSimulate();
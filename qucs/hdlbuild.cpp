@@ -0,0 +1,534 @@
+/***************************************************************************
+                               hdlbuild.cpp
+                              --------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "hdlbuild.h"
+#include "buildcache.h"
+#include "main.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QObject>
+#include <QProcess>
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/*!
+ * \file hdlbuild.cpp
+ * \brief Implementation of the HdlBuild class
+ */
+
+namespace {
+
+enum SegmentKind { Context, Primary, Secondary };
+
+struct Segment {
+  int start;
+  SegmentKind kind;
+  QString name;           // unit declared (primary) or completed (secondary)
+};
+
+// Copy of VHDL text with comments and string literals blanked out, the
+// positions stay the same.
+QString stripVhdl(const QString &text)
+{
+  QString s = text;
+  int n = s.size();
+  for (int i = 0; i < n; i++) {
+    if (s.at(i) == '-' && i + 1 < n && s.at(i+1) == '-') {
+      while (i < n && s.at(i) != '\n') s[i++] = ' ';
+    } else if (s.at(i) == '\'' && i + 2 < n && s.at(i+2) == '\'') {
+      s[i+1] = ' ';       // character literal, could be '"'
+      i += 2;
+    } else if (s.at(i) == '"') {
+      int j = i + 1;
+      while (j < n && s.at(j) != '"' && s.at(j) != '\n') j++;
+      if (j < n && s.at(j) == '"') {
+        for (int k = i + 1; k < j; k++) s[k] = ' ';
+        i = j;
+      }
+    }
+  }
+  return s;
+}
+
+// true if the text holds nothing but library, use and context clauses
+bool onlyContext(const QString &stripped)
+{
+  static const QRegularExpression context_rx("^(library|use|context)\\b",
+                                             QRegularExpression::CaseInsensitiveOption);
+  const QStringList clauses = stripped.split(';');
+  for (int i = 0; i < clauses.size(); i++) {
+    QString c = clauses.at(i).trimmed();
+    if (c.isEmpty()) continue;
+    if (i == clauses.size() - 1 || !context_rx.match(c).hasMatch()) return false;
+  }
+  return true;
+}
+
+QString libraryName(const QString &unit)
+{
+  return "q_" + unit;
+}
+
+bool readKey(const QString &file, QString &key)
+{
+  QFile f(file);
+  if (!f.open(QIODevice::ReadOnly)) return false;
+  key = QString::fromLatin1(f.readAll()).trimmed();
+  return true;
+}
+
+bool writeText(const QString &file, const QString &text)
+{
+  QFile f(file);
+  if (!f.open(QIODevice::WriteOnly)) return false;
+  QByteArray data = text.toUtf8();
+  return f.write(data) == data.size();
+}
+
+} // namespace
+
+/*!
+ * \brief HdlBuild::HdlBuild class constructor
+ * \param lang Language of the netlists
+ * \param dir Build directory, kept between builds
+ * \param cacheTool Name of the BuildCache, empty for the default
+ */
+HdlBuild::HdlBuild(Language lang, const QString &dir, const QString &cacheTool) :
+  a_lang(lang),
+  a_dir(dir),
+  a_cacheTool(cacheTool),
+  a_jobs(0),
+  a_cancelled(false),
+  a_analysed(0),
+  a_restored(0),
+  a_upToDate(0)
+{
+  if (a_cacheTool.isEmpty()) a_cacheTool = (lang == VHDL) ? "ghdl" : "iverilog";
+  a_tool = (lang == VHDL) ? "ghdl" : "iverilog";
+}
+
+/*!
+ * \brief HdlBuild::splitVhdl Split a VHDL netlist into design units.
+ *
+ * A unit starts with the context clauses of its entity, package or
+ * configuration declaration and takes the architectures or the package
+ * body (with their context clauses) of the declaration. References to
+ * other units are found in entity and component instantiations, component
+ * declarations and "work." names; a library and use clause for every
+ * referenced unit is put in front of the unit, on its first line so that
+ * line numbers in messages stay the same.
+ *
+ * If there is no declaration, a name is declared twice or the references
+ * form a loop, the whole netlist is returned as one unit "digi".
+ * \param netlist VHDL netlist
+ * \return Units, each after the units it depends on
+ */
+QVector<HdlBuild::Unit> HdlBuild::splitVhdl(const QString &netlist)
+{
+  static const QRegularExpression unit_rx(
+    "^[ \\t]*(?:(library|use|context)\\b|"
+    "entity\\s+(\\w+)\\s+is\\b|"
+    "architecture\\s+\\w+\\s+of\\s+(\\w+)\\s+is\\b|"
+    "package\\s+body\\s+(\\w+)\\s+is\\b|"
+    "package\\s+(\\w+)\\s+is\\b|"
+    "configuration\\s+(\\w+)\\s+of\\s+\\w+\\s+is\\b)",
+    QRegularExpression::CaseInsensitiveOption | QRegularExpression::MultilineOption);
+  static const QRegularExpression ref_rx(
+    "\\bentity\\s+(?:work\\s*\\.\\s*)?(\\w+)|"
+    "\\bwork\\s*\\.\\s*(\\w+)|"
+    "\\bcomponent\\s+(\\w+)|"
+    ":\\s*(?:component\\s+)?(\\w+)\\s+(?:generic|port)\\s+map\\b|"
+    "\\bconfiguration\\s+(?:work\\s*\\.\\s*)?(\\w+)",
+    QRegularExpression::CaseInsensitiveOption);
+  static const QRegularExpression work_rx("\\bwork(\\s*\\.\\s*)(\\w+)",
+                                          QRegularExpression::CaseInsensitiveOption);
+
+  QVector<Unit> whole(1);
+  whole[0].name = "digi";
+  whole[0].text = netlist;
+
+  QString stripped = stripVhdl(netlist);
+
+  // where the context clauses and library units start
+  QVector<Segment> segments;
+  QRegularExpressionMatchIterator it = unit_rx.globalMatch(stripped);
+  while (it.hasNext()) {
+    QRegularExpressionMatch m = it.next();
+    Segment seg;
+    seg.start = m.capturedStart();
+    if (m.capturedLength(1) > 0) {
+      seg.kind = Context;
+    } else if (m.capturedLength(3) > 0 || m.capturedLength(4) > 0) {
+      seg.kind = Secondary;
+      seg.name = m.captured(m.capturedLength(3) > 0 ? 3 : 4).toLower();
+    } else {
+      seg.kind = Primary;
+      for (int g = 2; g <= 6; g++)
+        if (m.capturedLength(g) > 0) seg.name = m.captured(g).toLower();
+    }
+    segments.append(seg);
+  }
+  // A use clause may also stand in a declarative part. Such a "context"
+  // is followed by more than context clauses and belongs to the segment
+  // before it.
+  for (int i = segments.size() - 1; i > 0; i--) {
+    if (segments.at(i).kind != Context) continue;
+    int end = i + 1 < segments.size() ? segments.at(i+1).start : stripped.size();
+    if (!onlyContext(stripped.mid(segments.at(i).start, end - segments.at(i).start)))
+      segments.remove(i);
+  }
+
+  // collect the segments into units
+  QVector<Unit> units;
+  QHash<QString, int> index;
+  int pending = -1;               // start of the context clauses not yet taken
+  for (int i = 0; i < segments.size(); i++) {
+    const Segment &seg = segments.at(i);
+    int end = i + 1 < segments.size() ? segments.at(i+1).start : netlist.size();
+    // the first unit also takes the blank lines and comments before it
+    int start = (i == 0) ? 0 : seg.start;
+    if (seg.kind == Context) {
+      if (pending < 0) pending = start;
+      continue;
+    }
+    int from = pending >= 0 ? pending : start;
+    pending = -1;
+    QString text = netlist.mid(from, end - from);
+    if (seg.kind == Primary) {
+      if (index.contains(seg.name) || seg.name == "digi") return whole;
+      index.insert(seg.name, units.size());
+      Unit u;
+      u.name = seg.name;
+      u.text = text;
+      units.append(u);
+    } else if (index.contains(seg.name)) {
+      units[index.value(seg.name)].text += text;
+    } else if (!units.isEmpty()) {
+      units.last().text += text;
+    } else {
+      return whole;               // architecture without entity
+    }
+  }
+  if (units.isEmpty()) return whole;
+  if (pending >= 0) units.last().text += netlist.mid(pending);
+
+  // references between the units
+  for (int u = 0; u < units.size(); u++) {
+    QString s = stripVhdl(units.at(u).text);
+    QRegularExpressionMatchIterator rit = ref_rx.globalMatch(s);
+    while (rit.hasNext()) {
+      QRegularExpressionMatch m = rit.next();
+      for (int g = 1; g <= 5; g++) {
+        if (m.capturedLength(g) == 0) continue;
+        int dep = index.value(m.captured(g).toLower(), -1);
+        if (dep >= 0 && dep != u && !units.at(u).deps.contains(dep))
+          units[u].deps.append(dep);
+      }
+    }
+  }
+
+  // dependency order, the netlist order where there is a choice
+  QVector<int> order, state(units.size(), 0);   // 1: visiting, 2: done
+  std::function<bool(int)> visit = [&](int u) {
+    if (state.at(u) == 2) return true;
+    if (state.at(u) == 1) return false;         // loop
+    state[u] = 1;
+    for (int dep : units.at(u).deps)
+      if (!visit(dep)) return false;
+    state[u] = 2;
+    order.append(u);
+    return true;
+  };
+  for (int u = 0; u < units.size(); u++)
+    if (!visit(u)) return whole;
+
+  QVector<int> position(units.size());
+  for (int i = 0; i < order.size(); i++) position[order.at(i)] = i;
+  QVector<Unit> sorted;
+  for (int u : order) {
+    Unit unit = units.at(u);
+    QStringList libs;
+    for (int &dep : unit.deps) {
+      libs.append(libraryName(units.at(dep).name));
+      dep = position.at(dep);
+    }
+    std::sort(unit.deps.begin(), unit.deps.end());
+    if (!libs.isEmpty()) {
+      libs.sort();
+      // work.<unit> becomes q_<unit>.<unit>
+      QString text;
+      int last = 0;
+      QRegularExpressionMatchIterator wit = work_rx.globalMatch(unit.text);
+      while (wit.hasNext()) {
+        QRegularExpressionMatch m = wit.next();
+        QString name = m.captured(2).toLower();
+        if (name == unit.name || !index.contains(name)) continue;
+        text += unit.text.mid(last, m.capturedStart() - last);
+        text += libraryName(name) + m.captured(1) + m.captured(2);
+        last = m.capturedEnd();
+      }
+      text += unit.text.mid(last);
+      unit.text = "library " + libs.join(", ") + "; use " +
+                  libs.join(".all; use ") + ".all; " + text;
+    }
+    sorted.append(unit);
+  }
+  return sorted;
+}
+
+/*!
+ * \brief HdlBuild::setNetlist Split the netlist and key its units.
+ * \param netlist VHDL or Verilog netlist
+ * \param top Entity or module to simulate
+ * \return False if the top unit is missing
+ */
+bool HdlBuild::setNetlist(const QString &netlist, const QString &top)
+{
+  a_error.clear();
+  a_top = top;
+  if (a_lang == VHDL) {
+    a_units = splitVhdl(netlist);
+  } else {
+    a_units.resize(1);
+    a_units[0].name = "digi";
+    a_units[0].text = netlist;
+    a_units[0].deps.clear();
+  }
+
+  QCryptographicHash tool(QCryptographicHash::Sha256);
+  BuildCache::hashExecutable(tool, a_tool);
+  QByteArray toolKey = tool.result();
+
+  a_topLibrary.clear();
+  for (Unit &u : a_units) {
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(toolKey);
+    hash.addData(u.name.toUtf8());
+    if (a_lang == Verilog) hash.addData(top.toUtf8());
+    hash.addData(u.text.toUtf8());
+    for (int dep : u.deps)
+      hash.addData(a_units.at(dep).key.toLatin1());
+    u.key = hash.result().toHex();
+    if (u.name == top.toLower()) a_topLibrary = libraryName(u.name);
+  }
+  if (a_lang == VHDL && a_topLibrary.isEmpty()) {
+    if (a_units.size() == 1) {
+      a_topLibrary = libraryName(a_units.first().name);
+    } else {
+      a_error = QObject::tr("ERROR: No entity \"%1\" in the netlist.").arg(top);
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * \brief HdlBuild::runTool Run GHDL or iverilog in the build directory.
+ * \param program Tool to run
+ * \param args Its arguments
+ * \param output Receives the messages of the tool
+ * \return True if the tool ran without errors
+ */
+bool HdlBuild::runTool(const QString &program, const QStringList &args,
+                       QString &output)
+{
+#if defined(_WIN32) || defined(__MINGW32__)
+  QString sep(";");
+#else
+  QString sep(":");
+#endif
+  QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+  env.insert("PATH", env.value("PATH") + sep + QucsSettings.BinDir);
+
+  QProcess proc;
+  proc.setWorkingDirectory(a_dir);
+  proc.setProcessEnvironment(env);
+  proc.setProcessChannelMode(QProcess::MergedChannels);
+  proc.start(program, args);
+  if (!proc.waitForStarted(-1)) {
+    output = QObject::tr("ERROR: Cannot start %1 (%2)").arg(program, proc.errorString());
+    return false;
+  }
+  proc.closeWriteChannel();
+  while (!proc.waitForFinished(100) && proc.state() != QProcess::NotRunning) {
+    if (a_cancelled) {
+      proc.kill();
+      proc.waitForFinished(-1);
+      return false;
+    }
+  }
+  output = QString::fromLocal8Bit(proc.readAll());
+  return proc.exitStatus() == QProcess::NormalExit && proc.exitCode() == 0;
+}
+
+/*!
+ * \brief HdlBuild::buildUnit Bring one unit up to date, its dependencies
+ *        must be up to date.
+ * \param unit Index of the unit
+ * \param output Messages of the tool
+ * \return False if the unit cannot be analysed
+ */
+bool HdlBuild::buildUnit(int unit, QString &output)
+{
+  const Unit &u = a_units.at(unit);
+  QDir dir(a_dir);
+  QString keyFile = dir.filePath(u.name + ".key");
+  QString source, library;
+  QStringList filters;
+  if (a_lang == VHDL) {
+    source = u.name + ".vhdl";
+    library = libraryName(u.name);
+    filters << library + "-obj*.cf" << u.name + ".o";
+  } else {
+    source = u.name + ".v";
+    filters << u.name + ".vvp";
+  }
+
+  QString key;
+  if (readKey(keyFile, key) && key == u.key &&
+      !dir.entryList(QStringList(filters.first()), QDir::Files).isEmpty()) {
+    a_upToDate++;
+    return true;
+  }
+  QFile::remove(keyFile);
+
+  BuildCache cache(a_cacheTool);
+  if (cache.restore(u.key, dir)) {
+    writeText(keyFile, u.key);
+    a_restored++;
+    return true;
+  }
+
+  for (const QString &old : dir.entryList(filters, QDir::Files))
+    dir.remove(old);
+  if (!writeText(dir.filePath(source), u.text)) {
+    output = QObject::tr("ERROR: Cannot write \"%1\"!").arg(dir.filePath(source));
+    return false;
+  }
+
+  QStringList args;
+  if (a_lang == VHDL)
+    args << "-a" << "--work=" + library << "--workdir=." << "-P." << source;
+  else
+    args << "-o" + u.name + ".vvp" << "-s" + a_top << source;
+  if (!runTool(a_tool, args, output)) return false;
+
+  QStringList outputs(dir.filePath(source));
+  for (const QString &out : dir.entryList(filters, QDir::Files))
+    outputs.append(dir.filePath(out));
+  cache.store(u.key, outputs);
+  writeText(keyFile, u.key);
+  a_analysed++;
+  return true;
+}
+
+/*!
+ * \brief HdlBuild::build Analyse the units that have changed, as many at
+ *        a time as there are jobs. A unit is started when the units it
+ *        depends on are done.
+ * \param report Receives the tool messages and a summary
+ * \return False on errors (see error()) or if cancelled
+ */
+bool HdlBuild::build(const std::function<void(const QString&)> &report)
+{
+  a_error.clear();
+  a_analysed = a_restored = a_upToDate = 0;
+  if (!QDir().mkpath(a_dir)) {
+    a_error = QObject::tr("ERROR: Cannot create directory \"%1\"!").arg(a_dir);
+    return false;
+  }
+
+  int n = a_units.size();
+  QVector<int> waiting(n);
+  QVector<QVector<int>> dependents(n);
+  std::deque<int> ready;
+  for (int u = 0; u < n; u++) {
+    waiting[u] = a_units.at(u).deps.size();
+    for (int dep : a_units.at(u).deps) dependents[dep].append(u);
+    if (waiting.at(u) == 0) ready.push_back(u);
+  }
+
+  std::mutex lock;
+  std::condition_variable wake;
+  int done = 0;
+  bool failed = false;
+  auto work = [&]() {
+    std::unique_lock<std::mutex> guard(lock);
+    for (;;) {
+      while (ready.empty() && done < n && !failed && !a_cancelled)
+        wake.wait_for(guard, std::chrono::milliseconds(100));
+      if (ready.empty() || failed || a_cancelled) break;
+      int u = ready.front();
+      ready.pop_front();
+
+      guard.unlock();
+      QString output;
+      bool ok = buildUnit(u, output);
+      guard.lock();
+
+      if (!ok) {
+        if (!failed && !a_cancelled)
+          a_error = a_units.at(u).name + ": " + output.trimmed();
+        failed = true;
+        break;
+      }
+      if (!output.trimmed().isEmpty())
+        report(a_units.at(u).name + ": " + output.trimmed());
+      done++;
+      for (int d : dependents.at(u))
+        if (--waiting[d] == 0) ready.push_back(d);
+    }
+    wake.notify_all();
+  };
+
+  int jobs = a_jobs > 0 ? a_jobs : int(std::thread::hardware_concurrency());
+  jobs = qBound(1, jobs, n);
+  std::vector<std::thread> pool;
+  for (int j = 1; j < jobs; j++) pool.emplace_back(work);
+  work();
+  for (std::thread &t : pool) t.join();
+
+  if (failed || a_cancelled) return false;
+  report(QObject::tr("%1 units: %2 analysed, %3 restored from cache, %4 up to date")
+           .arg(n).arg(a_analysed).arg(a_restored).arg(a_upToDate));
+  return true;
+}
+
+QString HdlBuild::program() const
+{
+  return (a_lang == VHDL) ? "ghdl" : "vvp";
+}
+
+QStringList HdlBuild::arguments(const QString &time, const QString &vcd) const
+{
+  QStringList args;
+  if (a_lang == VHDL) {
+    QString dir = QDir::toNativeSeparators(a_dir);
+    args << "--elab-run" << "--work=" + a_topLibrary << "--workdir=" + dir
+         << "-P" + dir << a_top << "--vcd=" + vcd << "--stop-time=" + time;
+  } else {
+    args << QDir::toNativeSeparators(QDir(a_dir).filePath("digi.vvp")) << "-vcd";
+  }
+  return args;
+}
@@ -0,0 +1,112 @@
+/***************************************************************************
+                                hdlbuild.h
+                               ------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef HDLBUILD_H
+#define HDLBUILD_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+
+/*!
+ * \file hdlbuild.h
+ * \brief Declaration of the HdlBuild class
+ */
+
+/*!
+ * \brief The HdlBuild class prepares a digital netlist for simulation with
+ *        GHDL or Icarus Verilog, rebuilding only what has changed.
+ *
+ * A VHDL netlist is split into its design units: an entity or package
+ * with its architectures or body. Every unit is analysed by GHDL into a
+ * library of its own ("q_<unit>"), which is what allows units that do
+ * not depend on each other to be analysed at the same time. References
+ * between the units are made visible by library and use clauses, and
+ * "work.<unit>" names are redirected to the library of the unit.
+ *
+ * Each unit is keyed by a content hash of its text, the keys of the units
+ * it depends on and the identity of GHDL. A unit whose key is unchanged
+ * since the last build is left alone, one whose key is in the BuildCache
+ * is restored from it, the others are analysed. So after an edit, only
+ * the edited units and the units depending on them are analysed again.
+ *
+ * Icarus Verilog compiles a design in one pass and cannot link parts
+ * compiled separately, so a Verilog netlist is one unit.
+ */
+class HdlBuild
+{
+public:
+  enum Language { VHDL, Verilog };
+
+  struct Unit {
+    QString name;         // lower case, also the source file name
+    QString text;         // as written to the source file
+    QVector<int> deps;    // units this one depends on
+    QString key;
+  };
+
+  // "dir" keeps the sources and libraries between builds, "cacheTool"
+  // names the BuildCache (default "ghdl" or "iverilog").
+  HdlBuild(Language lang, const QString &dir,
+           const QString &cacheTool = QString());
+
+  // Splits the netlist into units, false (see error()) if it has none.
+  // "top" is the entity (module) that is simulated.
+  bool setNetlist(const QString &netlist, const QString &top = "TestBench");
+  void setJobs(int jobs) { a_jobs = jobs; }
+
+  // Analyses (compiles) what has changed. Progress messages go to
+  // "report", which is called from the build threads, one at a time.
+  // False if a unit fails or the build is cancelled.
+  bool build(const std::function<void(const QString&)> &report);
+  // May be called from any thread.
+  void cancel() { a_cancelled = true; }
+
+  // Command that simulates the top unit after build() and writes the
+  // waveforms into "vcd" (GHDL only, Verilog writes "digi.vcd" into the
+  // working directory as the netlist says).
+  QString program() const;
+  QStringList arguments(const QString &time, const QString &vcd) const;
+
+  const QString &error() const { return a_error; }
+  const QVector<Unit> &units() const { return a_units; }
+  int analysed() const { return a_analysed; }
+  int restored() const { return a_restored; }
+  int upToDate() const { return a_upToDate; }
+
+  // Design units of a VHDL netlist in dependency order, a single unit
+  // if the netlist cannot be split.
+  static QVector<Unit> splitVhdl(const QString &netlist);
+
+private:
+  bool buildUnit(int unit, QString &output);
+  bool runTool(const QString &program, const QStringList &args,
+               QString &output);
+
+  Language a_lang;
+  QString a_dir, a_cacheTool, a_tool;
+  QString a_top, a_topLibrary;
+  QVector<Unit> a_units;
+  int a_jobs;
+
+  QString a_error;
+  std::atomic<bool> a_cancelled;
+  std::atomic<int> a_analysed, a_restored, a_upToDate;
+};
+
+#endif // HDLBUILD_H
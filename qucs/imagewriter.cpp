@@ -22,11 +22,27 @@
 
 #include "schematic.h"
 #include "imagewriter.h"
+#include "epsgenerator.h"
 #include "dialogs/exportdialog.h"
 
 #include <QMargins>
+#include <QPicture>
+#include <QThread>
 #include <QtSvg>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+// PNG images are painted in tiles of at most TileSize x TileSize pixels,
+// one band of tiles (at most BandBytes) at a time
+constexpr int TileSize = 1024;
+constexpr qint64 BandBytes = 32 << 20;
+}
+
 
 ImageWriter::ImageWriter(QString lastfile)
 {
@@ -45,60 +61,24 @@ ImageWriter::noGuiPrint(QWidget *doc, const QString& printFile, const QString& c
   const QMargins bourder{30, 30, 30, 30};
   QRect schematic_bounding_rect = sch->allBoundingRect();
 
-  if (printFile.endsWith(".svg") || printFile.endsWith(".eps")) {
+  if (printFile.endsWith(".svg")) {
     QSvgGenerator* svg1 = new QSvgGenerator();
-
-    QString tempfile = printFile + ".tmp.svg";
-    if (!printFile.endsWith(".svg")) {
-        svg1->setFileName(tempfile);
-    } else {
-        svg1->setFileName(printFile);
-    }
-
+    svg1->setFileName(printFile);
     svg1->setSize(schematic_bounding_rect.size());
     QPainter *p = new QPainter(svg1);
     sch->print(nullptr, p, true, true, bourder);
 
     delete p;
     delete svg1;
-
-    if (!printFile.endsWith(".svg")) {
-        QString cmd = "inkscape";
-        QStringList args;
-        args<<"-z"<<"-D";
-        QString tmpf = "--file=" + tempfile;
-        args<<tmpf;
-
-        if (printFile.endsWith(".eps")) {
-          QString pf = "--export-eps=" + printFile;
-          args<<pf;
-        }
-
-        int result = QProcess::execute(cmd,args);
-
-        if (result!=0) {
-            QMessageBox* msg =  new QMessageBox(QMessageBox::Critical,"Export to image", "Inkscape start error!", QMessageBox::Ok);
-            msg->exec();
-            delete msg;
-        }
-        QFile::remove(tempfile);
-    }
-
+  } else if (printFile.endsWith(".eps")) {
+    if (!writeEps(sch, printFile, schematic_bounding_rect.size(), true, bourder))
+      fprintf(stderr, "Cannot write %s\n", qPrintable(printFile));
   } else if (printFile.endsWith(".png")) {
-    QImage* img;
-    if (color == "BW") {
-      img = new QImage(schematic_bounding_rect.size(), QImage::Format_Mono);
-    } else {
-      img = new QImage(schematic_bounding_rect.size(), QImage::Format_RGB888);
-    }
-
-    QPainter* p = new QPainter(img);
-    sch->print(nullptr, p, true, true, bourder);
-
-    img->save(printFile);
-
-    delete p;
-    delete img;
+    QString error;
+    PngWriter::Mode mode = color == "BW" ? PngWriter::Monochrome : PngWriter::RGB;
+    if (!writeTiledPng(sch, printFile, schematic_bounding_rect.size(), mode,
+                       true, bourder, error))
+      fprintf(stderr, "%s\n", qPrintable(error));
   } else {
     fprintf(stderr, "Unsupported format of output file. \n"
         "Use PNG, SVG or PDF format!\n");
@@ -106,6 +86,101 @@ ImageWriter::noGuiPrint(QWidget *doc, const QString& printFile, const QString& c
   }
 }
 
+/*!
+  Paints the schematic into a PNG file, tile by tile. The schematic is
+  recorded once into a QPicture that the tiles replay, each in its own
+  thread and with its own painter, so the elements are only touched by the
+  calling thread. Only one band of tiles is kept in memory, the PNG encoder
+  compresses it before the next one is painted.
+*/
+bool ImageWriter::writeTiledPng(Schematic *sch, const QString &file, QSize size,
+                                PngWriter::Mode mode, bool printAll, QMargins margins,
+                                QString &error)
+{
+  QPicture picture;
+  QPainter recorder(&picture);
+  sch->print(nullptr, &recorder, printAll, true, margins, size);
+  recorder.end();
+  const QByteArray data(picture.data(), picture.size());
+  // the texts are replayed at the resolution they were recorded with
+  const int dotsPerMeter = qRound(picture.logicalDpiX() / 0.0254);
+
+  const QImage::Format format = mode == PngWriter::RGB ? QImage::Format_RGB888
+                                                      : QImage::Format_Grayscale8;
+  const int depth = mode == PngWriter::RGB ? 3 : 1;
+  const int width = size.width(), height = size.height();
+  const int bandHeight = int(std::max<qint64>(1, std::min<qint64>(
+      TileSize, BandBytes / (qint64(width) * depth))));
+  const int columns = (width + TileSize - 1) / TileSize;
+  const int threads = std::max(1, std::min(QThread::idealThreadCount(), columns));
+
+  PngWriter png;
+  if (!png.open(file, width, height, mode)) {
+    error = png.error();
+    return false;
+  }
+
+  std::vector<uchar> band(size_t(width) * depth * bandHeight);
+  for (int y = 0; y < height; y += bandHeight) {
+    const int rows = std::min(bandHeight, height - y);
+    std::atomic<int> next{0};
+    auto paintTiles = [&]() {
+      QPicture replay;
+      replay.setData(data.constData(), data.size());
+      for (;;) {
+        const int column = next++;
+        if (column >= columns)
+          break;
+        const int x = column * TileSize;
+        const int w = std::min(TileSize, width - x);
+        QImage tile(w, rows, format);
+        tile.setDotsPerMeterX(dotsPerMeter);
+        tile.setDotsPerMeterY(dotsPerMeter);
+        tile.fill(Qt::white);
+        QPainter p(&tile);
+        p.setClipRect(0, 0, w, rows);
+        p.translate(-x, -y);
+        p.drawPicture(0, 0, replay);
+        p.end();
+        for (int r = 0; r < rows; r++)
+          memcpy(band.data() + (size_t(r) * width + x) * depth, tile.constScanLine(r),
+                 size_t(w) * depth);
+      }
+    };
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++)
+      workers.emplace_back(paintTiles);
+    paintTiles();
+    for (std::thread &t : workers)
+      t.join();
+
+    if (!png.writeRows(band.data(), rows, width * depth)) {
+      error = png.error();
+      png.close();
+      return false;
+    }
+  }
+  if (!png.close()) {
+    error = png.error();
+    return false;
+  }
+  return true;
+}
+
+// Writes the schematic as Encapsulated PostScript.
+bool ImageWriter::writeEps(Schematic *sch, const QString &file, QSize size,
+                           bool printAll, QMargins margins)
+{
+  EpsGenerator eps;
+  eps.setFileName(file);
+  eps.setSize(size);
+  QPainter p;
+  if (!p.begin(&eps))
+    return false;
+  sch->print(nullptr, &p, printAll, true, margins);
+  return p.end();
+}
+
 QString ImageWriter::getLastSavedFile()
 {
     return lastExportFilename;
@@ -162,7 +237,21 @@ int ImageWriter::print(QWidget *doc)
     }
 
     if (dlg->isValidFilename()) {
-      if (!dlg->isSvg()) {
+      const QMargins margins{border, border, border, border};
+      if (QFileInfo(filename).suffix().toLower() == "png") {
+        PngWriter::Mode mode = PngWriter::RGB;
+        if (dlg->getImgFormat() == ExportDialog::Grayscale)
+          mode = PngWriter::Grayscale;
+        else if (dlg->getImgFormat() == ExportDialog::Monochrome)
+          mode = PngWriter::Monochrome;
+        QString error;
+        if (!writeTiledPng(sch, filename, QSize(w, h), mode, exportAll, margins, error))
+          QMessageBox::critical(0, QObject::tr("Export to image"), error, QMessageBox::Ok);
+      }
+      else if (dlg->isEps()) {
+        writeEps(sch, filename, QSize(w, h), exportAll, margins);
+      }
+      else if (!dlg->isSvg()) {
         QImage* img;
 
         switch (dlg->getImgFormat()) {
@@ -224,11 +313,6 @@ int ImageWriter::print(QWidget *doc)
                 args<<stmp;
             }
 
-            if (dlg->isEps()) {
-                stmp = "--export-eps=" + filename;
-                args<<stmp;
-            }
-
             int result = QProcess::execute(cmd,args);
 
             if (result!=0) {
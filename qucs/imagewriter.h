@@ -23,9 +23,14 @@
 #ifndef IMAGEWRITER_H_
 #define IMAGEWRITER_H_ value
 
+#include <QMargins>
+#include <QSize>
 #include <QString>
 
+#include "pngwriter.h"
+
 class QWidget;
+class Schematic;
 
 class ImageWriter
 {
@@ -39,6 +44,12 @@ public:
 
   void setDiagram(bool diagram) { onlyDiagram = diagram; };
 private:
+  static bool writeTiledPng(Schematic *sch, const QString &file, QSize size,
+                            PngWriter::Mode mode, bool printAll, QMargins margins,
+                            QString &error);
+  static bool writeEps(Schematic *sch, const QString &file, QSize size,
+                       bool printAll, QMargins margins);
+
   bool onlyDiagram;
   QString lastExportFilename;
 };
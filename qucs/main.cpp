@@ -46,193 +46,19 @@
 #include "settings.h"
 #include "module.h"
 #include "misc.h"
+#include "tracing.h"
 
 
 #include "extsimkernels/ngspice.h"
 #include "extsimkernels/xyce.h"
+#include "extsimkernels/optimizer.h"
+#include "extsimkernels/spicecompat.h"
+#include "components/opt_sim.h"
 
 #if defined(_WIN32) ||defined(__MINGW32__)
 #include <windows.h>  //for OutputDebugString
 #endif
 
-#if defined(_WIN32) ||defined(__MINGW32__)
-#define executableSuffix ".exe"
-#else
-#define executableSuffix ""
-#endif
-
-tQucsSettings QucsSettings;
-
-QucsApp *QucsMain = nullptr;  // the Qucs application itself
-QString lastDir;    // to remember last directory for several dialogs
-QStringList qucsPathList;
-VersionTriplet QucsVersion; // Qucs version string
-
-// #########################################################################
-// Loads the settings file and stores the settings.
-bool loadSettings()
-{
-    QSettings settings("qucs","qucs_s");
-
-    QucsSettings.DefaultSimulator = _settings::Get().item<int>("DefaultSimulator");
-    QucsSettings.firstRun = _settings::Get().item<bool>("firstRun");
-
-    /*** Temporarily continue to use QucsSettings to make sure all settings convert okay and remain compatible ***/
-    QucsSettings.font.fromString(_settings::Get().item<QString>("font"));
-    QucsSettings.appFont.fromString(_settings::Get().item<QString>("appFont"));
-    QucsSettings.textFont.fromString(_settings::Get().item<QString>("textFont"));
-    QucsSettings.largeFontSize = _settings::Get().item<double>("LargeFontSize");
-    QucsSettings.maxUndo = _settings::Get().item<int>("maxUndo");
-    QucsSettings.NodeWiring = _settings::Get().item<int>("NodeWiring");
-    QucsSettings.BGColor = _settings::Get().item<QString>("BGColor");
-    QucsSettings.Editor = _settings::Get().item<QString>("Editor");
-    QucsSettings.FileTypes = _settings::Get().item<QStringList>("FileTypes");
-    QucsSettings.Language = _settings::Get().item<QString>("Language");
-
-    // Editor syntax highlighting settings.
-    QucsSettings.Comment = _settings::Get().item<QString>("Comment");
-    QucsSettings.String = _settings::Get().item<QString>("String");
-    QucsSettings.Integer = _settings::Get().item<QString>("Integer");
-    QucsSettings.Real = _settings::Get().item<QString>("Real");
-    QucsSettings.Character = _settings::Get().item<QString>("Character");
-    QucsSettings.Type = _settings::Get().item<QString>("Type");
-    QucsSettings.Attribute = _settings::Get().item<QString>("Attribute");
-    QucsSettings.Directive = _settings::Get().item<QString>("Directive");
-    QucsSettings.Task = _settings::Get().item<QString>("Task");
-
-    // TODO: Convert this to the new settings model.
-    if(settings.contains("Qucsator")) {
-        QucsSettings.Qucsator = settings.value("Qucsator").toString();
-        QFileInfo inf(QucsSettings.Qucsator);
-        QucsSettings.QucsatorDir = inf.canonicalPath() + QDir::separator();
-        if (QucsSettings.Qucsconv.isEmpty())
-            QucsSettings.Qucsconv = QucsSettings.QucsatorDir + QDir::separator() + "qucsconv_rf" + executableSuffix;
-    } else {
-        QucsSettings.Qucsator = QucsSettings.BinDir + "qucsator_rf" + executableSuffix;
-        QucsSettings.QucsatorDir = QucsSettings.BinDir;
-        if (QucsSettings.Qucsconv.isEmpty())
-            QucsSettings.Qucsconv = QucsSettings.BinDir + "qucsconv_rf" + executableSuffix;
-    }
-
-    QucsSettings.AdmsXmlBinDir.setPath(_settings::Get().item<QString>("AdmsXmlBinDir"));
-    QucsSettings.AscoBinDir.setPath(_settings::Get().item<QString>("AscoBinDir"));
-    QucsSettings.NgspiceExecutable = _settings::Get().item<QString>("NgspiceExecutable");
-    QucsSettings.XyceExecutable = _settings::Get().item<QString>("XyceExecutable");
-    QucsSettings.XyceParExecutable = _settings::Get().item<QString>("XyceParExecutable");
-    QucsSettings.SpiceOpusExecutable = _settings::Get().item<QString>("SpiceOpusExecutable");
-    QucsSettings.NProcs = _settings::Get().item<int>("Nprocs");
-
-    // TODO: Currently the default settings cannot include other settings during initialisation. This is a
-    // problem for this setting as it needs to include the QucsWorkDir setting. Therefore, set the default to an
-    // empty string and populate it here by brute force.
-    QucsSettings.S4Qworkdir = _settings::Get().item<QString>("S4Q_workdir");
-    if (QucsSettings.S4Qworkdir == "")
-      QucsSettings.S4Qworkdir = QDir::toNativeSeparators(QucsSettings.QucsWorkDir.absolutePath()+"/spice4qucs");
-
-    QucsSettings.SimParameters = _settings::Get().item<QString>("SimParameters");
-    QucsSettings.OctaveExecutable = _settings::Get().item<QString>("OctaveExecutable");
-    QucsSettings.OpenVAFExecutable = _settings::Get().item<QString>("OpenVAFExecutable");
-
-    QucsSettings.RFLayoutExecutable = _settings::Get().item<QString>("RFLayoutExecutable");
-
-    QucsSettings.qucsWorkspaceDir.setPath(_settings::Get().item<QString>("QucsHomeDir"));
-    QucsSettings.QucsWorkDir = QucsSettings.qucsWorkspaceDir;
-    QucsSettings.tempFilesDir.setPath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
-
-    QucsSettings.IgnoreFutureVersion = _settings::Get().item<bool>("IgnoreVersion");
-    QucsSettings.GraphAntiAliasing = _settings::Get().item<bool>("GraphAntiAliasing");
-    QucsSettings.TextAntiAliasing = _settings::Get().item<bool>("TextAntiAliasing");
-    QucsSettings.fullTraceName = _settings::Get().item<bool>("fullTraceName");
-    QucsSettings.RecentDocs = _settings::Get().item<QString>("RecentDocs").split("*",qucs::SkipEmptyParts);
-    QucsSettings.numRecentDocs = QucsSettings.RecentDocs.count();
-    QucsSettings.spiceExtensions << "*.sp" << "*.cir" << "*.spc" << "*.spi";
-
-    // If present read in the list of directory paths in which Qucs should
-    // search for subcircuit schematics
-    int npaths = settings.beginReadArray("Paths");
-    for (int i = 0; i < npaths; ++i)
-    {
-        settings.setArrayIndex(i);
-        QString apath = settings.value("path").toString();
-        qucsPathList.append(apath);
-    }
-    settings.endArray();
-
-    QucsSettings.numRecentDocs = 0;
-
-    return true;
-}
-
-// #########################################################################
-// Saves the settings in the settings file.
-bool saveApplSettings()
-{
-    QSettings settings ("qucs","qucs_s");
-
-    // Note: It is not really necessary to take the following reference, but it
-    // arguably makes the code slightly cleaner - thoughts? To be clear:
-    // qs.item<int>() is identical to _settings::get().item<int>()
-    settingsManager& qs = _settings::Get();
-
-    qs.setItem<int>("DefaultSimulator", QucsSettings.DefaultSimulator);
-    qs.setItem<bool>("firstRun", false);
-    qs.setItem<QString>("font", QucsSettings.font.toString());
-    qs.setItem<QString>("appFont", QucsSettings.appFont.toString());
-    qs.setItem<QString>("textFont", QucsSettings.textFont.toString());
-    if (QucsMain != nullptr) {
-      qs.setItem<QByteArray>("MainWindowGeometry", QucsMain->saveGeometry());
-    }
-
-    // store LargeFontSize as a string, so it will be also human-readable in the settings file (will be a @Variant() otherwise)
-    qs.setItem<QString>("LargeFontSize", QString::number(QucsSettings.largeFontSize));
-    qs.setItem<unsigned int>("maxUndo", QucsSettings.maxUndo);
-    qs.setItem<unsigned int>("NodeWiring", QucsSettings.NodeWiring);
-    qs.setItem<QString>("BGColor", QucsSettings.BGColor.name());
-    qs.setItem<QString>("Editor", QucsSettings.Editor);
-    qs.setItem<QStringList>("FileTypes", QucsSettings.FileTypes);
-    qs.setItem<QString>("Language", QucsSettings.Language);
-    qs.setItem<QString>("Comment", QucsSettings.Comment.name());
-    qs.setItem<QString>("String", QucsSettings.String.name());
-    qs.setItem<QString>("Integer", QucsSettings.Integer.name());
-    qs.setItem<QString>("Real", QucsSettings.Real.name());
-    qs.setItem<QString>("Character", QucsSettings.Character.name());
-    qs.setItem<QString>("Type", QucsSettings.Type.name());
-    qs.setItem<QString>("Attribute", QucsSettings.Attribute.name());
-    qs.setItem<QString>("Directive", QucsSettings.Directive.name());
-    qs.setItem<QString>("Task", QucsSettings.Task.name());
-    qs.setItem<QString>("AdmsXmlBinDir", QucsSettings.AdmsXmlBinDir.canonicalPath());
-    qs.setItem<QString>("AscoBinDir", QucsSettings.AscoBinDir.canonicalPath());
-    qs.setItem<QString>("NgspiceExecutable",QucsSettings.NgspiceExecutable);
-    qs.setItem<QString>("XyceExecutable",QucsSettings.XyceExecutable);
-    qs.setItem<QString>("XyceParExecutable",QucsSettings.XyceParExecutable);
-    qs.setItem<QString>("SpiceOpusExecutable",QucsSettings.SpiceOpusExecutable);
-    qs.setItem<QString>("Qucsator",QucsSettings.Qucsator);
-    qs.setItem<int>("Nprocs",QucsSettings.NProcs);
-    qs.setItem<QString>("S4Q_workdir",QucsSettings.S4Qworkdir);
-    qs.setItem<QString>("SimParameters",QucsSettings.SimParameters);
-    qs.setItem<QString>("OctaveExecutable",QucsSettings.OctaveExecutable);
-    qs.setItem<QString>("OpenVAFExecutable",QucsSettings.OpenVAFExecutable);
-    qs.setItem<QString>("QucsHomeDir", QucsSettings.qucsWorkspaceDir.canonicalPath());
-    qs.setItem<bool>("IgnoreVersion", QucsSettings.IgnoreFutureVersion);
-    qs.setItem<bool>("GraphAntiAliasing", QucsSettings.GraphAntiAliasing);
-    qs.setItem<bool>("TextAntiAliasing", QucsSettings.TextAntiAliasing);
-    qs.setItem<bool>("fullTraceName",QucsSettings.fullTraceName);
-
-    // Copy the list of directory paths in which Qucs should
-    // search for subcircuit schematics from qucsPathList
-    settings.remove("Paths");
-    settings.beginWriteArray("Paths");
-    int i = 0;
-    for (QString& path: qucsPathList) {
-         settings.setArrayIndex(i);
-         settings.setValue("path", path);
-         i++;
-     }
-     settings.endArray();
-
-  return true;
-}
-
 /*!
  * \brief qucsMessageOutput handles qDebug, qWarning, qCritical, qFatal.
  * \param type Message type (Qt enum)
@@ -405,6 +231,68 @@ int runXyce(QString schematic, QString dataset)
     return 0;
 }
 
+/*!
+ * \brief doOptimize Run the optimization of a schematic with Ngspice or Xyce
+ *        and print the best values. An interrupted run continues from the
+ *        log next to the schematic.
+ * \param dataset Dataset of the best point, not written if empty
+ * \param jobs Parallel simulations, 0 for one per CPU
+ */
+int doOptimize(QString schematic, QString dataset, bool xyce, int jobs)
+{
+    QucsSettings.DefaultSimulator = xyce ? spicecompat::simXyce : spicecompat::simNgspice;
+    Module::registerModules();
+    Schematic *sch = openSchematic(schematic);
+    if (sch == NULL) {
+      return 1;
+    }
+    Optimize_Sim *opt = Optimizer::find(sch);
+    if (opt == nullptr) {
+        fprintf(stderr, "Error: %s has no optimization\n", schematic.toLatin1().data());
+        delete sch;
+        return 1;
+    }
+
+    AbstractSpiceKernel *kernel;
+    if (xyce) kernel = new Xyce(sch);
+    else kernel = new Ngspice(sch);
+    Optimizer optimizer(opt);
+    AbstractSpiceKernel::Batch batch;
+    bool ok = kernel->createBatch(batch) &&
+              optimizer.setBatch(batch, QucsSettings.S4Qworkdir);
+    if (ok) {
+        optimizer.setJobs(jobs);
+        optimizer.setLog(Optimizer::logFile(schematic));
+        ok = optimizer.run([](const QString &msg) {
+            fprintf(stdout, "%s\n", msg.toLocal8Bit().data());
+            fflush(stdout);
+        });
+    }
+    if (!ok) {
+        QString msg = optimizer.error();
+        if (msg.isEmpty()) msg = "Cannot create the netlist";
+        fprintf(stderr, "Error: %s\n", msg.toLocal8Bit().data());
+    } else {
+        const QVector<Optimizer::Variable> &vars = optimizer.variables();
+        for (int i = 0; i < vars.size(); i++)
+            if (vars.at(i).active)
+                fprintf(stdout, "%s = %s\n", vars.at(i).name.toLocal8Bit().data(),
+                        optimizer.valueText(i).toLocal8Bit().data());
+        const QVector<Optimizer::Goal> &goals = optimizer.goals();
+        for (int i = 0; i < goals.size(); i++)
+            fprintf(stdout, "%s = %g\n", goals.at(i).name.toLocal8Bit().data(),
+                    optimizer.goalValues().value(i));
+        if (!dataset.isEmpty()) {
+            kernel->setWorkdir(optimizer.resultDir());
+            kernel->convertToQucsData(dataset);
+        }
+    }
+
+    delete kernel;
+    delete sch;
+    return ok ? 0 : 1;
+}
+
 int doNgspiceNetlist(QString schematic, QString netlist)
 {
     QucsSettings.DefaultSimulator = spicecompat::simNgspice;
@@ -780,8 +668,16 @@ int main(int argc, char *argv[])
   QucsSettings.qucsWorkspaceDir.setPath(QucsWorkdirPath);
   QucsSettings.QucsWorkDir.setPath(QucsSettings.qucsWorkspaceDir.canonicalPath());
 
+  // trace startup if requested, the trace is written on exit
+  QString trace_file = QString::fromLocal8Bit(qgetenv("QUCS_TRACE"));
+  if (trace_file.isEmpty()) trace_file = _settings::Get().item<QString>("TraceFile");
+  Tracer::start(trace_file);
+
   // load existing settings (if any)
-  loadSettings();
+  {
+    QUCS_TRACE("loadSettings");
+    loadSettings();
+  }
 
   QDir().mkpath(QucsSettings.qucsWorkspaceDir.absolutePath());
   QDir().mkpath(QucsSettings.tempFilesDir.absolutePath());
@@ -913,6 +809,8 @@ int main(int argc, char *argv[])
   bool ngspice_flag = false;
   bool xyce_flag = false;
   bool run_flag = false;
+  bool optimize_flag = false;
+  int jobs = 0;
   QString page = "A4";
   int dpi = 96;
   QString color = "RGB";
@@ -924,11 +822,12 @@ int main(int argc, char *argv[])
       fprintf(stdout,
   "Usage: %s [-hv] \n"
   "       qucs -n -i FILENAME -o FILENAME\n"
-  "       qucs -p -i FILENAME -o FILENAME.[pdf|png|svg|eps] \n\n"
+  "       qucs -p -i FILENAME -o FILENAME.[pdf|png|svg|eps] \n"
+  "       qucs --optimize -i FILENAME [-o FILENAME]\n\n"
   "  -h, --help     display this help and exit\n"
   "  -v, --version  display version information and exit\n"
   "  -n, --netlist  convert Qucs schematic into netlist\n"
-  "  -p, --print    print Qucs schematic to file (eps needs inkscape)\n"
+  "  -p, --print    print Qucs schematic to file (png, svg, eps, pdf)\n"
   "    --page [A4|A3|B4|B5]         set print page size (default A4)\n"
   "    --dpi NUMBER                 set dpi value (default 96)\n"
   "    --color [RGB|RGB]            set color mode (default RGB)\n"
@@ -938,6 +837,9 @@ int main(int argc, char *argv[])
   "     --ngspice   create Ngspice netlist\n"
   "     --xyce      Xyce netlist\n"
   "     --run       execute Ngspice/Xyce immediately\n"
+  "  --optimize     optimize the input schematic with Ngspice (or --xyce),\n"
+  "                 -o writes the dataset of the best point\n"
+  "     --jobs N    run N simulations at a time (default one per CPU)\n"
   "  -icons         create component icons under ./bitmaps_generated\n"
   "  -doc           dump data for documentation:\n"
   "                 * file with of categories: categories.txt\n"
@@ -945,6 +847,7 @@ int main(int argc, char *argv[])
   "                   - CSV file with component data ([comp#]_data.csv)\n"
   "                   - CSV file with component properties. ([comp#]_props.csv)\n"
   "  -list-entries  list component entry formats for schematic and netlist\n"
+  "\nSet QUCS_TRACE=FILE to write a Chrome trace (JSON) of the session to FILE.\n"
   , argv[0]);
       return 0;
     }
@@ -989,6 +892,12 @@ int main(int argc, char *argv[])
     else if (!strcmp(argv[i], "--run")) {
       run_flag = true;
     }
+    else if (!strcmp(argv[i], "--optimize")) {
+      optimize_flag = true;
+    }
+    else if (!strcmp(argv[i], "--jobs")) {
+      jobs = QString(argv[++i]).toInt();
+    }
     else if(!strcmp(argv[i], "-icons")) {
       createIcons();
       return 0;
@@ -1008,7 +917,17 @@ int main(int argc, char *argv[])
   }
 
   // check operation and its required arguments
-  if (netlist_flag and print_flag) {
+  if (optimize_flag) {
+    if (netlist_flag or print_flag) {
+      fprintf(stderr, "Error: --optimize cannot be used with --netlist or --print\n");
+      return -1;
+    }
+    if (inputfile.isEmpty()) {
+      fprintf(stderr, "Error: Expected input file.\n");
+      return -1;
+    }
+    return doOptimize(inputfile, outputfile, xyce_flag, jobs);
+  } else if (netlist_flag and print_flag) {
     fprintf(stderr, "Error: --print and --netlist cannot be used together\n");
     return -1;
   } else if (((ngspice_flag||xyce_flag) && print_flag)||
@@ -1042,7 +961,10 @@ int main(int argc, char *argv[])
     }
   }
 
-  QucsMain = new QucsApp();
+  {
+    QUCS_TRACE("QucsApp::QucsApp");
+    QucsMain = new QucsApp();
+  }
   //1a.setMainWidget(QucsMain);
 
   QucsMain->show();
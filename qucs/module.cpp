@@ -14,20 +14,30 @@
  *   (at your option) any later version.                                   *
  *                                                                         *
  ***************************************************************************/
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
 #include <QHash>
 #include <QString>
 #include <QStringList>
 #include <QList>
 #include <QDebug>
+#include <QFileInfo>
+#include <QPixmap>
+#include <QRegularExpression>
 
 #include "element.h"
 #include "components/component.h"
 #include "components/components.h"
+#include "components/symbolgeometry.h"
 #include "spicecomponents/spicecomponents.h"
 #include "paintings/paintings.h"
 #include "diagrams/diagrams.h"
 #include "module.h"
 #include "main.h"
+#include "misc.h"
+#include "tracing.h"
 #include "extsimkernels/spicecompat.h"
 
 // Global category and component lists.
@@ -35,6 +45,7 @@ QHash<QString, Module *> Module::Modules;
 QList<Category *> Category::Categories;
 
 QMap<QString, QString> Module::vaComponents;
+QList<Module *> Module::SearchIndex;
 
 // Constructor creates instance of module object.
 Module::Module () {
@@ -51,9 +62,12 @@ Module::~Module () {
 // Module registration using a category name and the appropriate
 // function returning a modules instance object.
 void Module::registerModule (QString category, pInfoFunc info) {
+  char * File;
   Module * m = new Module ();
   m->info = info;
   m->category = category;
+  info (m->name, File, false);
+  m->bitmapFile = QString (File);
   intoCategory (m);
 }
 
@@ -73,9 +87,9 @@ void Module::registerComponent(QString category, pInfoFunc info) {
     Module* m     = new Module();
     m->info       = info;
     m->category   = category;
-
-    m->icon = new QPixmap(128, 128);
-    c->paintIcon(m->icon);
+    m->name       = Name;
+    m->bitmapFile = QString(File);
+    m->model      = c->Model;
 
     intoCategory(m);
     if (!Modules.contains(c->Model)) {
@@ -102,6 +116,61 @@ Component * Module::getComponent (QString Model) {
   return 0;
 }
 
+// Returns the palette icon of the module.  The bitmap resource is used
+// if there is one, otherwise the component symbol is painted.  Painted
+// icons are kept in an on-disk cache per application version and theme,
+// named after the model and a hash of the symbol, so the symbol is
+// painted only once per installation.  The component is still built to
+// compute the hash; only the painting is saved.
+QPixmap Module::getIcon () {
+  if (icon != nullptr) return *icon;
+  icon = new QPixmap ();
+
+  QString icon_path = misc::getIconPath (bitmapFile);
+  if (QFileInfo::exists (icon_path)) {
+    icon->load (icon_path);
+    return *icon;
+  }
+  if (model.isEmpty () || !info) return *icon;  // not a component
+
+  QDir cache_dir (QucsSettings.tempFilesDir.filePath (
+      QStringLiteral ("iconcache/%1-%2").arg (PACKAGE_VERSION)
+      .arg (QucsSettings.hasDarkTheme ? "dark" : "light")));
+
+  QString Name;
+  char * File;
+  Component * c = (Component *) info (Name, File, true);
+  QString base = model;
+  base.replace (QRegularExpression ("[^A-Za-z0-9_]"), "_");
+  QString cache_file = cache_dir.filePath (QStringLiteral ("%1-%2.png")
+      .arg (base, QString (SymbolGeometry::fingerprint (c))));
+  if (!icon->load (cache_file, "PNG")) {
+    *icon = QPixmap (128, 128);
+    c->paintIcon (icon);
+    if (cache_dir.mkpath (".")) icon->save (cache_file, "PNG");
+  }
+  delete c;
+  return *icon;
+}
+
+// Returns the modules whose name contains the given text, in category
+// order.  The index of named modules is built on the first search
+// after (re-)registration.
+QList<Module *> Module::findModules (const QString & text) {
+  if (SearchIndex.isEmpty ()) {
+    for (Category * cat : Category::Categories)
+      for (Module * m : cat->Content)
+        if (m->info) SearchIndex.append (m);
+  }
+
+  QList<Module *> res;
+  for (Module * m : SearchIndex) {
+    if (m->name.contains (text, Qt::CaseInsensitive))
+      res.append (m);
+  }
+  return res;
+}
+
 void Module::registerDynamicComponents()
 {
     qDebug() << "Module::registerDynamicComponents()";
@@ -150,12 +219,15 @@ void Module::registerDynamicComponents()
 // The function appends the given module to the appropriate category.
 // If there is no such category yet, then the category gets created.
 void Module::intoCategory (Module * m) {
+  SearchIndex.clear ();
 
   // look through existing categories
   QList<Category *>::const_iterator it;
   for (it = Category::Categories.constBegin();
        it != Category::Categories.constEnd(); it++) {
     if ((*it)->Name == m->category) {
+      m->catIdx = it - Category::Categories.constBegin();
+      m->compIdx = (*it)->Content.size();
       (*it)->Content.append (m);
       break;
     }
@@ -164,6 +236,8 @@ void Module::intoCategory (Module * m) {
   // if there is no such category, then create it
   if (it == Category::Categories.constEnd()) {
     Category *cat = new Category (m->category);
+    m->catIdx = Category::Categories.size();
+    m->compIdx = 0;
     Category::Categories.append (cat);
     cat->Content.append (m);
   }
@@ -257,6 +331,7 @@ REGISTER_COMP_2 (QObject::tr("microelectronics"),val,inf1,inf2)
 // registers every component available in the application.  Put here
 // any new component.
 void Module::registerModules (void) {
+  QUCS_TRACE("Module::registerModules");
   unregisterModules();
 
   REGISTER_LUMPED_2 (Resistor, info, info_us);
@@ -618,6 +693,7 @@ void Module::registerModules (void) {
 // This function has to be called once at application end.  It removes
 // all categories and registered modules from memory.
 void Module::unregisterModules(void) {
+  SearchIndex.clear();
   while (!Category::Categories.isEmpty()) {
     delete Category::Categories.takeFirst();
   }
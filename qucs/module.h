@@ -40,11 +40,15 @@ class Module
   static void intoCategory (Module *);
   static Component * getComponent (QString);
   static void registerDynamicComponents(void);
+  static QList<Module *> findModules (const QString &);
 
  public:
   static QHash<QString, Module *> Modules;
   static QMap<QString, QString> vaComponents;
 
+ private:
+  static QList<Module *> SearchIndex;
+
  public:
   static void registerModules (void);
   static void unregisterModules (void);
@@ -53,8 +57,16 @@ class Module
   pInfoFunc info = 0;
   pInfoVAFunc infoVA = 0;
   QString category;
+  QString name;        // translated name returned by info()
+  QString bitmapFile;  // bitmap resource name returned by info()
+  QString model;       // component model, empty for other modules
+  int catIdx = -1;     // position in Category::Categories
+  int compIdx = -1;    // position in Category::Content
+
+  QPixmap getIcon ();
 
-  QPixmap *icon;
+ private:
+  QPixmap *icon;       // created on first use by getIcon()
 };
 
 class Category
@@ -0,0 +1,105 @@
+/***************************************************************************
+                                netindex.cpp
+                               --------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "netindex.h"
+#include "node.h"
+#include "wire.h"
+
+#include <algorithm>
+
+/*!
+ * \file netindex.cpp
+ * \brief Implementation of the NetIndex class
+ */
+
+NetIndex::NetIndex() : a_count(0)
+{
+}
+
+// -----------------------------------------------------------
+int NetIndex::find(int i)
+{
+  while (a_parent[i] != i) {
+    a_parent[i] = a_parent[a_parent[i]];   // path halving
+    i = a_parent[i];
+  }
+  return i;
+}
+
+// -----------------------------------------------------------
+void NetIndex::update(Q3PtrList<Node>& nodes, Q3PtrList<Wire>& wires)
+{
+  std::vector<Node*> Nodes;
+  Nodes.reserve(nodes.count());
+  for (Node *pn : nodes)
+    Nodes.push_back(pn);
+  std::vector<std::pair<Node*, Node*>> Wires;
+  Wires.reserve(wires.count());
+  for (Wire *pw : wires)
+    Wires.emplace_back(pw->Port1, pw->Port2);
+
+  // the nets are a function of the node order and of the wire ends only
+  bool grown = Nodes.size() >= a_nodes.size() && Wires.size() >= a_wires.size()
+            && std::equal(a_nodes.begin(), a_nodes.end(), Nodes.begin())
+            && std::equal(a_wires.begin(), a_wires.end(), Wires.begin());
+  if (grown && Nodes.size() == a_nodes.size() && Wires.size() == a_wires.size())
+    return;   // unchanged
+
+  std::size_t firstNode = a_nodes.size(), firstWire = a_wires.size();
+  if (!grown) {
+    a_index.clear();
+    a_parent.clear();
+    firstNode = firstWire = 0;
+  }
+  for (std::size_t i = firstNode; i < Nodes.size(); i++) {
+    a_index[Nodes[i]] = int(i);
+    a_parent.push_back(int(i));
+  }
+  for (std::size_t i = firstWire; i < Wires.size(); i++) {
+    auto p1 = a_index.find(Wires[i].first);
+    auto p2 = a_index.find(Wires[i].second);
+    if (p1 == a_index.end() || p2 == a_index.end())
+      continue;   // dangling wire, not part of the document
+    int r1 = find(p1->second), r2 = find(p2->second);
+    if (r1 != r2)   // the lower index stays the root, it is met first
+      a_parent[std::max(r1, r2)] = std::min(r1, r2);
+  }
+  a_nodes.swap(Nodes);
+  a_wires.swap(Wires);
+
+  // dense net numbers in the order of the first node of each net
+  a_nodeNet.assign(a_nodes.size(), -1);
+  std::vector<int> number(a_nodes.size(), -1);
+  a_count = 0;
+  for (std::size_t i = 0; i < a_nodes.size(); i++) {
+    int r = find(int(i));
+    if (number[r] < 0)
+      number[r] = a_count++;
+    a_nodeNet[i] = number[r];
+  }
+}
+
+// -----------------------------------------------------------
+int NetIndex::net(const Node *pn) const
+{
+  auto it = a_index.find(pn);
+  return it == a_index.end() ? -1 : a_nodeNet[it->second];
+}
+
+bool NetIndex::connected(const Node *a, const Node *b) const
+{
+  int na = net(a);
+  return na >= 0 && na == net(b);
+}
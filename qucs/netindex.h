@@ -0,0 +1,70 @@
+/***************************************************************************
+                                 netindex.h
+                                ------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef NETINDEX_H
+#define NETINDEX_H
+
+#include "qt3_compat/q3ptrlist.h"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Node;
+class Wire;
+
+/*!
+ * \file netindex.h
+ * \brief Declaration of the NetIndex class
+ */
+
+/*!
+ * \brief Groups the nodes of a schematic into nets (sets of nodes joined
+ *        by wires).
+ *
+ * The nets are kept in a union-find structure. update() compares the
+ * wiring with the one seen last time: if nothing changed the index is
+ * used as it is, if wires and nodes were only added they are merged in,
+ * otherwise (something was deleted or rewired) the index is rebuilt.
+ * None of these floods the wire graph. Nets are numbered in the order of
+ * their first node in the node list.
+ */
+class NetIndex
+{
+public:
+  NetIndex();
+
+  // Brings the index up to date with the nodes and wires of a schematic.
+  void update(Q3PtrList<Node>& nodes, Q3PtrList<Wire>& wires);
+
+  int count() const { return a_count; }
+  // Net of the i-th node of the list given to update().
+  int net(int i) const { return a_nodeNet[i]; }
+  // Net of a node, -1 if the node is unknown.
+  int net(const Node *pn) const;
+  bool connected(const Node *a, const Node *b) const;
+
+private:
+  int find(int i);
+
+  std::vector<Node*> a_nodes;
+  std::vector<std::pair<Node*, Node*>> a_wires;
+  std::unordered_map<const Node*, int> a_index;
+  std::vector<int> a_parent;
+  std::vector<int> a_nodeNet;
+  int a_count;
+};
+
+#endif // NETINDEX_H
@@ -38,6 +38,13 @@ function dataSet = loadQucsDataSet(dataSetFile)
 % Modified  2012 Richard Crozier
 % Published under GNU General Public License (GPL V2). No warranty at all.
 
+    % the native reader (libqucsdata) is much faster on large files and
+    % also reads SPICE raw files
+    if exist('qucsdata_mex') == 3
+        dataSet = qucsdata_mex(dataSetFile);
+        return;
+    end
+
     dataSet = [];
     fid = fopen(dataSetFile,'r');
     if fid < 0
@@ -0,0 +1,94 @@
+/***************************************************************************
+                               qucsdata_mex.c
+                              ----------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*
+ * Octave/MATLAB gateway to libqucsdata, used by loadQucsDataSet.m:
+ *
+ *   dataSet = qucsdata_mex(fileName)
+ *
+ * returns the same structure array as the script reader (fields name,
+ * nameDep, dep, data, len), read with the native library. Digital
+ * variables come as cell arrays of strings.
+ */
+
+#include "mex.h"
+#include "qucsdata.h"
+
+#include <string.h>
+
+static const char *fields[] = { "name", "nameDep", "dep", "data", "len" };
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  char *path;
+  qucsdata_file *ds;
+  int i, n;
+  (void) nlhs;
+
+  if (nrhs != 1 || !mxIsChar(prhs[0]))
+    mexErrMsgIdAndTxt("QUCS:qucsdata_mex:args", "usage: qucsdata_mex(fileName)");
+
+  path = mxArrayToString(prhs[0]);
+  ds = qucsdata_open(path);
+  mxFree(path);
+  if (!ds)
+    mexErrMsgIdAndTxt("QUCS:qucsdata_mex:open", "%s", qucsdata_last_error());
+
+  qucsdata_decode_all(ds, 0);
+  n = qucsdata_count(ds);
+  plhs[0] = mxCreateStructMatrix(1, n, 5, fields);
+
+  for (i = 0; i < n; i++) {
+    int kind = qucsdata_kind(ds, i);
+    size_t len = qucsdata_length(ds, i), k;
+    mxArray *data;
+
+    if (kind == QUCSDATA_DIGITAL) {
+      size_t bytes;
+      const char *bits = qucsdata_digital(ds, i, &bytes);
+      data = mxCreateCellMatrix(1, len);
+      for (k = 0; k < len; k++) {
+        mxSetCell(data, k, mxCreateString(bits));
+        bits += strlen(bits) + 1;
+      }
+    }
+    else {
+      const double *v = qucsdata_values(ds, i);
+      if (kind == QUCSDATA_COMPLEX) {
+        double *re, *im;
+        data = mxCreateDoubleMatrix(1, len, mxCOMPLEX);
+        re = mxGetPr(data);
+        im = mxGetPi(data);
+        for (k = 0; k < len; k++) {
+          re[k] = v[2 * k];
+          im[k] = v[2 * k + 1];
+        }
+      }
+      else {
+        data = mxCreateDoubleMatrix(1, len, mxREAL);
+        if (v && len) memcpy(mxGetPr(data), v, len * sizeof(double));
+      }
+    }
+
+    mxSetField(plhs[0], i, "name", mxCreateString(qucsdata_name(ds, i)));
+    mxSetField(plhs[0], i, "nameDep", mxCreateString(
+                 qucsdata_dep_count(ds, i) > 0 ? qucsdata_dep_name(ds, i, 0) : "-"));
+    mxSetField(plhs[0], i, "dep", mxCreateDoubleScalar(!qucsdata_is_indep(ds, i)));
+    mxSetField(plhs[0], i, "data", data);
+    mxSetField(plhs[0], i, "len", mxCreateDoubleScalar((double) len));
+  }
+
+  qucsdata_close(ds);
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+                              pngwriter.cpp
+                             ---------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+/*!
+  \file pngwriter.cpp
+  \brief Implementation of the PngWriter class
+*/
+
+#include "pngwriter.h"
+
+#include <QObject>
+#include <QtEndian>
+
+#include <cstring>
+
+#include <zlib.h>
+
+struct PngWriter::Stream {
+    z_stream z;
+};
+
+namespace {
+// compressed data is written in chunks of this size
+constexpr int ChunkSize = 1 << 16;
+}
+
+PngWriter::PngWriter()
+    : a_mode(RGB), a_width(0), a_height(0), a_rows(0)
+{
+}
+
+PngWriter::~PngWriter()
+{
+    if (a_stream)
+        deflateEnd(&a_stream->z);
+}
+
+bool PngWriter::open(const QString &fileName, int width, int height, Mode mode)
+{
+    a_file.setFileName(fileName);
+    if (!a_file.open(QIODevice::WriteOnly)) {
+        a_error = QObject::tr("Cannot open \"%1\" for writing").arg(fileName);
+        return false;
+    }
+    a_mode = mode;
+    a_width = width;
+    a_height = height;
+    a_rows = 0;
+
+    a_stream.reset(new Stream);
+    a_stream->z = z_stream();
+    deflateInit(&a_stream->z, Z_DEFAULT_COMPRESSION);
+
+    // filter type byte in front of the packed pixels of each row
+    int rowBytes = mode == RGB ? 3 * width : mode == Grayscale ? width : (width + 7) / 8;
+    a_row.resize(rowBytes + 1);
+    a_out.resize(ChunkSize);
+    a_stream->z.next_out = reinterpret_cast<Bytef*>(a_out.data());
+    a_stream->z.avail_out = ChunkSize;
+
+    static const char signature[] = "\x89PNG\r\n\x1a\n";
+    if (a_file.write(signature, 8) != 8) {
+        a_error = a_file.errorString();
+        return false;
+    }
+    QByteArray header(13, '\0');
+    qToBigEndian<quint32>(width, header.data());
+    qToBigEndian<quint32>(height, header.data() + 4);
+    header[8] = mode == Monochrome ? 1 : 8;  // bit depth
+    header[9] = mode == RGB ? 2 : 0;         // color type, 0 is gray
+    return writeChunk("IHDR", header);
+}
+
+bool PngWriter::writeRows(const uchar *rows, int count, int bytesPerLine)
+{
+    uchar *row = reinterpret_cast<uchar*>(a_row.data());
+    for (int r = 0; r < count && a_rows < a_height; r++, a_rows++) {
+        const uchar *src = rows + qsizetype(r) * bytesPerLine;
+        row[0] = 0;  // no filter
+        if (a_mode == Monochrome) {
+            uchar *dst = row + 1;
+            for (int x = 0; x < a_width; x += 8) {
+                uchar bits = 0;
+                for (int b = 0; b < 8 && x + b < a_width; b++)
+                    if (src[x + b] >= 128)
+                        bits |= 0x80 >> b;  // white
+                *dst++ = bits;
+            }
+        } else {
+            memcpy(row + 1, src, a_row.size() - 1);
+        }
+
+        a_stream->z.next_in = row;
+        a_stream->z.avail_in = a_row.size();
+        if (!encode(false))
+            return false;
+    }
+    return true;
+}
+
+bool PngWriter::close()
+{
+    bool ok = a_rows == a_height;
+    if (!ok)
+        a_error = QObject::tr("Image is incomplete");
+    ok = ok && encode(true) && writeChunk("IEND", QByteArray());
+    if (a_stream) {
+        deflateEnd(&a_stream->z);
+        a_stream.reset();
+    }
+    a_file.close();
+    return ok;
+}
+
+// Compresses the pending input, full output buffers become IDAT chunks.
+bool PngWriter::encode(bool finish)
+{
+    z_stream &z = a_stream->z;
+    for (;;) {
+        int result = ::deflate(&z, finish ? Z_FINISH : Z_NO_FLUSH);
+        if (result == Z_STREAM_ERROR) {
+            a_error = QObject::tr("Compression failed");
+            return false;
+        }
+        bool full = z.avail_out == 0;
+        bool done = finish ? result == Z_STREAM_END : z.avail_in == 0 && !full;
+        if (full || (finish && done)) {
+            if (!writeChunk("IDAT", a_out.left(ChunkSize - z.avail_out)))
+                return false;
+            z.next_out = reinterpret_cast<Bytef*>(a_out.data());
+            z.avail_out = ChunkSize;
+        }
+        if (done)
+            return true;
+    }
+}
+
+bool PngWriter::writeChunk(const char *type, const QByteArray &data)
+{
+    char length[4], crc[4];
+    qToBigEndian<quint32>(data.size(), length);
+    uLong sum = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+    if (!data.isEmpty())
+        sum = crc32(sum, reinterpret_cast<const Bytef*>(data.constData()), data.size());
+    qToBigEndian<quint32>(sum, crc);
+    if (a_file.write(length, 4) != 4 || a_file.write(type, 4) != 4 ||
+        a_file.write(data) != data.size() || a_file.write(crc, 4) != 4) {
+        a_error = a_file.errorString();
+        return false;
+    }
+    return true;
+}
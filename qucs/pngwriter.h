@@ -0,0 +1,71 @@
+/***************************************************************************
+                               pngwriter.h
+                              -------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PNGWRITER_H
+#define PNGWRITER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <memory>
+
+/*!
+ * \file pngwriter.h
+ * \brief Declaration of the PngWriter class
+ */
+
+/*!
+ * \brief The PngWriter class encodes a PNG file row by row.
+ *
+ * Unlike QImage::save() it never holds the whole image: the rows are
+ * compressed as they arrive and written out in chunks, so images of any
+ * height can be written with the memory of a few rows.
+ */
+class PngWriter
+{
+public:
+    enum Mode {
+        RGB,        // rows of 8 bit red, green, blue
+        Grayscale,  // rows of 8 bit gray
+        Monochrome  // rows of 8 bit gray, written as black and white
+    };
+
+    PngWriter();
+    ~PngWriter();
+
+    bool open(const QString &fileName, int width, int height, Mode mode);
+    // Appends "count" rows, "bytesPerLine" apart.
+    bool writeRows(const uchar *rows, int count, int bytesPerLine);
+    // Finishes the file, false if it is not complete.
+    bool close();
+
+    const QString &error() const { return a_error; }
+
+private:
+    struct Stream;
+
+    bool writeChunk(const char *type, const QByteArray &data);
+    bool encode(bool finish);
+
+    QFile a_file;
+    std::unique_ptr<Stream> a_stream;
+    Mode a_mode;
+    int a_width, a_height, a_rows;
+    QByteArray a_row, a_out;
+    QString a_error;
+};
+
+#endif // PNGWRITER_H
@@ -27,31 +27,92 @@
 #include <QString>
 #include <QStringList>
 #include <QDir>
+#include <QFileInfo>
 #include <QStandardItemModel>
 #include <QDebug>
 
+// rows of the categories
+enum {
+  CAT_DATASETS = 0,
+  CAT_DISPLAYS,
+  CAT_VERILOG,
+  CAT_VERILOGA,
+  CAT_VHDL,
+  CAT_OCTAVE,
+  CAT_SCHEMATICS,
+  CAT_SYMBOLS,
+  CAT_SPICE,
+  CAT_OTHERS
+};
+
+// The category of a file follows from its name only.
+static int fileCategory(const QFileInfo &Info)
+{
+  QString extName = Info.suffix().toLower();
+  QString fullExtName = Info.completeSuffix().toLower();
+
+  if(extName == "dat" || fullExtName == "dat.ngspice" ||
+     fullExtName == "dat.xyce" || fullExtName == "dat.spopus" )
+    return CAT_DATASETS;
+  if(extName == "dpl")
+    return CAT_DISPLAYS;
+  if(extName == "v")
+    return CAT_VERILOG;
+  if(extName == "va")
+    return CAT_VERILOGA;
+  if((extName == "vhdl") || (extName == "vhd"))
+    return CAT_VHDL;
+  if((extName == "m") || (extName == "oct"))
+    return CAT_OCTAVE;
+  if(extName == "sch")
+    return CAT_SCHEMATICS;
+  if (extName == "sym")
+    return CAT_SYMBOLS;
+  if ((extName == "cir") || (extName=="ckt") || (extName=="sp"))
+    return CAT_SPICE;
+  return CAT_OTHERS;
+}
+
 ProjectView::ProjectView(QWidget *parent)
   : QTreeView(parent)
 {
   m_projPath = QString();
   m_projPath = QString();
   m_valid = false;
+  m_stop = false;
   m_model = new QStandardItemModel(8, 2, this);
 
-  refresh();
+  reset();
 
   this->setModel(m_model);
   this->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+  m_refreshTimer.setSingleShot(true);
+  m_refreshTimer.setInterval(200);
+  connect(&m_refreshTimer, &QTimer::timeout, this, &ProjectView::refresh);
+  connect(&m_watcher, &QFileSystemWatcher::directoryChanged,
+          &m_refreshTimer, static_cast<void (QTimer::*)()>(&QTimer::start));
 }
 
 ProjectView::~ProjectView()
 {
+  if (m_worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    m_worker.join();
+  }
   delete m_model;
 }
 
 void
 ProjectView::setProjPath(const QString &path)
 {
+  if (!m_watcher.directories().isEmpty())
+    m_watcher.removePaths(m_watcher.directories());
+
   // check if path exist
   m_valid = !path.isEmpty() && QDir(path).exists();
 
@@ -63,15 +124,18 @@ ProjectView::setProjPath(const QString &path)
     } else { // should not happen
       qWarning() << "ProjectView::setProjPath() : path does not end in '_prj' (" << m_projName << ")";
     }
+    m_watcher.addPath(m_projPath);
   }
+  reset();
   refresh();
 }
 
-// refresh using projectPath
+// Removes all files and recreates the categories.
 void
-ProjectView::refresh()
+ProjectView::reset()
 {
   m_model->clear();
+  m_files.clear();
 
   QStringList header;
   header << tr("Content of %1").arg(m_projName) << tr("Note");
@@ -88,79 +152,166 @@ ProjectView::refresh()
   APPEND_ROW(m_model, tr("SPICE")       );
   APPEND_ROW(m_model, tr("Others")       );
 
-  setExpanded(m_model->index(6, 0), true);
+  setExpanded(m_model->index(CAT_SCHEMATICS, 0), true);
+}
 
+// refresh using projectPath, only the files that appeared or vanished
+// since the last time are touched
+void
+ProjectView::refresh()
+{
   if (!m_valid) {
     return;
   }
 
   // put all files into "Content"-ListView
   QDir workPath(m_projPath);
-  QStringList files = workPath.entryList(QStringList() << "*", QDir::Files, QDir::Name);
-  QStringList::iterator it;
-  QString extName, fileName, fullExtName;
-  QList<QStandardItem *> columnData;
+  QFileInfoList files = workPath.entryInfoList(QStringList() << "*", QDir::Files, QDir::Name);
+  QSet<QString> present;
 
-#define APPEND_CHILD(category, data) \
-  m_model->item(category, 0)->appendRow(data);
+  for (const QFileInfo &Info : files) {
+    QString fileName = Info.fileName();
+    present.insert(fileName);
 
-  for(it = files.begin(); it != files.end(); ++it) {
-    fileName = (*it).toLatin1();
-    extName = QFileInfo(workPath.filePath(fileName)).suffix().toLower();
-    fullExtName = QFileInfo(workPath.filePath(fileName)).completeSuffix().toLower();
-
-    columnData.clear();
-    columnData.append(new QStandardItem(fileName));
+    int category = fileCategory(Info);
+    if (category == CAT_SCHEMATICS)
+      testSchematic(Info);   // shown unless known to be invalid
+    else if (!m_files.contains(fileName))
+      m_files.insert(fileName, addFile(category, fileName));
+  }
 
-    if(extName == "dat" || fullExtName == "dat.ngspice" ||
-       fullExtName == "dat.xyce" || fullExtName == "dat.spopus" ) {
-      APPEND_CHILD(0, columnData);
-    }
-    else if(extName == "dpl") {
-      APPEND_CHILD(1, columnData);
-    }
-    else if(extName == "v") {
-      APPEND_CHILD(2, columnData);
-    }
-    else if(extName == "va") {
-      APPEND_CHILD(3, columnData);
-    }
-    else if((extName == "vhdl") || (extName == "vhd")) {
-      APPEND_CHILD(4, columnData);
-    }
-    else if((extName == "m") || (extName == "oct")) {
-      APPEND_CHILD(5, columnData);
-    }
-    else if(extName == "sch") {
-      // test if it's a valid schematic file
-      int n = Schematic::testFile(workPath.filePath(fileName));
-      if(n >= 0) {
-        if(n > 0) { // is a subcircuit
-          columnData.append(new QStandardItem(QString::number(n)+tr("-port")));
-        }
-        APPEND_CHILD(6, columnData);
-      }
-    } else if (extName == "sym") {
-        APPEND_CHILD(7,columnData);
-    } else if ((extName == "cir") || (extName=="ckt") ||
-             (extName=="sp")) {
-        APPEND_CHILD(8,columnData);
-    }
-    else {
-      APPEND_CHILD(9, columnData);
+  for (auto it = m_files.begin(); it != m_files.end(); ) {
+    if (present.contains(it.key())) {
+      ++it;
+      continue;
     }
+    if (it.value())
+      it.value()->parent()->removeRow(it.value()->row());
+    it = m_files.erase(it);
   }
 
   resizeColumnToContents(0);
 }
 
+// Inserts a file into its category, in name order.
+QStandardItem *
+ProjectView::addFile(int category, const QString &fileName)
+{
+  QStandardItem *parent = m_model->item(category, 0);
+  int lo = 0, hi = parent->rowCount();
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (parent->child(mid, 0)->text() < fileName) lo = mid + 1;
+    else hi = mid;
+  }
+  QStandardItem *item = new QStandardItem(fileName);
+  parent->insertRow(lo, QList<QStandardItem*>() << item);
+  return item;
+}
+
+// Shows a schematic with its cached port count, or queues it for the
+// worker if it is new or has changed.
+void
+ProjectView::testSchematic(const QFileInfo &Info)
+{
+  QString path = Info.absoluteFilePath();
+  auto cached = m_schematics.constFind(path);
+  if (cached != m_schematics.constEnd() && cached->size == Info.size() &&
+      cached->modified == Info.lastModified()) {
+    showSchematic(Info.fileName(), cached->ports);
+    return;
+  }
+
+  if (!m_files.contains(Info.fileName()))
+    showSchematic(Info.fileName(), 0);   // until it is known
+  if (m_testing.contains(path))
+    return;
+  m_testing.insert(path);
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_queue.push_back(path);
+  }
+  m_wake.notify_one();
+  if (!m_worker.joinable())
+    m_worker = std::thread(&ProjectView::work, this);
+}
+
+// Adds, updates or removes (if not valid) the row of a schematic.
+void
+ProjectView::showSchematic(const QString &fileName, int ports)
+{
+  QStandardItem *item = m_files.value(fileName);
+  if (ports < 0) {   // not a valid schematic, not listed
+    if (item)
+      item->parent()->removeRow(item->row());
+    m_files.insert(fileName, nullptr);
+    return;
+  }
+
+  if (!item) {
+    item = addFile(CAT_SCHEMATICS, fileName);
+    m_files.insert(fileName, item);
+  }
+  QStandardItem *parent = item->parent();
+  QString note = ports > 0 ? QString::number(ports)+tr("-port") : QString();
+  QStandardItem *noteItem = parent->child(item->row(), 1);
+  if (noteItem)
+    noteItem->setText(note);
+  else if (!note.isEmpty())   // is a subcircuit
+    parent->setChild(item->row(), 1, new QStandardItem(note));
+}
+
+// Result of the worker, in the GUI thread.
+void
+ProjectView::schematicTested(const QString &path, qint64 size,
+                             const QDateTime &modified, int ports)
+{
+  m_testing.remove(path);
+  m_schematics.insert(path, SchematicInfo{size, modified, ports});
+
+  QFileInfo Info(path);
+  if (m_valid && QDir(Info.absolutePath()) == QDir(m_projPath) &&
+      m_files.contains(Info.fileName())) {
+    // changed meanwhile, tests it again
+    if (!Info.exists() || Info.size() != size || Info.lastModified() != modified)
+      testSchematic(Info);
+    else
+      showSchematic(Info.fileName(), ports);
+  }
+}
+
+// Worker thread, tests the queued schematics one after the other.
+void
+ProjectView::work()
+{
+  std::unique_lock<std::mutex> guard(m_lock);
+  for (;;) {
+    m_wake.wait(guard, [this]() { return m_stop || !m_queue.empty(); });
+    if (m_stop)
+      return;
+    QString path = m_queue.front();
+    m_queue.pop_front();
+    guard.unlock();
+
+    QFileInfo Info(path);   // before reading, a later change is seen
+    qint64 size = Info.size();
+    QDateTime modified = Info.lastModified();
+    int ports = Schematic::testFile(path);
+    QMetaObject::invokeMethod(this, [this, path, size, modified, ports]() {
+      schematicTested(path, size, modified, ports);
+    }, Qt::QueuedConnection);
+
+    guard.lock();
+  }
+}
+
 QStringList
 ProjectView::exportSchematic()
 {
   QStringList list;
-  QStandardItem *item = m_model->item(6, 0);
+  QStandardItem *item = m_model->item(CAT_SCHEMATICS, 0);
   for (int i = 0; i < item->rowCount(); ++i) {
-    if (item->child(i,1)) {
+    if (item->child(i,1) && !item->child(i,1)->text().isEmpty()) {
       list.append(item->child(i,0)->text());
     }
   }
@@ -26,6 +26,16 @@
 
 #include <QTreeView>
 #include <QString>
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 /*#define APPEND_ROW(parent, data) \
 ({ \
@@ -42,8 +52,19 @@ if(1){ \
     parent->appendRow(c); \
 }
 
+class QFileInfo;
+class QStandardItem;
 class QStandardItemModel;
 
+/*!
+ * \brief Lists the files of the project directory by category.
+ *
+ * The directory is watched and refresh() only adds and removes the rows
+ * of files that appeared or vanished. Whether a schematic is valid and
+ * how many ports it has is found on a worker thread and cached by path,
+ * size and modification time, so unchanged schematics are never read
+ * again.
+ */
 class ProjectView : public QTreeView
 {
   Q_OBJECT
@@ -58,11 +79,38 @@ public:
   void refresh();
   QStringList exportSchematic();
 private:
+  void reset();
+  QStandardItem *addFile(int category, const QString &fileName);
+  void testSchematic(const QFileInfo &);
+  void showSchematic(const QString &fileName, int ports);
+  void schematicTested(const QString &path, qint64 size,
+                       const QDateTime &modified, int ports);
+  void work();
+
   QStandardItemModel *m_model;
 
   bool m_valid;
   QString m_projPath;
   QString m_projName;
+
+  QFileSystemWatcher m_watcher;
+  QTimer m_refreshTimer;   // collects bursts of directory changes
+  QHash<QString, QStandardItem*> m_files;   // file name -> row, 0 if hidden
+
+  struct SchematicInfo {
+    qint64 size;
+    QDateTime modified;
+    int ports;   // Schematic::testFile()
+  };
+  QHash<QString, SchematicInfo> m_schematics;   // by absolute path
+  QSet<QString> m_testing;
+
+  // worker testing schematics
+  std::thread m_worker;
+  std::mutex m_lock;
+  std::condition_variable m_wake;
+  std::deque<QString> m_queue;
+  bool m_stop;
 };
 
 #endif /* PROJECTVIEW_H_ */
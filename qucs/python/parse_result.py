@@ -1,6 +1,11 @@
 import re
 import numpy as np
 
+try:
+    import qucsdata
+except ImportError:
+    qucsdata = None
+
 
 class QucsDataset:
     def __init__(self, name: str) -> None:
@@ -25,6 +30,10 @@ class QucsDataset:
             __data (Dict[str, np.ndarray]):
                 A dictionary mapping variable names to arrays of values.
         '''
+        self._variables = {}
+        if qucsdata is not None and qucsdata.available():
+            self.__data = self.__load_native(name)
+            return
         try:
             with open(name, 'r') as f:
                 first_line = f.readline()
@@ -33,9 +42,42 @@ class QucsDataset:
                 self.__qucs_dataset = f.readlines()
         except FileNotFoundError:
             raise FileNotFoundError(f"QUCS-S dataset {name} not found.")
-        self._variables = {}
         self.__data = self.__parse_qucs_result()
 
+    def __load_native(self, name: str) -> dict:
+        '''
+        Reads the dataset with libqucsdata, which is much faster for large
+        files and also understands SPICE raw files. The arrays share the
+        memory of the library.
+
+        Returns:
+            dict: A dictionary of the variables in the dataset and their values
+        '''
+        try:
+            with open(name, 'rb') as f:
+                head = f.read(64)
+        except FileNotFoundError:
+            raise FileNotFoundError(f"QUCS-S dataset {name} not found.")
+        if not head.startswith(b"<Qucs Dataset") and b"Title:" not in head:
+            raise ValueError(f"Invalid QUCS-S dataset {name}.")
+        try:
+            ds = qucsdata.Dataset(name, decode_all=True)
+        except FileNotFoundError:
+            raise ValueError(f"Invalid QUCS-S dataset {name}.")
+
+        data = {}
+        self._variables = ds.variables()
+        for key, vtype in self._variables.items():
+            data[key] = ds[key]
+            deps = ds.dependencies(key) if vtype == 'dep' else []
+            if len(deps) > 1:
+                # first independent variable runs fastest -> last one is
+                # the first axis of the N-dimensional matrix
+                shape = [len(ds[d]) for d in reversed(deps)]
+                data[key] = data[key].reshape(shape)
+                print(f'Simulation results for variable {key} reshaped into an N-dimensional matrix')
+        return data
+
     def __parse_qucs_result(self) -> dict:
         '''
         Parses a *.dat file containing QUCS-S simulation results.
@@ -0,0 +1,200 @@
+'''
+Python binding of libqucsdata, the dataset reader of Qucs-S.
+
+Reads Qucs datasets and SPICE raw files (Ngspice, Xyce). The file is only
+indexed when opened; the values of a variable are decoded on first access
+and returned as numpy arrays that share the memory of the library, no copy
+is made. Complex variables come as complex128, all others as float64.
+
+    from qucsdata import Dataset
+    ds = Dataset('rc_ac_sweep.dat')
+    print(ds.variables())            # {'acfrequency': 'indep', ...}
+    v = ds['out.v']                  # numpy array
+    print(ds.dependencies('out.v'))  # ['acfrequency', 'Cx']
+
+The library is looked up in $QUCSDATA_LIBRARY, next to this script, in
+the "lib" and "bin" directories of the Qucs-S installation and finally in
+the system library path.
+'''
+
+import ctypes
+import ctypes.util
+import os
+import struct
+import sys
+
+import numpy as np
+
+_REAL, _COMPLEX, _DIGITAL = 1, 2, 3
+
+
+def _load_library():
+    names = {'win32': ['qucsdata.dll', 'libqucsdata.dll'],
+             'darwin': ['libqucsdata.dylib']}.get(sys.platform, ['libqucsdata.so', 'libqucsdata.so.1'])
+    here = os.path.dirname(os.path.abspath(__file__))
+    prefix = os.path.normpath(os.path.join(here, '..', '..', '..'))  # share/qucs-s/python
+    candidates = []
+    if os.environ.get('QUCSDATA_LIBRARY'):
+        candidates.append(os.environ['QUCSDATA_LIBRARY'])
+    for d in (here, os.path.join(prefix, 'lib'), os.path.join(prefix, 'bin')):
+        candidates += [os.path.join(d, n) for n in names]
+    found = ctypes.util.find_library('qucsdata')
+    if found:
+        candidates.append(found)
+
+    for path in candidates:
+        try:
+            return ctypes.CDLL(path)
+        except OSError:
+            pass
+    return None
+
+
+_lib = _load_library()
+
+if _lib is not None:
+    _handle = ctypes.c_void_p
+    _lib.qucsdata_abi_version.restype = ctypes.c_int
+    _lib.qucsdata_open.argtypes = [ctypes.c_char_p]
+    _lib.qucsdata_open.restype = _handle
+    _lib.qucsdata_last_error.restype = ctypes.c_char_p
+    _lib.qucsdata_close.argtypes = [_handle]
+    _lib.qucsdata_count.argtypes = [_handle]
+    _lib.qucsdata_find.argtypes = [_handle, ctypes.c_char_p]
+    _lib.qucsdata_name.argtypes = [_handle, ctypes.c_int]
+    _lib.qucsdata_name.restype = ctypes.c_char_p
+    _lib.qucsdata_is_indep.argtypes = [_handle, ctypes.c_int]
+    _lib.qucsdata_dep_count.argtypes = [_handle, ctypes.c_int]
+    _lib.qucsdata_dep_name.argtypes = [_handle, ctypes.c_int, ctypes.c_int]
+    _lib.qucsdata_dep_name.restype = ctypes.c_char_p
+    _lib.qucsdata_decode_all.argtypes = [_handle, ctypes.c_int]
+    _lib.qucsdata_kind.argtypes = [_handle, ctypes.c_int]
+    _lib.qucsdata_length.argtypes = [_handle, ctypes.c_int]
+    _lib.qucsdata_length.restype = ctypes.c_size_t
+    _lib.qucsdata_values.argtypes = [_handle, ctypes.c_int]
+    _lib.qucsdata_values.restype = ctypes.POINTER(ctypes.c_double)
+    _lib.qucsdata_digital.argtypes = [_handle, ctypes.c_int, ctypes.POINTER(ctypes.c_size_t)]
+    _lib.qucsdata_digital.restype = ctypes.POINTER(ctypes.c_char)
+
+
+def available() -> bool:
+    '''True if libqucsdata could be loaded.'''
+    return _lib is not None
+
+
+class Dataset:
+    def __init__(self, name: str, decode_all: bool = False) -> None:
+        '''
+        Opens a Qucs dataset or SPICE raw file.
+
+        Args:
+            name (str): Path to the dataset file
+            decode_all (bool): Decode all variables right away, in parallel
+
+        Raises:
+            RuntimeError: If libqucsdata is not available
+            FileNotFoundError: If the file cannot be opened or read
+        '''
+        if _lib is None:
+            raise RuntimeError('libqucsdata not found, set QUCSDATA_LIBRARY')
+        self._ds = _lib.qucsdata_open(os.fsencode(name))
+        if not self._ds:
+            raise FileNotFoundError(_lib.qucsdata_last_error().decode(errors='replace'))
+        self._cache = {}
+        if decode_all:
+            _lib.qucsdata_decode_all(self._ds, 0)
+
+    def __del__(self) -> None:
+        if getattr(self, '_ds', None):
+            _lib.qucsdata_close(self._ds)
+            self._ds = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args) -> None:
+        self._cache.clear()
+
+    def _index(self, name: str) -> int:
+        idx = _lib.qucsdata_find(self._ds, name.encode())
+        if idx < 0:
+            raise KeyError(name)
+        return idx
+
+    def __contains__(self, name: str) -> bool:
+        return _lib.qucsdata_find(self._ds, name.encode()) >= 0
+
+    def names(self) -> list:
+        '''Returns the names of all variables in file order.'''
+        return [_lib.qucsdata_name(self._ds, i).decode()
+                for i in range(_lib.qucsdata_count(self._ds))]
+
+    def variables(self) -> dict:
+        '''Returns a dictionary mapping variable names to 'indep' or 'dep'.'''
+        return {_lib.qucsdata_name(self._ds, i).decode():
+                ('indep' if _lib.qucsdata_is_indep(self._ds, i) else 'dep')
+                for i in range(_lib.qucsdata_count(self._ds))}
+
+    def dependencies(self, name: str) -> list:
+        '''Returns the names of the independent variables of a variable.'''
+        idx = self._index(name)
+        return [_lib.qucsdata_dep_name(self._ds, idx, d).decode()
+                for d in range(_lib.qucsdata_dep_count(self._ds, idx))]
+
+    def __getitem__(self, name: str):
+        '''
+        Returns the values of a variable as a read-only numpy array sharing
+        the memory of the library, digital variables as a list of strings.
+        '''
+        if name in self._cache:
+            return self._cache[name]
+        idx = self._index(name)
+        kind = _lib.qucsdata_kind(self._ds, idx)
+        length = _lib.qucsdata_length(self._ds, idx)
+
+        if kind == _DIGITAL:
+            size = ctypes.c_size_t()
+            ptr = _lib.qucsdata_digital(self._ds, idx, ctypes.byref(size))
+            values = [s.decode() for s in ctypes.string_at(ptr, size.value).split(b'\0')[:length]]
+        elif kind in (_REAL, _COMPLEX):
+            doubles = length * (2 if kind == _COMPLEX else 1)
+            ptr = _lib.qucsdata_values(self._ds, idx)
+            if doubles == 0:
+                values = np.zeros(0, dtype=np.complex128 if kind == _COMPLEX else np.float64)
+            else:
+                buf = (ctypes.c_double * doubles).from_address(ctypes.addressof(ptr.contents))
+                buf._owner = self  # keeps the dataset open as long as the array lives
+                values = np.frombuffer(buf, dtype=np.complex128 if kind == _COMPLEX else np.float64)
+                values.flags.writeable = False
+        else:
+            raise ValueError(f'cannot decode variable {name}')
+        self._cache[name] = values
+        return values
+
+
+def read_columns(name: str) -> dict:
+    '''
+    Reads a columnar file written by the dataset export ("*.qcol"). The
+    columns are mapped from the file, not read, so this is fast for files
+    of any size.
+
+    Returns:
+        dict: A dictionary mapping column names to numpy arrays
+    '''
+    with open(name, 'rb') as f:
+        magic, columns, _, rows = struct.unpack('<8sIIQ', f.read(24))
+        if magic != b'QUCSCOL1':
+            raise ValueError(f'{name} is not a columnar dataset file')
+        layout = []
+        for _ in range(columns):
+            kind, size = struct.unpack('<II', f.read(8))
+            layout.append((f.read(size).decode(), kind))
+            f.read((8 - size % 8) % 8)
+        offset = f.tell()
+
+    data = {}
+    for col, kind in layout:
+        dtype = '<c16' if kind == _COMPLEX else '<f8'
+        data[col] = np.memmap(name, dtype=dtype, mode='r', offset=offset, shape=(rows,))
+        offset += rows * np.dtype(dtype).itemsize
+    return data
@@ -82,6 +82,7 @@
 #include "imagewriter.h"
 #include "qucslib_common.h"
 #include "misc.h"
+#include "tracing.h"
 #include "extsimkernels/verilogawriter.h"
 #include "extsimkernels/simsettingsdialog.h"
 //#include "extsimkernels/codemodelgen.h"
@@ -578,6 +579,7 @@ void QucsApp::initView()
 // Put all available libraries into ComboBox.
 void QucsApp::fillLibrariesTreeView ()
 {
+    QUCS_TRACE("QucsApp::fillLibrariesTreeView");
     QList<QTreeWidgetItem *> topitems;
 
     libTreeWidget->clear();
@@ -867,7 +869,6 @@ void QucsApp::slotSetCompView (int index)
 
   Comps = Category::getModules(item);
   QString Name;
-  pInfoFunc Infos = 0;
 
   // if something was registered dynamically, get and draw icons into dock
   if (item == QObject::tr("verilog-a user devices")) {
@@ -913,25 +914,13 @@ void QucsApp::slotSetCompView (int index)
     }
   } else {
     // static components
-    char * File;
     // Populate list of component bitmaps
     compIdx = 0;
     QList<Module *>::const_iterator it;
     for (it = Comps.constBegin(); it != Comps.constEnd(); it++) {
-      Infos = (*it)->info;
-      if (Infos) {
-        /// \todo warning: expression result unused, can we rewrite this?
-        //(void) *((*it)->info) (Name, File, false);
-        Component* c = (Component*)Infos(Name, File, true);
-        if (c) delete c;
-        QString icon_path = misc::getIconPath(QString (File));
-        QListWidgetItem *icon = new QListWidgetItem(Name);
-        if (QFileInfo::exists(icon_path)) {
-            icon->setIcon(QPixmap(icon_path));
-        } else {
-            icon->setIcon(*(*it)->icon);
-        }
-        icon->setToolTip(Name);
+      if ((*it)->info) {
+        QListWidgetItem *icon = new QListWidgetItem((*it)->getIcon(), (*it)->name);
+        icon->setToolTip((*it)->name);
         icon->setData(Qt::UserRole + 1, catIdx);
         icon->setData(Qt::UserRole + 2, compIdx);
         CompComps->addItem(icon);
@@ -963,43 +952,15 @@ void QucsApp::slotSearchComponent(const QString &searchText)
     CompChoose->setCurrentIndex(0); // make sure the "Search results" category is selected
     editText->setHidden (true); // disable text edit of component property
 
-    //traverse all component and match searchText with name
-    QString Name;
-    char * File;
-    QList<Module *> Comps;
-
+    // look up the prebuilt name index of all modules
     QStringList cats = Category::getCategories ();
-    int catIdx = 0;
-    for (const QString& it : cats) {
-      // this will go also over the "verilog-a user devices" category, if present
-      //   but since modules there have no 'info' function it won't handle them
-      Comps = Category::getModules(it);
-      QList<Module *>::const_iterator modit;
-      int compIdx = 0;
-      for (modit = Comps.constBegin(); modit != Comps.constEnd(); modit++) {
-        if ((*modit)->info) {
-          /// \todo warning: expression result unused, can we rewrite this?
-          (void) *((*modit)->info) (Name, File, false);
-
-          if((Name.indexOf(searchText, 0, Qt::CaseInsensitive)) != -1) {
-            //match
-            QString icon_path = misc::getIconPath(QString (File));
-            QListWidgetItem *icon = new QListWidgetItem(Name);
-            if (QFileInfo::exists(icon_path)) {
-                icon->setIcon(QPixmap(icon_path));
-            } else {
-                icon->setIcon(*(*modit)->icon);
-            }
-            icon->setToolTip(it + ": " + Name);
-            // add component category and module indexes to the icon
-            icon->setData(Qt::UserRole + 1, catIdx);
-            icon->setData(Qt::UserRole + 2, compIdx);
-            CompComps->addItem(icon);
-          }
-        }
-        compIdx++;
-      }
-      catIdx++;
+    for (Module *m : Module::findModules(searchText)) {
+      QListWidgetItem *icon = new QListWidgetItem(m->getIcon(), m->name);
+      icon->setToolTip(cats.at(m->catIdx) + ": " + m->name);
+      // add component category and module indexes to the icon
+      icon->setData(Qt::UserRole + 1, m->catIdx);
+      icon->setData(Qt::UserRole + 2, m->compIdx);
+      CompComps->addItem(icon);
     }
     // the "verilog-a user devices" is the last category, if present
     QMapIterator<QString, QString> i(Module::vaComponents);
@@ -1034,7 +995,7 @@ void QucsApp::slotSearchComponent(const QString &searchText)
         QListWidgetItem *icon = new QListWidgetItem(vaIcon, vaName);
         icon->setToolTip(tr("verilog-a user devices") + ": " + vaName);
         // Verilog-A is the last category
-        icon->setData(Qt::UserRole + 1, catIdx-1);
+        icon->setData(Qt::UserRole + 1, cats.size()-1);
         icon->setData(Qt::UserRole + 2, compIdx);
         CompComps->addItem(icon);
       }
@@ -354,7 +354,7 @@ public:
           *showMsg, *showNet, *alignTop, *alignBottom, *alignLeft, *alignRight,
           *distrHor, *distrVert, *selectAll, *callMatch, *changeProps,
           *addToProj, *editFind, *insEntity, *selectMarker,
-          *createLib, *callConverter, *graph2csv,
+          *createLib, *callConverter, *graph2csv, *exportDataset,
           *callAtt, *centerHor, *centerVert, *loadModule, *buildModule, *callPwrComb, *callRFLayout, *callSPAR_Viewer;
 
   QAction *helpQucsIndex;
@@ -428,6 +428,7 @@ private slots:
   void slotCreateLib();
   void slotImportData();
   void slotExportGraphAsCsv();
+  void slotExportDataset();
   void slotUpdateRecentFiles();
   void slotClearRecentFiles();
   void slotLoadModule();
@@ -40,6 +40,7 @@
 #include <QMutableHashIterator>
 #include <QListWidget>
 #include <QDesktopServices>
+#include <QPlainTextEdit>
 
 #include "portsymbol.h"
 #include "projectView.h"
@@ -59,8 +60,10 @@
 #include "dialogs/librarydialog.h"
 #include "dialogs/loaddialog.h"
 #include "dialogs/importdialog.h"
+#include "dialogs/exportdatasetdialog.h"
 #include "dialogs/aboutdialog.h"
 #include "module.h"
+#include "buildcache.h"
 
 #include "extsimkernels/xyce.h"
 
@@ -1409,11 +1412,15 @@ void QucsApp::slotExportGraphAsCsv()
   // First output the names of independent and dependent variables.
   for(unsigned ii=0; (pD=g->axis(ii)); ++ii)
     Stream << '\"' << pD->Var << "\";";
-  Stream << "\"r " << g->Var << "\";\"i " << g->Var << "\"\n";
+  if(g->cPointsY)
+    Stream << "\"r " << g->Var << "\";\"i " << g->Var << "\"\n";
+  else   // digital variable
+    Stream << '\"' << g->Var << "\"\n";
 
 
   int n, m;
   double *py = g->cPointsY;
+  int run = 0;
   int Count = g->countY * g->axis(0)->count;
   for(n = 0; n < Count; n++) {
     m = n;
@@ -1422,14 +1429,40 @@ void QucsApp::slotExportGraphAsCsv()
       m /= pD->count;
     }
 
-    Stream << *(py) << ';' << *(py+1) << '\n';
-    py += 2;
+    if(py) {
+      Stream << *(py) << ';' << *(py+1) << '\n';
+      py += 2;
+    }
+    else {
+      if(n >= g->cDigital.runEnd(run))  run++;
+      Stream << g->cDigital.value(run) << '\n';
+    }
   }
 
   File.close();
 }
 
 
+// -----------------------------------------------------------
+void QucsApp::slotExportDataset()
+{
+  slotHideEdit(); // disable text edit of component property
+
+  QWidget *w = DocumentTab->currentWidget();
+  if (isTextDocument(w)) {
+    QMessageBox::critical(this, tr("Error"), tr("Please open a schematic or data display first!"));
+    return;
+  }
+  Schematic *Doc = (Schematic*)w;
+  QFileInfo Info(Doc->getDocName());
+  QString DataSet = Info.absolutePath() + QDir::separator() + Doc->getDataSet();
+
+  ExportDatasetDialog *Dia = new ExportDatasetDialog(DataSet, this);
+  Dia->setAttribute(Qt::WA_DeleteOnClose);
+  Dia->exec();
+}
+
+
 void QucsApp::slotOpenRecent()
 {
   QAction *action = qobject_cast<QAction *>(sender());
@@ -1563,6 +1596,10 @@ void QucsApp::slotLoadModule()
  * Run the va2cpp
  * Run the cpp2lib
  *
+ * Both steps run asynchronously, the GUI stays responsive. The libraries
+ * are kept in a BuildCache, an unchanged module is restored from it
+ * instead of being rebuilt.
+ *
  * TODO
  * - split into two actions, elaborate and compile?
  * - collect, parse and display output of make
@@ -1603,12 +1640,6 @@ void QucsApp::slotBuildModule()
 
     QString workDir = QucsSettings.QucsWorkDir.absolutePath();
 
-    // need to cd into project to make sure output is dropped there?
-    // need to cd - into previous location?
-    QDir::setCurrent(workDir);
-
-    QProcess *builder = new QProcess();
-    builder->setProcessChannelMode(QProcess::MergedChannels);
     // get current va document
     QucsDoc *Doc = getDoc();
     QString vaModule = Doc->fileBase(Doc->getDocName());
@@ -1628,66 +1659,108 @@ void QucsApp::slotBuildModule()
               << QStringLiteral("PREFIX=%1").arg(QDir::toNativeSeparators(prefix.absolutePath()))
               << QStringLiteral("MODEL=%1").arg(vaModule);
 
+    QStringList libArguments;
+    libArguments << "-f" <<  QDir::toNativeSeparators(include.absoluteFilePath("cpp2lib.makefile"))
+                 << QStringLiteral("PREFIX=\"%1\"").arg(QDir::toNativeSeparators(prefix.absolutePath()))
+                 << QStringLiteral("PROJDIR=\"%1\"").arg(QDir::toNativeSeparators(workDir))
+                 << QStringLiteral("MODEL=%1").arg(vaModule);
+
+    // skip the build if nothing has changed since the last one
+    static const QRegularExpression va_include_rx("^\\s*`include\\s+\"([^\"]+)\"");
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QSet<QString> visited;
+    BuildCache::hashSource(hash, Doc->getDocName(), va_include_rx, visited);
+    BuildCache::hashSource(hash, include.absoluteFilePath("va2cpp.makefile"), va_include_rx, visited);
+    BuildCache::hashSource(hash, include.absoluteFilePath("cpp2lib.makefile"), va_include_rx, visited);
+    BuildCache::hashExecutable(hash, admsXml);
+    BuildCache::hashExecutable(hash, make);
+    hash.addData(Arguments.join(" ").toUtf8());
+    hash.addData(libArguments.join(" ").toUtf8());
+    QString key = hash.result().toHex();
+
+    BuildCache cache("admsxml");
+    if (cache.restore(key, QDir(workDir))) {
+        messageDock->admsOutput->appendPlainText(
+            tr("%1 is up to date, library restored from build cache.\n").arg(vaModule));
+        messageDock->msgDock->show();
+        return;
+    }
+
+    // need to cd into project to make sure output is dropped there?
+    // need to cd - into previous location?
+    QDir::setCurrent(workDir);
+
+    QProcess *builder = new QProcess(this);
+    builder->setProcessChannelMode(QProcess::MergedChannels);
+    builder->setWorkingDirectory(workDir);
+
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     env.insert("PATH", env.value("PATH") );
     builder->setProcessEnvironment(env);
 
-    // prepend command to log
-    QString cmdString = QStringLiteral("%1 %2\n").arg(make, Arguments.join(" "));
-    messageDock->admsOutput->appendPlainText(cmdString);
-
-    qDebug() << "Command :" << make << Arguments.join(" ");
-    builder->start(make, Arguments);
+    QDateTime started = QDateTime::currentDateTime();
+    buildModule->setEnabled(false);
 
     // admsXml seems to communicate all via stdout, or is it because of make?
-    QString vaStatus;
-    if (!builder->waitForFinished()) {
-        vaStatus = builder->errorString();
-        qDebug() << "Make failed:" << vaStatus;
-    }
-    else {
-        vaStatus = builder->readAll();
-        qDebug() << "Make stdout"  << vaStatus;
-    }
-
-    //build libs
-    qDebug() << "\nbuild libs\n";
-
-    Arguments.clear();
+    connect(builder, &QProcess::readyRead, this, [this, builder]() {
+        QPlainTextEdit *out = builder->property("step").toInt() == 0 ?
+                    messageDock->admsOutput : messageDock->cppOutput;
+        out->appendPlainText(QString::fromLocal8Bit(builder->readAll()));
+    });
+    connect(builder, &QProcess::errorOccurred, this, [this, builder](QProcess::ProcessError err) {
+        if (err != QProcess::FailedToStart) return;
+        qDebug() << "Make failed:" << builder->errorString();
+        messageDock->admsOutput->appendPlainText(builder->errorString());
+        buildModule->setEnabled(true);
+        builder->deleteLater();
+    });
+    connect(builder, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, builder, make, libArguments, workDir, vaModule, started, cache, key]
+            (int exitCode, QProcess::ExitStatus exitStatus) mutable {
+        if (builder->property("step").toInt() == 0) {
+            //build libs
+            qDebug() << "\nbuild libs\n";
+            builder->setProperty("step", 1);
+            messageDock->cppOutput->appendPlainText(
+                QStringLiteral("%1 %2\n").arg(make, libArguments.join(" ")));
+            builder->start(make, libArguments);
+            return;
+        }
 
-    Arguments << "-f" <<  QDir::toNativeSeparators(include.absoluteFilePath("cpp2lib.makefile"))
-              << QStringLiteral("PREFIX=\"%1\"").arg(QDir::toNativeSeparators(prefix.absolutePath()))
-              << QStringLiteral("PROJDIR=\"%1\"").arg(QDir::toNativeSeparators(workDir))
-              << QStringLiteral("MODEL=%1").arg(vaModule);
+        if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+            // keep the libraries produced by this build
+            QStringList libs;
+            QDir dir(workDir);
+            for (const QFileInfo &lib : dir.entryInfoList(
+                     QStringList() << vaModule + ".*" << "lib" + vaModule + ".*", QDir::Files)) {
+                if (QLibrary::isLibrary(lib.fileName()) && lib.lastModified() >= started)
+                    libs.append(lib.absoluteFilePath());
+            }
+            cache.store(key, libs);
+        }
+        buildModule->setEnabled(true);
+        builder->deleteLater();
+    });
 
     // prepend command to log
-    cmdString = QStringLiteral("%1 %2\n").arg(make, Arguments.join(" "));
-    messageDock->cppOutput->appendPlainText(cmdString);
+    QString cmdString = QStringLiteral("%1 %2\n").arg(make, Arguments.join(" "));
+    messageDock->admsOutput->appendPlainText(cmdString);
 
+    qDebug() << "Command :" << make << Arguments.join(" ");
+    builder->setProperty("step", 0);
     builder->start(make, Arguments);
 
-    QString cppStatus;
-
-    if (!builder->waitForFinished()) {
-        cppStatus = builder->errorString();
-        qDebug() << "Make failed:" << cppStatus;
-    }
-    else {
-        cppStatus = builder->readAll();
-        qDebug() << "Make output:" << cppStatus;
-    }
-    delete builder;
-
-    // push make output to message dock
-    messageDock->admsOutput->appendPlainText(vaStatus);
-    messageDock->cppOutput->appendPlainText(cppStatus);
-
     // shot the message docks
     messageDock->msgDock->show();
 
 }
 
 
+/*!
+ * \brief QucsApp::buildWithOpenVAF compiles the current Verilog-A document
+ *        into an OSDI module next to it. OpenVAF runs asynchronously, an
+ *        unchanged module is restored from the build cache.
+ */
 void QucsApp::buildWithOpenVAF()
 {
     messageDock->builderTabs->setTabIcon(0,QPixmap());
@@ -1698,22 +1771,64 @@ void QucsApp::buildWithOpenVAF()
     QString workDir = QucsSettings.QucsWorkDir.absolutePath();
     QDir::setCurrent(workDir);
 
-    QProcess *builder = new QProcess();
-    builder->setProcessChannelMode(QProcess::MergedChannels);
     // get current va document
     QucsDoc *Doc = getDoc();
     QString vaModule = Doc->getDocName();
+    QFileInfo vaInfo(vaModule);
+    QString osdiFile = vaInfo.absoluteDir().filePath(vaInfo.completeBaseName() + ".osdi");
 
     QString openVAF = QucsSettings.OpenVAFExecutable;
 
-    // admsXml emits C++
     QStringList Arguments;
     Arguments<<vaModule;
 
+    // skip the build if nothing has changed since the last one
+    static const QRegularExpression va_include_rx("^\\s*`include\\s+\"([^\"]+)\"");
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    QSet<QString> visited;
+    BuildCache::hashSource(hash, vaModule, va_include_rx, visited);
+    BuildCache::hashExecutable(hash, openVAF);
+    hash.addData(Arguments.join(" ").toUtf8());
+    QString key = hash.result().toHex();
+
+    BuildCache cache("openvaf");
+    if (cache.restore(key, vaInfo.absoluteDir())) {
+        messageDock->admsOutput->appendPlainText(
+            tr("%1 is up to date, restored from build cache.\n").arg(osdiFile));
+        messageDock->msgDock->show();
+        return;
+    }
+
+    QProcess *builder = new QProcess(this);
+    builder->setProcessChannelMode(QProcess::MergedChannels);
+    builder->setWorkingDirectory(workDir);
+
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     env.insert("PATH", env.value("PATH") );
     builder->setProcessEnvironment(env);
 
+    buildModule->setEnabled(false);
+
+    connect(builder, &QProcess::readyRead, this, [this, builder]() {
+        messageDock->admsOutput->appendPlainText(QString::fromLocal8Bit(builder->readAll()));
+    });
+    connect(builder, &QProcess::errorOccurred, this, [this, builder](QProcess::ProcessError err) {
+        if (err != QProcess::FailedToStart) return;
+        qDebug() << "OpenVAF failed:" << builder->errorString();
+        messageDock->admsOutput->appendPlainText(builder->errorString());
+        buildModule->setEnabled(true);
+        builder->deleteLater();
+    });
+    connect(builder, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, builder, osdiFile, cache, key]
+            (int exitCode, QProcess::ExitStatus exitStatus) mutable {
+        if (exitStatus == QProcess::NormalExit && exitCode == 0 && QFile::exists(osdiFile)) {
+            cache.store(key, QStringList(osdiFile));
+        }
+        buildModule->setEnabled(true);
+        builder->deleteLater();
+    });
+
     // prepend command to log
     QString cmdString = QStringLiteral("%1 %2\n").arg(openVAF, Arguments.join(" "));
     messageDock->admsOutput->appendPlainText(cmdString);
@@ -1721,22 +1836,6 @@ void QucsApp::buildWithOpenVAF()
     qDebug() << "Command :" << openVAF << Arguments.join(" ");
     builder->start(openVAF, Arguments);
 
-    // admsXml seems to communicate all via stdout, or is it because of make?
-    QString vaStatus;
-    if (!builder->waitForFinished()) {
-        vaStatus = builder->errorString();
-        qDebug() << "OpenVAF failed:" << vaStatus;
-    }
-    else {
-        vaStatus = builder->readAll();
-        qDebug() << "OpenVAF stdout"  << vaStatus;
-    }
-
-    delete builder;
-
-    // push make output to message dock
-    messageDock->admsOutput->appendPlainText(vaStatus);
-
     // shot the message docks
     messageDock->msgDock->show();
 }
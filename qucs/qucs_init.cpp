@@ -341,6 +341,11 @@ void QucsApp::initActions()
   graph2csv->setWhatsThis(tr("Export to CSV\n\nConvert graph data to CSV file"));
   connect(graph2csv, SIGNAL(triggered()), SLOT(slotExportGraphAsCsv()));
 
+  exportDataset = new QAction(tr("Export &dataset..."), this);
+  exportDataset->setStatusTip(tr("Export variables of the dataset to CSV or columnar files"));
+  exportDataset->setWhatsThis(tr("Export dataset\n\nWrite variables of the current dataset to CSV or columnar binary files"));
+  connect(exportDataset, SIGNAL(triggered()), SLOT(slotExportDataset()));
+
   buildModule = new QAction(tr("Build Verilog-A module..."), this);
   buildModule->setStatusTip(tr("Run admsXml and C++ compiler"));
   buildModule->setWhatsThis(tr("Build Verilog-A module\nRuns amdsXml and C++ compiler"));
@@ -759,6 +764,7 @@ void QucsApp::initMenuBar()
   projMenu->addAction(createLib);
   projMenu->addSeparator();
   projMenu->addAction(graph2csv);
+  projMenu->addAction(exportDataset);
   // TODO only enable if document is VA file
   if (QucsSettings.DefaultSimulator == spicecompat::simQucsator ||
       QucsSettings.DefaultSimulator == spicecompat::simNgspice) {
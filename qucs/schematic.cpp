@@ -40,6 +40,7 @@
 #include <QPoint>
 #include <QPrinter>
 #include <QRect>
+#include <QRegion>
 #include <QTextStream>
 #include <QUrl>
 #include <QWheelEvent>
@@ -59,6 +60,7 @@
 #include "textdoc.h"
 
 #include "misc.h"
+#include "tracing.h"
 
 // just dummies for empty lists
 Q3PtrList<Wire> SymbolWires;
@@ -515,31 +517,57 @@ void Schematic::drawElements(QPainter* painter) {
 
 void Schematic::drawDcBiasPoints(QPainter* painter) {
     painter->save();
-    int x, y, z;
     for (auto* pn : *a_Nodes) {
         if (pn->Name.isEmpty())
             continue;
-        x = pn->cx;
-        y = pn->cy + 4;
-        z = pn->x1;
-        if (z & 1)
-            x -= painter->fontMetrics().boundingRect(pn->Name).width();
-        if (!(z & 2)) {
-            y -= (painter->fontMetrics().lineSpacing() >> 1) + 4;
-            if (z & 1)
-                x -= 4;
-            else
-                x += 4;
-        }
-        if (z & 0x10)
+        if (pn->x1 & 0x10)
             painter->setPen(Qt::darkGreen); // green for currents
         else
             painter->setPen(Qt::blue); // blue for voltages
-        painter->drawText(x, y, pn->Name);
+        painter->drawText(biasTextPosition(pn, pn->Name, painter->fontMetrics()), pn->Name);
     }
     painter->restore();
 }
 
+// Baseline start of the DC bias text of a node, placed as told by the
+// flags in "x1": 1 = left of the node, 2 = on a horizontal wire.
+QPoint Schematic::biasTextPosition(const Node* pn, const QString& text, const QFontMetrics& metrics) {
+    int x = pn->cx;
+    int y = pn->cy + 4;
+    int z = pn->x1;
+    if (z & 1)
+        x -= metrics.boundingRect(text).width();
+    if (!(z & 2)) {
+        y -= (metrics.lineSpacing() >> 1) + 4;
+        if (z & 1)
+            x -= 4;
+        else
+            x += 4;
+    }
+    return QPoint{x, y};
+}
+
+void Schematic::updateBiasPoints(const QList<QPair<Node*, QString>>& changed) {
+    if (a_showBias <= 0)
+        return;
+
+    // the texts are drawn in model coordinates with the schematic font
+    QFontMetrics metrics(QucsSettings.font);
+    QRegion dirty;
+    for (const auto& entry : changed) {
+        for (const QString& text : {entry.second, entry.first->Name}) {
+            if (text.isEmpty())
+                continue;
+            QRect r = metrics.boundingRect(text).translated(biasTextPosition(entry.first, text, metrics));
+            // a little more for antialiasing
+            dirty += QRect{modelToViewport(r.topLeft()), modelToViewport(r.bottomRight())}
+                         .adjusted(-2, -2, 2, 2);
+        }
+    }
+    if (!dirty.isEmpty())
+        viewport()->update(dirty);
+}
+
 void Schematic::drawPostPaintEvents(QPainter* painter) {
     painter->save();
     /*
@@ -725,11 +753,13 @@ void Schematic::contentsMouseDoubleClickEvent(QMouseEvent *Event)
 }
 
 void Schematic::print(QPrinter*, QPainter* painter, bool printAll,
-                      bool fitToPage, QMargins margins) {
+                      bool fitToPage, QMargins margins, QSize page) {
     painter->save();
 
-    const QRectF pageSize{0, 0, static_cast<double>(painter->device()->width()),
-                          static_cast<double>(painter->device()->height())};
+    if (page.isEmpty())
+        page = QSize{painter->device()->width(), painter->device()->height()};
+    const QRectF pageSize{0, 0, static_cast<double>(page.width()),
+                          static_cast<double>(page.height())};
 
     QRect printedArea = printAll ? allBoundingRect() : sizeOfSelection();
 
@@ -1614,9 +1644,12 @@ bool Schematic::mirrorYComponents()
 // Updates the graph data of all diagrams (load from data files).
 void Schematic::reloadGraphs()
 {
+    QUCS_TRACE("Schematic::reloadGraphs");
     QFileInfo Info(a_DocName);
+    Graph::holdDataSet(true);   // the diagrams share one read of the dataset
     for (Diagram *pd = a_Diagrams->first(); pd != 0; pd = a_Diagrams->next())
         pd->loadGraphData(Info.path() + QDir::separator() + a_DataSet);
+    Graph::holdDataSet(false);
 }
 
 // Copy function,
@@ -2331,7 +2364,24 @@ void Schematic::contentsWheelEvent(QWheelEvent *Event)
             Event->pos().x(),
             Event->pos().y()};
 #endif
-        zoomAroundPoint(scaleCoef, pointer);
+        // Over a timing diagram the wheel zooms its time axis instead.
+        const QPoint inModel = viewportToModel(pointer);
+        TimingDiagram *timing = nullptr;
+        for (Diagram *pd = a_Diagrams->last(); pd != nullptr; pd = a_Diagrams->prev()) {
+            if (pd->Name == "Time" && pd->getSelected(inModel.x(), inModel.y())) {
+                timing = static_cast<TimingDiagram *>(pd);
+                break;
+            }
+        }
+
+        if (timing) {
+            if (timing->zoom(1.0 / scaleCoef, inModel.x() - timing->cx)) {
+                setChanged(true, true, 'm'); // 'm' = only the first time
+                viewport()->update();
+            }
+        } else {
+            zoomAroundPoint(scaleCoef, pointer);
+        }
     }
     // Scroll vertically
     else {
@@ -29,6 +29,7 @@
 
 #include "wire.h"
 #include "node.h"
+#include "netindex.h"
 #include "qucsdoc.h"
 #include "diagrams/diagram.h"
 #include "paintings/painting.h"
@@ -36,7 +37,10 @@
 
 #include "qt3_compat/qt_compat.h"
 #include "qt3_compat/q3scrollview.h"
+#include <QFontMetrics>
+#include <QPair>
 #include <QVector>
+#include <QHash>
 #include <QStringList>
 #include <QFileInfo>
 
@@ -83,7 +87,9 @@ public:
 
   void setName(const QString&);
   void setChanged(bool, bool fillStack=false, char Op='*');
-  void print(QPrinter*, QPainter*, bool printAll, bool fitToPage, QMargins margins={});
+  // "page" is the size painted on, that of the paint device if empty
+  void print(QPrinter*, QPainter*, bool printAll, bool fitToPage, QMargins margins={},
+             QSize page={});
 
   void paintSchToViewpainter(QPainter* painter, bool printAll);
 
@@ -155,6 +161,13 @@ public:
   */
   QPoint viewportToModel(const QPoint& viewportCoordinates);
 
+  /**
+    Repaints the DC bias text of the given nodes only. Each node's text
+    is given as it was before it changed, so the old and new areas are
+    both updated.
+  */
+  void updateBiasPoints(const QList<QPair<Node*, QString>>& changed);
+
   /**
     Given coordinates of a point on the view plane (schematic's canvas), this method
     returns coordinates of a corresponding point on the model plane.
@@ -415,6 +428,7 @@ private:
   double renderModel(double scale, QRect newModelBounds, QPoint modelPlaneCoords, QPoint viewportCoords);
   void drawElements(QPainter* painter);
   void drawDcBiasPoints(QPainter* painter);
+  static QPoint biasTextPosition(const Node* pn, const QString& text, const QFontMetrics& metrics);
   void drawPostPaintEvents(QPainter* painter);
   void paintFrame(QPainter* painter);
   void drawGrid(QPainter* painter);
@@ -508,6 +522,8 @@ public:
   bool isDigitalCircuit();
   bool loadDocument();
   void highlightWireLabels (void);
+  // Nets of the document nodes, brought up to date with the wiring.
+  const NetIndex& nets();
   void clearSignalsAndFileList();
   void clearSignals();
 
@@ -520,6 +536,9 @@ private:
   int  saveDocument();
 
   bool loadProperties(QTextStream*);
+  QHash<quint64, Node*> a_nodeIndex;  // node lookup by position while loading
+  void buildNodeIndex();
+  Node* loadedNodeAt(int x, int y);
   void simpleInsertComponent(Component*);
   bool loadComponents(QTextStream*, Q3PtrList<Component> *List=0);
   void simpleInsertWire(Wire*);
@@ -539,6 +558,7 @@ private:
   static void createNodeSet(QStringList&, int&, Conductor*, Node*);
   void throughAllNodes(bool, QStringList&, int&);
   void propagateNode(QStringList&, int&, Node*);
+  bool nameNets();
   void collectDigitalSignals(void);
   bool giveNodeNames(QTextStream *, int&, QStringList&, QPlainTextEdit*, int);
   void beginNetlistDigital(QTextStream &);
@@ -547,6 +567,7 @@ private:
 
   DigMap a_Signals; // collecting node names for VHDL signal declarations
   QStringList a_PortTypes;
+  NetIndex a_Nets;
 
   bool a_isAnalog;
   bool a_isVerilog;
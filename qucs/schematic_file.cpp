@@ -42,6 +42,7 @@
 #include "components/sparamfile.h"
 #include "module.h"
 #include "misc.h"
+#include "tracing.h"
 #include "extsimkernels/abstractspicekernel.h"
 #include "extsimkernels/s2spice.h"
 #include "osdi/osdi_0_3.h"
@@ -830,6 +831,34 @@ bool Schematic::loadProperties(QTextStream *stream)
   return false;
 }
 
+// ---------------------------------------------------
+static inline quint64 nodeKey(int x, int y)
+{
+  return (quint64(quint32(x)) << 32) | quint32(y);
+}
+
+// ---------------------------------------------------
+// Index the existing nodes by position. Searching the node list for every
+// port and wire end made loading large schematics quadratic.
+void Schematic::buildNodeIndex()
+{
+  a_nodeIndex.clear();
+  a_nodeIndex.reserve(a_DocNodes.count());
+  for(Node *pn = a_DocNodes.first(); pn != 0; pn = a_DocNodes.next()) {
+    quint64 key = nodeKey(pn->cx, pn->cy);
+    if(!a_nodeIndex.contains(key))  // keep the first node like the list search
+      a_nodeIndex.insert(key, pn);
+  }
+}
+
+// ---------------------------------------------------
+// Returns the node at position (x,y) or null, uses the index built by
+// buildNodeIndex().
+Node* Schematic::loadedNodeAt(int x, int y)
+{
+  return a_nodeIndex.value(nodeKey(x, y), nullptr);
+}
+
 // ---------------------------------------------------
 // Inserts a component without performing logic for wire optimization.
 void Schematic::simpleInsertComponent(Component *c)
@@ -842,20 +871,19 @@ void Schematic::simpleInsertComponent(Component *c)
     y = pp->y+c->cy;
 
     // check if new node lies upon existing node
-    for(pn = a_DocNodes.first(); pn != 0; pn = a_DocNodes.next())
-      if(pn->cx == x) if(pn->cy == y) {
-        if (!pn->DType.isEmpty()) {
-          pp->Type = pn->DType;
-        }
-        if (!pp->Type.isEmpty()) {
-          pn->DType = pp->Type;
-        }
-        break;
+    pn = loadedNodeAt(x, y);
+    if(pn) {
+      if (!pn->DType.isEmpty()) {
+        pp->Type = pn->DType;
       }
-
-    if(pn == nullptr) { // create new node, if no existing one lies at this position
+      if (!pp->Type.isEmpty()) {
+        pn->DType = pp->Type;
+      }
+    }
+    else { // create new node, if no existing one lies at this position
       pn = new Node(x, y);
       a_DocNodes.append(pn);
+      a_nodeIndex.insert(nodeKey(x, y), pn);
     }
     pn->connect(c);  // connect schematic node to component node
     if (!pp->Type.isEmpty()) {
@@ -873,15 +901,22 @@ bool Schematic::loadComponents(QTextStream *stream, Q3PtrList<Component> *List)
 {
   QString Line, cstr;
   Component *c;
+  if(!List) buildNodeIndex();
   while(!stream->atEnd()) {
     Line = stream->readLine();
-    if(Line.at(0) == '<') if(Line.at(1) == '/') return true;
+    if(Line.at(0) == '<') if(Line.at(1) == '/') {
+      a_nodeIndex.clear();
+      return true;
+    }
     Line = Line.trimmed();
     if(Line.isEmpty()) continue;
 
     /// \todo enable user to load partial schematic, skip unknown components
     c = getComponentFromName(Line, this);
-    if(!c) return false;
+    if(!c) {
+      a_nodeIndex.clear();
+      return false;
+    }
 
     if(List) {  // "paste" ?
       int z;
@@ -893,6 +928,7 @@ bool Schematic::loadComponents(QTextStream *stream, Q3PtrList<Component> *List)
     else  simpleInsertComponent(c);
   }
 
+  a_nodeIndex.clear();
   QMessageBox::critical(0, QObject::tr("Error"),
 	   QObject::tr("Format Error:\n'Component' field is not closed!"));
   return false;
@@ -904,12 +940,12 @@ void Schematic::simpleInsertWire(Wire *pw)
 {
   Node *pn;
   // check if first wire node lies upon existing node
-  for(pn = a_DocNodes.first(); pn != 0; pn = a_DocNodes.next())
-    if(pn->cx == pw->x1) if(pn->cy == pw->y1) break;
+  pn = loadedNodeAt(pw->x1, pw->y1);
 
   if(!pn) {   // create new node, if no existing one lies at this position
     pn = new Node(pw->x1, pw->y1);
     a_DocNodes.append(pn);
+    a_nodeIndex.insert(nodeKey(pw->x1, pw->y1), pn);
   }
 
   if(pw->x1 == pw->x2) if(pw->y1 == pw->y2) {
@@ -925,12 +961,12 @@ void Schematic::simpleInsertWire(Wire *pw)
   pw->Port1 = pn;
 
   // check if second wire node lies upon existing node
-  for(pn = a_DocNodes.first(); pn != 0; pn = a_DocNodes.next())
-    if(pn->cx == pw->x2) if(pn->cy == pw->y2) break;
+  pn = loadedNodeAt(pw->x2, pw->y2);
 
   if(!pn) {   // create new node, if no existing one lies at this position
     pn = new Node(pw->x2, pw->y2);
     a_DocNodes.append(pn);
+    a_nodeIndex.insert(nodeKey(pw->x2, pw->y2), pn);
   }
   pn->connect(pw);  // connect schematic node to component node
   pw->Port2 = pn;
@@ -943,9 +979,13 @@ bool Schematic::loadWires(QTextStream *stream, Q3PtrList<Element> *List)
 {
   Wire *w;
   QString Line;
+  if(!List) buildNodeIndex();
   while(!stream->atEnd()) {
     Line = stream->readLine();
-    if(Line.at(0) == '<') if(Line.at(1) == '/') return true;
+    if(Line.at(0) == '<') if(Line.at(1) == '/') {
+      a_nodeIndex.clear();
+      return true;
+    }
     Line = Line.trimmed();
     if(Line.isEmpty()) continue;
 
@@ -955,6 +995,7 @@ bool Schematic::loadWires(QTextStream *stream, Q3PtrList<Element> *List)
       QMessageBox::critical(0, QObject::tr("Error"),
       QObject::tr("Format Error:\nWrong 'wire' line format!"));
       delete w;
+      a_nodeIndex.clear();
       return false;
     }
     if(List) {
@@ -970,6 +1011,7 @@ bool Schematic::loadWires(QTextStream *stream, Q3PtrList<Element> *List)
     else simpleInsertWire(w);
   }
 
+  a_nodeIndex.clear();
   QMessageBox::critical(0, QObject::tr("Error"),
   QObject::tr("Format Error:\n'Wire' field is not closed!"));
   return false;
@@ -1073,6 +1115,7 @@ bool Schematic::loadPaintings(QTextStream *stream, Q3PtrList<Painting> *List)
  */
 bool Schematic::loadDocument()
 {
+  QUCS_TRACE("Schematic::loadDocument");
   QFile file(a_DocName);
   if(!file.open(QIODevice::ReadOnly)) {
     /// \todo implement unified error/warning handling GUI and CLI
@@ -1311,6 +1354,44 @@ void Schematic::throughAllNodes(bool User, QStringList& Collect,
   }
 }
 
+// ---------------------------------------------------
+// Names all nodes net by net from the net index instead of flooding the
+// wires like throughAllNodes(). Returns false without touching any node
+// if a net carries two different names; the flood decides then which
+// nodes get which name.
+bool Schematic::nameNets()
+{
+  a_Nets.update(a_DocNodes, a_DocWires);
+  std::vector<QString> Names(a_Nets.count());
+
+  int i = 0;
+  for (Node *pn : a_DocNodes) {
+    QString &Name = Names[a_Nets.net(i++)];
+    if (pn->Name.isEmpty()) continue;
+    if (Name.isEmpty()) Name = pn->Name;
+    else if (Name != pn->Name) return false;
+  }
+
+  int z = 0;
+  i = 0;
+  for (Node *pn : a_DocNodes) {
+    QString &Name = Names[a_Nets.net(i++)];
+    if (Name.isEmpty()) {   // create numbered node name
+      // VHDL names must not begin with '_'
+      Name = (a_isAnalog ? "_net" : "net_net") + QString::number(z++);
+    }
+    pn->Name = Name;
+    pn->State = 1;
+  }
+  return true;
+}
+
+const NetIndex& Schematic::nets()
+{
+  a_Nets.update(a_DocNodes, a_DocWires);
+  return a_Nets;
+}
+
 // ----------------------------------------------------------
 // Checks whether this file is a qucs file and whether it is an subcircuit.
 // It returns the number of subcircuit ports.
@@ -1676,6 +1757,10 @@ bool Schematic::throughAllComps(QTextStream *stream, int& countInit,
 bool Schematic::giveNodeNames(QTextStream *stream, int& countInit,
                    QStringList& Collect, QPlainTextEdit *ErrText, int NumPorts)
 {
+  // initial values of labels become nodesets in the order the wires
+  // are flooded, only throughAllNodes() knows that order
+  bool nodeSets = false;
+
   // delete the node names
   for(Node *pn = a_DocNodes.first(); pn != 0; pn = a_DocNodes.next()) {
     pn->State = 0;
@@ -1684,6 +1769,7 @@ bool Schematic::giveNodeNames(QTextStream *stream, int& countInit,
         pn->Name = pn->Label->Name;
       else
         pn->Name = "net" + pn->Label->Name;
+      nodeSets |= !pn->Label->initValue.isEmpty();
     }
     else pn->Name = "";
   }
@@ -1695,6 +1781,7 @@ bool Schematic::giveNodeNames(QTextStream *stream, int& countInit,
         pw->Port1->Name = pw->Label->Name;
       else  // avoid to use reserved VHDL words
         pw->Port1->Name = "net" + pw->Label->Name;
+      nodeSets |= !pw->Label->initValue.isEmpty();
     }
 
   // go through components
@@ -1703,11 +1790,13 @@ bool Schematic::giveNodeNames(QTextStream *stream, int& countInit,
     return false;
   }
 
-  // work on named nodes first in order to preserve the user given names
-  throughAllNodes(true, Collect, countInit);
+  if((nodeSets && a_isAnalog) || !nameNets()) {
+    // work on named nodes first in order to preserve the user given names
+    throughAllNodes(true, Collect, countInit);
 
-  // give names to the remaining (unnamed) nodes
-  throughAllNodes(false, Collect, countInit);
+    // give names to the remaining (unnamed) nodes
+    throughAllNodes(false, Collect, countInit);
+  }
 
   if(!a_isAnalog) // collect all node names for VHDL signal declaration
     collectDigitalSignals();
@@ -2092,6 +2181,7 @@ bool Schematic::isDigitalCircuit()
 int Schematic::prepareNetlist(QTextStream& stream, QStringList& Collect,
                               QPlainTextEdit *ErrText)
 {
+  QUCS_TRACE("Schematic::prepareNetlist");
   if(a_showBias > 0) a_showBias = -1;  // do not show DC bias anymore
 
   a_isVerilog = false;
@@ -2238,6 +2328,7 @@ void Schematic::endNetlistDigital(QTextStream& stream)
 // write all components with node names into the netlist file
 QString Schematic::createNetlist(QTextStream& stream, int NumPorts)
 {
+  QUCS_TRACE("Schematic::createNetlist");
   if(!a_isAnalog) {
     beginNetlistDigital(stream);
   }
@@ -1,7 +1,9 @@
 #include <QApplication>
+#include <QFileInfo>
 #include <QStandardPaths>
 
 #include "main.h"
+#include "misc.h"
 #include "settings.h"
 #include "extsimkernels/spicecompat.h"
 
@@ -75,9 +77,191 @@ void settingsManager::initDefaults()
     m_Defaults["TextAntiAliasing"] = false;
     m_Defaults["fullTraceName"] = false;
     m_Defaults["NgspiceCompatMode"] = spicecompat::NgspDefault;
+    m_Defaults["SimResultCache"] = true;
+    m_Defaults["SimCacheSizeMB"] = 200;
+    m_Defaults["HdlIncrementalBuild"] = true;
+    m_Defaults["TraceFile"] = "";
 }
 
 void settingsManager::initAliases()
 {
     m_Aliases["IgnoreVersion"] = QStringList({"IngnoreVersion"});
 }
+
+#if defined(_WIN32) ||defined(__MINGW32__)
+#define executableSuffix ".exe"
+#else
+#define executableSuffix ""
+#endif
+
+tQucsSettings QucsSettings;
+
+QucsApp *QucsMain = nullptr;  // the Qucs application itself
+QString lastDir;    // to remember last directory for several dialogs
+QStringList qucsPathList;
+VersionTriplet QucsVersion; // Qucs version string
+
+// #########################################################################
+// Loads the settings file and stores the settings.
+bool loadSettings()
+{
+    QSettings settings("qucs","qucs_s");
+
+    QucsSettings.DefaultSimulator = _settings::Get().item<int>("DefaultSimulator");
+    QucsSettings.firstRun = _settings::Get().item<bool>("firstRun");
+
+    /*** Temporarily continue to use QucsSettings to make sure all settings convert okay and remain compatible ***/
+    QucsSettings.font.fromString(_settings::Get().item<QString>("font"));
+    QucsSettings.appFont.fromString(_settings::Get().item<QString>("appFont"));
+    QucsSettings.textFont.fromString(_settings::Get().item<QString>("textFont"));
+    QucsSettings.largeFontSize = _settings::Get().item<double>("LargeFontSize");
+    QucsSettings.maxUndo = _settings::Get().item<int>("maxUndo");
+    QucsSettings.NodeWiring = _settings::Get().item<int>("NodeWiring");
+    QucsSettings.BGColor = _settings::Get().item<QString>("BGColor");
+    QucsSettings.Editor = _settings::Get().item<QString>("Editor");
+    QucsSettings.FileTypes = _settings::Get().item<QStringList>("FileTypes");
+    QucsSettings.Language = _settings::Get().item<QString>("Language");
+
+    // Editor syntax highlighting settings.
+    QucsSettings.Comment = _settings::Get().item<QString>("Comment");
+    QucsSettings.String = _settings::Get().item<QString>("String");
+    QucsSettings.Integer = _settings::Get().item<QString>("Integer");
+    QucsSettings.Real = _settings::Get().item<QString>("Real");
+    QucsSettings.Character = _settings::Get().item<QString>("Character");
+    QucsSettings.Type = _settings::Get().item<QString>("Type");
+    QucsSettings.Attribute = _settings::Get().item<QString>("Attribute");
+    QucsSettings.Directive = _settings::Get().item<QString>("Directive");
+    QucsSettings.Task = _settings::Get().item<QString>("Task");
+
+    // TODO: Convert this to the new settings model.
+    if(settings.contains("Qucsator")) {
+        QucsSettings.Qucsator = settings.value("Qucsator").toString();
+        QFileInfo inf(QucsSettings.Qucsator);
+        QucsSettings.QucsatorDir = inf.canonicalPath() + QDir::separator();
+        if (QucsSettings.Qucsconv.isEmpty())
+            QucsSettings.Qucsconv = QucsSettings.QucsatorDir + QDir::separator() + "qucsconv_rf" + executableSuffix;
+    } else {
+        QucsSettings.Qucsator = QucsSettings.BinDir + "qucsator_rf" + executableSuffix;
+        QucsSettings.QucsatorDir = QucsSettings.BinDir;
+        if (QucsSettings.Qucsconv.isEmpty())
+            QucsSettings.Qucsconv = QucsSettings.BinDir + "qucsconv_rf" + executableSuffix;
+    }
+
+    QucsSettings.AdmsXmlBinDir.setPath(_settings::Get().item<QString>("AdmsXmlBinDir"));
+    QucsSettings.AscoBinDir.setPath(_settings::Get().item<QString>("AscoBinDir"));
+    QucsSettings.NgspiceExecutable = _settings::Get().item<QString>("NgspiceExecutable");
+    QucsSettings.XyceExecutable = _settings::Get().item<QString>("XyceExecutable");
+    QucsSettings.XyceParExecutable = _settings::Get().item<QString>("XyceParExecutable");
+    QucsSettings.SpiceOpusExecutable = _settings::Get().item<QString>("SpiceOpusExecutable");
+    QucsSettings.NProcs = _settings::Get().item<int>("Nprocs");
+
+    // TODO: Currently the default settings cannot include other settings during initialisation. This is a
+    // problem for this setting as it needs to include the QucsWorkDir setting. Therefore, set the default to an
+    // empty string and populate it here by brute force.
+    QucsSettings.S4Qworkdir = _settings::Get().item<QString>("S4Q_workdir");
+    if (QucsSettings.S4Qworkdir == "")
+      QucsSettings.S4Qworkdir = QDir::toNativeSeparators(QucsSettings.QucsWorkDir.absolutePath()+"/spice4qucs");
+
+    QucsSettings.SimParameters = _settings::Get().item<QString>("SimParameters");
+    QucsSettings.OctaveExecutable = _settings::Get().item<QString>("OctaveExecutable");
+    QucsSettings.OpenVAFExecutable = _settings::Get().item<QString>("OpenVAFExecutable");
+
+    QucsSettings.RFLayoutExecutable = _settings::Get().item<QString>("RFLayoutExecutable");
+
+    QucsSettings.qucsWorkspaceDir.setPath(_settings::Get().item<QString>("QucsHomeDir"));
+    QucsSettings.QucsWorkDir = QucsSettings.qucsWorkspaceDir;
+    QucsSettings.tempFilesDir.setPath(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+
+    QucsSettings.IgnoreFutureVersion = _settings::Get().item<bool>("IgnoreVersion");
+    QucsSettings.GraphAntiAliasing = _settings::Get().item<bool>("GraphAntiAliasing");
+    QucsSettings.TextAntiAliasing = _settings::Get().item<bool>("TextAntiAliasing");
+    QucsSettings.fullTraceName = _settings::Get().item<bool>("fullTraceName");
+    QucsSettings.RecentDocs = _settings::Get().item<QString>("RecentDocs").split("*",qucs::SkipEmptyParts);
+    QucsSettings.numRecentDocs = QucsSettings.RecentDocs.count();
+    QucsSettings.spiceExtensions << "*.sp" << "*.cir" << "*.spc" << "*.spi";
+
+    // If present read in the list of directory paths in which Qucs should
+    // search for subcircuit schematics
+    int npaths = settings.beginReadArray("Paths");
+    for (int i = 0; i < npaths; ++i)
+    {
+        settings.setArrayIndex(i);
+        QString apath = settings.value("path").toString();
+        qucsPathList.append(apath);
+    }
+    settings.endArray();
+
+    QucsSettings.numRecentDocs = 0;
+
+    return true;
+}
+
+// #########################################################################
+// Saves the settings in the settings file.
+bool saveApplSettings()
+{
+    QSettings settings ("qucs","qucs_s");
+
+    // Note: It is not really necessary to take the following reference, but it
+    // arguably makes the code slightly cleaner - thoughts? To be clear:
+    // qs.item<int>() is identical to _settings::get().item<int>()
+    settingsManager& qs = _settings::Get();
+
+    qs.setItem<int>("DefaultSimulator", QucsSettings.DefaultSimulator);
+    qs.setItem<bool>("firstRun", false);
+    qs.setItem<QString>("font", QucsSettings.font.toString());
+    qs.setItem<QString>("appFont", QucsSettings.appFont.toString());
+    qs.setItem<QString>("textFont", QucsSettings.textFont.toString());
+    if (QucsMain != nullptr) {
+      qs.setItem<QByteArray>("MainWindowGeometry", QucsMain->saveGeometry());
+    }
+
+    // store LargeFontSize as a string, so it will be also human-readable in the settings file (will be a @Variant() otherwise)
+    qs.setItem<QString>("LargeFontSize", QString::number(QucsSettings.largeFontSize));
+    qs.setItem<unsigned int>("maxUndo", QucsSettings.maxUndo);
+    qs.setItem<unsigned int>("NodeWiring", QucsSettings.NodeWiring);
+    qs.setItem<QString>("BGColor", QucsSettings.BGColor.name());
+    qs.setItem<QString>("Editor", QucsSettings.Editor);
+    qs.setItem<QStringList>("FileTypes", QucsSettings.FileTypes);
+    qs.setItem<QString>("Language", QucsSettings.Language);
+    qs.setItem<QString>("Comment", QucsSettings.Comment.name());
+    qs.setItem<QString>("String", QucsSettings.String.name());
+    qs.setItem<QString>("Integer", QucsSettings.Integer.name());
+    qs.setItem<QString>("Real", QucsSettings.Real.name());
+    qs.setItem<QString>("Character", QucsSettings.Character.name());
+    qs.setItem<QString>("Type", QucsSettings.Type.name());
+    qs.setItem<QString>("Attribute", QucsSettings.Attribute.name());
+    qs.setItem<QString>("Directive", QucsSettings.Directive.name());
+    qs.setItem<QString>("Task", QucsSettings.Task.name());
+    qs.setItem<QString>("AdmsXmlBinDir", QucsSettings.AdmsXmlBinDir.canonicalPath());
+    qs.setItem<QString>("AscoBinDir", QucsSettings.AscoBinDir.canonicalPath());
+    qs.setItem<QString>("NgspiceExecutable",QucsSettings.NgspiceExecutable);
+    qs.setItem<QString>("XyceExecutable",QucsSettings.XyceExecutable);
+    qs.setItem<QString>("XyceParExecutable",QucsSettings.XyceParExecutable);
+    qs.setItem<QString>("SpiceOpusExecutable",QucsSettings.SpiceOpusExecutable);
+    qs.setItem<QString>("Qucsator",QucsSettings.Qucsator);
+    qs.setItem<int>("Nprocs",QucsSettings.NProcs);
+    qs.setItem<QString>("S4Q_workdir",QucsSettings.S4Qworkdir);
+    qs.setItem<QString>("SimParameters",QucsSettings.SimParameters);
+    qs.setItem<QString>("OctaveExecutable",QucsSettings.OctaveExecutable);
+    qs.setItem<QString>("OpenVAFExecutable",QucsSettings.OpenVAFExecutable);
+    qs.setItem<QString>("QucsHomeDir", QucsSettings.qucsWorkspaceDir.canonicalPath());
+    qs.setItem<bool>("IgnoreVersion", QucsSettings.IgnoreFutureVersion);
+    qs.setItem<bool>("GraphAntiAliasing", QucsSettings.GraphAntiAliasing);
+    qs.setItem<bool>("TextAntiAliasing", QucsSettings.TextAntiAliasing);
+    qs.setItem<bool>("fullTraceName",QucsSettings.fullTraceName);
+
+    // Copy the list of directory paths in which Qucs should
+    // search for subcircuit schematics from qucsPathList
+    settings.remove("Paths");
+    settings.beginWriteArray("Paths");
+    int i = 0;
+    for (QString& path: qucsPathList) {
+         settings.setArrayIndex(i);
+         settings.setValue("path", path);
+         i++;
+     }
+     settings.endArray();
+
+  return true;
+}
@@ -23,12 +23,176 @@
 
 #include "textdoc.h"
 #include "syntax.h"
+#include "misc.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QScrollBar>
+
+#include <climits>
+
+// Documents with more lines get the lines out of view highlighted later.
+static const int DeferBlocks = 2000;
+
+enum word_category {
+  WORD_RESERVED = 0,
+  WORD_UNIT,
+  WORD_DATATYPE,
+  WORD_DIRECTIVE,
+  WORD_FUNCTION,
+};
+
+// Highlighting rules of a language. A word listed in several categories
+// gets the format of the last one.
+struct LexiconSource {
+  const char *words[5];     // space separated, in word_category order
+  const char *comment;      // comment up to the end of the line
+  char lineComment;         // comment if first non-blank character
+  char prefix;              // part of the word if in front of it, e.g. ".tran"
+  bool caseSensitive;
+};
+
+struct Lexicon {
+  QHash<QString, int> words;
+  int longest;
+  QString comment;
+  QChar lineComment;
+  QChar prefix;
+  bool caseSensitive;
+};
+
+static const LexiconSource Sources[] = {
+  // LANG_NONE
+  { { "", "", "", "", "" }, "", 0, 0, true },
+
+  // LANG_VHDL
+  { { "abs access after alias all and architecture array assert attribute "
+      "begin block body buffer bus case component configuration constant "
+      "disconnect downto else elsif end entity exit file for function "
+      "generate generic group guarded if impure in inertial inout is label "
+      "library linkage literal loop map mod nand new next nor not null of on "
+      "open or others out package port postponed procedure process pure "
+      "range record register reject rem report return rol ror select "
+      "severity shared signal sla sll sra srl subtype then to transport type "
+      "unaffected units until use variable wait when while with xnor xor",
+      // units
+      "fs ps ns us ms sec min hr",
+      // data types
+      "bit bit_vector boolean std_logic std_logic_vector std_ulogic "
+      "std_ulogic_vector signed unsigned integer real time character natural",
+      // attributes
+      "active ascending base delayed event high image last_active last_event "
+      "last_value left leftof length low pos pred quiet range reverse_range "
+      "right rightof stable succ transaction val value",
+      "" },
+    "--", 0, 0, true },
+
+  // LANG_VERILOG
+  { { "always and assign attribute begin buf bufif0 bufif1 case casex casez "
+      "cmos deassign default defparam disable edge else end endattribute "
+      "endcase endfunction endmodule endprimitive endspecify endtable endtask "
+      "event for force forever fork function highz0 highz1 if ifnone initial "
+      "inout input join large medium module macromodule nand negedge nmos nor "
+      "not notif0 notif1 or output pmos posedge primitive pull0 pull1 "
+      "pulldown pullup rcmos release repeat rnmos rpmos rtran rtranif0 "
+      "rtranif1 scalared signed small specify strength strong0 strong1 table "
+      "task tran tranif0 tranif1 unsigned vectored wait weak0 weak1 while "
+      "xnor xor",
+      "",
+      "reg integer time real realtime wire tri wor trior wand triand tri0 "
+      "tri1 supply0 supply1 trireg parameter specparam event",
+      // compiler directives
+      "reset_all timescale define include ifdef else endif celldefine "
+      "endcelldefine default_nettype unconnected_drive nounconnected_drive "
+      "delay_mode_zero delay_mode_unit delay_mode_path delay_mode_distributed "
+      "uselib",
+      // system tasks
+      "setup hold setuphold skew recovery period width monitor display write "
+      "strobe fopen fclose time stime realtime timeformat printtimescale "
+      "random readmemb readmemh finish stop" },
+    "//", 0, 0, true },
+
+  // LANG_VERILOGA
+  { { "abstol access analog ac_stim analysis begin branch bound_step case "
+      "discipline ddt_nature ddt delay discontinuity default enddiscipline "
+      "else end endnature exclude endfunction endmodule electrical endcase "
+      "for flow from final_step flicker_noise function generate ground if "
+      "idt_nature inf idt initial_step input inout laplace_nd laplace_np "
+      "laplace_zd laplace_zp last_crossing module nature noise_table "
+      "potential parameter slew timer transition units white_noise while "
+      "zi_nd zi_np zi_zd zi_zp",
+      "T G M K m u n p f a",
+      "integer real",
+      "define else undef ifdef endif include resetall",
+      "realtime temperature vt display strobe" },
+    "//", 0, 0, true },
+
+  // LANG_OCTAVE
+  { { "case catch else elseif end endfor endfunction endif endswitch "
+      "end_try_catch endwhile end_unwind_protect for function if otherwise "
+      "switch try unwind_protect unwind_protect_cleanup while",
+      "",
+      "inf nan pi",
+      "",
+      "plot" },
+    "//", 0, 0, true },
+
+  // LANG_SPICE
+  { { "",
+      "",
+      "",
+      // dot commands
+      ".ac .control .csparam .dc .disto .end .endc .ends .four .func .global "
+      ".ic .if .else .elseif .endif .include .inc .lib .endl .meas .measure "
+      ".model .net .nodeset .noise .op .option .options .param .plot .print "
+      ".probe .pz .save .sens .sp .subckt .temp .tf .tran .width",
+      "" },
+    ";", '*', '.', false },
+};
+
+// Compiles the rules of a language, once.
+static const Lexicon *lexicon(int language)
+{
+  static Lexicon Compiled[sizeof(Sources)/sizeof(Sources[0])];
+  static bool Done[sizeof(Sources)/sizeof(Sources[0])] = { false };
+  if (language < 0 || language >= int(sizeof(Sources)/sizeof(Sources[0])))
+    language = LANG_NONE;
+
+  Lexicon &lex = Compiled[language];
+  if (!Done[language]) {
+    const LexiconSource &src = Sources[language];
+    lex.longest = 0;
+    for (int cat = WORD_RESERVED; cat <= WORD_FUNCTION; cat++)
+      for (const QString &word : QString::fromLatin1(src.words[cat]).split(' ', qucs::SkipEmptyParts)) {
+        lex.words.insert(word, cat);
+        lex.longest = qMax(lex.longest, int(word.size()));
+      }
+    lex.comment = QString::fromLatin1(src.comment);
+    lex.lineComment = QChar::fromLatin1(src.lineComment);
+    lex.prefix = QChar::fromLatin1(src.prefix);
+    lex.caseSensitive = src.caseSensitive;
+    Done[language] = true;
+  }
+  return &lex;
+}
+
+// Letters, digits and '_' in ASCII, like "\b" of a regular expression.
+static inline bool isWordChar(QChar c)
+{
+  ushort u = c.unicode();
+  return u < 128 && (u == '_' || (u >= '0' && u <= '9') ||
+                     ((u | 0x20) >= 'a' && (u | 0x20) <= 'z'));
+}
 
 
 SyntaxHighlighter::SyntaxHighlighter(TextDoc *textEdit) : QSyntaxHighlighter(textEdit)
 {
   Doc = textEdit;
-  language = LANG_NONE;
+  language = -1;
+  a_lexicon = lexicon(LANG_NONE);
+  a_pendingFrom = INT_MAX;
+  a_pendingTo = -1;
+  a_highlightAll = false;
 
   reservedWordFormat.setForeground(Qt::darkBlue);
   reservedWordFormat.setFontWeight(QFont::Bold);
@@ -48,6 +212,20 @@ SyntaxHighlighter::SyntaxHighlighter(TextDoc *textEdit) : QSyntaxHighlighter(tex
   commentFormat.setForeground(Qt::gray);;
   commentFormat.setFontWeight(QFont::StyleItalic);;
 
+  a_formats[WORD_RESERVED] = &reservedWordFormat;
+  a_formats[WORD_UNIT] = &unitFormat;
+  a_formats[WORD_DATATYPE] = &datatypeFormat;
+  a_formats[WORD_DIRECTIVE] = &directiveFormat;
+  a_formats[WORD_FUNCTION] = &functionFormat;
+
+  a_pendingTimer.setInterval(0);
+  connect(&a_pendingTimer, &QTimer::timeout, this, [this]() {
+    if (!highlightPending(20))
+      a_pendingTimer.stop();
+  });
+  // lines scrolled into view are highlighted at once
+  connect(Doc->verticalScrollBar(), &QScrollBar::valueChanged,
+          this, [this]() { highlightView(); });
 }
 
 SyntaxHighlighter::~SyntaxHighlighter()
@@ -57,202 +235,133 @@ SyntaxHighlighter::~SyntaxHighlighter()
 // ---------------------------------------------------
 void SyntaxHighlighter::setLanguage(int lang)
 {
+  if (lang == language)
+    return;
   language = lang;
+  a_lexicon = lexicon(lang);
+  if (document())
+    rehighlight();
+}
 
-  HighlightingRule rule;
-
-  QStringList reservedWordPattern;
-  QStringList unitPattern;
-  QStringList datatypePattern;
-  QStringList directivePattern;
-  QStringList functionPattern;
-  QStringList commentPattern;
-
-  switch (language) {
-    case LANG_VHDL:
-        reservedWordPattern << "\\babs\\b" << "\\baccess\\b" << "\\bafter\\b" << "\\balias\\b" << "\\ball\\b" << "\\band\\b" <<
-                        "\\barchitecture\\b\\b"<< "\\barray\\b"<< "\\bassert\\b" << "\\battribute\\b"<<
-                        "\\bbegin\\b\\b"<< "\\bblock\\b"<< "\\bbody\\b"<< "\\bbuffer\\b"<< "\\bbus\\b"<<
-                        "\\bcase\\b"<< "\\bcomponent\\b"<< "\\bconfiguration\\b"<< "\\bconstant\\b"<<
-                        "\\bdisconnect\\b"<< "\\bdownto\\b"<<
-                        "\\belse\\b"<< "\\belsif\\b"<< "\\bend\\b"<< "\\bentity\\b"<< "\\bexit\\b"<<
-                        "\\bfile\\b"<< "\\bfor\\b"<< "\\bfunction"
-                        "\\bgenerate\\b"<< "\\bgeneric\\b"<< "\\bgroup\\b"<< "\\bguarded"
-                        "\\bif\\b"<< "\\bimpure\\b"<< "\\bin\\b"<< "\\binertial\\b"<< "\\binout\\b"<< "\\bis\\b"<<
-                        "\\blabel\\b"<< "\\blibrary\\b"<< "\\blinkage\\b"<< "\\bliteral\\b"<< "\\bloop\\b"<<
-                        "\\bmap\\b"<< "\\bmod\\b"<< 
-                        "\\bnand\\b"<< "\\bnew\\b"<< "\\bnext\\b"<< "\\bnor\\b"<< "\\bnot\\b"<< "\\bnull"
-                        "\\bof\\b"<< "\\bon\\b"<< "\\bopen\\b"<< "\\bor\\b"<< "\\bothers\\b"<< "\\bout\\b"<<
-                        "\\bpackage\\b"<< "\\bport\\b"<< "\\bpostponed\\b"<< "\\bprocedure\\b"<< "\\bprocess\\b"<< "\\bpure\\b"<<
-                        "\\brange\\b"<< "\\brecord\\b"<< "\\bregister\\b"<< "\\breject\\b"<< "\\brem\\b"<< "\\breport\\b"<< "\\breturn\\b"<< "\\brol\\b"<< "\\bror\\b"<<
-                        "\\bselect\\b"<< "\\bseverity\\b"<< "\\bshared\\b"<< "\\bsignal\\b"<< "\\bsla\\b"<< "\\bsll\\b"<< "\\bsra\\b"<< "\\bsrl\\b"<< "\\bsubtype\\b"<<
-                        "\\bthen\\b"<< "\\bto\\b"<< "\\btransport\\b"<< "\\btype\\b"<<
-                        "\\bunaffected\\b"<< "\\bunits\\b"<< "\\buntil\\b"<< "\\buse\\b"<<
-                        "\\bvariable\\b"<<
-                        "\\bwait\\b"<< "\\bwhen\\b"<< "\\bwhile\\b"<< "\\bwith\\b"<<
-                        "\\bxnor\\b"<< "\\bxor\\b";
-
-          unitPattern <<  "\\bfs\\b"<< "\\bps\\b"<< "\\bns\\b"<< "\\bus\\b"<< "\\bms\\b"<< "\\bsec\\b"<< "\\bmin\\b"<< "\\bhr\\b";
-
-          datatypePattern << "\\bbit\\b"<< "\\bbit_vector\\b"<< "\\bboolean\\b"<< "\\bstd_logic\\b"<< "\\bstd_logic_vector\\b"<< "\\bstd_ulogic\\b"<< "\\bstd_ulogic_vector\\b"<< "\\bsigned\\b"<< "\\bunsigned\\b"<< "\\binteger\\b"<< "\\breal\\b"<< "\\btime\\b"<< "\\bcharacter\\b"<< "\\bnatural\\b";
-
-          directivePattern << "\\bactive\\b"<< "\\bascending\\b" <<
-                        "\\bbase\\b" <<
-                        "\\bdelayed\\b" <<
-                        "\\bevent\\b" <<
-                        "\\bhigh\\b" <<
-                        "\\bimage\\b" <<
-                        "\\blast_active\\b"<< "\\blast_event\\b"<< "\\blast_value\\b"<< "\\bleft\\b"<< "\\bleftof\\b"<< "\\blength\\b"<< "\\blow\\b" <<
-                        "\\bpos\\b"<< "\\bpred\\b"<<
-                        "\\bquiet\\b"<<
-                        "\\brange\\b"<< "\\breverse_range\\b"<< "\\bright\\b"<< "\\brightof\\b"<<
-                        "\\bstable\\b"<< "\\bsucc\\b"<<
-                        "\\btransaction\\b"<<
-                        "\\bval\\b"<< "\\bvalue\\b";
-
-          commentPattern << "--[^\n]*";
-
-        break;
-
-  case LANG_VERILOG:
-        reservedWordPattern << "\\balways\\b"<< "\\band\\b"<< "\\bassign\\b"<< "\\battribute\\b"<<
-                        "\\bbegin\\b"<< "\\bbuf\\b"<< "\\bbufif0\\b"<< "\\bbufif1\\b"<<
-                        "\\bcase\\b"<< "\\bcasex\\b"<< "\\bcasez\\b" <<  "\\bcmos\\b"<< 
-                        "\\bdeassign\\b"<< "\\bdefault\\b"<< "\\bdefparam\\b"<< "\\bdisable\\b"<<
-                        "\\bedge\\b"<< "\\belse\\b"<< "\\bend\\b"<< "\\bendattribute\\b"<< "\\bendcase\\b"<< "\\bendfunction\\b"<< "\\bendmodule\\b"<< "\\bendprimitive\\b"<< "\\bendspecify\\b"<< "\\bendtable\\b"<< "\\bendtask\\b"<< "\\bevent\\b"<<
-                        "\\bfor\\b"<< "\\bforce\\b"<< "\\bforever\\b"<< "\\bfork\\b"<< "\\bfunction\\b"<<
-                        "\\bhighz0\\b"<< "\\bhighz1\\b"<<
-                        "\\bif\\b"<< "\\bifnone\\b"<< "\\binitial\\b"<< "\\binout\\b"<< "\\binput\\b"<<
-                        "\\bjoin\\b"<<
-                        "\\blarge\\b"<<
-                        "\\bmedium\\b"<< "\\bmodule\\b"<< "\\bmacromodule\\b"<<
-                        "\\bnand\\b"<< "\\bnegedge\\b"<< "\\bnmos\\b"<< "\\bnor\\b"<< "\\bnot\\b"<< "\\bnotif0\\b"<< "\\bnotif1\\b"<<
-                        "\\bor\\b"<< "\\boutput\\b"<<
-                        "\\bpmos\\b"<< "\\bposedge\\b"<< "\\bprimitive\\b"<< "\\bpull0\\b"<< "\\bpull1\\b"<< "\\bpulldown\\b"<< "\\bpullup\\b"<<
-                        "\\brcmos\\b"<< "\\brelease\\b"<< "\\brepeat\\b"<< "\\brnmos\\b"<< "\\brpmos\\b"<< "\\brtran\\b"<< "\\brtranif0\\b"<< "\\brtranif1\\b"<<
-                        "\\bscalared\\b"<< "\\bsigned\\b"<< "\\bsmall\\b"<< "\\bspecify\\b"<< "\\bstrength\\b"<< "\\bstrong0\\b"<< "\\bstrong1\\b"<<
-                        "\\btable\\b"<< "\\btask\\b"<< "\\btran\\b"<< "\\btranif0\\b"<< "\\btranif1\\b"<<
-                        "\\bunsigned\\b"<<
-                        "\\bvectored\\b"<<
-                        "\\bwait\\b"<< "\\bweak0\\b"<< "\\bweak1\\b"<< "\\bwhile\\b"<<
-                        "\\bxnor\\b"<< "\\bxor\\b";
-
-        directivePattern << "\\breset_all\\b"<< "\\btimescale\\b"<< "\\bdefine\\b"<< "\\binclude\\b"<< "\\bifdef\\b"<< "\\belse\\b"<< "\\bendif\\b"<<
-                          "\\bcelldefine\\b"<< "\\bendcelldefine\\b"<< "\\bdefault_nettype\\b"<< "\\bunconnected_drive\\b"<<
-                          "\\bnounconnected_drive\\b"<< "\\bdelay_mode_zero\\b"<< "\\bdelay_mode_unit\\b"<<
-                          "\\bdelay_mode_path\\b"<< "\\bdelay_mode_distributed\\b"<< "\\buselib\\b";
-
-        datatypePattern << "\\breg\\b"<< "\\binteger\\b"<< "\\btime\\b"<< "\\breal\\b"<< "\\brealtime\\b"<< "\\bwire\\b"<< "\\btri\\b"<< "\\bwor\\b"<<
-                          "\\btrior\\b"<< "\\bwand\\b"<< "\\btriand\\b"<< "\\btri0\\b"<< "\\btri1\\b"<< "\\bsupply0\\b"<< "\\bsupply1\\b"<< "\\btrireg\\b"<<
-                          "\\bparameter\\b"<< "\\bspecparam\\b"<< "\\bevent\\b";
-
-        functionPattern <<  "\\bsetup\\b"<< "\\bhold\\b"<< "\\bsetuphold\\b"<< "\\bskew\\b"<< "\\brecovery\\b"<< "\\bperiod\\b"<< "\\bwidth\\b"<<
-                          "\\bmonitor\\b"<< "\\bdisplay\\b"<< "\\bwrite\\b"<< "\\bstrobe\\b"<< "\\bfopen\\b"<< "\\bfclose\\b"<< "\\btime\\b"<<
-                          "\\bstime\\b"<< "\\brealtime\\b"<< "\\btimeformat\\b"<< "\\bprinttimescale\\b"<< "\\brandom\\b"<< "\\breadmemb\\b"<<
-                          "\\breadmemh\\b"<< "\\bfinish\\b"<< "\\bstop\\b";
-
-        commentPattern << "//[^\n]*";
-
-    break;
-
-  case LANG_VERILOGA:
-
-        reservedWordPattern << "\\babstol\\b"<< "\\baccess\\b"<< "\\banalog\\b"<< "\\bac_stim\\b"<< "\\banalysis\\b"<<
-                          "\\bbegin\\b"<< "\\bbranch\\b"<< "\\bbound_step\\b"<<
-                          "\\bcase\\b"<<
-                          "\\bdiscipline\\b"<< "\\bddt_nature\\b"<< "\\bddt\\b"<< "\\bdelay\\b"<< "\\bdiscontinuity\\b"<< "\\bdefault\\b"<< 
-                          "\\benddiscipline\\b"<< "\\belse\\b"<< "\\bend\\b"<< "\\bendnature\\b"<< "\\bexclude\\b"<< "\\bendfunction\\b"<< "\\bendmodule\\b"<< "\\belectrical\\b"<< "\\bendcase\\b"<<
-                          "\\bfor\\b"<< "\\bflow\\b"<< "\\bfrom\\b"<< "\\bfinal_step\\b"<< "\\bflicker_noise\\b"<< "\\bfunction\\b"<<
-                          "\\bgenerate\\b"<< "\\bground\\b"<<
-                          "\\bif\\b"<< "\\bidt_nature\\b"<< "\\binf\\b"<< "\\bidt\\b"<< "\\binitial_step\\b"<< "\\binput\\b"<< "\\binout\\b"<<
-                          "\\blaplace_nd\\b"<< "\\blaplace_np\\b"<< "\\blaplace_zd\\b"<< "\\blaplace_zp\\b"<< "\\blast_crossing\\b"<<
-                          "\\bmodule\\b"<<
-                          "\\bnature\\b"<< "\\bnoise_table\\b"<<
-                          "\\bpotential\\b"<< "\\bparameter\\b"<<
-                          "\\bslew\\b"<<
-                          "\\btimer\\b"<< "\\btransition\\b"<<
-                          "\\bunits\\b"<<
-                          "\\bwhite_noise\\b"<< "\\bwhile\\b"<<
-                          "\\bzi_nd\\b"<< "\\bzi_np\\b"<< "\\bzi_zd\\b"<< "\\bzi_zp\\b";
-
-        unitPattern << "\\bT\\b"<< "\\bG\\b"<< "\\bM\\b"<< "\\bK\\b"<< "\\bm\\b"<< "\\bu\\b"<< "\\bn\\b"<< "\\bp\\b"<< "\\bf\\b"<< "\\ba\\b";
-
-        datatypePattern << "\\binteger\\b"<< "\\breal\\b";
-
-        directivePattern << "\\bdefine\\b"<< "\\belse\\b"<< "\\bundef\\b"<< "\\bifdef\\b"<< "\\bendif\\b"<< "\\binclude\\b"<< "\\bresetall\\b";
-
-        functionPattern << "\\brealtime\\b"<< "\\btemperature\\b"<< "\\bvt\\b"<< "\\bdisplay\\b"<< "\\bstrobe\\b";
-
-        commentPattern << "//[^\n]*";
-
-    break;
-  case LANG_OCTAVE:
-      
-        reservedWordPattern << "\\bcase\\b"<< "\\bcatch\\b"<<
-                          "\\belse\\b"<< "\\belseif\\b"<< "\\bend\\b"<< "\\bendfor\\b"<< "\\bendfunction\\b"<< "\\bendif\\b"<< "\\bendswitch\\b"<< "\\bend_try_catch\\b"<< "\\bendwhile\\b"<< "\\bend_unwind_protect\\b"
-                          "\\bfor\\b" << "\\bfunction\\b" <<
-                          "\\bif\\b" <<
-                          "\\botherwise\\b" <<
-                          "\\bswitch\\b" <<
-                          "\\btry\\b" <<
-                          "\\bunwind_protect\\b"<< "\\bunwind_protect_cleanup\\b" <<
-                          "\\bwhile\\b";
-
-        datatypePattern << "\\binf\\b"<< "\\bnan\\b"<< "\\bpi\\b";
-
-        functionPattern << "\\bplot\\b";
-
-        commentPattern << "//[^\n]*";
-
-    break;
-    }
+// ---------------------------------------------------
+// True if the line is out of view in a large document and is left for
+// later.
+bool SyntaxHighlighter::deferred(int block) const
+{
+  if (a_highlightAll || document()->blockCount() <= DeferBlocks)
+    return false;
+  // without line wrapping the scroll bar counts lines
+  const QScrollBar *bar = Doc->verticalScrollBar();
+  int page = qMax(bar->pageStep(), 100);
+  return block < bar->value() - page || block > bar->value() + 2*page;
+}
 
-  for (const QString &pattern : reservedWordPattern) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = reservedWordFormat;
-    highlightingRules.append(rule);
+// ---------------------------------------------------
+void SyntaxHighlighter::highlightBlock(const QString &text) {
+  if (a_lexicon->words.isEmpty() && a_lexicon->comment.isEmpty())
+    return;
+
+  int number = currentBlock().blockNumber();
+  if (deferred(number)) {
+    a_pendingFrom = qMin(a_pendingFrom, number);
+    a_pendingTo = qMax(a_pendingTo, number);
+    if (!a_pendingTimer.isActive())
+      a_pendingTimer.start();
+    return;
   }
 
-  for (const QString &pattern : unitPattern) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = unitFormat;
-    highlightingRules.append(rule);
-  }
+  const QChar *s = text.constData();
+  int size = text.size();
 
-  for (const QString &pattern : datatypePattern) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = datatypeFormat;
-    highlightingRules.append(rule);
+  int comment = size;
+  if (!a_lexicon->lineComment.isNull()) {
+    int i = 0;
+    while (i < size && s[i].isSpace()) i++;
+    if (i < size && s[i] == a_lexicon->lineComment)
+      comment = i;
   }
-
-  for (const QString &pattern : directivePattern) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = directiveFormat;
-    highlightingRules.append(rule);
+  if (comment == size && !a_lexicon->comment.isEmpty()) {
+    int i = text.indexOf(a_lexicon->comment);
+    if (i >= 0) comment = i;
   }
 
-  for (const QString &pattern : functionPattern) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = functionFormat;
-    highlightingRules.append(rule);
+  QChar lower[64];
+  for (int i = 0; i < comment; ) {
+    if (!isWordChar(s[i])) {
+      i++;
+      continue;
+    }
+    int start = i;
+    while (i < size && isWordChar(s[i])) i++;
+
+    // with its prefix character if there is one
+    int from = start;
+    if (!a_lexicon->prefix.isNull() && start > 0 && s[start-1] == a_lexicon->prefix)
+      from--;
+    int length = i - from;
+    if (length > a_lexicon->longest || s[start].isDigit())
+      continue;
+
+    const QChar *word = s + from;
+    if (!a_lexicon->caseSensitive) {
+      for (int k = 0; k < length; k++)
+        lower[k] = word[k].toLower();
+      word = lower;
+    }
+    auto it = a_lexicon->words.constFind(QString::fromRawData(word, length));
+    if (it != a_lexicon->words.constEnd())
+      setFormat(from, length, *a_formats[it.value()]);
   }
 
-  for (const QString &pattern : commentPattern) {
-    rule.pattern = QRegularExpression(pattern);
-    rule.format = commentFormat;
-    highlightingRules.append(rule);
-  }
+  if (comment < size)
+    setFormat(comment, size - comment, commentFormat);
 }
 
 // ---------------------------------------------------
-void SyntaxHighlighter::highlightBlock(const QString &text) {
-    for (const HighlightingRule &rule : highlightingRules) {
-        QRegularExpression expression(rule.pattern);
-        QRegularExpressionMatchIterator iter = expression.globalMatch(text);
-        while (iter.hasNext()) {
-            QRegularExpressionMatch match = iter.next();
-            int length = match.capturedLength();
-            setFormat(match.capturedStart(), length, rule.format);
-        }
-    }
+// Highlights the deferred lines that are in view.
+void SyntaxHighlighter::highlightView()
+{
+  if (a_pendingFrom > a_pendingTo || !document())
+    return;
+  const QScrollBar *bar = Doc->verticalScrollBar();
+  int first = qMax(bar->value(), a_pendingFrom);
+  int last = qMin(bar->value() + qMax(bar->pageStep(), 100), a_pendingTo);
+
+  a_highlightAll = true;
+  for (QTextBlock block = document()->findBlockByNumber(first);
+       block.isValid() && block.blockNumber() <= last; block = block.next())
+    rehighlightBlock(block);
+  a_highlightAll = false;
+}
+
+// ---------------------------------------------------
+bool SyntaxHighlighter::highlightPending(int ms)
+{
+  if (!document())
+    return false;
+  a_pendingTo = qMin(a_pendingTo, document()->blockCount() - 1);
+  if (a_pendingFrom > a_pendingTo) {
+    a_pendingFrom = INT_MAX;
+    a_pendingTo = -1;
+    return false;
+  }
+
+  QElapsedTimer clock;
+  clock.start();
+  a_highlightAll = true;
+  QTextBlock block = document()->findBlockByNumber(a_pendingFrom);
+  while (block.isValid() && a_pendingFrom <= a_pendingTo) {
+    rehighlightBlock(block);
+    block = block.next();
+    if ((++a_pendingFrom & 127) == 0 && clock.elapsed() >= ms)
+      break;
+  }
+  a_highlightAll = false;
+
+  if (!block.isValid() || a_pendingFrom > a_pendingTo) {
+    a_pendingFrom = INT_MAX;
+    a_pendingTo = -1;
+    return false;
+  }
+  return true;
 }
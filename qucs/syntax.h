@@ -20,7 +20,7 @@
 
 #include "textdoc.h"
 #include <QSyntaxHighlighter>
-#include <QRegularExpression>
+#include <QTimer>
 
 enum language_type {
   LANG_NONE = 0,
@@ -28,6 +28,7 @@ enum language_type {
   LANG_VERILOG,
   LANG_VERILOGA,
   LANG_OCTAVE,
+  LANG_SPICE,
 };
 
 enum textstate_type {
@@ -35,6 +36,17 @@ enum textstate_type {
   STATE_COMMENT = 100,
 };
 
+struct Lexicon;
+
+/*!
+ * \brief Highlights keywords and comments of a TextDoc.
+ *
+ * Each language is a table of words compiled once into a hash, a line is
+ * split into words in a single pass and every word is looked up. Lines
+ * do not depend on each other, so in large documents only the lines
+ * around the view are highlighted right away and the rest in the
+ * background, a few milliseconds at a time.
+ */
 class SyntaxHighlighter : public QSyntaxHighlighter {
 public:
  SyntaxHighlighter(TextDoc*);
@@ -43,17 +55,22 @@ public:
  void setLanguage(int);
  void highlightBlock(const QString&);
 
+ // Highlights deferred lines for about "ms" milliseconds, returns true
+ // if there are more left.
+ bool highlightPending(int ms);
+
 private:
+  bool deferred(int block) const;
+  void highlightView();
+
   int language;
   TextDoc *Doc;
+  const Lexicon *a_lexicon;
 
-  struct HighlightingRule
-     {
-         QRegularExpression pattern;
-         QTextCharFormat format;
-     };
-  
-  QVector<HighlightingRule> highlightingRules;
+  // deferred lines (block numbers), empty if a_pendingFrom > a_pendingTo
+  int a_pendingFrom, a_pendingTo;
+  bool a_highlightAll;
+  QTimer a_pendingTimer;
 
   QTextCharFormat reservedWordFormat;
   QTextCharFormat unitFormat;
@@ -61,6 +78,7 @@ private:
   QTextCharFormat directiveFormat;
   QTextCharFormat functionFormat;
   QTextCharFormat commentFormat;
+  const QTextCharFormat *a_formats[5];
 
 };
 
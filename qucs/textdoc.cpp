@@ -105,6 +105,9 @@ void TextDoc::setLanguage (const QString& FileName)
     setLanguage (LANG_VERILOGA);
   else if (ext == "m" || ext == "oct")
     setLanguage (LANG_OCTAVE);
+  else if (ext == "cir" || ext == "ckt" || ext == "sp" || ext == "spi" ||
+           ext == "spice")
+    setLanguage (LANG_SPICE);
   else
     setLanguage (LANG_NONE);
 }
@@ -488,6 +491,9 @@ void TextDoc::commentSelected ()
   case LANG_OCTAVE:
     co = "%";
     break;
+  case LANG_SPICE:
+    co = "*";
+    break;
   default:
     co = "";
     break;
@@ -604,6 +610,5 @@ void TextDoc::highlightCurrentLine()
 void TextDoc::refreshLanguage()
 {
     this->setLanguage(a_DocName);
-    syntaxHighlight->setLanguage(language);
-    syntaxHighlight->setDocument(document());
+    syntaxHighlight->setLanguage(language);  // rehighlights if changed
 }
@@ -61,6 +61,7 @@ public:
   void  insertSkeleton ();
   void  setLanguage (int);
   void  setLanguage (const QString&);
+  SyntaxHighlighter* highlighter () const { return syntaxHighlight; }
   QString getModuleName (void);
 
   virtual void wheelEvent(QWheelEvent* event) override;
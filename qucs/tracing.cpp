@@ -0,0 +1,103 @@
+/***************************************************************************
+                               tracing.cpp
+                              -------------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "tracing.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+#include <QDebug>
+
+/*!
+ * \file tracing.cpp
+ * \brief Implementation of the Tracer class.
+ */
+
+std::atomic<bool> Tracer::s_enabled{false};
+QString Tracer::s_file;
+QElapsedTimer Tracer::s_clock;
+QMutex Tracer::s_lock;
+std::vector<Tracer::Event> Tracer::s_events;
+QHash<quintptr, int> Tracer::s_threads;
+
+// -------------------------------------------------------
+// Starts recording. Timestamps are relative to this call.
+void Tracer::start(const QString &file)
+{
+  if (file.isEmpty() || enabled()) return;
+  QMutexLocker locker(&s_lock);
+  s_file = file;
+  s_events.reserve(4096);
+  s_clock.start();
+  s_enabled.store(true, std::memory_order_relaxed);
+  qAddPostRoutine(Tracer::finish); // every exit path of main()
+}
+
+// -------------------------------------------------------
+qint64 Tracer::now()
+{
+  return s_clock.nsecsElapsed();
+}
+
+// -------------------------------------------------------
+// Adds one complete event. Thread ids are numbered in order of appearance,
+// the main thread normally gets 1.
+void Tracer::record(const char *name, qint64 begin_ns, qint64 end_ns)
+{
+  if (!enabled()) return;
+  quintptr thread = quintptr(QThread::currentThreadId());
+  QMutexLocker locker(&s_lock);
+  int tid = s_threads.value(thread, 0);
+  if (tid == 0) {
+    tid = s_threads.size() + 1;
+    s_threads.insert(thread, tid);
+  }
+  s_events.push_back(Event{name, begin_ns, end_ns - begin_ns, tid});
+}
+
+// -------------------------------------------------------
+// Stops recording and writes the events in Chrome trace JSON format.
+void Tracer::finish()
+{
+  if (!enabled()) return;
+  s_enabled.store(false, std::memory_order_relaxed);
+  QMutexLocker locker(&s_lock);
+
+  QFile file(s_file);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "Tracer: cannot write" << s_file;
+    return;
+  }
+
+  qint64 pid = QCoreApplication::applicationPid();
+  QTextStream stream(&file);
+  stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+         << ",\"args\":{\"name\":\"qucs-s\"}}";
+  for (const Event &e : s_events) {
+    // names are literals from the source, nothing to escape
+    stream << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"qucs\",\"ph\":\"X\""
+           << ",\"ts\":" << QString::number(e.begin / 1000.0, 'f', 3)
+           << ",\"dur\":" << QString::number(e.duration / 1000.0, 'f', 3)
+           << ",\"pid\":" << pid << ",\"tid\":" << e.tid << "}";
+  }
+  stream << "\n]}\n";
+  file.close();
+
+  s_events.clear();
+  s_threads.clear();
+}
@@ -0,0 +1,85 @@
+/***************************************************************************
+                                tracing.h
+                               -----------
+    begin                : Mon Oct 19 2026
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <atomic>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+/*!
+ * \file tracing.h
+ * \brief Scoped timers that record a Chrome trace (chrome://tracing,
+ *        Perfetto) of startup, loading, netlisting and simulation.
+ *
+ * Tracing is switched on by the QUCS_TRACE environment variable or by the
+ * "TraceFile" setting, both give the name of the JSON file written when
+ * the application exits. A disabled span costs one atomic load.
+ */
+
+class Tracer {
+public:
+  static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+  static void start(const QString &file);
+  static void finish();
+
+  static qint64 now();
+  static void record(const char *name, qint64 begin_ns, qint64 end_ns);
+
+private:
+  struct Event {
+    const char *name;
+    qint64 begin;
+    qint64 duration;
+    int tid;
+  };
+
+  static std::atomic<bool> s_enabled;
+  static QString s_file;
+  static QElapsedTimer s_clock;
+  static QMutex s_lock;
+  static std::vector<Event> s_events;
+  static QHash<quintptr, int> s_threads;
+};
+
+/*!
+ * \brief The TraceSpan class records the lifetime of a scope as one trace
+ *        event. Spans may nest, the viewer stacks them by time.
+ *        The name must be a string literal.
+ */
+class TraceSpan {
+public:
+  explicit TraceSpan(const char *name)
+    : a_name(name), a_begin(Tracer::enabled() ? Tracer::now() : -1) {}
+  ~TraceSpan() { if (a_begin >= 0) Tracer::record(a_name, a_begin, Tracer::now()); }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+  const char *a_name;
+  qint64 a_begin;
+};
+
+#define QUCS_TRACE_CONCAT2(a, b) a##b
+#define QUCS_TRACE_CONCAT(a, b) QUCS_TRACE_CONCAT2(a, b)
+#define QUCS_TRACE(name) TraceSpan QUCS_TRACE_CONCAT(_trace_span_, __LINE__)(name)
+
+#endif // TRACING_H
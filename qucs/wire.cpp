@@ -179,35 +179,38 @@ bool Wire::load(const QString& _s)
   if(s.at(s.length()-1) != '>') return false;
   s = s.mid(1, s.length()-2);   // cut off start and end character
 
+  const QStringList fields = s.split(' ');
+  const QStringList quoted = s.split('"');
+
   QString n;
-  n  = s.section(' ',0,0);    // x1
+  n  = fields.value(0);    // x1
   x1 = n.toInt(&ok);
   if(!ok) return false;
 
-  n  = s.section(' ',1,1);    // y1
+  n  = fields.value(1);    // y1
   y1 = n.toInt(&ok);
   if(!ok) return false;
 
-  n  = s.section(' ',2,2);    // x2
+  n  = fields.value(2);    // x2
   x2 = n.toInt(&ok);
   if(!ok) return false;
 
-  n  = s.section(' ',3,3);    // y2
+  n  = fields.value(3);    // y2
   y2 = n.toInt(&ok);
   if(!ok) return false;
 
-  n = s.section('"',1,1);
+  n = quoted.value(1);
   if(!n.isEmpty()) {     // is wire labeled ?
-    int nx = s.section(' ',5,5).toInt(&ok);   // x coordinate
+    int nx = fields.value(5).toInt(&ok);   // x coordinate
     if(!ok) return false;
 
-    int ny = s.section(' ',6,6).toInt(&ok);   // y coordinate
+    int ny = fields.value(6).toInt(&ok);   // y coordinate
     if(!ok) return false;
 
-    int delta = s.section(' ',7,7).toInt(&ok);// delta for x/y root coordinate
+    int delta = fields.value(7).toInt(&ok);// delta for x/y root coordinate
     if(!ok) return false;
 
-    setName(n, s.section('"',3,3), delta, nx, ny);  // Wire Label
+    setName(n, quoted.value(3), delta, nx, ny);  // Wire Label
   }
 
   return true;